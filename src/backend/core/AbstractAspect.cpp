@@ -676,6 +676,7 @@ void AbstractAspect::exec(QUndoCommand* command,
  * \brief Begin an undo stack macro (series of commands)
  */
 void AbstractAspect::beginMacro(const QString& text) {
+	AbstractColumn::beginChangeBatch();
 	if (!d->m_undoAware)
 		return;
 
@@ -688,12 +689,14 @@ void AbstractAspect::beginMacro(const QString& text) {
  * \brief End the current undo stack macro
  */
 void AbstractAspect::endMacro() {
-	if (!d->m_undoAware)
-		return;
+	if (d->m_undoAware) {
+		QUndoStack* stack = undoStack();
+		if (stack)
+			stack->endMacro();
+	}
 
-	QUndoStack* stack = undoStack();
-	if (stack)
-		stack->endMacro();
+	//announce the rows changed within the macro
+	AbstractColumn::endChangeBatch();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
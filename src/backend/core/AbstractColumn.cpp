@@ -33,9 +33,15 @@
 #include "backend/lib/SignallingUndoCommand.h"
 
 #include <QDateTime>
+#include <QMetaObject>
+#include <QThread>
 #include <KLocale>
 #include <cmath>
 
+//nesting depth of the change batches and the columns with changed rows not announced yet
+static int changeBatchDepth = 0;
+static QList<AbstractColumn*> changedColumns;
+
 /**
  * \class AbstractColumn
  * \brief Interface definition for data with column logic
@@ -84,6 +90,7 @@ AbstractColumn::AbstractColumn(const QString &name) : AbstractAspect(name),
 }
 
 AbstractColumn::~AbstractColumn() {
+	changedColumns.removeOne(this);
 	emit aboutToBeDestroyed(this);
 	delete m_abstract_column_private;
 }
@@ -485,6 +492,75 @@ double AbstractColumn::maximum() const{
 //@}
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * \brief Start a batch of changes
+ *
+ * The rows changed in all columns until the matching endChangeBatch() are announced
+ * with one rowsChanged() per column when the outermost batch ends.
+ * Called by AbstractAspect::beginMacro().
+ */
+void AbstractColumn::beginChangeBatch() {
+	++changeBatchDepth;
+}
+
+/**
+ * \brief End a batch of changes started with beginChangeBatch()
+ */
+void AbstractColumn::endChangeBatch() {
+	if (changeBatchDepth > 0)
+		--changeBatchDepth;
+
+	if (changeBatchDepth == 0) {
+		const QList<AbstractColumn*> columns = changedColumns;
+		foreach (AbstractColumn* column, columns)
+			column->flushChangedRows();
+	}
+}
+
+/**
+ * \brief Add the rows \c first to \c last to the changed rows of the column
+ *
+ * To be called by derived classes together with dataChanged(). The changed rows are merged into one range
+ * and announced by rowsChanged() once per event loop turn or at the end of a change batch.
+ * Calls from worker threads, e.g. while loading columns in parallel, are forwarded to the thread of the column.
+ */
+void AbstractColumn::markRowsChanged(int first, int last) {
+	if (QThread::currentThread() != thread()) {
+		QMetaObject::invokeMethod(this, "markRowsChanged", Qt::QueuedConnection, Q_ARG(int, first), Q_ARG(int, last));
+		return;
+	}
+
+	first = qMax(first, 0);
+	last = qMax(last, first);
+
+	AbstractColumnPrivate* d = m_abstract_column_private;
+	if (d->m_changedFirst < 0) {
+		d->m_changedFirst = first;
+		d->m_changedLast = last;
+		changedColumns << this;
+		QMetaObject::invokeMethod(this, "flushChangedRows", Qt::QueuedConnection);
+	} else {
+		d->m_changedFirst = qMin(d->m_changedFirst, first);
+		d->m_changedLast = qMax(d->m_changedLast, last);
+	}
+}
+
+/**
+ * \brief Emit rowsChanged() for the rows changed since the last call
+ */
+void AbstractColumn::flushChangedRows() {
+	AbstractColumnPrivate* d = m_abstract_column_private;
+	if (d->m_changedFirst < 0)
+		return;
+
+	const int first = d->m_changedFirst;
+	const int last = d->m_changedLast;
+	d->m_changedFirst = -1;
+	d->m_changedLast = -1;
+	changedColumns.removeOne(this);
+	emit rowsChanged(this, first, last);
+}
+
 /**
  * \fn void AbstractColumn::plotDesignationAboutToChange(const AbstractColumn *source)
  * \brief Column plot designation will be changed
@@ -542,6 +618,20 @@ double AbstractColumn::maximum() const{
  * one handler for lots of columns.
  */
 
+/**
+ * \fn void AbstractColumn::rowsChanged(const AbstractColumn *source, int first, int last)
+ * \brief Data of the column has changed, coalesced
+ *
+ * Emitted once per event loop turn or at the end of a change batch with the merged range of all rows
+ * changed since the last emission, instead of once per change like dataChanged().
+ * Rows may have been inserted or removed in the meantime, \c last can be beyond the current row count.
+ * Use this for expensive updates like retransforming curves or repainting views.
+ *
+ *	\param source the column that emitted the signal
+ *	\param first the first changed row
+ *	\param last the last changed row
+ */
+
 /**
  * \fn void AbstractColumn::rowsAboutToBeInserted(const AbstractColumn *source, int before, int count)
  * \brief Rows will be inserted
@@ -100,8 +100,8 @@ class AbstractColumn : public AbstractAspect
 		virtual void setFormula(int row, QString formula);
 		virtual void clearFormulas();
 
-		double minimum() const;
-		double maximum() const;
+		virtual double minimum() const;
+		virtual double maximum() const;
 
 		virtual QString textAt(int row) const;
 		virtual void setTextAt(int row, const QString& new_value);
@@ -117,6 +117,9 @@ class AbstractColumn : public AbstractAspect
 		virtual void setValueAt(int row, double new_value);
 		virtual void replaceValues(int first, const QVector<double>& new_values);
 
+		static void beginChangeBatch();
+		static void endChangeBatch();
+
 	signals:
 		void plotDesignationAboutToChange(const AbstractColumn * source);
 		void plotDesignationChanged(const AbstractColumn * source);
@@ -124,6 +127,7 @@ class AbstractColumn : public AbstractAspect
 		void modeChanged(const AbstractColumn * source);
 		void dataAboutToChange(const AbstractColumn * source);
 		void dataChanged(const AbstractColumn * source);
+		void rowsChanged(const AbstractColumn * source, int first, int last);
 		void rowsAboutToBeInserted(const AbstractColumn * source, int before, int count);
 		void rowsInserted(const AbstractColumn * source, int before, int count);
 		void rowsAboutToBeRemoved(const AbstractColumn * source, int first, int count);
@@ -138,6 +142,7 @@ class AbstractColumn : public AbstractAspect
 
 		virtual void handleRowInsertion(int before, int count);
 		virtual void handleRowRemoval(int first, int count);
+		Q_INVOKABLE void markRowsChanged(int first, int last);
 
 	private:
 		AbstractColumnPrivate* m_abstract_column_private;
@@ -146,6 +151,9 @@ class AbstractColumn : public AbstractAspect
 		friend class AbstractColumnInsertRowsCmd;
 		friend class AbstractColumnClearMasksCmd;
 		friend class AbstractColumnSetMaskedCmd;
+
+	private slots:
+		void flushChangedRows();
 };
 
 #endif
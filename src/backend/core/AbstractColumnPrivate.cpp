@@ -37,7 +37,8 @@
 /**
  * \brief Ctor
  */
-AbstractColumnPrivate::AbstractColumnPrivate(AbstractColumn *owner) : m_owner(owner) {
+AbstractColumnPrivate::AbstractColumnPrivate(AbstractColumn *owner) : m_owner(owner),
+	m_changedFirst(-1), m_changedLast(-1) {
 	Q_CHECK_PTR(m_owner);
 }
 
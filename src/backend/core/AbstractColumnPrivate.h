@@ -43,6 +43,8 @@ class AbstractColumnPrivate {
 	public:
 		AbstractColumn *m_owner;
 		IntervalAttribute<bool> m_masking;
+		int m_changedFirst; //first changed row not announced by rowsChanged() yet, -1 if none
+		int m_changedLast;
 };
 
 #endif // ifndef ABSTRACT_COLUMN_PRIVATE_H
@@ -27,6 +27,7 @@
  *                                                                         *
  ***************************************************************************/
 #include "backend/core/Project.h"
+#include "backend/core/column/ColumnCache.h"
 #include "backend/lib/XmlStreamReader.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/worksheet/Worksheet.h"
@@ -85,7 +86,8 @@ class Project::Private {
 			author(QString(qgetenv("USER"))),
 			modificationTime(QDateTime::currentDateTime()),
 			changed(false),
-			loading(false)
+			loading(false),
+			columnMemoryBudget(0)
 			{}
 
 		QUndoStack undo_stack;
@@ -97,6 +99,8 @@ class Project::Private {
 		QDateTime modificationTime;
 		bool changed;
 		bool loading;
+		int columnMemoryBudget; //in MB, 0 for no limit
+		ColumnCache columnCache;
 };
 
 Project::Project() : Folder(i18n("Project")), d(new Private()) {
@@ -105,6 +109,7 @@ Project::Project() : Folder(i18n("Project")), d(new Private()) {
 	KConfigGroup group = config.group("Project");
 
 	d->author = group.readEntry("Author", QString());
+	setColumnMemoryBudget(group.readEntry("ColumnMemoryBudget", 0));
 
 	//we don't have direct access to the members name and comment
 	//->temporaly disable the undo stack and call the setters
@@ -170,6 +175,23 @@ BASIC_D_ACCESSOR_IMPL(Project, QString, version, Version, version)
 CLASS_D_ACCESSOR_IMPL(Project, QString, author, Author, author)
 CLASS_D_ACCESSOR_IMPL(Project, QDateTime, modificationTime, ModificationTime, modificationTime)
 
+/*!
+  sets the memory budget in MB for the values of the numeric columns of the project.
+  The least recently used columns beyond the budget are swapped out to scratch files, 0 means no limit.
+*/
+void Project::setColumnMemoryBudget(const int budget) {
+	d->columnMemoryBudget = qMax(budget, 0);
+	d->columnCache.setBudget((qint64)d->columnMemoryBudget*1024*1024);
+}
+
+int Project::columnMemoryBudget() const {
+	return d->columnMemoryBudget;
+}
+
+ColumnCache* Project::columnCache() const {
+	return &d->columnCache;
+}
+
 void Project::setChanged(const bool value) {
 	if (d->loading)
 		return;
@@ -223,6 +245,7 @@ void Project::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute("fileName", fileName());
 	writer->writeAttribute("modificationTime", modificationTime().toString("yyyy-dd-MM hh:mm:ss:zzz"));
 	writer->writeAttribute("author", author());
+	writer->writeAttribute("columnMemoryBudget", QString::number(columnMemoryBudget()));
 	writeBasicAttributes(writer);
 
 	writeCommentElement(writer);
@@ -410,5 +433,10 @@ bool Project::readProjectAttributes(XmlStreamReader* reader) {
 	str = attribs.value(reader->namespaceUri().toString(), "author").toString();
 	d->author = str;
 
+	//projects of older versions don't have a memory budget, keep the default in this case
+	str = attribs.value(reader->namespaceUri().toString(), "columnMemoryBudget").toString();
+	if (!str.isEmpty())
+		setColumnMemoryBudget(str.toInt());
+
 	return true;
 }
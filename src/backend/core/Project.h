@@ -35,6 +35,7 @@
 
 class QString;
 class AbstractScriptingEngine;
+class ColumnCache;
 
 class Project : public Folder {
 	Q_OBJECT
@@ -66,6 +67,8 @@ class Project : public Folder {
 		BASIC_D_ACCESSOR_DECL(QString, version, Version)
 		CLASS_D_ACCESSOR_DECL(QString, author, Author)
 		CLASS_D_ACCESSOR_DECL(QDateTime, modificationTime, ModificationTime)
+		BASIC_D_ACCESSOR_DECL(int, columnMemoryBudget, ColumnMemoryBudget)
+		ColumnCache* columnCache() const;
 
 		bool isLoading() const;
 		void setChanged(const bool value=true);
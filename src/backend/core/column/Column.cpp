@@ -33,6 +33,8 @@
 #include "backend/lib/XmlStreamReader.h"
 #include "backend/core/datatypes/String2DateTimeFilter.h"
 #include "backend/core/datatypes/DateTime2StringFilter.h"
+#include "backend/core/column/DateTimeData.h"
+#include "backend/core/column/TextData.h"
 
 #include <QThreadPool>
 #ifndef NDEBUG
@@ -91,7 +93,18 @@ Column::Column(const QString& name, QVector<double> data)
  * \param data initial data vector
  */
 Column::Column(const QString& name, QStringList data)
-	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Text, new QStringList(data))) {
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Text, new TextData(data))) {
+	init();
+}
+
+/**
+ * \brief Ctor
+ *
+ * \param name the column name (= aspect name)
+ * \param data initial texts
+ */
+Column::Column(const QString& name, const TextData& data)
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Text, new TextData(data))) {
 	init();
 }
 
@@ -102,7 +115,18 @@ Column::Column(const QString& name, QStringList data)
  * \param data initial data vector
  */
 Column::Column(const QString& name, QList<QDateTime> data)
-	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::DateTime, new QList<QDateTime>(data)) ) {
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::DateTime, new DateTimeData(data)) ) {
+	init();
+}
+
+/**
+ * \brief Ctor
+ *
+ * \param name the column name (= aspect name)
+ * \param data initial date-time values
+ */
+Column::Column(const QString& name, const DateTimeData& data)
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::DateTime, new DateTimeData(data)) ) {
 	init();
 }
 
@@ -197,8 +221,10 @@ bool Column::copy(const AbstractColumn * source, int source_start, int dest_star
 void Column::handleRowInsertion(int before, int count) {
 	AbstractColumn::handleRowInsertion(before, count);
 	exec(new ColumnInsertRowsCmd(m_column_private, before, count));
-	if (!m_suppressDataChangedSignal)
+	if (!m_suppressDataChangedSignal) {
 		emit dataChanged(this);
+		markRowsChanged(before, rowCount() - 1);
+	}
 
 	setStatisticsAvailable(false);
 }
@@ -209,8 +235,10 @@ void Column::handleRowInsertion(int before, int count) {
 void Column::handleRowRemoval(int first, int count) {
 	AbstractColumn::handleRowRemoval(first, count);
 	exec(new ColumnRemoveRowsCmd(m_column_private, first, count));
-	if (!m_suppressDataChangedSignal)
+	if (!m_suppressDataChangedSignal) {
 		emit dataChanged(this);
+		markRowsChanged(first, rowCount() - 1);
+	}
 
 	setStatisticsAvailable(false);
 }
@@ -390,6 +418,50 @@ void Column::replaceValues(int first, const QVector<double>& new_values) {
 	}
 }
 
+/**
+ * \brief Reorder the rows, row i receives the old row permutation[i]
+ *
+ * The masking of the rows is moved together with the values.
+ */
+void Column::permuteRows(const QVector<int>& permutation) {
+	if (permutation.isEmpty())
+		return;
+
+	//determine the new masked intervals
+	QList< Interval<int> > masked;
+	if (!maskedIntervals().isEmpty()) {
+		int start = -1;
+		for (int i = 0; i < permutation.size(); ++i) {
+			if (isMasked(permutation.at(i))) {
+				if (start == -1)
+					start = i;
+			} else if (start != -1) {
+				masked << Interval<int>(start, i - 1);
+				start = -1;
+			}
+		}
+		if (start != -1)
+			masked << Interval<int>(start, permutation.size() - 1);
+
+		//rows behind the permuted range keep their masking
+		foreach (const Interval<int>& interval, maskedIntervals()) {
+			if (interval.end() >= permutation.size())
+				masked << Interval<int>(qMax(interval.start(), permutation.size()), interval.end());
+		}
+	}
+
+	beginMacro(i18n("%1: reorder rows", name()));
+	if (!maskedIntervals().isEmpty()) {
+		clearMasks();
+		foreach (const Interval<int>& interval, masked)
+			setMasked(interval);
+	}
+
+	setStatisticsAvailable(false);
+	exec(new ColumnPermuteRowsCmd(m_column_private, permutation));
+	endMacro();
+}
+
 void Column::setStatisticsAvailable(bool available) {
 	m_column_private->statisticsAvailable = available;
 }
@@ -410,7 +482,7 @@ void Column::calculateStatistics() {
 	m_column_private->statistics = ColumnStatistics();
 	ColumnStatistics& statistics = m_column_private->statistics;
 
-	QVector<double>* rowValues = reinterpret_cast<QVector<double>*>(data());
+	const ColumnValues rowValues = values();
 
 	int notNanCount = 0;
 	double val;
@@ -422,26 +494,31 @@ void Column::calculateStatistics() {
 	statistics.maximum = -INFINITY;
 	QMap<double, int> frequencyOfValues;
 	QVector<double> rowData;
-	rowData.reserve(rowValues->size());
-	for (int row = 0; row < rowValues->size(); ++row) {
-		val = rowValues->value(row);
-		if (std::isnan(val) || isMasked(row))
-			continue;
-
-		if (val < statistics.minimum)
-			statistics.minimum = val;
-		if (val > statistics.maximum)
-			statistics.maximum = val;
-		columnSum+= val;
-		columnSumNeg += (1.0 / val);
-		columnSumSquare += pow(val, 2.0);
-		columnProduct *= val;
-		if (frequencyOfValues.contains(val))
-			frequencyOfValues.operator [](val)++;
-		else
-			frequencyOfValues.insert(val, 1);
-		++notNanCount;
-		rowData.push_back(val);
+	rowData.reserve(rowValues.size());
+	for (int c = 0; c < rowValues.chunkCount(); ++c) {
+		int count;
+		const double* chunk = rowValues.chunk(c, &count);
+		const int offset = c*ColumnValues::chunkSize;
+		for (int i = 0; i < count; ++i) {
+			val = chunk[i];
+			if (std::isnan(val) || isMasked(offset + i))
+				continue;
+
+			if (val < statistics.minimum)
+				statistics.minimum = val;
+			if (val > statistics.maximum)
+				statistics.maximum = val;
+			columnSum+= val;
+			columnSumNeg += (1.0 / val);
+			columnSumSquare += pow(val, 2.0);
+			columnProduct *= val;
+			if (frequencyOfValues.contains(val))
+				frequencyOfValues.operator [](val)++;
+			else
+				frequencyOfValues.insert(val, 1);
+			++notNanCount;
+			rowData.push_back(val);
+		}
 	}
 
 	if (notNanCount == 0) {
@@ -449,7 +526,7 @@ void Column::calculateStatistics() {
 		return;
 	}
 
-	if (rowData.size() < rowValues->size())
+	if (rowData.size() < rowValues.size())
 		rowData.squeeze();
 
 	statistics.arithmeticMean = columnSum / notNanCount;
@@ -471,19 +548,24 @@ void Column::calculateStatistics() {
 	absoluteMedianList.resize(notNanCount);
 
 	int idx = 0;
-	for(int row = 0; row < rowValues->size(); ++row) {
-		val = rowValues->value(row);
-		if ( std::isnan(val) || isMasked(row) )
-			continue;
-		columnSumVariance+= pow(val - statistics.arithmeticMean, 2.0);
-
-		sumForCentralMoment_r3 += pow(val - statistics.arithmeticMean, 3.0);
-		sumForCentralMoment_r4 += pow(val - statistics.arithmeticMean, 4.0);
-		columnSumMeanDeviation += fabs( val - statistics.arithmeticMean );
-
-		absoluteMedianList[idx] = fabs(val - statistics.median);
-		columnSumMedianDeviation += absoluteMedianList[idx];
-		idx++;
+	for (int c = 0; c < rowValues.chunkCount(); ++c) {
+		int count;
+		const double* chunk = rowValues.chunk(c, &count);
+		const int offset = c*ColumnValues::chunkSize;
+		for (int i = 0; i < count; ++i) {
+			val = chunk[i];
+			if ( std::isnan(val) || isMasked(offset + i) )
+				continue;
+			columnSumVariance+= pow(val - statistics.arithmeticMean, 2.0);
+
+			sumForCentralMoment_r3 += pow(val - statistics.arithmeticMean, 3.0);
+			sumForCentralMoment_r4 += pow(val - statistics.arithmeticMean, 4.0);
+			columnSumMeanDeviation += fabs( val - statistics.arithmeticMean );
+
+			absoluteMedianList[idx] = fabs(val - statistics.median);
+			columnSumMedianDeviation += absoluteMedianList[idx];
+			idx++;
+		}
 	}
 
 	statistics.meanDeviationAroundMedian = columnSumMedianDeviation / notNanCount;
@@ -513,6 +595,16 @@ void Column::calculateStatistics() {
 void* Column::data() const {
 	return m_column_private->dataPointer();
 }
+
+/**
+ * \brief Return a read-only snapshot of the values of a numeric column.
+ *
+ * Unlike data(), this doesn't page in the values of a swapped out column.
+ * Use this for reading large columns, preferably chunk by chunk.
+ */
+ColumnValues Column::values() const {
+	return m_column_private->values();
+}
 /**
  * \brief Return the content of row 'row'.
  *
@@ -549,6 +641,45 @@ QDateTime Column::dateTimeAt(int row) const {
 	return m_column_private->dateTimeAt(row);
 }
 
+/**
+ * \brief Return the date-time in row 'row' as milliseconds of its wall-clock time since 1970-01-01
+ *
+ * Use this only when columnMode() is DateTime, Month or Day.
+ * Returns DateTimeData::invalidMSecs for invalid date-times.
+ */
+qint64 Column::msecsAt(int row) const {
+	const DateTimeData* data = static_cast<const DateTimeData*>(m_column_private->dataPointer());
+	return (row >= 0 && row < data->size()) ? data->msecsAt(row) : DateTimeData::invalidMSecs;
+}
+
+/**
+ * \brief Return the smallest value, date-times are compared by their milliseconds since epoch
+ */
+double Column::minimum() const {
+	switch (columnMode()) {
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		return static_cast<const DateTimeData*>(m_column_private->dataPointer())->minimum();
+	default:
+		return AbstractColumn::minimum();
+	}
+}
+
+/**
+ * \brief Return the largest value, date-times are compared by their milliseconds since epoch
+ */
+double Column::maximum() const {
+	switch (columnMode()) {
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		return static_cast<const DateTimeData*>(m_column_private->dataPointer())->maximum();
+	default:
+		return AbstractColumn::maximum();
+	}
+}
+
 /**
  * \brief Return the double value in row 'row'
  */
@@ -562,8 +693,10 @@ double Column::valueAt(int row) const {
  * This is used e.g. in \c XYFitCurvePrivate::recalculate()
  */
 void Column::setChanged() {
-	if (!m_suppressDataChangedSignal)
+	if (!m_suppressDataChangedSignal) {
 		emit dataChanged(this);
+		markRowsChanged(0, rowCount() - 1);
+	}
 
 	setStatisticsAvailable(false);
 }
@@ -646,20 +779,40 @@ void Column::save(QXmlStreamWriter* writer) const {
 	int i;
 	switch(columnMode()) {
 	case AbstractColumn::Numeric: {
-			const char* data = reinterpret_cast<const char*>(
-			                       static_cast< QVector<double>* >(m_column_private->dataPointer())->constData());
-			int size = m_column_private->rowCount()*sizeof(double);
-			writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
+			//written in pieces of a multiple of three bytes to get the same base64 text as for the whole data,
+			//swapped out columns are read from their scratch files without paging them in
+			const ColumnValues values = m_column_private->values();
+			const int pieceSize = 3*ColumnValues::chunkSize;
+			for (int first = 0; first < values.size(); first += pieceSize) {
+				const char* data = reinterpret_cast<const char*>(values.constData() + first);
+				int size = qMin(pieceSize, values.size() - first)*sizeof(double);
+				writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
+			}
 			break;
 		}
-	case AbstractColumn::Text:
-		for(i=0; i<rowCount(); ++i) {
-			writer->writeStartElement("row");
-			writer->writeAttribute("index", QString::number(i));
-			writer->writeCharacters(textAt(i));
-			writer->writeEndElement();
+	case AbstractColumn::Text: {
+			//dictionary encoded columns are saved as the dictionary followed by the codes of the rows
+			const TextData* textData = static_cast< TextData* >(m_column_private->dataPointer());
+			if (textData->isEncoded()) {
+				writer->writeStartElement("dictionary");
+				foreach (const QString& text, textData->dictionary())
+					writer->writeTextElement("text", text);
+				writer->writeEndElement();
+
+				const char* data = reinterpret_cast<const char*>(textData->codes().constData());
+				int size = textData->size()*sizeof(quint32);
+				writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
+				break;
+			}
+
+			for(i=0; i<rowCount(); ++i) {
+				writer->writeStartElement("row");
+				writer->writeAttribute("index", QString::number(i));
+				writer->writeCharacters(textAt(i));
+				writer->writeEndElement();
+			}
+			break;
 		}
-		break;
 
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
@@ -718,6 +871,7 @@ bool Column::load(XmlStreamReader* reader) {
 			setWidth(str.toInt());
 
 		// read child elements
+		QStringList dictionary;
 		while (!reader->atEnd()) {
 			reader->readNext();
 
@@ -737,6 +891,8 @@ bool Column::load(XmlStreamReader* reader) {
 					ret_val = XmlReadFormula(reader);
 				else if(reader->name() == "row")
 					ret_val = XmlReadRow(reader);
+				else if(reader->name() == "dictionary")
+					ret_val = XmlReadDictionary(reader, dictionary);
 				else { // unknown element
 					reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
 					if (!reader->skipToEndElement()) return false;
@@ -748,6 +904,17 @@ bool Column::load(XmlStreamReader* reader) {
 			if (!content.isEmpty() && columnMode() == AbstractColumn::Numeric) {
 				DecodeColumnTask* task = new DecodeColumnTask(m_column_private, content);
 				QThreadPool::globalInstance()->start(task);
+			} else if (!content.isEmpty() && columnMode() == AbstractColumn::Text) {
+				QByteArray bytes = QByteArray::fromBase64(content.toAscii());
+				QVector<quint32> codes(bytes.size()/sizeof(quint32));
+				memcpy(codes.data(), bytes.data(), codes.size()*sizeof(quint32));
+				for (int i = 0; i < codes.size(); ++i) {
+					if (codes.at(i) >= (quint32)dictionary.size()) {
+						reader->raiseError(i18n("invalid row value"));
+						return false;
+					}
+				}
+				static_cast< TextData* >(m_column_private->dataPointer())->setEncoded(dictionary, codes);
 			}
 		}
 	} else // no column element
@@ -833,6 +1000,20 @@ bool Column::XmlReadFormula(XmlStreamReader* reader) {
 // }
 
 
+/**
+ * \brief Read XML dictionary element of a dictionary encoded text column
+ */
+bool Column::XmlReadDictionary(XmlStreamReader* reader, QStringList& dictionary) {
+	Q_ASSERT(reader->isStartElement() && reader->name() == "dictionary");
+	while (reader->readNext()) {
+		if (reader->name() == "dictionary" && reader->isEndElement()) break;
+
+		if (reader->isStartElement())
+			dictionary << reader->readElementText();
+	}
+	return true;
+}
+
 /**
  * \brief Read XML row element
  */
@@ -963,8 +1144,10 @@ void Column::handleFormatChange() {
 	}
 
 	emit aspectDescriptionChanged(this); // the icon for the type changed
-	if (!m_suppressDataChangedSignal)
+	if (!m_suppressDataChangedSignal) {
 		emit dataChanged(this); // all cells must be repainted
+		markRowsChanged(0, rowCount() - 1);
+	}
 
 	setStatisticsAvailable(false);
 }
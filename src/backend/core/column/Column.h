@@ -31,10 +31,13 @@
 #define COLUMN_H
 
 #include "backend/core/AbstractSimpleFilter.h"
+#include "backend/core/column/ColumnValues.h"
 #include "backend/lib/XmlStreamReader.h"
 
 class ColumnStringIO;
 class ColumnPrivate;
+class DateTimeData;
+class TextData;
 
 class Column : public AbstractColumn {
 	Q_OBJECT
@@ -80,7 +83,9 @@ class Column : public AbstractColumn {
 		explicit Column(const QString& name, AbstractColumn::ColumnMode mode = AbstractColumn::Numeric);
 		Column(const QString& name, QVector<double> data);
 		Column(const QString& name, QStringList data);
+		Column(const QString& name, const TextData& data);
 		Column(const QString& name, QList<QDateTime> data);
+		Column(const QString& name, const DateTimeData& data);
 		void init();
 		~Column();
 
@@ -113,6 +118,7 @@ class Column : public AbstractColumn {
 
 		const ColumnStatistics& statistics();
 		void* data() const;
+		ColumnValues values() const;
 		QString textAt(int row) const;
 		void setTextAt(int row, const QString& new_value);
 		void replaceTexts(int first, const QStringList& new_values);
@@ -126,6 +132,10 @@ class Column : public AbstractColumn {
 		double valueAt(int row) const;
 		void setValueAt(int row, double new_value);
 		virtual void replaceValues(int first, const QVector<double>& new_values);
+		qint64 msecsAt(int row) const;
+		virtual double minimum() const;
+		virtual double maximum() const;
+		void permuteRows(const QVector<int>& permutation);
 		void setChanged();
 		void setSuppressDataChangedSignal(bool);
 
@@ -137,6 +147,7 @@ class Column : public AbstractColumn {
 		bool XmlReadOutputFilter(XmlStreamReader * reader);
 		bool XmlReadFormula(XmlStreamReader * reader);
 		bool XmlReadRow(XmlStreamReader * reader);
+		bool XmlReadDictionary(XmlStreamReader* reader, QStringList& dictionary);
 
 		void handleRowInsertion(int before, int count);
 		void handleRowRemoval(int first, int count);
@@ -0,0 +1,109 @@
+/***************************************************************************
+    File                 : ColumnCache.cpp
+    Project              : LabPlot
+    Description          : Memory budget for the values of the columns of a project
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ColumnCache.h"
+#include "ColumnPrivate.h"
+
+#include <QMetaObject>
+#include <QMutexLocker>
+
+/*!
+  \class ColumnCache
+  \brief Keeps the resident values of the numeric columns of a project within a memory budget.
+
+  The columns register themselves on every access to their data pointer. When the resident values
+  exceed the budget, the least recently used columns are swapped out to memory-mapped scratch files.
+  The eviction is deferred to the event loop, so pointers obtained by data() stay valid
+  until control returns to it. A budget of 0 means no limit.
+
+  \ingroup backend
+*/
+
+ColumnCache::ColumnCache(QObject* parent) : QObject(parent), m_budget(0), m_evictionPending(false) {
+}
+
+void ColumnCache::setBudget(qint64 bytes) {
+	QMutexLocker locker(&m_mutex);
+	m_budget = bytes;
+	if (m_budget > 0 && !m_evictionPending) {
+		m_evictionPending = true;
+		QMetaObject::invokeMethod(this, "evict", Qt::QueuedConnection);
+	}
+}
+
+qint64 ColumnCache::budget() const {
+	QMutexLocker locker(&m_mutex);
+	return m_budget;
+}
+
+/*!
+  marks \c column as the most recently used column.
+*/
+void ColumnCache::touch(ColumnPrivate* column) {
+	QMutexLocker locker(&m_mutex);
+	if (!m_columns.isEmpty() && m_columns.last() == column)
+		return;
+
+	m_columns.removeOne(column);
+	m_columns.append(column);
+
+	if (m_budget > 0 && !m_evictionPending) {
+		m_evictionPending = true;
+		QMetaObject::invokeMethod(this, "evict", Qt::QueuedConnection);
+	}
+}
+
+/*!
+  removes \c column from the cache, called when the column is deleted.
+*/
+void ColumnCache::remove(ColumnPrivate* column) {
+	QMutexLocker locker(&m_mutex);
+	m_columns.removeOne(column);
+}
+
+/*!
+  swaps out the least recently used columns until the resident values fit into the budget.
+  The most recently used column is kept in memory even if it exceeds the budget on its own.
+*/
+void ColumnCache::evict() {
+	QMutexLocker locker(&m_mutex);
+	m_evictionPending = false;
+	if (m_budget <= 0)
+		return;
+
+	qint64 resident = 0;
+	foreach (const ColumnPrivate* column, m_columns)
+		resident += column->residentBytes();
+
+	for (int i = 0; i < m_columns.size() - 1 && resident > m_budget; ++i) {
+		ColumnPrivate* column = m_columns.at(i);
+		const qint64 bytes = column->residentBytes();
+		if (bytes > 0 && column->pageOut())
+			resident -= bytes;
+	}
+}
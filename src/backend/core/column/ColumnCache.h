@@ -0,0 +1,60 @@
+/***************************************************************************
+    File                 : ColumnCache.h
+    Project              : LabPlot
+    Description          : Memory budget for the values of the columns of a project
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef COLUMNCACHE_H
+#define COLUMNCACHE_H
+
+#include <QObject>
+#include <QList>
+#include <QMutex>
+
+class ColumnPrivate;
+
+class ColumnCache : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit ColumnCache(QObject* parent = 0);
+
+		void setBudget(qint64 bytes);
+		qint64 budget() const;
+
+		void touch(ColumnPrivate*);
+		void remove(ColumnPrivate*);
+
+	private:
+		mutable QMutex m_mutex;
+		QList<ColumnPrivate*> m_columns; //least recently used first
+		qint64 m_budget;
+		bool m_evictionPending;
+
+	private slots:
+		void evict();
+};
+
+#endif
@@ -0,0 +1,533 @@
+/***************************************************************************
+    File                 : ColumnConversion.cpp
+    Project              : LabPlot
+    Description          : Bulk conversion of column data between column modes
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ColumnConversion.h"
+#include "DateTimeData.h"
+#include "TextData.h"
+#include "backend/core/datatypes/String2DateTimeFilter.h"
+#include "backend/core/datatypes/String2MonthFilter.h"
+#include "backend/core/datatypes/String2DayOfWeekFilter.h"
+#include "backend/core/datatypes/Double2MonthFilter.h"
+#include "backend/core/datatypes/Double2DayOfWeekFilter.h"
+
+#include <QLocale>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <cmath>
+#include <limits>
+
+/*!
+  \class ColumnConversion
+  \brief Bulk conversion of the data of a column to another column mode.
+
+  Used by ColumnPrivate::setColumnMode(). The conversions have the same semantics as the conversion
+  filters (Double2StringFilter, String2DoubleFilter, String2DateTimeFilter, etc.) but work on the whole
+  data buffers instead of one virtual call per row. Large columns are converted in blocks of rows in parallel,
+  dictionary encoded texts are converted once per distinct string.
+
+  \ingroup backend
+*/
+
+//! runs the conversion kernel for the rows first to last
+template <class Kernel>
+class ConvertRowsTask : public QRunnable {
+public:
+	ConvertRowsTask(const Kernel& kernel, int first, int last) : m_kernel(kernel), m_first(first), m_last(last) {}
+
+	void run() {
+		m_kernel(m_first, m_last);
+	}
+
+private:
+	const Kernel& m_kernel;
+	const int m_first;
+	const int m_last;
+};
+
+//! converts every value of \c source with a copy of \c converter per block of rows
+template <class Source, class T, class Converter>
+class ConvertKernel {
+public:
+	ConvertKernel(const Source& source, T* target, const Converter& converter)
+		: m_source(source), m_target(target), m_converter(converter) {}
+
+	void operator()(int first, int last) const {
+		const Converter converter(m_converter);
+		for (int i = first; i <= last; ++i)
+			m_target[i] = converter(m_source.at(i));
+	}
+
+private:
+	const Source& m_source;
+	T* m_target;
+	const Converter& m_converter;
+};
+
+/*!
+  returns the converted values of \c source. The rows are split into blocks processed in parallel for large columns.
+*/
+template <class T, class Source, class Converter>
+static QVector<T> convert(const Source& source, const Converter& converter) {
+	const int count = source.size();
+	QVector<T> target(count);
+	const ConvertKernel<Source, T, Converter> kernel(source, target.data(), converter);
+
+	QThreadPool pool;
+	const int blocks = (count > 100000) ? pool.maxThreadCount() : 1;
+	if (blocks > 1) {
+		const int blockSize = count/blocks + 1;
+		for (int first = 0; first < count; first += blockSize)
+			pool.start(new ConvertRowsTask<ConvertKernel<Source, T, Converter> >(kernel, first, qMin(first + blockSize, count) - 1));
+		pool.waitForDone();
+	} else if (count > 0)
+		kernel(0, count - 1);
+
+	return target;
+}
+
+//! looks up the converted value of a dictionary code
+template <class T>
+class DictionaryLookup {
+public:
+	explicit DictionaryLookup(const QVector<T>& values) : m_values(values) {}
+	T operator()(quint32 code) const { return m_values.at(code); }
+
+private:
+	QVector<T> m_values;
+};
+
+/*!
+  converts the texts of \c texts, dictionary encoded texts only once per distinct string.
+*/
+template <class T, class Converter>
+static QVector<T> convertTexts(const TextData& texts, const Converter& converter) {
+	if (!texts.isEncoded())
+		return convert<T>(texts.strings(), converter);
+
+	const QVector<T> values = convert<T>(texts.dictionary(), converter);
+	return convert<T>(texts.codes(), DictionaryLookup<T>(values));
+}
+
+//##############################################################################
+//###############################  numbers  ####################################
+//##############################################################################
+static const double powersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static inline bool isDigit(QChar c) {
+	return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+/*!
+  parses plain decimal numbers like "-12.5e3" with at most 15 significant digits.
+  Mantissa and power of ten are exact doubles then and the result of the single multiplication
+  or division is correctly rounded. Returns \c false for everything else
+  (whitespace, group separators, more digits, etc.), these are parsed by QLocale.
+*/
+static bool parsePlainNumber(const QString& text, QChar decimalPoint, double& value) {
+	const QChar* c = text.constData();
+	const QChar* end = c + text.size();
+
+	bool negative = false;
+	if (c != end && (*c == '-' || *c == '+')) {
+		negative = (*c == '-');
+		++c;
+	}
+
+	quint64 mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool anyDigit = false;
+	for (; c != end && isDigit(*c); ++c) {
+		anyDigit = true;
+		if (mantissa == 0 && *c == '0')
+			continue;
+		if (++digits > 15)
+			return false;
+		mantissa = 10*mantissa + (c->unicode() - '0');
+	}
+
+	if (c != end && *c == decimalPoint) {
+		for (++c; c != end && isDigit(*c); ++c) {
+			anyDigit = true;
+			--exponent;
+			if (mantissa == 0 && *c == '0')
+				continue;
+			if (++digits > 15)
+				return false;
+			mantissa = 10*mantissa + (c->unicode() - '0');
+		}
+	}
+	if (!anyDigit)
+		return false;
+
+	if (c != end && (*c == 'e' || *c == 'E')) {
+		++c;
+		bool negativeExponent = false;
+		if (c != end && (*c == '-' || *c == '+')) {
+			negativeExponent = (*c == '-');
+			++c;
+		}
+		if (c == end)
+			return false;
+
+		int e = 0;
+		for (; c != end && isDigit(*c); ++c) {
+			e = 10*e + (c->unicode() - '0');
+			if (e > 1000)
+				return false;
+		}
+		exponent += negativeExponent ? -e : e;
+	}
+	if (c != end)
+		return false;
+
+	if (mantissa == 0) {
+		value = negative ? -0.0 : 0.0;
+		return true;
+	}
+	if (exponent < -22 || exponent > 22)
+		return false;
+
+	value = (exponent < 0) ? (double)mantissa/powersOf10[-exponent] : (double)mantissa*powersOf10[exponent];
+	if (negative)
+		value = -value;
+	return true;
+}
+
+//! Double2StringFilter
+class NumberToText {
+public:
+	NumberToText(char format, int digits) : m_format(format), m_digits(digits) {}
+
+	QString operator()(double value) const {
+		if (std::isnan(value))
+			return QString();
+		return m_locale.toString(value, m_format, m_digits);
+	}
+
+private:
+	QLocale m_locale;
+	char m_format;
+	int m_digits;
+};
+
+//! String2DoubleFilter, plain numbers are parsed without QLocale
+class TextToNumber {
+public:
+	TextToNumber() : m_decimalPoint(m_locale.decimalPoint()) {}
+
+	double operator()(const QString& text) const {
+		double value;
+		if (parsePlainNumber(text, m_decimalPoint, value))
+			return value;
+
+		bool valid;
+		value = m_locale.toDouble(text, &valid);
+		return valid ? value : NAN;
+	}
+
+private:
+	QLocale m_locale;
+	QChar m_decimalPoint;
+};
+
+//##############################################################################
+//##############################  date-times  ##################################
+//##############################################################################
+/*!
+  a date-time format consisting of numeric fields and literals only, compiled once for all rows.
+  Formats with names of months or days, AM/PM or quotes are not supported,
+  the strings are parsed with QDateTime::fromString() then.
+*/
+class CompiledDateTimeFormat {
+public:
+	explicit CompiledDateTimeFormat(const QString& format) : m_valid(true) {
+		int i = 0;
+		while (i < format.size()) {
+			const QChar c = format.at(i);
+			int n = 1;
+			while (i + n < format.size() && format.at(i + n) == c)
+				++n;
+
+			Token token;
+			token.field = Literal;
+			token.literal = c;
+			token.minDigits = token.maxDigits = 0;
+			switch (c.toLatin1()) {
+			case 'y':
+				token.field = (n == 2) ? Year2 : Year;
+				token.minDigits = token.maxDigits = n;
+				m_valid = m_valid && (n == 2 || n == 4);
+				break;
+			case 'M':
+				token.field = Month;
+				break;
+			case 'd':
+				token.field = Day;
+				break;
+			case 'h':
+			case 'H':
+				token.field = Hour;
+				break;
+			case 'm':
+				token.field = Minute;
+				break;
+			case 's':
+				token.field = Second;
+				break;
+			case 'z':
+				token.field = MSecond;
+				token.minDigits = (n == 3) ? 3 : 1;
+				token.maxDigits = 3;
+				m_valid = m_valid && (n == 1 || n == 3);
+				break;
+			default:
+				if (c.isLetter() || c == '\'')
+					m_valid = false;
+				n = 1;
+			}
+			if (token.field != Literal && token.field != Year && token.field != Year2 && token.field != MSecond) {
+				token.minDigits = (n == 2) ? 2 : 1;
+				token.maxDigits = 2;
+				m_valid = m_valid && (n <= 2);
+			}
+
+			//a field of variable width has to be followed by a literal
+			if (!m_tokens.isEmpty() && token.field != Literal) {
+				const Token& previous = m_tokens.last();
+				if (previous.field != Literal && previous.minDigits != previous.maxDigits)
+					m_valid = false;
+			}
+
+			m_tokens << token;
+			i += n;
+		}
+	}
+
+	bool isValid() const {
+		return m_valid;
+	}
+
+	/*!
+	  parses \c text, returns \c false if it doesn't match the format exactly.
+	  Fields missing in the format default to 1900-01-01 00:00 like in QDateTime::fromString().
+	*/
+	bool parse(const QString& text, qint64& msecs) const {
+		int fields[MSecond + 1] = {0, 1900, 0, 1, 1, 0, 0, 0, 0};
+		int pos = 0;
+		foreach (const Token& token, m_tokens) {
+			if (token.field == Literal) {
+				if (pos >= text.size() || text.at(pos) != token.literal)
+					return false;
+				++pos;
+				continue;
+			}
+
+			int value = 0;
+			int digits = 0;
+			while (digits < token.maxDigits && pos < text.size() && isDigit(text.at(pos))) {
+				value = 10*value + (text.at(pos).unicode() - '0');
+				++digits;
+				++pos;
+			}
+			if (digits < token.minDigits)
+				return false;
+			//two-digit years are in the 20th century like in QDate::fromString()
+			if (token.field == Year2)
+				fields[Year] = 1900 + value;
+			else
+				fields[token.field] = value;
+		}
+		if (pos != text.size())
+			return false;
+
+		const int year = fields[Year];
+		if (!QDate::isValid(year, fields[Month], fields[Day])
+			|| !QTime::isValid(fields[Hour], fields[Minute], fields[Second], fields[MSecond]))
+			return false;
+
+		msecs = (qint64)(QDate(year, fields[Month], fields[Day]).toJulianDay() - DateTimeData::epochJulianDay)*DateTimeData::msecsPerDay
+			+ ((fields[Hour]*60 + fields[Minute])*60 + fields[Second])*1000 + fields[MSecond];
+		return true;
+	}
+
+private:
+	enum Field {Literal, Year, Year2, Month, Day, Hour, Minute, Second, MSecond};
+	struct Token {
+		Field field;
+		int minDigits;
+		int maxDigits;
+		QChar literal;
+	};
+
+	QVector<Token> m_tokens;
+	bool m_valid;
+};
+
+//! String2DateTimeFilter, String2MonthFilter and String2DayOfWeekFilter
+class TextToDateTime {
+public:
+	TextToDateTime(AbstractColumn::ColumnMode mode, const QString& format) : m_mode(mode), m_format(format), m_compiledFormat(format) {}
+
+	qint64 operator()(const QString& text) const {
+		switch (m_mode) {
+		case AbstractColumn::Month:
+			return m_data.toMSecs(String2MonthFilter::dateTimeFromString(text));
+		case AbstractColumn::Day:
+			return m_data.toMSecs(String2DayOfWeekFilter::dateTimeFromString(text));
+		default:
+			break;
+		}
+
+		qint64 msecs;
+		if (m_compiledFormat.isValid() && m_compiledFormat.parse(text, msecs))
+			return msecs;
+		return m_data.toMSecs(String2DateTimeFilter::dateTimeFromString(text, m_format));
+	}
+
+private:
+	AbstractColumn::ColumnMode m_mode;
+	QString m_format;
+	CompiledDateTimeFormat m_compiledFormat;
+	DateTimeData m_data;
+};
+
+//! Double2DateTimeFilter, Double2MonthFilter and Double2DayOfWeekFilter
+class NumberToDateTime {
+public:
+	explicit NumberToDateTime(AbstractColumn::ColumnMode mode) : m_mode(mode) {}
+
+	qint64 operator()(double value) const {
+		switch (m_mode) {
+		case AbstractColumn::Month:
+			return m_data.toMSecs(Double2MonthFilter::dateTimeFromDouble(value));
+		case AbstractColumn::Day:
+			return m_data.toMSecs(QDateTime(Double2DayOfWeekFilter::dateFromDouble(value), QTime(0,0,0,0)));
+		default:
+			break;
+		}
+
+		//(fractional) Julian days, the fraction is counted from noon
+		if (std::isnan(value) || std::fabs(value) > std::numeric_limits<int>::max())
+			return DateTimeData::invalidMSecs;
+		const int julianDay = qRound(value);
+		if (julianDay == 0)
+			return DateTimeData::invalidMSecs;
+
+		const qint64 msecsOfDay = (DateTimeData::msecsPerDay/2 + int((value - int(value))*86400000.0)) % DateTimeData::msecsPerDay;
+		return (qint64)(julianDay - DateTimeData::epochJulianDay)*DateTimeData::msecsPerDay
+			+ (msecsOfDay < 0 ? msecsOfDay + DateTimeData::msecsPerDay : msecsOfDay);
+	}
+
+private:
+	AbstractColumn::ColumnMode m_mode;
+	DateTimeData m_data;
+};
+
+//! DateTime2StringFilter
+class DateTimeToText {
+public:
+	DateTimeToText(const DateTimeData& data, const QString& format) : m_data(data), m_format(format) {}
+
+	QString operator()(qint64 msecs) const {
+		if (msecs == DateTimeData::invalidMSecs)
+			return QString();
+		return m_data.fromMSecs(msecs).toString(m_format);
+	}
+
+private:
+	const DateTimeData& m_data;
+	QString m_format;
+};
+
+//! DateTime2DoubleFilter, Month2DoubleFilter and DayOfWeek2DoubleFilter
+class DateTimeToNumber {
+public:
+	explicit DateTimeToNumber(AbstractColumn::ColumnMode mode) : m_mode(mode) {}
+
+	double operator()(qint64 msecs) const {
+		if (msecs == DateTimeData::invalidMSecs)
+			return NAN;
+
+		qint64 days = msecs/DateTimeData::msecsPerDay;
+		qint64 rest = msecs%DateTimeData::msecsPerDay;
+		if (rest < 0) {
+			--days;
+			rest += DateTimeData::msecsPerDay;
+		}
+		const int julianDay = days + DateTimeData::epochJulianDay;
+
+		switch (m_mode) {
+		case AbstractColumn::Month:
+			return QDate::fromJulianDay(julianDay).month();
+		case AbstractColumn::Day:
+			return QDate::fromJulianDay(julianDay).dayOfWeek();
+		default:
+			return julianDay + double(rest - DateTimeData::msecsPerDay/2)/86400000.0;
+		}
+	}
+
+private:
+	AbstractColumn::ColumnMode m_mode;
+};
+
+//##############################################################################
+//##############################  conversions  #################################
+//##############################################################################
+QStringList ColumnConversion::numericToText(const QVector<double>& values, char format, int digits) {
+	return convert<QString>(values, NumberToText(format, digits)).toList();
+}
+
+/*!
+  converts \c values to the date-times of a column of the mode \c mode (DateTime, Month or Day) in \c data.
+*/
+void ColumnConversion::numericToDateTime(const QVector<double>& values, AbstractColumn::ColumnMode mode, DateTimeData& data) {
+	data.msecs() = convert<qint64>(values, NumberToDateTime(mode));
+}
+
+QVector<double> ColumnConversion::textToNumeric(const TextData& texts) {
+	return convertTexts<double>(texts, TextToNumber());
+}
+
+/*!
+  converts \c texts to the date-times of a column of the mode \c mode (DateTime, Month or Day) in \c data.
+  For DateTime, \c format is tried first like in String2DateTimeFilter.
+*/
+void ColumnConversion::textToDateTime(const TextData& texts, AbstractColumn::ColumnMode mode, const QString& format, DateTimeData& data) {
+	data.msecs() = convertTexts<qint64>(texts, TextToDateTime(mode, format));
+}
+
+QStringList ColumnConversion::dateTimeToText(const DateTimeData& data, const QString& format) {
+	return convert<QString>(data.msecs(), DateTimeToText(data, format)).toList();
+}
+
+QVector<double> ColumnConversion::dateTimeToNumeric(const DateTimeData& data, AbstractColumn::ColumnMode mode) {
+	return convert<double>(data.msecs(), DateTimeToNumber(mode));
+}
@@ -0,0 +1,50 @@
+/***************************************************************************
+    File                 : ColumnConversion.h
+    Project              : LabPlot
+    Description          : Bulk conversion of column data between column modes
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef COLUMNCONVERSION_H
+#define COLUMNCONVERSION_H
+
+#include "backend/core/AbstractColumn.h"
+
+#include <QStringList>
+#include <QVector>
+
+class DateTimeData;
+class TextData;
+
+class ColumnConversion {
+	public:
+		static QStringList numericToText(const QVector<double>&, char format, int digits);
+		static void numericToDateTime(const QVector<double>&, AbstractColumn::ColumnMode, DateTimeData&);
+		static QVector<double> textToNumeric(const TextData&);
+		static void textToDateTime(const TextData&, AbstractColumn::ColumnMode, const QString& format, DateTimeData&);
+		static QStringList dateTimeToText(const DateTimeData&, const QString& format);
+		static QVector<double> dateTimeToNumeric(const DateTimeData&, AbstractColumn::ColumnMode);
+};
+
+#endif
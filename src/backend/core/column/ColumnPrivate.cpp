@@ -27,20 +27,23 @@
  ***************************************************************************/
 
 #include "ColumnPrivate.h"
+#include "ColumnConversion.h"
+#include "DateTimeData.h"
+#include "TextData.h"
 #include "backend/core/AbstractSimpleFilter.h"
+#include "backend/core/Project.h"
 #include "backend/core/datatypes/SimpleCopyThroughFilter.h"
 #include "backend/core/datatypes/String2DoubleFilter.h"
 #include "backend/core/datatypes/Double2StringFilter.h"
-#include "backend/core/datatypes/Double2DateTimeFilter.h"
-#include "backend/core/datatypes/Double2MonthFilter.h"
-#include "backend/core/datatypes/Double2DayOfWeekFilter.h"
 #include "backend/core/datatypes/String2DateTimeFilter.h"
 #include "backend/core/datatypes/DateTime2StringFilter.h"
 #include "backend/core/datatypes/String2MonthFilter.h"
 #include "backend/core/datatypes/String2DayOfWeekFilter.h"
-#include "backend/core/datatypes/DateTime2DoubleFilter.h"
-#include "backend/core/datatypes/DayOfWeek2DoubleFilter.h"
-#include "backend/core/datatypes/Month2DoubleFilter.h"
+
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <cstring>
 
 
 /**
@@ -62,8 +65,8 @@
  * \var ColumnPrivate::m_data
  * \brief Pointer to the data vector
  *
- * This will point to a QVector<double>, QStringList or
- * QList<QDateTime> depending on the stored data type.
+ * This will point to a QVector<double>, TextData or
+ * DateTimeData depending on the stored data type.
  */
 
 /**
@@ -91,6 +94,14 @@
  * \brief The owner column
  */
 
+/**
+ * \var ColumnPrivate::m_scratch
+ * \brief Scratch file with the values of a swapped out numeric column
+ *
+ * The data vector is empty while the values are swapped out,
+ * valueAt() and rowCount() read the mapped file, all other accesses page the values back in.
+ */
+
 /**
  * \brief Ctor
  */
@@ -102,29 +113,31 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode)
 	case AbstractColumn::Numeric:
 		m_input_filter = new String2DoubleFilter();
 		m_output_filter = new Double2StringFilter();
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		        m_owner, SLOT(handleFormatChange()));
 		m_data = new QVector<double>();
 		break;
 	case AbstractColumn::Text:
 		m_input_filter = new SimpleCopyThroughFilter();
 		m_output_filter = new SimpleCopyThroughFilter();
-		m_data = new QStringList();
+		m_data = new TextData();
 		break;
 	case AbstractColumn::DateTime:
 		m_input_filter = new String2DateTimeFilter();
 		m_output_filter = new DateTime2StringFilter();
-		m_data = new QList<QDateTime>();
+		m_data = new DateTimeData();
 		break;
 	case AbstractColumn::Month:
 		m_input_filter = new String2MonthFilter();
 		m_output_filter = new DateTime2StringFilter();
 		static_cast<DateTime2StringFilter *>(m_output_filter)->setFormat("MMMM");
-		m_data = new QList<QDateTime>();
+		m_data = new DateTimeData();
 		break;
 	case AbstractColumn::Day:
 		m_input_filter = new String2DayOfWeekFilter();
 		m_output_filter = new DateTime2StringFilter();
 		static_cast<DateTime2StringFilter *>(m_output_filter)->setFormat("dddd");
-		m_data = new QList<QDateTime>();
+		m_data = new DateTimeData();
 		break;
 	}
 
@@ -146,6 +159,8 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, voi
 		m_output_filter = new Double2StringFilter();
 		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		        m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		m_input_filter = new SimpleCopyThroughFilter();
@@ -181,6 +196,9 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, voi
  * \brief Dtor
  */
 ColumnPrivate::~ColumnPrivate() {
+	if (m_cache)
+		m_cache->remove(this);
+
 	if (!m_data) return;
 
 	switch(m_column_mode) {
@@ -189,13 +207,13 @@ ColumnPrivate::~ColumnPrivate() {
 		break;
 
 	case AbstractColumn::Text:
-		delete static_cast< QStringList* >(m_data);
+		delete static_cast< TextData* >(m_data);
 		break;
 
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		delete static_cast< QList<QDateTime>* >(m_data);
+		delete static_cast< DateTimeData* >(m_data);
 		break;
 	} // switch(m_column_mode)
 }
@@ -222,114 +240,31 @@ AbstractColumn::ColumnMode ColumnPrivate::columnMode() const {
 void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 	if (mode == m_column_mode) return;
 
+	pageIn();
 	void * old_data = m_data;
 	// remark: the deletion of the old data will be done in the dtor of a command
 
-	AbstractSimpleFilter* filter = 0;
 	AbstractSimpleFilter* new_in_filter = 0;
 	AbstractSimpleFilter* new_out_filter = 0;
-	bool filter_is_temporary = false; // it can also become outputFilter(), which we may not delete here
-	Column* temp_col = 0;
 
 	emit m_owner->modeAboutToChange(m_owner);
 
-	// determine the conversion filter and allocate the new data vector
+	// disconnect formatChanged()
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
 		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
-		switch(mode) {
-		case AbstractColumn::Numeric:
-			break;
-		case AbstractColumn::Text:
-			filter = outputFilter();
-			filter_is_temporary = false;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QStringList();
-			break;
-		case AbstractColumn::DateTime:
-			filter = new Double2DateTimeFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
-			break;
-		case AbstractColumn::Month:
-			filter = new Double2MonthFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
-			break;
-		case AbstractColumn::Day:
-			filter = new Double2DayOfWeekFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
-			break;
-		} // switch(mode)
+		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		           m_owner, SLOT(handleFormatChange()));
 		break;
-
 	case AbstractColumn::Text:
-		switch(mode) {
-		case AbstractColumn::Text:
-			break;
-		case AbstractColumn::Numeric:
-			filter = new String2DoubleFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QVector<double>();
-			break;
-		case AbstractColumn::DateTime:
-			filter = new String2DateTimeFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
-			break;
-		case AbstractColumn::Month:
-			filter = new String2MonthFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
-			break;
-		case AbstractColumn::Day:
-			filter = new String2DayOfWeekFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
-			break;
-		} // switch(mode)
 		break;
-
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
 		disconnect(static_cast<DateTime2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
-		switch(mode) {
-		case AbstractColumn::DateTime:
-			break;
-		case AbstractColumn::Text:
-			filter = outputFilter();
-			filter_is_temporary = false;
-			temp_col = new Column("temp_col", *(static_cast< QList<QDateTime>* >(old_data)));
-			m_data = new QStringList();
-			break;
-		case AbstractColumn::Numeric:
-			if (m_column_mode == AbstractColumn::Month)
-				filter = new Month2DoubleFilter();
-			else if (m_column_mode == AbstractColumn::Day)
-				filter = new DayOfWeek2DoubleFilter();
-			else
-				filter = new DateTime2DoubleFilter();
-			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QList<QDateTime>* >(old_data)));
-			m_data = new QVector<double>();
-			break;
-		case AbstractColumn::Month:
-		case AbstractColumn::Day:
-			break;
-		} // switch(mode)
 		break;
-
 	}
 
 	// determine the new input and output filters
@@ -339,6 +274,8 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		new_out_filter = new Double2StringFilter();
 		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
+		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(digitsChanged()),
+		        m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		new_in_filter = new SimpleCopyThroughFilter();
@@ -366,6 +303,77 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		break;
 	} // switch(mode)
 
+	// convert the data in bulk with the semantics of the conversion filters.
+	// The converted data is created in place, the old data is taken over by the undo command.
+	const bool dateTimeModes = (m_column_mode != AbstractColumn::Numeric && m_column_mode != AbstractColumn::Text
+		&& mode != AbstractColumn::Numeric && mode != AbstractColumn::Text);
+	if (!dateTimeModes)
+		emit m_owner->dataAboutToChange(m_owner);
+
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric: {
+		const QVector<double>& values = *static_cast< QVector<double>* >(old_data);
+		switch(mode) {
+		case AbstractColumn::Numeric:
+			break;
+		case AbstractColumn::Text: {
+			const Double2StringFilter* filter = static_cast<Double2StringFilter *>(m_output_filter);
+			m_data = new TextData(ColumnConversion::numericToText(values, filter->numericFormat(), filter->numDigits()));
+			break;
+		}
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day: {
+			DateTimeData* data = new DateTimeData();
+			ColumnConversion::numericToDateTime(values, mode, *data);
+			m_data = data;
+			break;
+		}
+		} // switch(mode)
+		break;
+	}
+
+	case AbstractColumn::Text: {
+		const TextData& texts = *static_cast< TextData* >(old_data);
+		switch(mode) {
+		case AbstractColumn::Text:
+			break;
+		case AbstractColumn::Numeric:
+			m_data = new QVector<double>(ColumnConversion::textToNumeric(texts));
+			break;
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day: {
+			DateTimeData* data = new DateTimeData();
+			const QString format = (mode == AbstractColumn::DateTime) ? static_cast<String2DateTimeFilter *>(new_in_filter)->format() : QString();
+			ColumnConversion::textToDateTime(texts, mode, format, *data);
+			m_data = data;
+			break;
+		}
+		} // switch(mode)
+		break;
+	}
+
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day: {
+		const DateTimeData& dateTimes = *static_cast< DateTimeData* >(old_data);
+		switch(mode) {
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			break;
+		case AbstractColumn::Text:
+			m_data = new TextData(ColumnConversion::dateTimeToText(dateTimes, static_cast<DateTime2StringFilter *>(m_output_filter)->format()));
+			break;
+		case AbstractColumn::Numeric:
+			m_data = new QVector<double>(ColumnConversion::dateTimeToNumeric(dateTimes, m_column_mode));
+			break;
+		} // switch(mode)
+		break;
+	}
+	}
+
 	m_column_mode = mode;
 
 	new_in_filter->setName("InputFilter");
@@ -377,15 +385,11 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 	m_input_filter->setHidden(true);
 	m_output_filter->setHidden(true);
 
-	if (temp_col) { // if temp_col == 0, only the input/output filters need to be changed
-		// copy the filtered, i.e. converted, column
-		filter->input(0, temp_col);
-		copy(filter->output(0));
-		delete temp_col;
+	if (!dateTimeModes && !m_owner->m_suppressDataChangedSignal) {
+		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(0, rowCount() - 1);
 	}
 
-	if (filter_is_temporary) delete filter;
-
 	emit m_owner->modeChanged(m_owner);
 }
 
@@ -396,12 +400,15 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
  */
 void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data,
                                     AbstractSimpleFilter * in_filter, AbstractSimpleFilter * out_filter) {
+	pageIn();
 	emit m_owner->modeAboutToChange(m_owner);
 	// disconnect formatChanged()
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
 		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
+		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		           m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		break;
@@ -428,6 +435,8 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
 	case AbstractColumn::Numeric:
 		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		        m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		break;
@@ -446,10 +455,14 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
  * \brief Replace data pointer
  */
 void ColumnPrivate::replaceData(void * data) {
+	pageIn();
+	const int oldRowCount = rowCount();
 	emit m_owner->dataAboutToChange(m_owner);
 	m_data = data;
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(0, qMax(oldRowCount, rowCount()) - 1);
+	}
 }
 
 /**
@@ -463,6 +476,7 @@ bool ColumnPrivate::copy(const AbstractColumn * other) {
 	if (other->columnMode() != columnMode()) return false;
 	int num_rows = other->rowCount();
 
+	pageIn();
 	emit m_owner->dataAboutToChange(m_owner);
 	resizeTo(num_rows);
 
@@ -475,21 +489,25 @@ bool ColumnPrivate::copy(const AbstractColumn * other) {
 			break;
 		}
 	case AbstractColumn::Text: {
+			TextData* data = static_cast< TextData* >(m_data);
 			for(int i=0; i<num_rows; i++)
-				static_cast< QStringList* >(m_data)->replace(i, other->textAt(i));
+				data->replace(i, other->textAt(i));
+			data->optimize();
 			break;
 		}
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day: {
 			for(int i=0; i<num_rows; i++)
-				static_cast< QList<QDateTime>* >(m_data)->replace(i, other->dateTimeAt(i));
+				static_cast< DateTimeData* >(m_data)->replace(i, other->dateTimeAt(i));
 			break;
 		}
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(0, num_rows - 1);
+	}
 
 	return true;
 }
@@ -508,6 +526,7 @@ bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int de
 	if (source->columnMode() != m_column_mode) return false;
 	if (num_rows == 0) return true;
 
+	pageIn();
 	emit m_owner->dataAboutToChange(m_owner);
 	if (dest_start + num_rows > rowCount())
 		resizeTo(dest_start + num_rows);
@@ -520,20 +539,25 @@ bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int de
 				ptr[dest_start+i] = source->valueAt(source_start + i);
 			break;
 		}
-	case AbstractColumn::Text:
-		for(int i=0; i<num_rows; i++)
-			static_cast< QStringList* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
-		break;
+	case AbstractColumn::Text: {
+			TextData* data = static_cast< TextData* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				data->replace(dest_start+i, source->textAt(source_start + i));
+			data->optimize();
+			break;
+		}
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
 		for(int i=0; i<num_rows; i++)
-			static_cast< QList<QDateTime>* >(m_data)->replace(dest_start+i, source->dateTimeAt(source_start + i));
+			static_cast< DateTimeData* >(m_data)->replace(dest_start+i, source->dateTimeAt(source_start + i));
 		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(dest_start, dest_start + num_rows - 1);
+	}
 
 	return true;
 }
@@ -549,6 +573,7 @@ bool ColumnPrivate::copy(const ColumnPrivate * other) {
 	if (other->columnMode() != m_column_mode) return false;
 	int num_rows = other->rowCount();
 
+	pageIn();
 	emit m_owner->dataAboutToChange(m_owner);
 	resizeTo(num_rows);
 
@@ -561,21 +586,23 @@ bool ColumnPrivate::copy(const ColumnPrivate * other) {
 			break;
 		}
 	case AbstractColumn::Text: {
+			TextData* data = static_cast< TextData* >(m_data);
 			for(int i=0; i<num_rows; i++)
-				static_cast< QStringList* >(m_data)->replace(i, other->textAt(i));
+				data->replace(i, other->textAt(i));
+			data->optimize();
 			break;
 		}
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day: {
-			for(int i=0; i<num_rows; i++)
-				static_cast< QList<QDateTime>* >(m_data)->replace(i, other->dateTimeAt(i));
-			break;
-		}
+	case AbstractColumn::Day:
+		static_cast< DateTimeData* >(m_data)->copy(*static_cast< DateTimeData* >(other->m_data), 0, 0, num_rows);
+		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(0, num_rows - 1);
+	}
 
 	return true;
 }
@@ -594,6 +621,7 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 	if (source->columnMode() != m_column_mode) return false;
 	if (num_rows == 0) return true;
 
+	pageIn();
 	emit m_owner->dataAboutToChange(m_owner);
 	if (dest_start + num_rows > rowCount())
 		resizeTo(dest_start + num_rows);
@@ -606,20 +634,24 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 				ptr[dest_start+i] = source->valueAt(source_start + i);
 			break;
 		}
-	case AbstractColumn::Text:
-		for(int i=0; i<num_rows; i++)
-			static_cast< QStringList* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
-		break;
+	case AbstractColumn::Text: {
+			TextData* data = static_cast< TextData* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				data->replace(dest_start+i, source->textAt(source_start + i));
+			data->optimize();
+			break;
+		}
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		for(int i=0; i<num_rows; i++)
-			static_cast< QList<QDateTime>* >(m_data)->replace(dest_start+i, source->dateTimeAt(source_start + i));
+		static_cast< DateTimeData* >(m_data)->copy(*static_cast< DateTimeData* >(source->m_data), source_start, dest_start, num_rows);
 		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(dest_start, dest_start + num_rows - 1);
+	}
 
 	return true;
 }
@@ -634,13 +666,15 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 int ColumnPrivate::rowCount() const {
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
+		if (m_scratch)
+			return m_scratch->size();
 		return static_cast< QVector<double>* >(m_data)->size();
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		return static_cast< QList<QDateTime>* >(m_data)->size();
+		return static_cast< DateTimeData* >(m_data)->size();
 	case AbstractColumn::Text:
-		return static_cast< QStringList* >(m_data)->size();
+		return static_cast< TextData* >(m_data)->size();
 	}
 
 	return 0;
@@ -660,36 +694,24 @@ void ColumnPrivate::resizeTo(int new_size) {
 	int old_size = rowCount();
 	if (new_size == old_size) return;
 
+	pageIn();
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric: {
 			QVector<double> *numeric_data = static_cast< QVector<double>* >(m_data);
-			numeric_data->insert(numeric_data->end(), new_size-old_size, NAN);
+			if (new_size > old_size)
+				numeric_data->insert(numeric_data->end(), new_size-old_size, NAN);
+			else
+				numeric_data->resize(new_size);
 			break;
 		}
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day: {
-			int new_rows = new_size - old_size;
-			if (new_rows > 0) {
-				for(int i=0; i<new_rows; i++)
-					static_cast< QList<QDateTime>* >(m_data)->append(QDateTime());
-			} else {
-				for(int i=0; i<-new_rows; i++)
-					static_cast< QList<QDateTime>* >(m_data)->removeLast();
-			}
-			break;
-		}
-	case AbstractColumn::Text: {
-			int new_rows = new_size - old_size;
-			if (new_rows > 0) {
-				for(int i=0; i<new_rows; i++)
-					static_cast< QStringList* >(m_data)->append(QString());
-			} else {
-				for(int i=0; i<-new_rows; i++)
-					static_cast< QStringList* >(m_data)->removeLast();
-			}
-			break;
-		}
+	case AbstractColumn::Day:
+		static_cast< DateTimeData* >(m_data)->resize(new_size);
+		break;
+	case AbstractColumn::Text:
+		static_cast< TextData* >(m_data)->resize(new_size);
+		break;
 	}
 }
 
@@ -699,6 +721,7 @@ void ColumnPrivate::resizeTo(int new_size) {
 void ColumnPrivate::insertRows(int before, int count) {
 	if (count == 0) return;
 
+	pageIn();
 	m_formulas.insertRows(before, count);
 
 	if (before <= rowCount()) {
@@ -709,12 +732,10 @@ void ColumnPrivate::insertRows(int before, int count) {
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			for(int i=0; i<count; i++)
-				static_cast< QList<QDateTime>* >(m_data)->insert(before, QDateTime());
+			static_cast< DateTimeData* >(m_data)->insert(before, count);
 			break;
 		case AbstractColumn::Text:
-			for(int i=0; i<count; i++)
-				static_cast< QStringList* >(m_data)->insert(before, QString());
+			static_cast< TextData* >(m_data)->insert(before, count);
 			break;
 		}
 	}
@@ -726,6 +747,7 @@ void ColumnPrivate::insertRows(int before, int count) {
 void ColumnPrivate::removeRows(int first, int count) {
 	if (count == 0) return;
 
+	pageIn();
 	m_formulas.removeRows(first, count);
 
 	if (first < rowCount()) {
@@ -740,12 +762,10 @@ void ColumnPrivate::removeRows(int first, int count) {
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			for(int i=0; i<corrected_count; i++)
-				static_cast< QList<QDateTime>* >(m_data)->removeAt(first);
+			static_cast< DateTimeData* >(m_data)->remove(first, corrected_count);
 			break;
 		case AbstractColumn::Text:
-			for(int i=0; i<corrected_count; i++)
-				static_cast< QStringList* >(m_data)->removeAt(first);
+			static_cast< TextData* >(m_data)->remove(first, corrected_count);
 			break;
 		}
 	}
@@ -790,11 +810,98 @@ void ColumnPrivate::setWidth(int value) {
 
 /**
  * \brief Return the data pointer
+ *
+ * The values of a swapped out column are paged back in.
  */
 void *ColumnPrivate::dataPointer() const {
+	pageIn();
 	return m_data;
 }
 
+/**
+ * \brief Return a read-only snapshot of the values of a numeric column
+ *
+ * The values of a swapped out column are read from the mapped scratch file.
+ */
+ColumnValues ColumnPrivate::values() const {
+	ColumnValues values;
+	if (m_column_mode != AbstractColumn::Numeric)
+		return values;
+
+	if (m_scratch) {
+		values.m_scratch = m_scratch;
+		values.m_data = m_scratch->constData();
+		values.m_size = m_scratch->size();
+	} else {
+		values.m_vector = *static_cast< QVector<double>* >(m_data);
+		values.m_data = values.m_vector.constData();
+		values.m_size = values.m_vector.size();
+	}
+
+	return values;
+}
+
+/**
+ * \brief Return the size of the values that can be swapped out
+ */
+qint64 ColumnPrivate::residentBytes() const {
+	if (m_column_mode != AbstractColumn::Numeric || m_scratch)
+		return 0;
+
+	return (qint64)static_cast< QVector<double>* >(m_data)->size()*sizeof(double);
+}
+
+/**
+ * \brief Swap the values of a numeric column out to a memory-mapped scratch file
+ *
+ * Returns false if the column can't be swapped out.
+ */
+bool ColumnPrivate::pageOut() {
+	if (m_column_mode != AbstractColumn::Numeric || m_scratch)
+		return false;
+
+	QVector<double>* vector = static_cast< QVector<double>* >(m_data);
+	if (vector->isEmpty())
+		return false;
+
+	QSharedPointer<ColumnScratchFile> scratch(new ColumnScratchFile());
+	if (!scratch->write(vector->constData(), vector->size()))
+		return false;
+
+	m_scratch = scratch;
+	*vector = QVector<double>();
+	return true;
+}
+
+/**
+ * \brief Page the values of a swapped out column back in and mark the column as recently used
+ *
+ * Only the columns of data sources are registered in the column cache of the project,
+ * the result columns of the analysis curves keep their data pointers across updates.
+ */
+void ColumnPrivate::pageIn() const {
+	if (m_scratch) {
+		QVector<double>* vector = static_cast< QVector<double>* >(m_data);
+		vector->resize(m_scratch->size());
+		memcpy(vector->data(), m_scratch->constData(), m_scratch->size()*sizeof(double));
+		m_scratch.clear();
+	}
+
+	if (!m_cache) {
+		const AbstractAspect* parent = m_owner->parentAspect();
+		if (!parent || !parent->inherits("AbstractDataSource"))
+			return;
+
+		Project* project = m_owner->project();
+		if (!project)
+			return;
+
+		m_cache = project->columnCache();
+	}
+
+	m_cache->touch(const_cast<ColumnPrivate*>(this));
+}
+
 /**
  * \brief Return the input filter (for string -> data type conversion)
  */
@@ -898,7 +1005,7 @@ void ColumnPrivate::clearFormulas() {
  */
 QString ColumnPrivate::textAt(int row) const {
 	if (m_column_mode != AbstractColumn::Text) return QString();
-	return static_cast< QStringList* >(m_data)->value(row);
+	return static_cast< TextData* >(m_data)->value(row);
 }
 
 /**
@@ -929,7 +1036,7 @@ QDateTime ColumnPrivate::dateTimeAt(int row) const {
 	        m_column_mode != AbstractColumn::Month &&
 	        m_column_mode != AbstractColumn::Day)
 		return QDateTime();
-	return static_cast< QList<QDateTime>* >(m_data)->value(row);
+	return static_cast< DateTimeData* >(m_data)->value(row);
 }
 
 /**
@@ -937,6 +1044,8 @@ QDateTime ColumnPrivate::dateTimeAt(int row) const {
  */
 double ColumnPrivate::valueAt(int row) const {
 	if (m_column_mode != AbstractColumn::Numeric) return NAN;
+	if (m_scratch)
+		return (row >= 0 && row < m_scratch->size()) ? m_scratch->constData()[row] : NAN;
 	return static_cast< QVector<double>* >(m_data)->value(row, NAN);
 }
 
@@ -952,9 +1061,11 @@ void ColumnPrivate::setTextAt(int row, const QString& new_value) {
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QStringList* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
+	static_cast< TextData* >(m_data)->replace(row, new_value);
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(row, row);
+	}
 }
 
 /**
@@ -970,11 +1081,15 @@ void ColumnPrivate::replaceTexts(int first, const QStringList& new_values) {
 	if (first + num_rows > rowCount())
 		resizeTo(first + num_rows);
 
+	TextData* data = static_cast< TextData* >(m_data);
 	for(int i=0; i<num_rows; i++)
-		static_cast< QStringList* >(m_data)->replace(first+i, new_values.at(i));
+		data->replace(first+i, new_values.at(i));
+	data->optimize();
 
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(first, first + new_values.size() - 1);
+	}
 }
 
 /**
@@ -1020,9 +1135,11 @@ void ColumnPrivate::setDateTimeAt(int row, const QDateTime& new_value) {
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QList<QDateTime>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
+	static_cast< DateTimeData* >(m_data)->replace(row, new_value);
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(row, row);
+	}
 }
 
 /**
@@ -1042,10 +1159,12 @@ void ColumnPrivate::replaceDateTimes(int first, const QList<QDateTime>& new_valu
 		resizeTo(first + num_rows);
 
 	for(int i=0; i<num_rows; i++)
-		static_cast< QList<QDateTime>* >(m_data)->replace(first+i, new_values.at(i));
+		static_cast< DateTimeData* >(m_data)->replace(first+i, new_values.at(i));
 
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(first, first + new_values.size() - 1);
+	}
 }
 
 /**
@@ -1056,13 +1175,16 @@ void ColumnPrivate::replaceDateTimes(int first, const QList<QDateTime>& new_valu
 void ColumnPrivate::setValueAt(int row, double new_value) {
 	if (m_column_mode != AbstractColumn::Numeric) return;
 
+	pageIn();
 	emit m_owner->dataAboutToChange(m_owner);
 	if (row >= rowCount())
 		resizeTo(row+1);
 
 	static_cast< QVector<double>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(row, row);
+	}
 }
 
 /**
@@ -1073,6 +1195,7 @@ void ColumnPrivate::setValueAt(int row, double new_value) {
 void ColumnPrivate::replaceValues(int first, const QVector<double>& new_values) {
 	if (m_column_mode != AbstractColumn::Numeric) return;
 
+	pageIn();
 	emit m_owner->dataAboutToChange(m_owner);
 	int num_rows = new_values.size();
 	if (first + num_rows > rowCount())
@@ -1082,8 +1205,103 @@ void ColumnPrivate::replaceValues(int first, const QVector<double>& new_values)
 	for(int i=0; i<num_rows; i++)
 		ptr[first+i] = new_values.at(i);
 
-	if (!m_owner->m_suppressDataChangedSignal)
+	if (!m_owner->m_suppressDataChangedSignal) {
 		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(first, first + num_rows - 1);
+	}
+}
+
+/*!
+	gathers (or scatters for the inverse permutation) the rows first to last
+	from \c source into the already allocated and detached \c target.
+*/
+template <class T>
+class PermuteRowsTask : public QRunnable {
+public:
+	PermuteRowsTask(const T& source, T& target, const QVector<int>& permutation, int first, int last, bool inverse)
+		: m_source(source), m_target(target), m_permutation(permutation), m_first(first), m_last(last), m_inverse(inverse) {}
+
+	void run() {
+		const int* perm = m_permutation.constData();
+		if (m_inverse) {
+			for (int i = m_first; i <= m_last; ++i)
+				m_target[perm[i]] = m_source.at(i);
+		} else {
+			for (int i = m_first; i <= m_last; ++i)
+				m_target[i] = m_source.at(perm[i]);
+		}
+	}
+
+private:
+	const T& m_source;
+	T& m_target;
+	const QVector<int>& m_permutation;
+	const int m_first;
+	const int m_last;
+	const bool m_inverse;
+};
+
+template <class T>
+static void permuteContainer(T* data, const QVector<int>& permutation, bool inverse) {
+	const int count = permutation.size();
+	T target = *data;
+	target.detach();
+
+	//single gather per column, split into blocks of rows processed in parallel for large columns
+	QThreadPool pool;
+	const int blocks = (count > 100000) ? pool.maxThreadCount() : 1;
+	if (blocks > 1) {
+		const int blockSize = count/blocks + 1;
+		for (int first = 0; first < count; first += blockSize) {
+			const int last = qMin(first + blockSize, count) - 1;
+			pool.start(new PermuteRowsTask<T>(*data, target, permutation, first, last, inverse));
+		}
+		pool.waitForDone();
+	} else {
+		PermuteRowsTask<T> task(*data, target, permutation, 0, count - 1, inverse);
+		task.run();
+	}
+
+	data->swap(target);
+}
+
+/**
+ * \brief Reorder the rows of the column
+ *
+ * Row i receives the old row permutation[i], or for \c inverse == true,
+ * row permutation[i] receives the old row i.
+ * Only the first permutation.size() rows are reordered. Columns with less rows
+ * are padded with empty rows first, so the values stay together with their masking.
+ */
+void ColumnPrivate::permuteRows(const QVector<int>& permutation, bool inverse) {
+	pageIn();
+	emit m_owner->dataAboutToChange(m_owner);
+	if (permutation.size() > rowCount())
+		resizeTo(permutation.size());
+	switch (m_column_mode) {
+	case AbstractColumn::Numeric:
+		permuteContainer(static_cast<QVector<double>*>(m_data), permutation, inverse);
+		break;
+	case AbstractColumn::Text: {
+		//encoded columns only reorder the codes
+		TextData* data = static_cast<TextData*>(m_data);
+		if (data->isEncoded())
+			permuteContainer(&data->codes(), permutation, inverse);
+		else
+			permuteContainer(&data->strings(), permutation, inverse);
+		break;
+	}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		permuteContainer(&static_cast<DateTimeData*>(m_data)->msecs(), permutation, inverse);
+		break;
+	}
+
+	if (!m_owner->m_suppressDataChangedSignal) {
+		emit m_owner->dataChanged(m_owner);
+		m_owner->markRowsChanged(0, permutation.size() - 1);
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,6 +32,10 @@
 
 #include "backend/lib/IntervalAttribute.h"
 #include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnCache.h"
+#include "backend/core/column/ColumnValues.h"
+
+#include <QPointer>
 
 class AbstractSimpleFilter;
 
@@ -60,6 +64,9 @@ class ColumnPrivate: QObject {
 		int width() const;
 		void setWidth(int value);
 		void *dataPointer() const;
+		ColumnValues values() const;
+		qint64 residentBytes() const;
+		bool pageOut();
 		AbstractSimpleFilter* inputFilter() const;
 		AbstractSimpleFilter* outputFilter() const;
 		void replaceModeData(AbstractColumn::ColumnMode mode, void * data, AbstractSimpleFilter *in_filter,
@@ -92,6 +99,7 @@ class ColumnPrivate: QObject {
 		double valueAt(int row) const;
 		void setValueAt(int row, double new_value);
 		void replaceValues(int first, const QVector<double>& new_values);
+		void permuteRows(const QVector<int>& permutation, bool inverse);
 
 		Column::ColumnStatistics statistics;
 		bool statisticsAvailable;
@@ -108,6 +116,10 @@ class ColumnPrivate: QObject {
 		AbstractColumn::PlotDesignation m_plot_designation;
 		int m_width;
 		Column* m_owner;
+		mutable QSharedPointer<ColumnScratchFile> m_scratch;
+		mutable QPointer<ColumnCache> m_cache;
+
+		void pageIn() const;
 };
 
 #endif
@@ -0,0 +1,114 @@
+/***************************************************************************
+    File                 : ColumnValues.cpp
+    Project              : LabPlot
+    Description          : Read-only snapshot of the values of a numeric column
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ColumnValues.h"
+
+#include <QDir>
+
+#include <cmath>
+
+/*!
+  \class ColumnScratchFile
+  \brief Temporary file holding the values of a numeric column that was swapped out of memory.
+
+  The values are written once and mapped read-only afterwards, the operating system
+  pages them in on access and can drop them again under memory pressure.
+  The file is removed when the last ColumnPrivate or ColumnValues referencing it is gone.
+
+  \ingroup backend
+*/
+
+ColumnScratchFile::ColumnScratchFile() : m_file(QDir::tempPath() + QLatin1String("/labplot_column_XXXXXX")),
+	m_data(0), m_size(0) {
+}
+
+ColumnScratchFile::~ColumnScratchFile() {
+	if (m_data)
+		m_file.unmap(reinterpret_cast<uchar*>(const_cast<double*>(m_data)));
+}
+
+/*!
+  writes the \c count values starting at \c values to the file and maps it.
+  Returns \c false if the file couldn't be written or mapped.
+*/
+bool ColumnScratchFile::write(const double* values, int count) {
+	if (m_data || count <= 0 || !m_file.open())
+		return false;
+
+	const qint64 bytes = (qint64)count*sizeof(double);
+	if (m_file.write(reinterpret_cast<const char*>(values), bytes) != bytes || !m_file.flush())
+		return false;
+
+	uchar* mapped = m_file.map(0, bytes);
+	if (!mapped)
+		return false;
+
+	m_data = reinterpret_cast<const double*>(mapped);
+	m_size = count;
+	return true;
+}
+
+/*!
+  \class ColumnValues
+  \brief Read-only snapshot of the values of a numeric column.
+
+  The snapshot shares the values with the column, either the resident vector (implicitly shared)
+  or the mapped scratch file of a swapped out column. It stays valid when the column is modified
+  or swapped out afterwards and doesn't page the values of the column back into memory,
+  so it can be passed to worker threads. Large columns are best traversed chunk by chunk.
+
+  \ingroup backend
+*/
+
+const int ColumnValues::chunkSize = 65536;
+
+ColumnValues::ColumnValues() : m_data(0), m_size(0) {
+}
+
+/*!
+  returns the value in row \c row or NAN if \c row is out of range.
+*/
+double ColumnValues::value(int row) const {
+	if (row < 0 || row >= m_size)
+		return NAN;
+
+	return m_data[row];
+}
+
+int ColumnValues::chunkCount() const {
+	return (m_size + chunkSize - 1)/chunkSize;
+}
+
+/*!
+  returns the values of the chunk with the index \c index, the number of values is written to \c count.
+*/
+const double* ColumnValues::chunk(int index, int* count) const {
+	const int first = index*chunkSize;
+	*count = qMin(chunkSize, m_size - first);
+	return m_data + first;
+}
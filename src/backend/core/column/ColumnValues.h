@@ -0,0 +1,77 @@
+/***************************************************************************
+    File                 : ColumnValues.h
+    Project              : LabPlot
+    Description          : Read-only snapshot of the values of a numeric column
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef COLUMNVALUES_H
+#define COLUMNVALUES_H
+
+#include <QSharedPointer>
+#include <QTemporaryFile>
+#include <QVector>
+
+class ColumnScratchFile {
+	public:
+		ColumnScratchFile();
+		~ColumnScratchFile();
+
+		bool write(const double* values, int count);
+		int size() const { return m_size; }
+		const double* constData() const { return m_data; }
+
+	private:
+		Q_DISABLE_COPY(ColumnScratchFile)
+
+		QTemporaryFile m_file;
+		const double* m_data;
+		int m_size;
+};
+
+class ColumnValues {
+	public:
+		static const int chunkSize;
+
+		ColumnValues();
+
+		int size() const { return m_size; }
+		bool isEmpty() const { return m_size == 0; }
+		double at(int row) const { return m_data[row]; }
+		double value(int row) const;
+		const double* constData() const { return m_data; }
+
+		int chunkCount() const;
+		const double* chunk(int index, int* count) const;
+
+	private:
+		friend class ColumnPrivate;
+
+		QVector<double> m_vector;
+		QSharedPointer<ColumnScratchFile> m_scratch;
+		const double* m_data;
+		int m_size;
+};
+
+#endif
@@ -0,0 +1,215 @@
+/***************************************************************************
+    File                 : DateTimeData.cpp
+    Project              : LabPlot
+    Description          : Storage of the values of date-time columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "DateTimeData.h"
+
+#include <cmath>
+#include <limits>
+
+/*!
+  \class DateTimeData
+  \brief Storage of the values of DateTime, Month and Day columns.
+
+  The date-times are stored in a contiguous array as the milliseconds of their wall-clock time since
+  1970-01-01 00:00 in the time spec of the column, invalid date-times as \c invalidMSecs.
+  The time spec is taken from the first valid date-time written to the column,
+  later values with a different time spec are converted to it.
+  QDateTime objects are only created when a value is requested, sorting, minimum and maximum
+  and the plotting work on the integers directly.
+
+  \ingroup backend
+*/
+
+const qint64 DateTimeData::invalidMSecs = std::numeric_limits<qint64>::min();
+const qint64 DateTimeData::msecsPerDay = 86400000;
+const int DateTimeData::epochJulianDay = 2440588;	//1970-01-01
+
+DateTimeData::DateTimeData() : m_timeSpec(Qt::LocalTime), m_timeSpecAdopted(false) {
+}
+
+/*!
+  creates the storage for \c dateTimes. The time spec is taken from the first valid date-time.
+*/
+DateTimeData::DateTimeData(const QList<QDateTime>& dateTimes) : m_timeSpec(Qt::LocalTime), m_timeSpecAdopted(false) {
+	foreach (const QDateTime& dateTime, dateTimes) {
+		if (dateTime.isValid()) {
+			adoptTimeSpec(dateTime);
+			break;
+		}
+	}
+
+	m_msecs.resize(dateTimes.size());
+	for (int i = 0; i < dateTimes.size(); ++i)
+		m_msecs[i] = toMSecs(dateTimes.at(i));
+}
+
+/*!
+  returns the date-time in row \c row or an invalid date-time if \c row is out of range.
+*/
+QDateTime DateTimeData::value(int row) const {
+	if (row < 0 || row >= m_msecs.size())
+		return QDateTime();
+
+	return fromMSecs(m_msecs.at(row));
+}
+
+QList<QDateTime> DateTimeData::mid(int first, int count) const {
+	QList<QDateTime> dateTimes;
+	const int last = (count < 0) ? m_msecs.size() : qMin(first + count, m_msecs.size());
+	for (int i = first; i < last; ++i)
+		dateTimes << fromMSecs(m_msecs.at(i));
+
+	return dateTimes;
+}
+
+/*!
+  copies \c count values of \c source starting at \c sourceStart to the rows starting at \c destStart.
+  The integers are copied directly if both have the same time spec.
+*/
+void DateTimeData::copy(const DateTimeData& source, int sourceStart, int destStart, int count) {
+	if (!m_timeSpecAdopted && source.m_timeSpecAdopted) {
+		m_timeSpec = source.m_timeSpec;
+		m_timeSpecAdopted = true;
+	}
+
+	if (source.m_timeSpec == m_timeSpec) {
+		qCopy(source.m_msecs.constBegin() + sourceStart, source.m_msecs.constBegin() + sourceStart + count,
+			m_msecs.begin() + destStart);
+	} else {
+		for (int i = 0; i < count; ++i)
+			m_msecs[destStart + i] = toMSecs(source.at(sourceStart + i));
+	}
+}
+
+/*!
+  resizes the storage to \c size rows, new rows are invalid.
+*/
+void DateTimeData::resize(int size) {
+	const int oldSize = m_msecs.size();
+	m_msecs.resize(size);
+	for (int i = oldSize; i < size; ++i)
+		m_msecs[i] = invalidMSecs;
+	if (m_msecs.isEmpty())
+		m_timeSpecAdopted = false;
+}
+
+/*!
+  inserts \c count invalid rows before the row \c before.
+*/
+void DateTimeData::insert(int before, int count) {
+	m_msecs.insert(before, count, invalidMSecs);
+}
+
+void DateTimeData::remove(int first, int count) {
+	m_msecs.remove(first, count);
+	if (m_msecs.isEmpty())
+		m_timeSpecAdopted = false;
+}
+
+/*!
+  sets the time spec of the column. The stored values are converted to the new time spec.
+*/
+void DateTimeData::setTimeSpec(Qt::TimeSpec spec) {
+	m_timeSpecAdopted = true;
+	if (spec == m_timeSpec)
+		return;
+
+	const DateTimeData old = *this;
+	m_timeSpec = spec;
+	for (int i = 0; i < m_msecs.size(); ++i)
+		m_msecs[i] = toMSecs(old.at(i));
+}
+
+/*!
+  takes over the time spec of \c dateTime if it is the first valid date-time written to the column.
+  The column contains no valid values yet, so nothing has to be converted.
+*/
+void DateTimeData::adoptTimeSpec(const QDateTime& dateTime) {
+	if (m_timeSpecAdopted || !dateTime.isValid())
+		return;
+
+	m_timeSpec = dateTime.timeSpec();
+	m_timeSpecAdopted = true;
+}
+
+/*!
+  returns the smallest valid value in milliseconds or \c INFINITY if there is none.
+*/
+double DateTimeData::minimum() const {
+	qint64 min = std::numeric_limits<qint64>::max();
+	bool found = false;
+	const qint64* data = m_msecs.constData();
+	for (int i = 0; i < m_msecs.size(); ++i) {
+		if (data[i] != invalidMSecs && data[i] <= min) {
+			min = data[i];
+			found = true;
+		}
+	}
+
+	return found ? (double)min : INFINITY;
+}
+
+/*!
+  returns the largest valid value in milliseconds or \c -INFINITY if there is none.
+*/
+double DateTimeData::maximum() const {
+	qint64 max = invalidMSecs;
+	const qint64* data = m_msecs.constData();
+	for (int i = 0; i < m_msecs.size(); ++i) {
+		if (data[i] > max)
+			max = data[i];
+	}
+
+	return (max != invalidMSecs) ? (double)max : -INFINITY;
+}
+
+/*!
+  converts \c dateTime to the time spec of the column and returns the milliseconds of its wall-clock time since epoch.
+*/
+qint64 DateTimeData::toMSecs(const QDateTime& dateTime) const {
+	if (!dateTime.isValid())
+		return invalidMSecs;
+
+	const QDateTime converted = (dateTime.timeSpec() == m_timeSpec) ? dateTime : dateTime.toTimeSpec(m_timeSpec);
+	return (qint64)(converted.date().toJulianDay() - epochJulianDay)*msecsPerDay + QTime(0, 0).msecsTo(converted.time());
+}
+
+QDateTime DateTimeData::fromMSecs(qint64 msecs) const {
+	if (msecs == invalidMSecs)
+		return QDateTime();
+
+	//round towards negative infinity for dates before 1970
+	qint64 days = msecs/msecsPerDay;
+	qint64 rest = msecs%msecsPerDay;
+	if (rest < 0) {
+		--days;
+		rest += msecsPerDay;
+	}
+
+	return QDateTime(QDate::fromJulianDay(days + epochJulianDay), QTime(0, 0).addMSecs(rest), m_timeSpec);
+}
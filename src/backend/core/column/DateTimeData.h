@@ -0,0 +1,77 @@
+/***************************************************************************
+    File                 : DateTimeData.h
+    Project              : LabPlot
+    Description          : Storage of the values of date-time columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef DATETIMEDATA_H
+#define DATETIMEDATA_H
+
+#include <QDateTime>
+#include <QList>
+#include <QVector>
+
+class DateTimeData {
+	public:
+		static const qint64 invalidMSecs;
+		static const qint64 msecsPerDay;
+		static const int epochJulianDay;
+
+		DateTimeData();
+		explicit DateTimeData(const QList<QDateTime>&);
+
+		int size() const { return m_msecs.size(); }
+		QDateTime at(int row) const { return fromMSecs(m_msecs.at(row)); }
+		QDateTime value(int row) const;
+		QList<QDateTime> mid(int first, int count) const;
+		qint64 msecsAt(int row) const { return m_msecs.at(row); }
+		bool isValid(int row) const { return m_msecs.at(row) != invalidMSecs; }
+
+		void replace(int row, const QDateTime& dateTime) { adoptTimeSpec(dateTime); m_msecs[row] = toMSecs(dateTime); }
+		void append(const QDateTime& dateTime) { adoptTimeSpec(dateTime); m_msecs.append(toMSecs(dateTime)); }
+		void copy(const DateTimeData& source, int sourceStart, int destStart, int count);
+		void resize(int size);
+		void insert(int before, int count);
+		void remove(int first, int count);
+
+		QVector<qint64>& msecs() { return m_msecs; }
+		const QVector<qint64>& msecs() const { return m_msecs; }
+		Qt::TimeSpec timeSpec() const { return m_timeSpec; }
+		void setTimeSpec(Qt::TimeSpec);
+		double minimum() const;
+		double maximum() const;
+
+		qint64 toMSecs(const QDateTime&) const;
+		QDateTime fromMSecs(qint64) const;
+
+	private:
+		void adoptTimeSpec(const QDateTime&);
+
+		QVector<qint64> m_msecs;
+		Qt::TimeSpec m_timeSpec;
+		bool m_timeSpecAdopted;	//the time spec was taken from a value or set explicitly
+};
+
+#endif
@@ -0,0 +1,239 @@
+/***************************************************************************
+    File                 : TextData.cpp
+    Project              : LabPlot
+    Description          : Storage of the values of text columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "TextData.h"
+
+/*!
+  \class TextData
+  \brief Storage of the values of Text columns.
+
+  Columns with many rows but only a few distinct values (categories, labels, status codes, etc.)
+  are dictionary encoded: every distinct string is stored once in the dictionary and every row only
+  holds the 32-bit index of its string in the dictionary. All other columns are stored as a QStringList.
+
+  The storage switches between both representations automatically: the cardinality is checked
+  when the column grows beyond the next check size and in optimize(), which is called after
+  bulk changes. An encoded column falls back to the plain list when its dictionary grows too large.
+
+  \ingroup backend
+*/
+
+//! columns with less rows are never encoded
+static const int minEncodedRows = 1024;
+//! a column is encoded if at most every 8th row holds a new string
+static const int encodeRatio = 8;
+//! an encoded column is decoded again if more than every 4th row holds a new string
+static const int decodeRatio = 4;
+
+TextData::TextData() : m_encoded(false), m_nextCheck(minEncodedRows) {
+}
+
+TextData::TextData(const QStringList& strings) : m_encoded(false), m_nextCheck(minEncodedRows), m_strings(strings) {
+	optimize();
+}
+
+/*!
+  returns the string in row \c row or an empty string if \c row is out of range.
+*/
+QString TextData::value(int row) const {
+	if (row < 0 || row >= size())
+		return QString();
+
+	return at(row);
+}
+
+QStringList TextData::mid(int first, int count) const {
+	if (!m_encoded)
+		return m_strings.mid(first, count);
+
+	QStringList strings;
+	const int last = (count < 0) ? m_codes.size() : qMin(first + count, m_codes.size());
+	for (int i = first; i < last; ++i)
+		strings << m_dictionary.at(m_codes.at(i));
+
+	return strings;
+}
+
+QStringList TextData::toStringList() const {
+	return mid(0, -1);
+}
+
+void TextData::replace(int row, const QString& text) {
+	if (m_encoded) {
+		const int index = code(text);
+		if (index != -1) {
+			m_codes[row] = index;
+			return;
+		}
+		if (m_dictionary.size() < qMax(size()/decodeRatio, minEncodedRows/decodeRatio)) {
+			m_codes[row] = intern(text);
+			return;
+		}
+		decode();
+	}
+
+	m_strings[row] = text;
+}
+
+void TextData::append(const QString& text) {
+	if (m_encoded) {
+		m_codes.append(0);
+		replace(m_codes.size() - 1, text);
+		return;
+	}
+
+	m_strings.append(text);
+	if (m_strings.size() >= m_nextCheck)
+		optimize();
+}
+
+void TextData::clear() {
+	m_encoded = false;
+	m_nextCheck = minEncodedRows;
+	m_strings.clear();
+	m_dictionary.clear();
+	m_dictionaryIndex.clear();
+	m_codes.clear();
+}
+
+/*!
+  resizes the storage to \c size rows, new rows are empty.
+*/
+void TextData::resize(int size) {
+	const int oldSize = this->size();
+	if (size > oldSize) {
+		insert(oldSize, size - oldSize);
+		return;
+	}
+
+	remove(size, oldSize - size);
+}
+
+/*!
+  inserts \c count empty rows before the row \c before.
+*/
+void TextData::insert(int before, int count) {
+	if (m_encoded) {
+		m_codes.insert(before, count, intern(QString()));
+		return;
+	}
+
+	for (int i = 0; i < count; ++i)
+		m_strings.insert(before, QString());
+}
+
+void TextData::remove(int first, int count) {
+	if (m_encoded)
+		m_codes.remove(first, count);
+	else
+		m_strings.erase(m_strings.begin() + first, m_strings.begin() + first + count);
+}
+
+/*!
+  switches to the representation suited for the current content.
+  Called after bulk changes of the column.
+*/
+void TextData::optimize() {
+	if (m_encoded) {
+		if (m_dictionary.size() > qMax(size()/decodeRatio, minEncodedRows/decodeRatio))
+			decode();
+		return;
+	}
+
+	m_nextCheck = qMax(2*m_strings.size(), minEncodedRows);
+	if (m_strings.size() >= minEncodedRows)
+		encode();
+}
+
+/*!
+  returns the index of \c text in the dictionary or -1 if the dictionary doesn't contain it.
+*/
+int TextData::code(const QString& text) const {
+	QHash<QString, quint32>::const_iterator it = m_dictionaryIndex.constFind(text);
+	return (it != m_dictionaryIndex.constEnd()) ? (int)it.value() : -1;
+}
+
+/*!
+  sets the encoded content, used when loading a project. Every code has to be a valid index in \c dictionary.
+*/
+void TextData::setEncoded(const QStringList& dictionary, const QVector<quint32>& codes) {
+	clear();
+	m_encoded = true;
+	m_dictionary = dictionary;
+	m_codes = codes;
+	for (int i = 0; i < m_dictionary.size(); ++i)
+		m_dictionaryIndex.insert(m_dictionary.at(i), i);
+}
+
+quint32 TextData::intern(const QString& text) {
+	const int index = code(text);
+	if (index != -1)
+		return index;
+
+	m_dictionary << text;
+	m_dictionaryIndex.insert(text, m_dictionary.size() - 1);
+	return m_dictionary.size() - 1;
+}
+
+/*!
+  encodes the plain list if it has few distinct values, stops as soon as there are too many of them.
+*/
+void TextData::encode() {
+	const int maxDistinct = m_strings.size()/encodeRatio;
+	QStringList dictionary;
+	QHash<QString, quint32> dictionaryIndex;
+	QVector<quint32> codes(m_strings.size());
+	for (int i = 0; i < m_strings.size(); ++i) {
+		const QString& text = m_strings.at(i);
+		QHash<QString, quint32>::const_iterator it = dictionaryIndex.constFind(text);
+		if (it != dictionaryIndex.constEnd()) {
+			codes[i] = it.value();
+		} else {
+			if (dictionary.size() == maxDistinct)
+				return;
+			codes[i] = dictionary.size();
+			dictionaryIndex.insert(text, dictionary.size());
+			dictionary << text;
+		}
+	}
+
+	m_encoded = true;
+	m_strings.clear();
+	m_dictionary = dictionary;
+	m_dictionaryIndex = dictionaryIndex;
+	m_codes = codes;
+}
+
+void TextData::decode() {
+	m_strings = toStringList();
+	m_encoded = false;
+	m_dictionary.clear();
+	m_dictionaryIndex.clear();
+	m_codes.clear();
+	m_nextCheck = qMax(2*m_strings.size(), minEncodedRows);
+}
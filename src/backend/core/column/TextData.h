@@ -0,0 +1,77 @@
+/***************************************************************************
+    File                 : TextData.h
+    Project              : LabPlot
+    Description          : Storage of the values of text columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEXTDATA_H
+#define TEXTDATA_H
+
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+class TextData {
+	public:
+		TextData();
+		explicit TextData(const QStringList&);
+
+		int size() const { return m_encoded ? m_codes.size() : m_strings.size(); }
+		QString at(int row) const { return m_encoded ? m_dictionary.at(m_codes.at(row)) : m_strings.at(row); }
+		QString value(int row) const;
+		QStringList mid(int first, int count) const;
+		QStringList toStringList() const;
+
+		void replace(int row, const QString&);
+		void append(const QString&);
+		void clear();
+		void resize(int size);
+		void insert(int before, int count);
+		void remove(int first, int count);
+		void optimize();
+
+		bool isEncoded() const { return m_encoded; }
+		const QStringList& dictionary() const { return m_dictionary; }
+		int code(const QString&) const;
+		QVector<quint32>& codes() { return m_codes; }
+		const QVector<quint32>& codes() const { return m_codes; }
+		QStringList& strings() { return m_strings; }
+		const QStringList& strings() const { return m_strings; }
+		void setEncoded(const QStringList& dictionary, const QVector<quint32>& codes);
+
+	private:
+		quint32 intern(const QString&);
+		void encode();
+		void decode();
+
+		bool m_encoded;
+		int m_nextCheck;
+		QStringList m_strings;
+		QStringList m_dictionary;
+		QHash<QString, quint32> m_dictionaryIndex;
+		QVector<quint32> m_codes;
+};
+
+#endif
@@ -29,6 +29,8 @@
 
 #include "columncommands.h"
 #include "ColumnPrivate.h"
+#include "DateTimeData.h"
+#include "TextData.h"
 #include <KLocale>
 #include <cmath>
 
@@ -113,12 +115,12 @@ ColumnSetModeCmd::~ColumnSetModeCmd() {
 				delete static_cast< QVector<double>* >(m_new_data);
 				break;
 			case AbstractColumn::Text:
-				delete static_cast< QStringList* >(m_new_data);
+				delete static_cast< TextData* >(m_new_data);
 				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				delete static_cast< QList<QDateTime>* >(m_new_data);
+				delete static_cast< DateTimeData* >(m_new_data);
 				break;
 			}
 	} else {
@@ -128,12 +130,12 @@ ColumnSetModeCmd::~ColumnSetModeCmd() {
 				delete static_cast< QVector<double>* >(m_old_data);
 				break;
 			case AbstractColumn::Text:
-				delete static_cast< QStringList* >(m_old_data);
+				delete static_cast< TextData* >(m_old_data);
 				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				delete static_cast< QList<QDateTime>* >(m_old_data);
+				delete static_cast< DateTimeData* >(m_old_data);
 				break;
 			}
 	}
@@ -560,12 +562,12 @@ ColumnClearCmd::~ColumnClearCmd() {
 			delete static_cast< QVector<double>* >(m_empty_data);
 			break;
 		case AbstractColumn::Text:
-			delete static_cast< QStringList* >(m_empty_data);
+			delete static_cast< TextData* >(m_empty_data);
 			break;
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			delete static_cast< QList<QDateTime>* >(m_empty_data);
+			delete static_cast< DateTimeData* >(m_empty_data);
 			break;
 		}
 	} else {
@@ -575,12 +577,12 @@ ColumnClearCmd::~ColumnClearCmd() {
 			delete static_cast< QVector<double>* >(m_data);
 			break;
 		case AbstractColumn::Text:
-			delete static_cast< QStringList* >(m_data);
+			delete static_cast< TextData* >(m_data);
 			break;
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			delete static_cast< QList<QDateTime>* >(m_data);
+			delete static_cast< DateTimeData* >(m_data);
 			break;
 		}
 	}
@@ -602,15 +604,15 @@ void ColumnClearCmd::redo() {
 			}
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
-		case AbstractColumn::Day:
-			m_empty_data = new QList<QDateTime>();
-			for(int i=0; i<rowCount; i++)
-				static_cast< QList<QDateTime> *>(m_empty_data)->append(QDateTime());
-			break;
+		case AbstractColumn::Day: {
+				DateTimeData* data = new DateTimeData();
+				m_empty_data = data;
+				data->resize(rowCount);
+				break;
+			}
 		case AbstractColumn::Text:
-			m_empty_data = new QStringList();
-			for(int i=0; i<rowCount; i++)
-				static_cast< QStringList *>(m_empty_data)->append(QString());
+			m_empty_data = new TextData();
+			static_cast< TextData* >(m_empty_data)->resize(rowCount);
 			break;
 		}
 		m_data = m_col->dataPointer();
@@ -970,7 +972,7 @@ ColumnReplaceTextsCmd::ColumnReplaceTextsCmd(ColumnPrivate * col, int first, con
  */
 void ColumnReplaceTextsCmd::redo() {
 	if(!m_copied) {
-		m_old_values = static_cast< QStringList* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
+		m_old_values = static_cast< TextData* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
 		m_row_count = m_col->rowCount();
 		m_copied = true;
 	}
@@ -1100,7 +1102,7 @@ ColumnReplaceDateTimesCmd::ColumnReplaceDateTimesCmd(ColumnPrivate * col, int fi
  */
 void ColumnReplaceDateTimesCmd::redo() {
 	if(!m_copied) {
-		m_old_values = static_cast< QList<QDateTime>* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
+		m_old_values = static_cast< DateTimeData* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
 		m_row_count = m_col->rowCount();
 		m_copied = true;
 	}
@@ -1116,3 +1118,52 @@ void ColumnReplaceDateTimesCmd::undo() {
 	m_col->resizeTo(m_row_count);
 }
 
+/** ***************************************************************************
+ * \class ColumnPermuteRowsCmd
+ * \brief Reorder the rows of a column
+ *
+ * Only the permutation is stored, the old order is restored by applying its inverse.
+ ** ***************************************************************************/
+
+/**
+ * \var ColumnPermuteRowsCmd::m_col
+ * \brief The private column data to modify
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_permutation
+ * \brief The new order of the rows, row i receives the old row m_permutation[i]
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_row_count
+ * \brief The old number of rows
+ */
+
+/**
+ * \brief Ctor
+ */
+ColumnPermuteRowsCmd::ColumnPermuteRowsCmd(ColumnPrivate* col, const QVector<int>& permutation, QUndoCommand* parent)
+	: QUndoCommand(parent), m_col(col), m_permutation(permutation) {
+	setText(i18n("%1: reorder rows", col->name()));
+}
+
+/**
+ * \brief Execute the command
+ */
+void ColumnPermuteRowsCmd::redo() {
+	m_row_count = m_col->rowCount();
+	m_col->permuteRows(m_permutation, false);
+}
+
+/**
+ * \brief Undo the command
+ */
+void ColumnPermuteRowsCmd::undo() {
+	m_col->permuteRows(m_permutation, true);
+	//drop the rows that were appended to shorter columns, they end up at the bottom again
+	if (m_col->rowCount() != m_row_count) {
+		m_col->resizeTo(m_row_count);
+		m_col->replaceData(m_col->dataPointer());
+	}
+}
@@ -297,4 +297,17 @@ private:
 	int m_row_count;
 };
 
+class ColumnPermuteRowsCmd : public QUndoCommand {
+public:
+	explicit ColumnPermuteRowsCmd(ColumnPrivate* col, const QVector<int>& permutation, QUndoCommand* parent = 0);
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	ColumnPrivate* m_col;
+	QVector<int> m_permutation;
+	int m_row_count;
+};
+
 #endif
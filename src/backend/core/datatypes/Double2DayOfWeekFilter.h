@@ -41,7 +41,9 @@ class Double2DayOfWeekFilter : public AbstractSimpleFilter
 	public:
 		virtual QDate dateAt(int row) const {
 			if (!m_inputs.value(0)) return QDate();
-			double inputValue = m_inputs.value(0)->valueAt(row);
+			return dateFromDouble(m_inputs.value(0)->valueAt(row));
+		}
+		static QDate dateFromDouble(double inputValue) {
 			if (std::isnan(inputValue)) return QDate();
 			// Don't use Julian days here since support for years < 1 is bad
 			// Use 1900-01-01 instead (a Monday)
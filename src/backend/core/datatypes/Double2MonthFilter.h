@@ -47,7 +47,9 @@ class Double2MonthFilter : public AbstractSimpleFilter
 		}
 		virtual QDateTime dateTimeAt(int row) const {
 			if (!m_inputs.value(0)) return QDateTime();
-			double inputValue = m_inputs.value(0)->valueAt(row);
+			return dateTimeFromDouble(m_inputs.value(0)->valueAt(row));
+		}
+		static QDateTime dateTimeFromDouble(double inputValue) {
 			if (std::isnan(inputValue)) return QDateTime();
 			// Don't use Julian days here since support for years < 1 is bad
 			// Use 1900-01-01 instead
@@ -84,11 +84,21 @@ AbstractColumn::ColumnMode String2DateTimeFilter::columnMode() const {
 QDateTime String2DateTimeFilter::dateTimeAt(int row) const
 {
 	if (!m_inputs.value(0)) return QDateTime();
-	QString input_value = m_inputs.value(0)->textAt(row);
+	return dateTimeFromString(m_inputs.value(0)->textAt(row), m_format);
+}
+
+/**
+ * \brief Convert \c input_value to a date-time
+ *
+ * \c format is tried first, then the combinations of the
+ * date and time formats in date_formats and time_formats.
+ */
+QDateTime String2DateTimeFilter::dateTimeFromString(const QString& input_value, const QString& format)
+{
 	if (input_value.isEmpty()) return QDateTime();
 
-	// first try the selected format string m_format
-	QDateTime result = QDateTime::fromString(input_value, m_format);
+	// first try the selected format string
+	QDateTime result = QDateTime::fromString(input_value, format);
 	if(result.isValid())
 		return result;
 
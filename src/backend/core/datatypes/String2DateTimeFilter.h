@@ -78,6 +78,7 @@ class String2DateTimeFilter : public AbstractSimpleFilter
 
 	public:
 		virtual QDateTime dateTimeAt(int row) const;
+		static QDateTime dateTimeFromString(const QString& input, const QString& format);
 		virtual QDate dateAt(int row) const;
 		virtual QTime timeAt(int row) const;
 
@@ -53,8 +53,11 @@ class String2DayOfWeekFilter : public AbstractSimpleFilter
 		virtual QDateTime dateTimeAt(int row) const
 		{
 			if (!m_inputs.value(0)) return QDateTime();
+			return dateTimeFromString(m_inputs.value(0)->textAt(row));
+		}
 
-			QString input_value = m_inputs.value(0)->textAt(row);
+		static QDateTime dateTimeFromString(const QString& input_value)
+		{
 			if (input_value.isEmpty()) return QDateTime();
 			bool ok;
 			int day_value = input_value.toInt(&ok);
@@ -59,15 +59,17 @@
 DatapickerImage::DatapickerImage(AbstractScriptingEngine* engine, const QString& name, bool loading)
 	: AbstractPart(name), scripted(engine),
 	  isLoaded(false),
-	  foregroundBins( new int[ImageEditor::colorAttributeMax(Foreground) + 1]),
-	  hueBins( new int[ImageEditor::colorAttributeMax(Hue) + 1]),
-	  saturationBins( new int[ImageEditor::colorAttributeMax(Saturation) + 1]),
-	  valueBins( new int[ImageEditor::colorAttributeMax(Value) + 1]),
-	  intensityBins( new int[ImageEditor::colorAttributeMax(Intensity) + 1]),
+	  foregroundBins( new int[ImageEditor::colorAttributeMax(Foreground) + 1]()),
+	  hueBins( new int[ImageEditor::colorAttributeMax(Hue) + 1]()),
+	  saturationBins( new int[ImageEditor::colorAttributeMax(Saturation) + 1]()),
+	  valueBins( new int[ImageEditor::colorAttributeMax(Value) + 1]()),
+	  intensityBins( new int[ImageEditor::colorAttributeMax(Intensity) + 1]()),
 	  m_magnificationWindow(0),
 	  d(new DatapickerImagePrivate(this)),
 	  m_segments(new Segments(this)) {
 
+	connect(&d->histogramsFutureWatcher, SIGNAL(finished()), this, SLOT(updateHistograms()));
+
 	if (!loading)
 		init();
 }
@@ -375,6 +377,19 @@ void DatapickerImage::setPointSeparation(const int value) {
 	d->pointSeparation = value;
 }
 
+/*!
+	called when the calculation of the histograms started in DatapickerImagePrivate::uploadImage() is finished.
+*/
+void DatapickerImage::updateHistograms() {
+	const ImageEditor::Histograms histograms = d->histogramsFutureWatcher.result();
+	qCopy(histograms.intensity.constBegin(), histograms.intensity.constEnd(), intensityBins);
+	qCopy(histograms.foreground.constBegin(), histograms.foreground.constEnd(), foregroundBins);
+	qCopy(histograms.hue.constBegin(), histograms.hue.constEnd(), hueBins);
+	qCopy(histograms.saturation.constBegin(), histograms.saturation.constEnd(), saturationBins);
+	qCopy(histograms.value.constBegin(), histograms.value.constEnd(), valueBins);
+	emit histogramsChanged();
+}
+
 //##############################################################################
 //######################  Private implementation ###############################
 //##############################################################################
@@ -403,12 +418,8 @@ bool DatapickerImagePrivate::uploadImage(const QString& address) {
 
 		q->processedPlotImage = q->originalPlotImage;
 		q->background = ImageEditor::findBackgroundColor(&q->originalPlotImage);
-		//upload Histogram
-		ImageEditor::uploadHistogram(q->intensityBins, &q->originalPlotImage, q->background, DatapickerImage::Intensity);
-		ImageEditor::uploadHistogram(q->foregroundBins, &q->originalPlotImage, q->background, DatapickerImage::Foreground);
-		ImageEditor::uploadHistogram(q->hueBins, &q->originalPlotImage, q->background, DatapickerImage::Hue);
-		ImageEditor::uploadHistogram(q->saturationBins, &q->originalPlotImage, q->background, DatapickerImage::Saturation);
-		ImageEditor::uploadHistogram(q->valueBins, &q->originalPlotImage, q->background, DatapickerImage::Value);
+		//calculate the histograms in the background, the bins are updated in DatapickerImage::updateHistograms()
+		histogramsFutureWatcher.setFuture(ImageEditor::calculateHistograms(q->originalPlotImage, q->background));
 		discretize();
 
 		//resize the screen
@@ -138,10 +138,14 @@ private:
 	friend class DatapickerImagePrivate;
 	Segments* m_segments;
 
+private slots:
+	void updateHistograms();
+
 signals:
 	void requestProjectContextMenu(QMenu*);
 	void requestUpdate();
 	void requestUpdateActions();
+	void histogramsChanged();
 
 	void fileNameChanged(const QString&);
 	void rotationAngleChanged(float);
@@ -28,7 +28,9 @@
 #ifndef DATAPICKERIMAGEPRIVATE_H
 #define DATAPICKERIMAGEPRIVATE_H
 
+#include "backend/datapicker/ImageEditor.h"
 #include <QBrush>
+#include <QFutureWatcher>
 
 class QGraphicsScene;
 
@@ -58,6 +60,8 @@ public:
     qreal pointSize;
     bool pointVisibility;
 
+	QFutureWatcher<ImageEditor::Histograms> histogramsFutureWatcher;
+
 	QString name() const;
     void retransform();
 	void updateFileName();
@@ -28,7 +28,7 @@
 #include "ImageEditor.h"
 #include <QThreadPool>
 #include <QElapsedTimer>
-#include <QMutex>
+#include <QtConcurrentRun>
 #include <cmath>
 // #include <QDebug>
 
@@ -42,44 +42,125 @@ static const int maxHue = 360;
 static const int maxSaturation = 100;
 static const int maxValue = 100;
 
-QMutex mutex;
+//lookup tables shared by all threads, they are initialized once in the main thread by initLookupTables()
+static const int maxSquaredDistance = 3*255*255;
+static quint8 distanceBins[maxSquaredDistance + 1]; //!< bin of the intensity and of the foreground distance for the squared distance
+static quint8 saturationBins[256*256]; //!< saturation bin for max*256 + min of the RGB components
+static quint16 hueFractions[256*256]; //!< 6000*k/delta in 1/100 degree for delta*256 + k
+static bool lookupTablesInitialized = false;
+
+static void initLookupTables() {
+	if (lookupTablesInitialized)
+		return;
+
+	const double maxDistance = sqrt((double)maxSquaredDistance);
+	for (int i = 0; i <= maxSquaredDistance; ++i) {
+		const int value = (int)(sqrt((double)i) * maxIntensity / maxDistance + 0.5);
+		distanceBins[i] = qMin(value, maxIntensity);
+	}
+
+	//determine the saturation the same way as QColor does
+	for (int max = 0; max < 256; ++max) {
+		for (int min = 0; min <= max; ++min) {
+			const int value = QColor(max, min, min).saturation() * maxSaturation / 255;
+			saturationBins[max*256 + min] = qMin(value, maxSaturation);
+		}
+	}
+
+	for (int delta = 1; delta < 256; ++delta) {
+		for (int k = 0; k <= delta; ++k)
+			hueFractions[delta*256 + k] = qRound(6000.0*k/delta);
+	}
+
+	lookupTablesInitialized = true;
+}
+
+static inline int hueBin(int r, int g, int b, int max, int min) {
+	const int delta = max - min;
+	if (delta == 0) //gray, QColor::hue() returns -1
+		return 0;
+
+	//hue in 1/100 degree
+	const quint16* fractions = hueFractions + delta*256;
+	int h;
+	if (r == max)
+		h = (g >= b) ? fractions[g - b] : 36000 - fractions[b - g];
+	else if (g == max)
+		h = (b >= r) ? 12000 + fractions[b - r] : 12000 - fractions[r - b];
+	else
+		h = (r >= g) ? 24000 + fractions[r - g] : 24000 - fractions[g - r];
+
+	const int value = (h/100) * maxHue / 359;
+	return qMin(value, maxHue);
+}
+
+static inline int saturationBin(int max, int min) {
+	return saturationBins[max*256 + min];
+}
+
+static inline int valueBin(int max) {
+	return max * maxValue / 255;
+}
+
+static inline int intensityBin(int r, int g, int b) {
+	return distanceBins[r*r + g*g + b*b];
+}
+
+static inline int foregroundBin(int r, int g, int b, int rBg, int gBg, int bBg) {
+	return distanceBins[(r - rBg)*(r - rBg) + (g - gBg)*(g - gBg) + (b - bBg)*(b - bBg)];
+}
+
+static inline bool isOn(int value, int low, int high) {
+	if (low < high)
+		return ((low <= value) && (value <= high));
+	else
+		return ((low <= value) || (value <= high));
+}
+
+//returns the image in a 32-bit format that can be read scan line by scan line
+static QImage rgbImage(const QImage* image) {
+	if (image->format() == QImage::Format_RGB32 || image->format() == QImage::Format_ARGB32)
+		return *image;
+	return image->convertToFormat(QImage::Format_ARGB32);
+}
 
 class DiscretizeTask : public QRunnable {
 	public:
-		DiscretizeTask(int start, int end, QImage* plotImage, QImage* originalImage, DatapickerImage::EditorSettings settings, QColor background) {
-			m_start = start;
-			m_end = end;
-			m_plotImage = plotImage;
-			m_originalImage = originalImage;
-			m_settings = settings;
-			m_background = background;
+		DiscretizeTask(int start, int end, uchar* plotBits, int bytesPerLine, const QImage& originalImage,
+		               const DatapickerImage::EditorSettings& settings, QColor background) : m_start(start), m_end(end),
+			m_plotBits(plotBits), m_bytesPerLine(bytesPerLine), m_originalImage(originalImage), m_settings(settings),
+			m_background(background) {
 		};
 
 		void run() {
+			const int width = m_originalImage.width();
+			const int rBg = m_background.red();
+			const int gBg = m_background.green();
+			const int bBg = m_background.blue();
 			for (int y=m_start; y<m_end; ++y) {
-				mutex.lock();
-				QRgb* line = (QRgb*)m_plotImage->scanLine(y);
-				mutex.unlock();
-				int value;
-				for (int x=0; x<m_plotImage->width(); ++x) {
-					value = ImageEditor::discretizeHue(x, y, m_originalImage);
-					if (!ImageEditor::pixelIsOn(value, DatapickerImage::Hue, m_settings))
+				const QRgb* in = reinterpret_cast<const QRgb*>(m_originalImage.scanLine(y));
+				QRgb* line = reinterpret_cast<QRgb*>(m_plotBits + (size_t)y*m_bytesPerLine);
+				for (int x=0; x<width; ++x) {
+					const QRgb color = in[x];
+					const int r = qRed(color);
+					const int g = qGreen(color);
+					const int b = qBlue(color);
+					const int max = qMax(r, qMax(g, b));
+					const int min = qMin(r, qMin(g, b));
+
+					if (!isOn(hueBin(r, g, b, max, min), m_settings.hueThresholdLow, m_settings.hueThresholdHigh))
 						continue;
 
-					value = ImageEditor::discretizeSaturation(x, y, m_originalImage);
-					if (!ImageEditor::pixelIsOn(value, DatapickerImage::Saturation, m_settings))
+					if (!isOn(saturationBin(max, min), m_settings.saturationThresholdLow, m_settings.saturationThresholdHigh))
 						continue;
 
-					value = ImageEditor::discretizeValue(x, y, m_originalImage);
-					if (!ImageEditor::pixelIsOn(value, DatapickerImage::Value, m_settings))
+					if (!isOn(valueBin(max), m_settings.valueThresholdLow, m_settings.valueThresholdHigh))
 						continue;
 
-					value = ImageEditor::discretizeIntensity(x, y, m_originalImage);
-					if (!ImageEditor::pixelIsOn(value, DatapickerImage::Saturation, m_settings))
+					if (!isOn(intensityBin(r, g, b), m_settings.intensityThresholdLow, m_settings.intensityThresholdHigh))
 						continue;
 
-					value = ImageEditor::discretizeForeground(x, y, m_background, m_originalImage);
-					if (!ImageEditor::pixelIsOn(value, DatapickerImage::Foreground, m_settings))
+					if (!isOn(foregroundBin(r, g, b, rBg, gBg, bBg), m_settings.foregroundThresholdLow, m_settings.foregroundThresholdHigh))
 						continue;
 
 					line[x] = black;
@@ -90,8 +171,9 @@ class DiscretizeTask : public QRunnable {
 	private:
 		int m_start;
 		int m_end;
-		QImage* m_plotImage;
-		QImage* m_originalImage;
+		uchar* m_plotBits;
+		int m_bytesPerLine;
+		const QImage& m_originalImage;
 		DatapickerImage::EditorSettings m_settings;
 		QColor m_background;
 };
@@ -103,15 +185,18 @@ void ImageEditor::discretize(QImage* plotImage, QImage* originalImage,
                              DatapickerImage::EditorSettings settings, QColor background) {
 // 	QElapsedTimer timer;
 // 	timer.start();
+	initLookupTables();
+	const QImage image = rgbImage(originalImage);
 
 	plotImage->fill(white);
+	uchar* bits = plotImage->bits(); //detach here and not in the threads
 	QThreadPool* pool = QThreadPool::globalInstance();
 	int range = ceil(double(plotImage->height())/pool->maxThreadCount());
 	for (int i=0; i<pool->maxThreadCount(); ++i) {
 		const int start = i*range;
 		int end = (i+1)*range;
 		if (end>plotImage->height()) end = plotImage->height();
-		DiscretizeTask* task = new DiscretizeTask(start, end, plotImage, originalImage, settings, background);
+		DiscretizeTask* task = new DiscretizeTask(start, end, bits, plotImage->bytesPerLine(), image, settings, background);
 		pool->start(task);
 	}
 	pool->waitForDone();
@@ -123,11 +208,7 @@ bool ImageEditor::processedPixelIsOn(const QImage& plotImage, int x, int y) {
 	if ((x < 0) || (plotImage.width() <= x) || (y < 0) || (plotImage.height() <= y))
 		return false;
 
-	// pixel is on if it is closer to black than white in gray scale. this test must be performed
-	// on little endian and big endian systems, with or without alpha bits (which are typically high bits)
-	const int BLACK_WHITE_THRESHOLD = 255 / 2; // put threshold in middle of range
-	int gray = qGray(plotImage.pixel(x, y));
-	return (gray < BLACK_WHITE_THRESHOLD);
+	return processedPixelIsOn(plotImage.pixel(x, y));
 }
 
 //##############################################################################
@@ -167,22 +248,106 @@ QRgb ImageEditor::findBackgroundColor(const QImage* plotImage) {
 	return cMax.color.rgb();
 }
 
-void ImageEditor::uploadHistogram(int* bins, QImage* originalImage, QColor background, DatapickerImage::ColorAttributes type) {
-// 	QElapsedTimer timer;
-// 	timer.start();
-
-	//reset bin
-	for (int i = 0; i <= colorAttributeMax(type); i++)
-		bins [i] = 0;
+/*!
+	fills the histograms of all color attributes for the rows [start, end) of the image
+*/
+class HistogramTask : public QRunnable {
+	public:
+		HistogramTask(int start, int end, const QImage& image, QColor background, ImageEditor::Histograms& histograms) :
+			m_start(start), m_end(end), m_image(image), m_background(background), m_histograms(histograms) {
+		};
 
-	for (int x = 0; x < originalImage->width(); x++) {
-		for (int y = 0; y < originalImage->height(); y++) {
-			int value = discretizeValueForeground(x, y, type, background, originalImage);
-			bins[value] += 1;
+		void run() {
+			int* intensity = m_histograms.intensity.data();
+			int* foreground = m_histograms.foreground.data();
+			int* hue = m_histograms.hue.data();
+			int* saturation = m_histograms.saturation.data();
+			int* value = m_histograms.value.data();
+
+			const int width = m_image.width();
+			const int rBg = m_background.red();
+			const int gBg = m_background.green();
+			const int bBg = m_background.blue();
+			for (int y = m_start; y < m_end; ++y) {
+				const QRgb* line = reinterpret_cast<const QRgb*>(m_image.scanLine(y));
+				for (int x = 0; x < width; ++x) {
+					const int r = qRed(line[x]);
+					const int g = qGreen(line[x]);
+					const int b = qBlue(line[x]);
+					const int max = qMax(r, qMax(g, b));
+					const int min = qMin(r, qMin(g, b));
+
+					++intensity[intensityBin(r, g, b)];
+					++foreground[foregroundBin(r, g, b, rBg, gBg, bBg)];
+					++hue[hueBin(r, g, b, max, min)];
+					++saturation[saturationBin(max, min)];
+					++value[valueBin(max)];
+				}
+			}
 		}
+
+	private:
+		int m_start;
+		int m_end;
+		const QImage& m_image;
+		QColor m_background;
+		ImageEditor::Histograms& m_histograms;
+};
+
+static ImageEditor::Histograms emptyHistograms() {
+	ImageEditor::Histograms histograms;
+	histograms.intensity.fill(0, ImageEditor::colorAttributeMax(DatapickerImage::Intensity) + 1);
+	histograms.foreground.fill(0, ImageEditor::colorAttributeMax(DatapickerImage::Foreground) + 1);
+	histograms.hue.fill(0, ImageEditor::colorAttributeMax(DatapickerImage::Hue) + 1);
+	histograms.saturation.fill(0, ImageEditor::colorAttributeMax(DatapickerImage::Saturation) + 1);
+	histograms.value.fill(0, ImageEditor::colorAttributeMax(DatapickerImage::Value) + 1);
+	return histograms;
+}
+
+static void addBins(QVector<int>& bins, const QVector<int>& other) {
+	for (int i = 0; i < bins.size(); ++i)
+		bins[i] += other.at(i);
+}
+
+/*!
+	determines the histograms in one pass over the image. The rows are distributed over several threads,
+	every thread fills its own histograms, which are added at the end.
+	This function is running in a separate thread and uses its own thread pool.
+*/
+static ImageEditor::Histograms calculateHistogramsBlocking(const QImage& originalImage, QColor background) {
+	const QImage image = rgbImage(&originalImage);
+
+	QThreadPool pool;
+	const int threads = pool.maxThreadCount();
+	QVector<ImageEditor::Histograms> partialHistograms(threads, emptyHistograms());
+	const int range = ceil(double(image.height())/threads);
+	for (int i = 0; i < threads; ++i) {
+		const int start = i*range;
+		const int end = qMin((i+1)*range, image.height());
+		if (start >= end)
+			break;
+		pool.start(new HistogramTask(start, end, image, background, partialHistograms[i]));
 	}
+	pool.waitForDone();
+
+	ImageEditor::Histograms histograms = emptyHistograms();
+	foreach (const ImageEditor::Histograms& partial, partialHistograms) {
+		addBins(histograms.intensity, partial.intensity);
+		addBins(histograms.foreground, partial.foreground);
+		addBins(histograms.hue, partial.hue);
+		addBins(histograms.saturation, partial.saturation);
+		addBins(histograms.value, partial.value);
+	}
+
+	return histograms;
+}
 
-// 	qDebug() << "Histogram updated in " << timer.elapsed() << "ms";
+/*!
+	starts the calculation of the histograms of all color attributes of \c originalImage in the background.
+*/
+QFuture<ImageEditor::Histograms> ImageEditor::calculateHistograms(const QImage& originalImage, QColor background) {
+	initLookupTables();
+	return QtConcurrent::run(calculateHistogramsBlocking, originalImage, background);
 }
 
 int ImageEditor::colorAttributeMax(DatapickerImage::ColorAttributes type) {
@@ -210,138 +375,8 @@ bool ImageEditor::colorCompare(QRgb color1, QRgb color2) {
 	return (color1 & MASK) == (color2 & MASK);
 }
 
-int ImageEditor::discretizeHue(int x, int y, const QImage* originalImage) {
-	const QColor color(originalImage->pixel(x,y));
-	const int h = color.hue();
-	int value = h * maxHue / 359;
-
-	if (value<0) //QColor::hue() can return -1
-		value = 0;
-	if (maxHue < value)
-		value = maxHue;
-
-	return value;
-}
-
-int ImageEditor::discretizeSaturation(int x, int y, const QImage* originalImage) {
-	const QColor color(originalImage->pixel(x,y));
-	const int s = color.saturation();
-	int value = s * maxSaturation / 255;
-
-	if (maxSaturation < value)
-		value = maxSaturation;
-
-	return value;
-}
-
-int ImageEditor::discretizeValue(int x, int y, const QImage* originalImage) {
-	const QColor color(originalImage->pixel(x,y));
-	const int v = color.value();
-	int value = v * maxValue / 255;
-
-	if (maxValue < value)
-		value = maxValue;
-
-	return value;
-}
-
-int ImageEditor::discretizeIntensity(int x, int y, const QImage* originalImage) {
-	const QRgb color = originalImage->pixel(x,y);
-	const int r = qRed(color);
-	const int g = qGreen(color);
-	const int b = qBlue(color);
-
-	const double intensity = sqrt ((double) (r * r + g * g + b * b));
-	int value = (int) (intensity * maxIntensity / sqrt((double) (255 * 255 + 255 * 255 + 255 * 255)) + 0.5);
-
-	if (maxIntensity < value)
-		value = maxIntensity;
-
-	return value;
-}
-
-int ImageEditor::discretizeForeground(int x, int y, const QColor background, const QImage* originalImage) {
-	const QRgb color = originalImage->pixel(x,y);
-	const int r = qRed(color);
-	const int g = qGreen(color);
-	const int b = qBlue(color);
-	const int rBg = background.red();
-	const int gBg = background.green();
-	const int bBg = background.blue();
-	const double distance = sqrt ((double) ((r - rBg) * (r - rBg) + (g - gBg) * (g - gBg) + (b - bBg) * (b - bBg)));
-	int value = (int) (distance * maxForeground / sqrt((double) (255 * 255 + 255 * 255 + 255 * 255)) + 0.5);
-
-	if (maxForeground < value)
-		value = maxForeground;
-
-	return value;
-}
-
-int ImageEditor::discretizeValueForeground(int x, int y, DatapickerImage::ColorAttributes type,
-        const QColor background, const QImage* originalImage) {
-	const QColor color(originalImage->pixel(x,y));
-
-	// convert hue from 0 to 359, saturation from 0 to 255, value from 0 to 255
-	int value = 0;
-	switch (type) {
-	case DatapickerImage::None:
-		break;
-	case DatapickerImage::Intensity: {
-		const int r = color.red();
-		const int g = color.green();
-		const int b = color.blue();
-		const double intensity = sqrt ((double) (r * r + g * g + b * b));
-		value = (int) (intensity * maxIntensity / sqrt((double) (255 * 255 + 255 * 255 + 255 * 255)) + 0.5);
-		if (maxIntensity < value)
-			value = maxIntensity;
-		break;
-	}
-	case DatapickerImage::Foreground: {
-		const int r = color.red();
-		const int g = color.green();
-		const int b = color.blue();
-		const int rBg = background.red();
-		const int gBg = background.green();
-		const int bBg = background.blue();
-		const double distance = sqrt ((double) ((r - rBg) * (r - rBg) + (g - gBg) * (g - gBg) + (b - bBg) * (b - bBg)));
-		value = (int) (distance * maxForeground / sqrt((double) (255 * 255 + 255 * 255 + 255 * 255)) + 0.5);
-		if (maxForeground < value)
-			value = maxForeground;
-		break;
-	}
-	case DatapickerImage::Hue: {
-		const int h = color.hue();
-		value = h * maxHue / 359;
-		if (value<0)
-			value = 0;
-		if (maxHue < value)
-			value = maxHue;
-		break;
-	}
-	case DatapickerImage::Saturation: {
-		const int s = color.saturation();
-		value = s * maxSaturation / 255;
-		if (maxSaturation < value)
-			value = maxSaturation;
-		break;
-	}
-	case DatapickerImage::Value: {
-		const int v = color.value();
-		value = v * maxValue / 255;
-		if (maxValue < value)
-			value = maxValue;
-		break;
-	}
-	}
-
-	return value;
-}
-
 bool ImageEditor::pixelIsOn(int value, int low, int high) {
-	if (low < high)
-		return ((low <= value) && (value <= high));
-	else
-		return ((low <= value) || (value <= high));
+	return isOn(value, low, high);
 }
 
 bool ImageEditor::pixelIsOn( int value, DatapickerImage::ColorAttributes type,DatapickerImage::EditorSettings settings ) {
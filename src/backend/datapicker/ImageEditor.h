@@ -28,7 +28,9 @@
 #define IMAGEEDITOR_H
 
 #include <QColor>
+#include <QFuture>
 #include <QList>
+#include <QVector>
 
 #include <backend/datapicker/DatapickerImage.h>
 
@@ -36,17 +38,21 @@ class ImageEditor {
 public:
 	static void discretize(QImage*, QImage*, DatapickerImage::EditorSettings, QColor);
 	static bool processedPixelIsOn(const QImage&, int, int);
+	//! pixel is on if it is closer to black than white in gray scale (threshold in the middle of the range)
+	static bool processedPixelIsOn(QRgb pixel) { return qGray(pixel) < 255/2; }
 	static QRgb findBackgroundColor(const QImage*);
 	static int colorAttributeMax(DatapickerImage::ColorAttributes);
-	static void uploadHistogram(int*, QImage*, QColor, DatapickerImage::ColorAttributes);
-	static int discretizeValueForeground(int, int, DatapickerImage::ColorAttributes, const QColor, const QImage*);
-	static bool pixelIsOn(int, DatapickerImage::ColorAttributes, DatapickerImage::EditorSettings);
 
-	static int discretizeHue(int, int, const QImage*);
-	static int discretizeSaturation(int, int, const QImage*);
-	static int discretizeValue(int, int, const QImage*);
-	static int discretizeIntensity(int, int, const QImage*);
-	static int discretizeForeground(int, int, const QColor, const QImage*);
+	struct Histograms {
+		QVector<int> intensity;
+		QVector<int> foreground;
+		QVector<int> hue;
+		QVector<int> saturation;
+		QVector<int> value;
+	};
+	static QFuture<Histograms> calculateHistograms(const QImage&, QColor);
+
+	static bool pixelIsOn(int, DatapickerImage::ColorAttributes, DatapickerImage::EditorSettings);
 
 private:
 	static bool colorCompare(QRgb color1, QRgb color2);
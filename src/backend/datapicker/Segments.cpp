@@ -30,9 +30,11 @@
 
 #include <QGraphicsScene>
 #include <QImage>
+#include <QThreadPool>
 // #include <QElapsedTimer>
 // #include <QDebug>
 #include <QGraphicsItem>
+#include <cmath>
 
 /**
  * \class Segments
@@ -46,6 +48,132 @@
  * * \ingroup datapicker
  */
 
+//the processed image is kept as a bitplane with transposed scanlines: every column of the image
+//is stored in wordsPerColumn consecutive words, bit y%64 of the word y/64 is the pixel in the row y
+static const int bitsPerWord = 64;
+
+static inline int countTrailingZeros(quint64 word) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#else
+	int count = 0;
+	while (!(word & 1)) {
+		word >>= 1;
+		++count;
+	}
+	return count;
+#endif
+}
+
+/*!
+	returns the first row at or after \c from whose pixel in \c column is \c on, or \c height if there is none
+*/
+static int nextPixel(const quint64* column, int from, int height, bool on) {
+	if (from >= height)
+		return height;
+
+	const int words = (height + bitsPerWord - 1)/bitsPerWord;
+	int i = from/bitsPerWord;
+	quint64 word = (on ? column[i] : ~column[i]) & (~quint64(0) << (from%bitsPerWord));
+	while (!word) {
+		if (++i >= words)
+			return height;
+		word = on ? column[i] : ~column[i];
+	}
+
+	return qMin(i*bitsPerWord + countTrailingZeros(word), height);
+}
+
+/*!
+    return the number of runs adjacent to the pixels from yStart to yStop (inclusive)
+*/
+static int adjacentRuns(const quint64* column, int yStart, int yStop, int height) {
+	if (!column)
+		return 0;
+
+	const int end = qMin(yStop + 2, height);
+	int runs = 0;
+	int y = nextPixel(column, qMax(yStart - 1, 0), end, true);
+	while (y < end) {
+		++runs;
+		y = nextPixel(column, nextPixel(column, y, end, false), end, true);
+	}
+
+	return runs;
+}
+
+/*!
+	packs the rows [start, end) of the processed image into the bitplane.
+	\c start is a multiple of 64 so that different tasks never write to the same word.
+*/
+class BitplaneTask : public QRunnable {
+	public:
+		BitplaneTask(int start, int end, const QImage& image, quint64* bits, int wordsPerColumn) :
+			m_start(start), m_end(end), m_image(image), m_bits(bits), m_wordsPerColumn(wordsPerColumn) {
+		};
+
+		void run() {
+			const int width = m_image.width();
+			for (int y = m_start; y < m_end; ++y) {
+				const QRgb* line = reinterpret_cast<const QRgb*>(m_image.scanLine(y));
+				const quint64 mask = quint64(1) << (y%bitsPerWord);
+				quint64* word = m_bits + y/bitsPerWord;
+				for (int x = 0; x < width; ++x) {
+					if (ImageEditor::processedPixelIsOn(line[x]))
+						word[(size_t)x*m_wordsPerColumn] |= mask;
+				}
+			}
+		}
+
+	private:
+		int m_start;
+		int m_end;
+		const QImage& m_image;
+		quint64* m_bits;
+		int m_wordsPerColumn;
+};
+
+/*!
+	determines the runs in the columns [start, end) and whether they are at a branch point.
+	the columns next to the strip are read from the shared bitplane, so that the strips
+	can be processed independently and are stitched together by their column index.
+*/
+class RunsTask : public QRunnable {
+	public:
+		RunsTask(int start, int end, const quint64* bits, int wordsPerColumn, int width, int height, QVector<QVector<Segments::Run> >& runs) :
+			m_start(start), m_end(end), m_bits(bits), m_wordsPerColumn(wordsPerColumn), m_width(width), m_height(height), m_runs(runs) {
+		};
+
+		void run() {
+			for (int x = m_start; x < m_end; ++x) {
+				const quint64* curr = m_bits + (size_t)x*m_wordsPerColumn;
+				const quint64* last = (x > 0) ? curr - m_wordsPerColumn : 0;
+				const quint64* next = (x + 1 < m_width) ? curr + m_wordsPerColumn : 0;
+				QVector<Segments::Run>& columnRuns = m_runs[x];
+
+				int y = nextPixel(curr, 0, m_height, true);
+				while (y < m_height) {
+					Segments::Run run;
+					run.yStart = y;
+					run.yStop = nextPixel(curr, y, m_height, false) - 1;
+					run.branch = (adjacentRuns(last, run.yStart, run.yStop, m_height) > 1)
+						|| (adjacentRuns(next, run.yStart, run.yStop, m_height) > 1);
+					columnRuns.append(run);
+					y = nextPixel(curr, run.yStop + 1, m_height, true);
+				}
+			}
+		}
+
+	private:
+		int m_start;
+		int m_end;
+		const quint64* m_bits;
+		int m_wordsPerColumn;
+		int m_width;
+		int m_height;
+		QVector<QVector<Segments::Run> >& m_runs;
+};
+
 Segments::Segments(DatapickerImage* image): m_image(image) {
 }
 
@@ -60,6 +188,8 @@ void Segments::makeSegments(QImage &imageProcessed) {
 
 	const int width = imageProcessed.width();
 	const int height = imageProcessed.height();
+	if (width == 0 || height == 0)
+		return;
 
 	// for each new column of pixels, loop through the runs. a run is defined as
 	// one or more colored pixels that are all touching, with one uncolored pixel or the
@@ -74,114 +204,74 @@ void Segments::makeSegments(QImage &imageProcessed) {
 	//     else
 	//       "this run is appended to the segment on the left
 
-	bool* lastBool = new bool [height];
-	bool* currBool = new bool [height];
-	bool* nextBool = new bool [height];
-	Segment** lastSegment = new Segment* [height];
-	Segment** currSegment = new Segment* [height];
-	loadSegment(lastSegment, height);
-
-	//initialize one column of boolean flags using the pixels of the specified column
-	for (int y = 0; y < height; y++) {
-		lastBool[y] = false;
-		currBool[y] = ImageEditor::processedPixelIsOn(imageProcessed, 0, y);
-		nextBool[y] = ImageEditor::processedPixelIsOn(imageProcessed, 1, y);
-	}
-
+	QImage image = imageProcessed;
+	const QImage::Format format = image.format();
+	if (format != QImage::Format_RGB32 && format != QImage::Format_ARGB32 && format != QImage::Format_ARGB32_Premultiplied)
+		image = image.convertToFormat(QImage::Format_ARGB32);
+
+	//pack the image into the bitplane, the rows are distributed over the threads in multiples of 64
+	const int wordsPerColumn = (height + bitsPerWord - 1)/bitsPerWord;
+	QVector<quint64> bitplane(width*wordsPerColumn, 0);
+	quint64* bits = bitplane.data();
+	QThreadPool pool;
+	int range = ceil(double(wordsPerColumn)/pool.maxThreadCount())*bitsPerWord;
+	for (int start = 0; start < height; start += range)
+		pool.start(new BitplaneTask(start, qMin(start + range, height), image, bits, wordsPerColumn));
+	pool.waitForDone();
+
+	//find the runs in vertical strips of the image
+	QVector<QVector<Run> > runs(width);
+	range = ceil(double(width)/pool.maxThreadCount());
+	for (int start = 0; start < width; start += range)
+		pool.start(new RunsTask(start, qMin(start + range, width), bits, wordsPerColumn, width, height, runs));
+	pool.waitForDone();
+
+	//connect the runs to segments column by column
+	QVector<Segment*> segmentColumns(2*height, 0);
+	Segment** lastSegment = segmentColumns.data();
+	Segment** currSegment = lastSegment + height;
 	for (int x = 0; x < width; x++) {
-		matchRunsToSegments(x, height, lastBool, lastSegment, currBool, currSegment, nextBool);
-
-		// get ready for next column
-		for (int y = 0; y < height; y++) {
-			lastBool[y] = currBool[y];
-			currBool[y] = nextBool[y];
-		}
-
-		if (x + 1 < width) {
-			for (int y = 0; y < height; y++) {
-				nextBool[y] = ImageEditor::processedPixelIsOn(imageProcessed, x+1, y);
-			}
+		// the current column still holds the segment pointers of the column x-2
+		if (x >= 2) {
+			foreach (const Run& run, runs.at(x - 2))
+				qFill(currSegment + run.yStart, currSegment + run.yStop + 1, (Segment*)0);
 		}
-		scrollSegment(lastSegment, currSegment, height);
-	}
-
-	delete[] lastBool;
-	delete[] currBool;
-	delete[] nextBool;
-	delete[] lastSegment;
-	delete[] currSegment;
-// 	qDebug() << "Made segments in " << timer.elapsed() << "ms";
-}
 
-/*!
-    scroll the segment pointers of the right column into the left column
-*/
-void Segments::scrollSegment(Segment** left, Segment** right, int height) {
-	for (int y = 0; y < height; y++)
-		left [y] = right [y];
-}
-
-/*!
-    identify the runs in a column, and connect them to segments
-*/
-void Segments::matchRunsToSegments(int x, int height, bool* lastBool, Segment** lastSegment,
-                                   bool* currBool, Segment** currSegment, bool* nextBool) {
-	loadSegment(currSegment, height);
-
-	int yStart = 0;
-	bool inRun = false;
-	for (int y = 0; y < height; y++) {
-		if (!inRun && currBool [y]) {
-			inRun = true;
-			yStart = y;
+		foreach (const Run& run, runs.at(x)) {
+			if (!run.branch)
+				finishRun(lastSegment, currSegment, x, run.yStart, run.yStop, height);
 		}
 
-		if ((y + 1 >= height) || !currBool [y + 1]) {
-			if (inRun)
-				finishRun(lastBool, nextBool, lastSegment, currSegment, x, yStart, y, height);
+		if (x > 0)
+			removeUnneededLines(runs.at(x - 1), lastSegment, x);
 
-			inRun = false;
-		}
+		// get ready for next column
+		qSwap(lastSegment, currSegment);
 	}
 
-	removeUnneededLines(lastSegment, currSegment, height);
+	foreach (Segment* seg, segments)
+		seg->retransform();
+// 	qDebug() << "Made segments in " << timer.elapsed() << "ms";
 }
 
 /*!
     remove unneeded lines belonging to segments that just finished in the previous column.
 */
-void Segments::removeUnneededLines(Segment** lastSegment, Segment** currSegment, int height) {
-	Segment* segLast = 0;
-	for (int yLast = 0; yLast < height; yLast++) {
-		if (lastSegment [yLast] && (lastSegment [yLast] != segLast)) {
-			segLast = lastSegment [yLast];
-
-			bool found = false;
-			for (int yCur = 0; yCur < height; yCur++)
-				if (segLast == currSegment [yCur]) {
-					found = true;
-					break;
-				}
-
-			if (!found) {
-				if (segLast->length < m_image->minSegmentLength()) {
-					// remove whole segment since it is too short
-					m_image->scene()->removeItem(segLast->graphicsItem());
-					segments.removeOne(segLast);
-				}
-			}
+void Segments::removeUnneededLines(const QVector<Run>& lastRuns, Segment** lastSegment, int x) {
+	foreach (const Run& run, lastRuns) {
+		// a segment is continued if its last line ends in the current column
+		Segment* segLast = lastSegment[run.yStart];
+		if (!segLast || segLast->path.last()->x2() == x)
+			continue;
+
+		if (segLast->length < m_image->minSegmentLength()) {
+			// remove whole segment since it is too short
+			m_image->scene()->removeItem(segLast->graphicsItem());
+			segments.removeOne(segLast);
 		}
 	}
 }
 
-/*!
-    initialize one column of segment pointers
-*/
-void Segments::loadSegment(Segment** columnSegment, int height) {
-	for (int y = 0; y < height; y++)
-		columnSegment [y] = 0;
-}
-
 void Segments::clearSegments() {
 	foreach(Segment* seg, segments)
 		m_image->scene()->removeItem(seg->graphicsItem());
@@ -206,21 +296,11 @@ void Segments::setAcceptHoverEvents(bool on) {
 }
 
 /*!
-    process a run of pixels. if there are fewer than two adjacent pixel runs on
-    either side, this run will be added to an existing segment, or the start of
+    process a run of pixels that is not at a branch point (there are fewer than two adjacent
+    pixel runs on either side). this run will be added to an existing segment, or the start of
     a new segment
 */
-void Segments::finishRun(bool* lastBool, bool* nextBool, Segment** lastSegment, Segment** currSegment,
-                         int x, int yStart, int yStop, int height) {
-
-	// count runs that touch on the left
-	if (adjacentRuns(lastBool, yStart, yStop, height) > 1)
-		return;
-
-	// count runs that touch on the right
-	if (adjacentRuns(nextBool, yStart, yStop, height) > 1)
-		return;
-
+void Segments::finishRun(Segment** lastSegment, Segment** currSegment, int x, int yStart, int yStop, int height) {
 	Segment* seg;
 	int y = (int) ((yStart + yStop) / 2);
 	if (adjacentSegments(lastSegment, yStart, yStop, height) == 0) {
@@ -238,32 +318,10 @@ void Segments::finishRun(bool* lastBool, bool* nextBool, Segment** lastSegment,
 		seg->yLast = y;
 	}
 
-	seg->retransform();
-
 	for (int y = yStart; y <= yStop; y++)
 		currSegment [y] = seg;
 }
 
-/*!
-    return the number of runs adjacent to the pixels from yStart to yStop (inclusive)
-*/
-int Segments::adjacentRuns(bool* columnBool, int yStart, int yStop, int height) {
-	int runs = 0;
-	bool inRun = false;
-	for (int y = yStart - 1; y <= yStop + 1; y++) {
-		if ((0 <= y) && (y < height)) {
-			if (!inRun && columnBool [y]) {
-				inRun = true;
-				++runs;
-			} else if (inRun && !columnBool [y]) {
-				inRun = false;
-			}
-		}
-	}
-
-	return runs;
-}
-
 /*!
     find the single segment pointer among the adjacent pixels from yStart-1 to yStop+1
 */
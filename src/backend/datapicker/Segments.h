@@ -28,6 +28,7 @@
 #define SEGMENTS_H
 
 #include <QList>
+#include <QVector>
 
 class QImage;
 class DatapickerImage;
@@ -42,18 +43,21 @@ public:
 	void setSegmentsVisible(bool);
     void setAcceptHoverEvents(bool);
 
+	//! run of "on" pixels from yStart to yStop (inclusive) in one column of the processed image
+	struct Run {
+		int yStart;
+		int yStop;
+		bool branch; //!< true if the run touches more than one run in the left or in the right column
+	};
+
 private:
 	DatapickerImage* m_image;
 	QList<Segment*> segments;
 
 	void clearSegments();
-	void loadSegment(Segment**, int);
-	int adjacentRuns(bool*, int, int, int);
 	Segment* adjacentSegment(Segment**, int, int, int);
 	int adjacentSegments(Segment**, int, int, int);
-	void matchRunsToSegments(int, int, bool*, Segment**, bool*, Segment**, bool*);
-	void finishRun(bool*, bool*, Segment**, Segment**, int, int, int, int);
-	void scrollSegment(Segment**, Segment**, int);
-	void removeUnneededLines(Segment**, Segment**, int);
+	void finishRun(Segment**, Segment**, int, int, int, int);
+	void removeUnneededLines(const QVector<Run>&, Segment**, int);
 };
 #endif
@@ -29,6 +29,7 @@ Copyright            : (C) 2016 by Fabian Kristof (fkristofszabolcs@gmail.com)
 #include "FITSFilterPrivate.h"
 #include "backend/datasources/FileDataSource.h"
 #include "backend/core/column/Column.h"
+#include "backend/core/column/TextData.h"
 #include "backend/core/datatypes/Double2StringFilter.h"
 #include "commonfrontend/matrix/MatrixView.h"
 #include "backend/matrix/MatrixModel.h"
@@ -460,7 +461,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 
 		if (endRow != -1)
 			lines = endRow;
-		QVector<QStringList*> stringDataPointers;
+		QVector<TextData*> stringDataPointers;
 		QVector<QVector<double>*> numericDataPointers;
 		QList<bool> columnNumericTypes;
 
@@ -545,7 +546,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 							datap->clear();
 					} else {
 						spreadsheet->column(columnOffset+ n)->setColumnMode(AbstractColumn::Text);
-						QStringList* list = static_cast<QStringList* >(spreadsheet->column(columnOffset+n)->data());
+						TextData* list = static_cast<TextData* >(spreadsheet->column(columnOffset+n)->data());
 						stringDataPointers.push_back(list);
 						if (importMode == AbstractFileFilter::Replace)
 							list->clear();
@@ -606,7 +607,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 							numericDataPointers[numericixd++]->push_back(str.toDouble());
 						else {
 							if (!stringDataPointers.isEmpty())
-								stringDataPointers[stringidx++]->operator <<( str.simplified());
+								stringDataPointers[stringidx++]->append(str.simplified());
 						}
 					}
 				} else {
@@ -702,11 +703,12 @@ void FITSFilterPrivate::writeCHDU(const QString &fileName, AbstractDataSource *d
 			}
 			const long nelem = naxes[0] * naxes[1];
 			double* array = new double[nelem];
-			const QVector<QVector<double> >& data = matrix->data();
-
-			for (int row = 0; row < naxes[1]; ++row) {
-				for (int col = 0; col < naxes[0]; ++col)
-					array[row * naxes[0] + col] = data.at(col).at(row);
+			const MatrixStorage& storage = matrix->storage();
+			QVector<double> column(naxes[1]);
+			for (int col = 0; col < naxes[0]; ++col) {
+				storage.readColumn(col, 0, naxes[1], column.data());
+				for (int row = 0; row < naxes[1]; ++row)
+					array[row * naxes[0] + col] = column.at(row);
 			}
 
 			if (fits_write_img(fitsFile, TDOUBLE, 1, nelem, array, &status )) {
@@ -723,12 +725,10 @@ void FITSFilterPrivate::writeCHDU(const QString &fileName, AbstractDataSource *d
 			char* columnNames[tfields];
 			char* tform[tfields];
 			char* tunit[tfields];
-			const QVector<QVector<double> >& matrixData = matrix->data();
-			QVector<double> column;
+			const MatrixStorage& storage = matrix->storage();
 			const MatrixModel* matrixModel = static_cast<MatrixView*>(matrix->view())->model();
 			const int precision = matrix->precision();
 			for (int i = 0; i < tfields; ++i) {
-				column = matrixData.at(i);
 				const QString& columnName = matrixModel->headerData(i, Qt::Horizontal).toString();
 				columnNames[i] = new char[columnName.size()];
 				strcpy(columnNames[i], columnName.toLatin1().data());
@@ -778,9 +778,7 @@ void FITSFilterPrivate::writeCHDU(const QString &fileName, AbstractDataSource *d
 
 			double* columnNumeric = new double[nrows];
 			for (int col = 1; col <= tfields; ++col) {
-				column = matrixData.at(col-1);
-				for (int r = 0; r < column.size(); ++r)
-					columnNumeric[r] = column.at(r);
+				storage.readColumn(col-1, 0, nrows, columnNumeric);
 
 				fits_write_col(fitsFile, TDOUBLE, col, 1, 1, nrows, columnNumeric, &status);
 				if (status) {
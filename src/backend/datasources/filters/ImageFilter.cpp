@@ -180,6 +180,36 @@ void ImageFilterPrivate::read(const QString & fileName, AbstractDataSource* data
 	qDebug()<<"actual rows/cols ="<<actualRows<<actualCols;
 #endif
 
+	//the gray values are written column by column into the storage of the matrix directly,
+	//without the intermediate copy of the whole matrix as vectors of doubles
+	Matrix* matrix = dynamic_cast<Matrix*>(dataSource);
+	if (matrix && importFormat == ImageFilter::MATRIX) {
+		matrix->setUndoAware(false);
+		matrix->setSuppressDataChangedSignal(true);
+		if (mode == AbstractFileFilter::Replace) {
+			//the gray values only need one byte per pixel, the storage switches to double
+			//as soon as a value is written that doesn't fit into a byte
+			matrix->clear();
+			matrix->setDataType(MatrixStorage::UInt8);
+			matrix->setDimensions(actualRows, actualCols);
+		} else {
+			matrix->setDimensions(qMax(matrix->rowCount(), actualRows), actualCols);
+		}
+
+		QVector<double> values(actualRows);
+		for (int j=0; j<actualCols; j++) {
+			for (int i=0; i<actualRows; i++)
+				values[i] = qGray(image.pixel(j+startColumn-1,i+startRow-1));
+			matrix->setColumnCells(j, 0, actualRows-1, values);
+			emit q->completed(100*j/actualCols);
+		}
+
+		matrix->setSuppressDataChangedSignal(false);
+		matrix->setChanged();
+		matrix->setUndoAware(true);
+		return;
+	}
+
 	//make sure we have enough columns in the data source.
 	int columnOffset = 0;
 	QVector<QVector<double>*> dataPointers;
@@ -250,7 +280,6 @@ void ImageFilterPrivate::read(const QString & fileName, AbstractDataSource* data
 		return;
 	}
 
-	Matrix* matrix = dynamic_cast<Matrix*>(dataSource);
 	if (matrix) {
 		matrix->setSuppressDataChangedSignal(false);
 		matrix->setChanged();
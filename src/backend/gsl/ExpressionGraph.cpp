@@ -0,0 +1,552 @@
+/***************************************************************************
+    File             : ExpressionGraph.cpp
+    Project          : LabPlot
+    --------------------------------------------------------------------
+    Copyright        : (C) 2017 by LabPlot developers
+    Description      : mathematical expression compiled into a graph of operations
+                       with forward-mode automatic differentiation
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/gsl/ExpressionGraph.h"
+#include <QVarLengthArray>
+#include <cctype>
+#include <cfloat>
+#include <cmath>
+
+extern "C" {
+#include "backend/gsl/parser.h"
+}
+
+/*!
+	\class ExpressionGraph
+	\brief Mathematical expression compiled into a graph of operations.
+
+	The expression is parsed once with the same grammar, functions and constants as the bison generated parser.
+	The nodes of the graph are stored in topological order, so that evaluate() calculates all of them in one pass.
+	Together with the value, the derivatives with respect to all variables are calculated in forward mode.
+	Derivatives of the elementary functions are known analytically, those of the other functions
+	are approximated by central differences of the single function.
+
+	\ingroup backend
+*/
+
+typedef void (*GenericFunction)();
+typedef double (*Function1)(double);
+typedef double (*Function2)(double, double);
+typedef double (*Function3)(double, double, double);
+typedef double (*Function4)(double, double, double, double);
+
+//the functions of the parser are declared without arguments and are called with the number of arguments found in the expression
+static double callFunction(double (*function)(), int argc, const double* args) {
+	const GenericFunction f = reinterpret_cast<GenericFunction>(function);
+	switch (argc) {
+	case 0:
+		return function();
+	case 1:
+		return reinterpret_cast<Function1>(f)(args[0]);
+	case 2:
+		return reinterpret_cast<Function2>(f)(args[0], args[1]);
+	case 3:
+		return reinterpret_cast<Function3>(f)(args[0], args[1], args[2]);
+	default:
+		return reinterpret_cast<Function4>(f)(args[0], args[1], args[2], args[3]);
+	}
+}
+
+ExpressionGraph::ExpressionGraph() : m_variableCount(0), m_pos(0) {
+}
+
+/*!
+	compiles the expression \c expr. \c variables are the names of the variables whose values
+	are passed to evaluate() in the same order.
+	Returns \c false if the expression is not valid or uses unsupported syntax like assignments.
+*/
+bool ExpressionGraph::compile(const QString& expr, const QStringList& variables) {
+	m_nodes.clear();
+	m_variables.clear();
+	m_variableCount = variables.size();
+	foreach (const QString& var, variables)
+		m_variables << var.toLatin1();
+
+	m_string = expr.toLatin1();
+	m_pos = 0;
+	bool valid = (QString::fromLatin1(m_string) == expr) && parseSum() >= 0;
+	if (valid) {
+		skipWhiteSpace();
+		valid = (m_pos == m_string.size());
+	}
+
+	if (!valid)
+		m_nodes.clear();
+
+	m_string.clear();
+	m_variables.clear();
+	return valid;
+}
+
+/*!
+	calculates the value of the expression for the values \c variables of the variables.
+	If \c gradient is not null, the derivatives with respect to all variables are written to it.
+	The function doesn't modify the graph and can be called from several threads at the same time.
+*/
+double ExpressionGraph::evaluate(const double* variables, double* gradient) const {
+	const int count = m_nodes.size();
+	const int nv = gradient ? m_variableCount : 0;
+	QVarLengthArray<double, 128> values(count);
+	QVarLengthArray<double, 1024> gradients(count*nv);
+	double partial[4];
+	double args[4] = {0., 0., 0., 0.};
+
+	for (int i = 0; i < count; ++i) {
+		const Node& node = m_nodes.at(i);
+		for (int k = 0; k < node.argc; ++k)
+			args[k] = values[node.args[k]];
+		const double a = args[0];
+		const double b = args[1];
+
+		double v = 0;
+		switch (node.operation) {
+		case Constant:
+			v = node.value;
+			break;
+		case Variable:
+			v = variables[node.variable];
+			break;
+		case Add:
+			v = a + b;
+			partial[0] = 1.;
+			partial[1] = 1.;
+			break;
+		case Subtract:
+			v = a - b;
+			partial[0] = 1.;
+			partial[1] = -1.;
+			break;
+		case Multiply:
+			v = a*b;
+			partial[0] = b;
+			partial[1] = a;
+			break;
+		case Divide:
+			v = a/b;
+			partial[0] = 1./b;
+			partial[1] = -v/b;
+			break;
+		case Negate:
+			v = -a;
+			partial[0] = -1.;
+			break;
+		case Power:
+			v = pow(a, b);
+			if (nv && node.dependent) {
+				partial[0] = b*pow(a, b - 1.);
+				//the logarithm is only needed (and only defined for a > 0) if the exponent is not constant
+				partial[1] = m_nodes.at(node.args[1]).dependent ? v*log(a) : 0.;
+			}
+			break;
+		case Function:
+			v = callFunction(node.function, node.argc, args);
+			if (nv && node.dependent) {
+				switch (node.derivative) {
+				case Numeric:
+					for (int k = 0; k < node.argc; ++k) {
+						if (!m_nodes.at(node.args[k]).dependent)
+							continue;
+						const double h = 6.0555e-6*qMax(fabs(args[k]), 1.);	//cube root of the machine epsilon
+						double shifted[4] = {args[0], args[1], args[2], args[3]};
+						shifted[k] = args[k] + h;
+						const double fp = callFunction(node.function, node.argc, shifted);
+						shifted[k] = args[k] - h;
+						const double fm = callFunction(node.function, node.argc, shifted);
+						partial[k] = (fp - fm)/(2.*h);
+					}
+					break;
+				case Sin:
+					partial[0] = cos(a);
+					break;
+				case Cos:
+					partial[0] = -sin(a);
+					break;
+				case Tan:
+					partial[0] = 1. + v*v;
+					break;
+				case Asin:
+					partial[0] = 1./sqrt(1. - a*a);
+					break;
+				case Acos:
+					partial[0] = -1./sqrt(1. - a*a);
+					break;
+				case Atan:
+					partial[0] = 1./(1. + a*a);
+					break;
+				case Sinh:
+					partial[0] = cosh(a);
+					break;
+				case Cosh:
+					partial[0] = sinh(a);
+					break;
+				case Tanh:
+					partial[0] = 1. - v*v;
+					break;
+				case Exp:
+					partial[0] = v;
+					break;
+				case Expm1:
+					partial[0] = v + 1.;
+					break;
+				case Log:
+					partial[0] = 1./a;
+					break;
+				case Log10:
+					partial[0] = 1./(a*M_LN10);
+					break;
+				case Log1p:
+					partial[0] = 1./(1. + a);
+					break;
+				case Sqrt:
+					partial[0] = 0.5/v;
+					break;
+				case Cbrt:
+					partial[0] = 1./(3.*v*v);
+					break;
+				case Fabs:
+					partial[0] = (a < 0) ? -1. : 1.;
+					break;
+				case Erf:
+					partial[0] = M_2_SQRTPI*exp(-a*a);
+					break;
+				case Erfc:
+					partial[0] = -M_2_SQRTPI*exp(-a*a);
+					break;
+				case Pow:
+					partial[0] = b*pow(a, b - 1.);
+					partial[1] = m_nodes.at(node.args[1]).dependent ? v*log(a) : 0.;
+					break;
+				case PowInt:
+					partial[0] = node.value*pow(a, node.value - 1.);
+					break;
+				case Atan2:
+					partial[0] = b/(a*a + b*b);
+					partial[1] = -a/(a*a + b*b);
+					break;
+				case Hypot:
+					partial[0] = a/v;
+					partial[1] = b/v;
+					break;
+				}
+			}
+			break;
+		}
+		values[i] = v;
+
+		if (nv && node.dependent) {
+			double* g = gradients.data() + i*nv;
+			for (int j = 0; j < nv; ++j)
+				g[j] = 0.;
+
+			if (node.operation == Variable) {
+				g[node.variable] = 1.;
+			} else {
+				for (int k = 0; k < node.argc; ++k) {
+					if (!m_nodes.at(node.args[k]).dependent)
+						continue;
+					const double* ga = gradients.constData() + node.args[k]*nv;
+					for (int j = 0; j < nv; ++j)
+						g[j] += partial[k]*ga[j];
+				}
+			}
+		}
+	}
+
+	if (nv) {
+		if (m_nodes.last().dependent) {
+			const double* g = gradients.constData() + (count - 1)*nv;
+			for (int j = 0; j < nv; ++j)
+				gradient[j] = g[j];
+		} else {
+			for (int j = 0; j < nv; ++j)
+				gradient[j] = 0.;
+		}
+	}
+
+	return values[count - 1];
+}
+
+//##############################################################################
+//#################################  parser  ###################################
+//##############################################################################
+int ExpressionGraph::addNode(Operation operation, int arg1, int arg2) {
+	Node node;
+	node.operation = operation;
+	node.args[0] = arg1;
+	node.args[1] = arg2;
+	node.args[2] = -1;
+	node.args[3] = -1;
+	node.argc = (arg1 < 0) ? 0 : ((arg2 < 0) ? 1 : 2);
+	node.value = 0;
+	node.variable = -1;
+	node.function = 0;
+	node.derivative = Numeric;
+	node.dependent = (operation == Variable);
+	for (int k = 0; k < node.argc; ++k)
+		node.dependent = node.dependent || m_nodes.at(node.args[k]).dependent;
+
+	m_nodes.append(node);
+	return m_nodes.size() - 1;
+}
+
+void ExpressionGraph::skipWhiteSpace() {
+	while (m_pos < m_string.size() && (m_string.at(m_pos) == ' ' || m_string.at(m_pos) == '\t'))
+		++m_pos;
+}
+
+//! sum := product (('+' | '-') product)*
+int ExpressionGraph::parseSum() {
+	int node = parseProduct();
+	while (node >= 0) {
+		skipWhiteSpace();
+		if (m_pos >= m_string.size())
+			break;
+
+		const char c = m_string.at(m_pos);
+		if (c != '+' && c != '-')
+			break;
+
+		++m_pos;
+		const int rhs = parseProduct();
+		if (rhs < 0)
+			return -1;
+		node = addNode(c == '+' ? Add : Subtract, node, rhs);
+	}
+
+	return node;
+}
+
+//! product := unary (('*' | '/' | '**') unary)*, left associative like in the grammar of the parser,
+//! where '**' has the precedence of '*': a*x**2 is (a*x)**2
+int ExpressionGraph::parseProduct() {
+	int node = parseUnary();
+	while (node >= 0) {
+		skipWhiteSpace();
+		if (m_pos >= m_string.size())
+			break;
+
+		const char c = m_string.at(m_pos);
+		if (c != '*' && c != '/')
+			break;
+
+		Operation operation = (c == '*') ? Multiply : Divide;
+		++m_pos;
+		if (c == '*' && m_pos < m_string.size() && m_string.at(m_pos) == '*') {
+			operation = Power;
+			++m_pos;
+		}
+
+		const int rhs = parseUnary();
+		if (rhs < 0)
+			return -1;
+		node = addNode(operation, node, rhs);
+	}
+
+	return node;
+}
+
+//! unary := '-' unary | power
+int ExpressionGraph::parseUnary() {
+	skipWhiteSpace();
+	if (m_pos < m_string.size() && m_string.at(m_pos) == '-') {
+		++m_pos;
+		const int arg = parseUnary();
+		return (arg < 0) ? -1 : addNode(Negate, arg);
+	}
+
+	return parsePower();
+}
+
+//! power := primary ['^' unary], right associative and binding stronger than the unary minus
+int ExpressionGraph::parsePower() {
+	const int base = parsePrimary();
+	if (base < 0)
+		return -1;
+
+	skipWhiteSpace();
+	if (m_pos >= m_string.size() || m_string.at(m_pos) != '^')
+		return base;
+
+	++m_pos;
+	const int exponent = parseUnary();
+	return (exponent < 0) ? -1 : addNode(Power, base, exponent);
+}
+
+//! primary := number | variable | constant | function '(' [sum (',' sum)*] ')' | '(' sum ')'
+int ExpressionGraph::parsePrimary() {
+	skipWhiteSpace();
+	if (m_pos >= m_string.size())
+		return -1;
+
+	const char c = m_string.at(m_pos);
+	if (c == '(') {
+		++m_pos;
+		const int node = parseSum();
+		skipWhiteSpace();
+		if (node < 0 || m_pos >= m_string.size() || m_string.at(m_pos) != ')')
+			return -1;
+		++m_pos;
+		return node;
+	}
+
+	if (isdigit(c)) {
+		const int start = m_pos;
+		while (m_pos < m_string.size() && (isdigit(m_string.at(m_pos)) || m_string.at(m_pos) == '.'))
+			++m_pos;
+		if (m_pos < m_string.size() && (m_string.at(m_pos) == 'e' || m_string.at(m_pos) == 'E')) {
+			int pos = m_pos + 1;
+			if (pos < m_string.size() && (m_string.at(pos) == '+' || m_string.at(pos) == '-'))
+				++pos;
+			if (pos < m_string.size() && isdigit(m_string.at(pos))) {
+				m_pos = pos;
+				while (m_pos < m_string.size() && isdigit(m_string.at(m_pos)))
+					++m_pos;
+			}
+		}
+
+		bool ok;
+		const double value = m_string.mid(start, m_pos - start).toDouble(&ok);	//locale independent
+		if (!ok)
+			return -1;
+		const int node = addNode(Constant);
+		m_nodes[node].value = value;
+		return node;
+	}
+
+	if (!isalpha(c) && c != '.')
+		return -1;
+
+	const int start = m_pos;
+	do {
+		++m_pos;
+	} while (m_pos < m_string.size() && (isalnum(m_string.at(m_pos)) || m_string.at(m_pos) == '_' || m_string.at(m_pos) == '.'));
+	const QByteArray name = m_string.mid(start, m_pos - start);
+
+	//variables hide constants and functions with the same name
+	const int variable = m_variables.indexOf(name);
+	if (variable != -1) {
+		const int node = addNode(Variable);
+		m_nodes[node].variable = variable;
+		return node;
+	}
+
+	skipWhiteSpace();
+	if (m_pos < m_string.size() && m_string.at(m_pos) == '(')
+		return parseFunction(name);
+
+	//the bison parser uses the last definition of a symbol
+	int index = -1;
+	for (int i = 0; _constants[i].name != 0; i++)
+		if (name == _constants[i].name)
+			index = i;
+	if (index == -1)
+		return -1;
+
+	const int node = addNode(Constant);
+	m_nodes[node].value = _constants[index].value;
+	return node;
+}
+
+int ExpressionGraph::parseFunction(const QByteArray& name) {
+	int index = -1;
+	for (int i = 0; _functions[i].name != 0; i++)
+		if (name == _functions[i].name)
+			index = i;
+	if (index == -1)
+		return -1;
+
+	//arguments
+	++m_pos;
+	QVector<int> args;
+	skipWhiteSpace();
+	if (m_pos < m_string.size() && m_string.at(m_pos) == ')') {
+		++m_pos;
+	} else {
+		while (true) {
+			const int arg = parseSum();
+			if (arg < 0 || args.size() == 4)
+				return -1;
+			args << arg;
+
+			skipWhiteSpace();
+			if (m_pos >= m_string.size())
+				return -1;
+			const char c = m_string.at(m_pos++);
+			if (c == ')')
+				break;
+			if (c != ',')
+				return -1;
+		}
+	}
+
+	Node node;
+	node.operation = Function;
+	node.argc = args.size();
+	node.dependent = false;
+	for (int k = 0; k < 4; ++k) {
+		node.args[k] = (k < node.argc) ? args.at(k) : -1;
+		if (k < node.argc)
+			node.dependent = node.dependent || m_nodes.at(args.at(k)).dependent;
+	}
+	node.value = 0;
+	node.variable = -1;
+	node.function = _functions[index].fnct;
+
+	//functions with analytically known derivatives, the derivatives of all other functions are calculated numerically
+	static const struct {
+		const char* name;
+		Derivative derivative;
+		int exponent;
+	} knownDerivatives[] = {
+		{"sin", Sin, 0}, {"cos", Cos, 0}, {"tan", Tan, 0}, {"asin", Asin, 0}, {"acos", Acos, 0}, {"atan", Atan, 0},
+		{"sinh", Sinh, 0}, {"cosh", Cosh, 0}, {"tanh", Tanh, 0}, {"exp", Exp, 0}, {"expm1", Expm1, 0},
+		{"log", Log, 0}, {"ln", Log, 0}, {"log10", Log10, 0}, {"log1p", Log1p, 0}, {"sqrt", Sqrt, 0}, {"cbrt", Cbrt, 0},
+		{"fabs", Fabs, 0}, {"erf", Erf, 0}, {"erfc", Erfc, 0}, {"pow", Pow, 0},
+		{"pow2", PowInt, 2}, {"pow3", PowInt, 3}, {"pow4", PowInt, 4}, {"pow5", PowInt, 5},
+		{"pow6", PowInt, 6}, {"pow7", PowInt, 7}, {"pow8", PowInt, 8}, {"pow9", PowInt, 9},
+		{"atan2", Atan2, 0}, {"hypot", Hypot, 0},
+		{0, Numeric, 0}
+	};
+
+	node.derivative = Numeric;
+	for (int i = 0; knownDerivatives[i].name != 0; i++) {
+		if (name == knownDerivatives[i].name) {
+			const Derivative derivative = knownDerivatives[i].derivative;
+			const bool binary = (derivative == Pow || derivative == Atan2 || derivative == Hypot);
+			if (node.argc == (binary ? 2 : 1)) {
+				node.derivative = derivative;
+				node.value = knownDerivatives[i].exponent;
+			}
+			break;
+		}
+	}
+
+	m_nodes.append(node);
+	return m_nodes.size() - 1;
+}
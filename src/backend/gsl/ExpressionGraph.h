@@ -0,0 +1,81 @@
+/***************************************************************************
+    File             : ExpressionGraph.h
+    Project          : LabPlot
+    --------------------------------------------------------------------
+    Copyright        : (C) 2017 by LabPlot developers
+    Description      : mathematical expression compiled into a graph of operations
+                       with forward-mode automatic differentiation
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef EXPRESSIONGRAPH_H
+#define EXPRESSIONGRAPH_H
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+class ExpressionGraph {
+
+public:
+	ExpressionGraph();
+
+	bool compile(const QString& expr, const QStringList& variables);
+	bool isValid() const { return !m_nodes.isEmpty(); }
+	int variableCount() const { return m_variableCount; }
+	double evaluate(const double* variables, double* gradient = 0) const;
+
+private:
+	enum Operation {Constant, Variable, Add, Subtract, Multiply, Divide, Negate, Power, Function};
+	enum Derivative {Numeric, Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh, Exp, Expm1,
+		Log, Log10, Log1p, Sqrt, Cbrt, Fabs, Erf, Erfc, Pow, PowInt, Atan2, Hypot};
+
+	struct Node {
+		Operation operation;
+		int args[4];	//indices of the argument nodes, always smaller than the index of the node itself
+		int argc;
+		double value;	//value of a constant or exponent of PowInt
+		int variable;	//index of a variable
+		double (*function)();
+		Derivative derivative;
+		bool dependent;	//true if the node depends on at least one variable
+	};
+
+	int addNode(Operation, int arg1 = -1, int arg2 = -1);
+	int parseSum();
+	int parseProduct();
+	int parseUnary();
+	int parsePower();
+	int parsePrimary();
+	int parseFunction(const QByteArray& name);
+	void skipWhiteSpace();
+
+	QVector<Node> m_nodes;
+	int m_variableCount;
+
+	//state while compiling
+	QByteArray m_string;
+	int m_pos;
+	QList<QByteArray> m_variables;
+};
+
+#endif
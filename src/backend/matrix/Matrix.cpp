@@ -52,8 +52,10 @@
 	a MxN matrix with M rows, N columns). This data is typically
 	used to for 3D plots.
 
-	The values of the matrix are stored as double precision values. Each columng
-	of the matrix is stored in a QVector<double> objects.
+	The values of the matrix are stored column by column in one contiguous buffer
+	(see MatrixStorage) with a selectable element type, double precision by default.
+	Use \c storage() for a direct access to the values, \c data() provides
+	a copy as column vectors of doubles for the older code.
 
 	\ingroup backend
 */
@@ -200,8 +202,26 @@ BASIC_D_READER_IMPL(Matrix, int, precision, precision)
 BASIC_D_READER_IMPL(Matrix, Matrix::HeaderFormat, headerFormat, headerFormat)
 CLASS_D_READER_IMPL(Matrix, QString, formula, formula)
 
+MatrixStorage::DataType Matrix::dataType() const {
+	return d->storage.dataType();
+}
+
+/*!
+	returns the storage with the values of the matrix. The storage is only valid
+	until the matrix is modified the next time.
+*/
+const MatrixStorage& Matrix::storage() const {
+	d->commitAdapter();
+	return d->storage;
+}
+
+/*!
+	returns the values of the matrix as column vectors of doubles. Modifications of the vectors
+	are written back into the matrix storage with \c setChanged() or with the next modification
+	of the matrix.
+*/
 QVector<QVector<double> >& Matrix::data() const {
-	return d->matrixData;
+	return d->dataAdapter();
 }
 
 void Matrix::setSuppressDataChangedSignal(bool b) {
@@ -210,6 +230,7 @@ void Matrix::setSuppressDataChangedSignal(bool b) {
 }
 
 void Matrix::setChanged() {
+	d->commitAdapter();
 	if (m_model)
 		m_model->setChanged();
 }
@@ -286,6 +307,11 @@ void Matrix::setHeaderFormat(Matrix::HeaderFormat format) {
 	emit headerFormatChanged(format);
 }
 
+void Matrix::setDataType(MatrixStorage::DataType type) {
+	if (type != d->storage.dataType())
+		exec(new MatrixSetDataTypeCmd(d, type));
+}
+
 //columns
 void Matrix::insertColumns(int before, int count) {
 	if( count < 1 || before < 0 || before > columnCount()) return;
@@ -382,6 +408,7 @@ void Matrix::setDimensions(int rows, int cols) {
 void Matrix::copy(Matrix* other) {
 	WAIT_CURSOR;
 	beginMacro(i18n("%1: copy %2", name(), other->name()));
+	setDataType(other->dataType());
 	int rows = other->rowCount();
 	int columns = other->columnCount();
 	setDimensions(rows, columns);
@@ -527,26 +554,64 @@ void Matrix::mirrorVertically() {
 //######################  Private implementation ###############################
 //##############################################################################
 
-MatrixPrivate::MatrixPrivate(Matrix* owner) : q(owner), columnCount(0), rowCount(0), suppressDataChange(false) {
+MatrixPrivate::MatrixPrivate(Matrix* owner) : q(owner), columnCount(0), rowCount(0), adapter(0), suppressDataChange(false) {
 
 }
 
+MatrixPrivate::~MatrixPrivate() {
+	delete adapter;
+}
+
 void MatrixPrivate::updateViewHeader() {
 	reinterpret_cast<MatrixView*>(q->m_view)->model()->updateHeader();
 }
 
+/*!
+	returns the values of the matrix as column vectors of doubles for the callers of Matrix::data().
+	The vectors can be modified, the matrix reads and writes them until they are
+	written back into the storage by \c commitAdapter().
+*/
+QVector< QVector<double> >& MatrixPrivate::dataAdapter() {
+	if (!adapter) {
+		adapter = new QVector< QVector<double> >(columnCount);
+		for (int col = 0; col < columnCount; ++col) {
+			QVector<double>& column = (*adapter)[col];
+			column.resize(rowCount);
+			storage.readColumn(col, 0, rowCount, column.data());
+		}
+	}
+
+	return *adapter;
+}
+
+/*!
+	writes the values modified via Matrix::data() back into the storage and releases them.
+*/
+void MatrixPrivate::commitAdapter() {
+	if (!adapter)
+		return;
+
+	const int cols = qMin(adapter->size(), columnCount);
+	for (int col = 0; col < cols; ++col) {
+		const QVector<double>& column = adapter->at(col);
+		storage.writeColumn(col, 0, qMin(column.size(), rowCount), column.constData());
+	}
+
+	delete adapter;
+	adapter = 0;
+}
+
 /*!
 	Insert \count columns before column number \c before
 */
 void MatrixPrivate::insertColumns(int before, int count) {
 	Q_ASSERT(before >= 0);
 	Q_ASSERT(before <= columnCount);
+	commitAdapter();
 
 	emit q->columnsAboutToBeInserted(before, count);
-	for(int i=0; i<count; i++) {
-		matrixData.insert(before+i, QVector<double>(rowCount));
-		columnWidths.insert(before+i, 0);
-	}
+	storage.insertColumns(before, count);
+	columnWidths.insert(before, count, 0);
 
 	columnCount += count;
 	emit q->columnsInserted(before, count);
@@ -556,12 +621,12 @@ void MatrixPrivate::insertColumns(int before, int count) {
 	Remove \c count columns starting with column index \c first
 */
 void MatrixPrivate::removeColumns(int first, int count) {
+	commitAdapter();
 	emit q->columnsAboutToBeRemoved(first, count);
 	Q_ASSERT(first >= 0);
 	Q_ASSERT(first+count <= columnCount);
-	matrixData.remove(first, count);
-	for (int i=0; i<count; i++)
-		columnWidths.remove(first);
+	storage.removeColumns(first, count);
+	columnWidths.remove(first, count);
 	columnCount -= count;
 	emit q->columnsRemoved(first, count);
 }
@@ -570,14 +635,12 @@ void MatrixPrivate::removeColumns(int first, int count) {
 	Insert \c count rows before row with the index \c before
 */
 void MatrixPrivate::insertRows(int before, int count) {
+	commitAdapter();
 	emit q->rowsAboutToBeInserted(before, count);
 	Q_ASSERT(before >= 0);
 	Q_ASSERT(before <= rowCount);
-	for(int col=0; col<columnCount; col++)
-		for(int i=0; i<count; i++)
-			matrixData[col].insert(before+i, 0.0);
-	for(int i=0; i<count; i++)
-		rowHeights.insert(before+i, 0);
+	storage.insertRows(before, count);
+	rowHeights.insert(before, count, 0);
 
 	rowCount += count;
 	emit q->rowsInserted(before, count);
@@ -587,13 +650,12 @@ void MatrixPrivate::insertRows(int before, int count) {
 	Remove \c count columns starting from the column with index \c first
 */
 void MatrixPrivate::removeRows(int first, int count) {
+	commitAdapter();
 	emit q->rowsAboutToBeRemoved(first, count);
 	Q_ASSERT(first >= 0);
 	Q_ASSERT(first+count <= rowCount);
-	for(int col=0; col<columnCount; col++)
-		matrixData[col].remove(first, count);
-	for (int i=0; i<count; i++)
-		rowHeights.remove(first);
+	storage.removeRows(first, count);
+	rowHeights.remove(first, count);
 
 	rowCount -= count;
 	emit q->rowsRemoved(first, count);
@@ -606,13 +668,17 @@ double MatrixPrivate::cell(int row, int col) const {
 // 	if(row < 0 || row >= rowCount() || col < 0 || col >= columnCount())
 // 		return 0.0;
 
-	return matrixData.at(col).at(row);
+	if (adapter)
+		return adapter->at(col).at(row);
+
+	return storage.value(row, col);
 }
 
 void MatrixPrivate::setCell(int row, int col, double value) {
 	Q_ASSERT(row >= 0 && row < rowCount);
 	Q_ASSERT(col >= 0 && col < columnCount);
-	matrixData[col][row] = value;
+	commitAdapter();
+	storage.setValue(row, col, value);
 	if (!suppressDataChange)
 		emit q->dataChanged(row, col, row, col);
 }
@@ -620,13 +686,10 @@ void MatrixPrivate::setCell(int row, int col, double value) {
 QVector<double> MatrixPrivate::columnCells(int col, int first_row, int last_row) {
 	Q_ASSERT(first_row >= 0 && first_row < rowCount);
 	Q_ASSERT(last_row >= 0 && last_row < rowCount);
+	commitAdapter();
 
-	if(first_row == 0 && last_row == rowCount-1)
-		return matrixData.at(col);
-
-	QVector<double> result;
-	for(int i=first_row; i<=last_row; i++)
-		result.append(matrixData.at(col).at(i));
+	QVector<double> result(last_row - first_row + 1);
+	storage.readColumn(col, first_row, result.size(), result.data());
 	return result;
 }
 
@@ -634,17 +697,9 @@ void MatrixPrivate::setColumnCells(int col, int first_row, int last_row, const Q
 	Q_ASSERT(first_row >= 0 && first_row < rowCount);
 	Q_ASSERT(last_row >= 0 && last_row < rowCount);
 	Q_ASSERT(values.count() > last_row - first_row);
+	commitAdapter();
 
-	if(first_row == 0 && last_row == rowCount-1) {
-		matrixData[col] = values;
-		matrixData[col].resize(rowCount);  // values may be larger
-		if (!suppressDataChange)
-			emit q->dataChanged(first_row, col, last_row, col);
-		return;
-	}
-
-	for(int i=first_row; i<=last_row; i++)
-		matrixData[col][i] = values.at(i-first_row);
+	storage.writeColumn(col, first_row, last_row - first_row + 1, values.constData());
 	if (!suppressDataChange)
 		emit q->dataChanged(first_row, col, last_row, col);
 }
@@ -652,10 +707,10 @@ void MatrixPrivate::setColumnCells(int col, int first_row, int last_row, const Q
 QVector<double> MatrixPrivate::rowCells(int row, int first_column, int last_column) {
 	Q_ASSERT(first_column >= 0 && first_column < columnCount);
 	Q_ASSERT(last_column >= 0 && last_column < columnCount);
+	commitAdapter();
 
-	QVector<double> result;
-	for(int i=first_column; i<=last_column; i++)
-		result.append(matrixData.at(i).at(row));
+	QVector<double> result(last_column - first_column + 1);
+	storage.readRow(row, first_column, result.size(), result.data());
 	return result;
 }
 
@@ -663,20 +718,80 @@ void MatrixPrivate::setRowCells(int row, int first_column, int last_column, cons
 	Q_ASSERT(first_column >= 0 && first_column < columnCount);
 	Q_ASSERT(last_column >= 0 && last_column < columnCount);
 	Q_ASSERT(values.count() > last_column - first_column);
+	commitAdapter();
 
-	for(int i=first_column; i<=last_column; i++)
-		matrixData[i][row] = values.at(i-first_column);
+	storage.writeRow(row, first_column, last_column - first_column + 1, values.constData());
 	if (!suppressDataChange)
 		emit q->dataChanged(row, first_column, row, last_column);
 }
 
 //! Fill column with zeroes
 void MatrixPrivate::clearColumn(int col) {
-	matrixData[col].fill(0.0);
+	commitAdapter();
+	storage.fillColumn(col, 0.0);
 	if (!suppressDataChange)
 		emit q->dataChanged(0, col, rowCount-1, col);
 }
 
+/*!
+	transposes the matrix. The rows and columns exceeding the new dimension are removed first,
+	the missing ones are inserted after the values were transposed, such that the model
+	only sees valid cells.
+*/
+void MatrixPrivate::transpose() {
+	commitAdapter();
+	const int rows = rowCount;
+	const int cols = columnCount;
+
+	if (cols < rows) {
+		emit q->rowsAboutToBeRemoved(cols, rows - cols);
+		rowCount = cols;
+		emit q->rowsRemoved(cols, rows - cols);
+	} else if (rows < cols) {
+		emit q->columnsAboutToBeRemoved(rows, cols - rows);
+		columnCount = rows;
+		emit q->columnsRemoved(rows, cols - rows);
+	}
+
+	storage.transpose();
+	rowHeights.swap(columnWidths);
+
+	if (cols < rows) {
+		emit q->columnsAboutToBeInserted(cols, rows - cols);
+		columnCount = rows;
+		emit q->columnsInserted(cols, rows - cols);
+	} else if (rows < cols) {
+		emit q->rowsAboutToBeInserted(rows, cols - rows);
+		rowCount = cols;
+		emit q->rowsInserted(rows, cols - rows);
+	}
+
+	if (!suppressDataChange)
+		emit q->dataChanged(0, 0, rowCount-1, columnCount-1);
+}
+
+void MatrixPrivate::mirrorHorizontally() {
+	commitAdapter();
+	storage.mirrorHorizontally();
+	if (!suppressDataChange)
+		emit q->dataChanged(0, 0, rowCount-1, columnCount-1);
+}
+
+void MatrixPrivate::mirrorVertically() {
+	commitAdapter();
+	storage.mirrorVertically();
+	if (!suppressDataChange)
+		emit q->dataChanged(0, 0, rowCount-1, columnCount-1);
+}
+
+void MatrixPrivate::setDataType(MatrixStorage::DataType type) {
+	commitAdapter();
+	storage.setDataType(type);
+	if (!suppressDataChange)
+		emit q->dataChanged(0, 0, rowCount-1, columnCount-1);
+	emit q->dataTypeChanged(type);
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -695,6 +810,7 @@ void Matrix::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute("headerFormat", QString::number(d->headerFormat));
 	writer->writeAttribute("numericFormat", QString(QChar(d->numericFormat)));
 	writer->writeAttribute("precision", QString::number(d->precision));
+	writer->writeAttribute("dataType", QString::number(d->storage.dataType()));
 	writer->writeEndElement();
 
 	//dimensions
@@ -722,9 +838,10 @@ void Matrix::save(QXmlStreamWriter* writer) const {
 	writer->writeEndElement();
 
 	//columns
-	size = d->rowCount*sizeof(double);
+	d->commitAdapter();
+	size = d->rowCount*d->storage.elementSize();
 	for (int i=0; i<d->columnCount; ++i) {
-		data = reinterpret_cast<const char*>(d->matrixData.at(i).constData());
+		data = d->storage.columnBytes(i);
 		writer->writeStartElement("column");
 		writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
 		writer->writeEndElement();
@@ -744,6 +861,7 @@ bool Matrix::load(XmlStreamReader* reader) {
 	QString attributeWarning = i18n("Attribute '%1' missing or empty, default value is used");
 	QXmlStreamAttributes attribs;
 	QString str;
+	int columnIndex = 0;
 
 	// read child elements
 	while (!reader->atEnd()) {
@@ -781,6 +899,11 @@ bool Matrix::load(XmlStreamReader* reader) {
 			else
 				d->precision = str.toInt();
 
+			//not available in older projects, the values were always stored as double
+			str = attribs.value("dataType").toString();
+			if(!str.isEmpty())
+				d->storage.setDataType(MatrixStorage::DataType(str.toInt()));
+
 		} else if (reader->name() == "dimension") {
 			attribs = reader->attributes();
 
@@ -838,11 +961,13 @@ bool Matrix::load(XmlStreamReader* reader) {
 			reader->readNext();
 			QString content = reader->text().toString().trimmed();
 			QByteArray bytes = QByteArray::fromBase64(content.toAscii());
-			int count = bytes.size()/sizeof(double);
-			QVector<double> column;
-			column.resize(count);
-			memcpy(column.data(), bytes.data(), count*sizeof(double));
-			d->matrixData.append(column);
+			if (d->storage.rowCount() != d->rowCount || d->storage.columnCount() != d->columnCount)
+				d->storage.resize(d->rowCount, d->columnCount);
+			if (columnIndex < d->columnCount) {
+				const int size = qMin(bytes.size(), d->rowCount*d->storage.elementSize());
+				memcpy(d->storage.columnBytes(columnIndex), bytes.constData(), size);
+			}
+			++columnIndex;
 		} else { // unknown element
 			reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
 			if (!reader->skipToEndElement())
@@ -850,6 +975,9 @@ bool Matrix::load(XmlStreamReader* reader) {
 		}
 	}
 
+	//make sure the storage has the dimension of the matrix also if not all columns were saved
+	d->storage.resize(d->rowCount, d->columnCount);
+
 	return true;
 }
 
@@ -30,6 +30,7 @@
 #define MATRIX_H
 
 #include "backend/datasources/AbstractDataSource.h"
+#include "backend/matrix/MatrixStorage.h"
 #include "backend/lib/macros.h"
 
 class MatrixPrivate;
@@ -64,6 +65,10 @@ class Matrix : public AbstractDataSource {
 		BASIC_D_ACCESSOR_DECL(HeaderFormat, headerFormat, HeaderFormat)
 		CLASS_D_ACCESSOR_DECL(QString, formula, Formula)
 
+		MatrixStorage::DataType dataType() const;
+		void setDataType(MatrixStorage::DataType);
+		const MatrixStorage& storage() const;
+
 		QVector<QVector<double> >& data() const;
 		void setData(const QVector<QVector<double> >&);
 		void setSuppressDataChangedSignal(bool);
@@ -148,6 +153,7 @@ class Matrix : public AbstractDataSource {
 		void numericFormatChanged(char);
 		void precisionChanged(int);
 		void headerFormatChanged(Matrix::HeaderFormat);
+		void dataTypeChanged(MatrixStorage::DataType);
 
 	private:
 		void init();
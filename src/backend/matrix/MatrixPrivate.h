@@ -30,11 +30,13 @@
 #ifndef MATRIXPRIVATE_H
 #define MATRIXPRIVATE_H
 
+#include "MatrixStorage.h"
 #include <QVector>
 
 class MatrixPrivate {
 	public:
 		explicit MatrixPrivate(Matrix*);
+		~MatrixPrivate();
 
 		void insertColumns(int before, int count);
 		void removeColumns(int first, int count);
@@ -50,6 +52,13 @@ class MatrixPrivate {
 		QVector<double> rowCells(int row, int first_column, int last_column);
 		void setRowCells(int row, int first_column, int last_column, const QVector<double> & values);
 		void clearColumn(int col);
+		void transpose();
+		void mirrorHorizontally();
+		void mirrorVertically();
+		void setDataType(MatrixStorage::DataType);
+
+		QVector< QVector<double> >& dataAdapter();
+		void commitAdapter();
 
 		void setRowHeight(int row, int height) { rowHeights[row] = height; }
 		void setColumnWidth(int col, int width) { columnWidths[col] = width; }
@@ -62,7 +71,8 @@ class MatrixPrivate {
 		Matrix* q;
 		int columnCount;
 		int rowCount;
-		QVector< QVector<double> > matrixData;
+		MatrixStorage storage;
+		QVector< QVector<double> >* adapter; //!< column vectors handed out by Matrix::data(), written back by commitAdapter()
 		QVector<int> rowHeights;//!< Row widths
 		QVector<int> columnWidths;//!< Columns widths
 		int defaultRowHeight;
@@ -0,0 +1,396 @@
+/***************************************************************************
+    File                 : MatrixStorage.cpp
+    Project              : LabPlot
+    Description          : Contiguous, typed storage of the matrix values
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#include "MatrixStorage.h"
+
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/*!
+	\class MatrixStorage
+	\brief Stores the values of a matrix in one contiguous, aligned buffer.
+
+	The values are stored column by column with the element type \c dataType().
+	The columns are padded to a multiple of the cache line size, the distance between
+	two columns is given by \c stride() (in elements).
+	All values are converted from and to double in the value based accessors.
+	Writing a value that can not be represented exactly by the element type
+	(a fraction, NaN or a value out of range) converts the storage to \c Double first,
+	such that no written value is rounded or clamped. Only an explicit \c setDataType()
+	rounds and clamps the values to the range of an integer type.
+
+	\ingroup backend
+*/
+
+//alignment of the buffer and of the columns in bytes
+static const int StorageAlignment = 64;
+//size of the tiles used in transpose()
+static const int TransposeBlockSize = 32;
+
+//executes \c code with T being the C++ type of the element type \c type
+#define STORAGE_DISPATCH(type, code) \
+	switch (type) { \
+	case MatrixStorage::UInt8: { typedef quint8 T; code; break; } \
+	case MatrixStorage::Int16: { typedef qint16 T; code; break; } \
+	case MatrixStorage::Int32: { typedef qint32 T; code; break; } \
+	case MatrixStorage::Float: { typedef float T; code; break; } \
+	case MatrixStorage::Double: { typedef double T; code; break; } \
+	}
+
+template<typename T> static inline T fromDouble(double value) {
+	if (value != value)
+		return 0;
+	if (value <= (double)std::numeric_limits<T>::min())
+		return std::numeric_limits<T>::min();
+	if (value >= (double)std::numeric_limits<T>::max())
+		return std::numeric_limits<T>::max();
+	return (T)floor(value + 0.5);
+}
+
+template<> inline float fromDouble<float>(double value) {
+	return (float)value;
+}
+
+template<> inline double fromDouble<double>(double value) {
+	return value;
+}
+
+//! returns \c true if \c value is stored without loss by the element type T
+template<typename T> static inline bool isExact(double value) {
+	return (double)fromDouble<T>(value) == value;
+}
+
+template<> inline bool isExact<float>(double value) {
+	return (double)(float)value == value || value != value;
+}
+
+template<> inline bool isExact<double>(double) {
+	return true;
+}
+
+template<typename T> static void transposeBlocked(const T* src, int srcStride, T* dst, int dstStride, int rows, int columns) {
+	for (int cb = 0; cb < columns; cb += TransposeBlockSize) {
+		const int ce = qMin(cb + TransposeBlockSize, columns);
+		for (int rb = 0; rb < rows; rb += TransposeBlockSize) {
+			const int re = qMin(rb + TransposeBlockSize, rows);
+			for (int r = rb; r < re; ++r) {
+				T* d = dst + (size_t)r*dstStride;
+				for (int c = cb; c < ce; ++c)
+					d[c] = src[(size_t)c*srcStride + r];
+			}
+		}
+	}
+}
+
+static int paddedStride(int rows, int elementSize) {
+	const int perLine = StorageAlignment/elementSize;
+	return ((rows + perLine - 1)/perLine)*perLine;
+}
+
+MatrixStorage::MatrixStorage(DataType type) : m_type(type), m_rows(0), m_columns(0), m_stride(0), m_capacity(0), m_data(0) {
+}
+
+MatrixStorage::MatrixStorage(const MatrixStorage& other) : m_type(other.m_type), m_rows(0), m_columns(0), m_stride(0), m_capacity(0), m_data(0) {
+	reallocate(other.m_stride, other.m_columns);
+	m_rows = other.m_rows;
+	m_columns = other.m_columns;
+	if (m_data)
+		memcpy(m_data, other.m_data, (size_t)m_columns*m_stride*elementSize());
+}
+
+MatrixStorage& MatrixStorage::operator=(const MatrixStorage& other) {
+	MatrixStorage copy(other);
+	swap(copy);
+	return *this;
+}
+
+MatrixStorage::~MatrixStorage() {
+	qFreeAligned(m_data);
+}
+
+void MatrixStorage::swap(MatrixStorage& other) {
+	std::swap(m_type, other.m_type);
+	std::swap(m_rows, other.m_rows);
+	std::swap(m_columns, other.m_columns);
+	std::swap(m_stride, other.m_stride);
+	std::swap(m_capacity, other.m_capacity);
+	std::swap(m_data, other.m_data);
+}
+
+int MatrixStorage::elementSize(DataType type) {
+	switch (type) {
+	case UInt8:
+		return 1;
+	case Int16:
+		return 2;
+	case Int32:
+	case Float:
+		return 4;
+	case Double:
+		return 8;
+	}
+	return 8;
+}
+
+/*!
+	converts all values to the element type \c type.
+*/
+void MatrixStorage::setDataType(DataType type) {
+	if (type == m_type)
+		return;
+
+	MatrixStorage converted(type);
+	converted.resize(m_rows, m_columns);
+	QVector<double> buffer(m_rows);
+	for (int col = 0; col < m_columns; ++col) {
+		readColumn(col, 0, m_rows, buffer.data());
+		STORAGE_DISPATCH(type,
+			T* dst = converted.column<T>(col);
+			for (int i = 0; i < m_rows; ++i)
+				dst[i] = fromDouble<T>(buffer.at(i));
+		);
+	}
+	swap(converted);
+}
+
+/*!
+	converts the storage to \c Double if one of the \c count values can not be stored exactly
+	with the current element type.
+*/
+void MatrixStorage::promote(const double* values, int count) {
+	if (m_type == Double)
+		return;
+
+	STORAGE_DISPATCH(m_type,
+		for (int i = 0; i < count; ++i) {
+			if (!isExact<T>(values[i])) {
+				setDataType(Double);
+				return;
+			}
+		}
+	);
+}
+
+/*!
+	allocates a new buffer with \c capacity columns of \c stride elements each and
+	copies the current values into it. The new elements are initialized with zeros.
+*/
+void MatrixStorage::reallocate(int stride, int capacity) {
+	Q_ASSERT(stride >= m_rows);
+	Q_ASSERT(capacity >= m_columns);
+
+	const size_t size = elementSize();
+	const size_t bytes = (size_t)stride*capacity*size;
+	void* data = 0;
+	if (bytes) {
+		data = qMallocAligned(bytes, StorageAlignment);
+		memset(data, 0, bytes);
+		for (int col = 0; col < m_columns; ++col)
+			memcpy(static_cast<char*>(data) + (size_t)col*stride*size, columnBytes(col), m_rows*size);
+	}
+
+	qFreeAligned(m_data);
+	m_data = data;
+	m_stride = stride;
+	m_capacity = capacity;
+}
+
+double MatrixStorage::value(int row, int col) const {
+	Q_ASSERT(row >= 0 && row < m_rows);
+	Q_ASSERT(col >= 0 && col < m_columns);
+	STORAGE_DISPATCH(m_type, return (double)column<T>(col)[row]);
+	return 0.0;
+}
+
+void MatrixStorage::setValue(int row, int col, double value) {
+	Q_ASSERT(row >= 0 && row < m_rows);
+	Q_ASSERT(col >= 0 && col < m_columns);
+	promote(&value, 1);
+	STORAGE_DISPATCH(m_type, column<T>(col)[row] = fromDouble<T>(value));
+}
+
+void MatrixStorage::readColumn(int col, int first_row, int count, double* values) const {
+	Q_ASSERT(first_row >= 0 && first_row + count <= m_rows);
+	STORAGE_DISPATCH(m_type,
+		const T* src = column<T>(col) + first_row;
+		for (int i = 0; i < count; ++i)
+			values[i] = src[i];
+	);
+}
+
+void MatrixStorage::writeColumn(int col, int first_row, int count, const double* values) {
+	Q_ASSERT(first_row >= 0 && first_row + count <= m_rows);
+	promote(values, count);
+	STORAGE_DISPATCH(m_type,
+		T* dst = column<T>(col) + first_row;
+		for (int i = 0; i < count; ++i)
+			dst[i] = fromDouble<T>(values[i]);
+	);
+}
+
+void MatrixStorage::readRow(int row, int first_column, int count, double* values) const {
+	Q_ASSERT(first_column >= 0 && first_column + count <= m_columns);
+	STORAGE_DISPATCH(m_type,
+		const T* src = column<T>(first_column) + row;
+		for (int i = 0; i < count; ++i)
+			values[i] = src[(size_t)i*m_stride];
+	);
+}
+
+void MatrixStorage::writeRow(int row, int first_column, int count, const double* values) {
+	Q_ASSERT(first_column >= 0 && first_column + count <= m_columns);
+	promote(values, count);
+	STORAGE_DISPATCH(m_type,
+		T* dst = column<T>(first_column) + row;
+		for (int i = 0; i < count; ++i)
+			dst[(size_t)i*m_stride] = fromDouble<T>(values[i]);
+	);
+}
+
+void MatrixStorage::fillColumn(int col, double value) {
+	promote(&value, 1);
+	STORAGE_DISPATCH(m_type,
+		T* dst = column<T>(col);
+		std::fill(dst, dst + m_rows, fromDouble<T>(value));
+	);
+}
+
+void MatrixStorage::fill(double value) {
+	for (int col = 0; col < m_columns; ++col)
+		fillColumn(col, value);
+}
+
+/*!
+	sets the dimension to \c rows x \c columns. Existing values are kept, new values are zero.
+*/
+void MatrixStorage::resize(int rows, int columns) {
+	const size_t size = elementSize();
+
+	//only the values within the new dimension are kept
+	m_rows = qMin(m_rows, rows);
+	m_columns = qMin(m_columns, columns);
+
+	//use a new buffer if the current one is too small or much too large
+	const int stride = paddedStride(rows, size);
+	const size_t allocated = (size_t)m_stride*m_capacity;
+	if (rows > m_stride || columns > m_capacity || (allocated > 4096 && (size_t)stride*columns*4 < allocated)) {
+		reallocate(stride, columns);
+	} else {
+		//clear the values that were left behind by removeRows()/removeColumns()
+		for (int col = 0; col < m_columns; ++col)
+			memset(columnBytes(col) + m_rows*size, 0, (rows - m_rows)*size);
+		if (columns > m_columns)
+			memset(columnBytes(m_columns), 0, (size_t)(columns - m_columns)*m_stride*size);
+	}
+
+	m_rows = rows;
+	m_columns = columns;
+}
+
+void MatrixStorage::insertRows(int before, int count) {
+	Q_ASSERT(before >= 0 && before <= m_rows);
+	const size_t size = elementSize();
+	const int rows = m_rows + count;
+	if (rows > m_stride)
+		reallocate(paddedStride(qMax(rows, m_stride + m_stride/2), size), m_capacity);
+
+	for (int col = 0; col < m_columns; ++col) {
+		char* data = columnBytes(col);
+		memmove(data + (before + count)*size, data + before*size, (m_rows - before)*size);
+		memset(data + before*size, 0, count*size);
+	}
+	m_rows = rows;
+}
+
+void MatrixStorage::removeRows(int first, int count) {
+	Q_ASSERT(first >= 0 && first + count <= m_rows);
+	const size_t size = elementSize();
+	for (int col = 0; col < m_columns; ++col) {
+		char* data = columnBytes(col);
+		memmove(data + first*size, data + (first + count)*size, (m_rows - first - count)*size);
+	}
+	m_rows -= count;
+}
+
+void MatrixStorage::insertColumns(int before, int count) {
+	Q_ASSERT(before >= 0 && before <= m_columns);
+	const size_t columnSize = (size_t)m_stride*elementSize();
+	const int columns = m_columns + count;
+	if (columns > m_capacity)
+		reallocate(m_stride, qMax(columns, m_capacity + m_capacity/2));
+
+	if (columnSize) {
+		memmove(columnBytes(before + count), columnBytes(before), (m_columns - before)*columnSize);
+		memset(columnBytes(before), 0, count*columnSize);
+	}
+	m_columns = columns;
+}
+
+void MatrixStorage::removeColumns(int first, int count) {
+	Q_ASSERT(first >= 0 && first + count <= m_columns);
+	const size_t columnSize = (size_t)m_stride*elementSize();
+	if (columnSize)
+		memmove(columnBytes(first), columnBytes(first + count), (m_columns - first - count)*columnSize);
+	m_columns -= count;
+}
+
+/*!
+	transposes the matrix. The values are copied tile by tile to stay within the cache.
+*/
+void MatrixStorage::transpose() {
+	MatrixStorage transposed(m_type);
+	transposed.resize(m_columns, m_rows);
+	if (m_rows && m_columns) {
+		STORAGE_DISPATCH(m_type,
+			transposeBlocked<T>(column<T>(0), m_stride, transposed.column<T>(0), transposed.m_stride, m_rows, m_columns)
+		);
+	}
+	swap(transposed);
+}
+
+//! reverses the order of the columns
+void MatrixStorage::mirrorHorizontally() {
+	const size_t bytes = m_rows*elementSize();
+	for (int col = 0; col < m_columns/2; ++col) {
+		char* left = columnBytes(col);
+		std::swap_ranges(left, left + bytes, columnBytes(m_columns - col - 1));
+	}
+}
+
+//! reverses the order of the rows
+void MatrixStorage::mirrorVertically() {
+	for (int col = 0; col < m_columns; ++col) {
+		STORAGE_DISPATCH(m_type,
+			T* data = column<T>(col);
+			std::reverse(data, data + m_rows);
+		);
+	}
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+    File                 : MatrixStorage.h
+    Project              : LabPlot
+    Description          : Contiguous, typed storage of the matrix values
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MATRIXSTORAGE_H
+#define MATRIXSTORAGE_H
+
+#include <QtGlobal>
+#include <cstddef>
+
+class MatrixStorage {
+	public:
+		enum DataType {UInt8, Int16, Int32, Float, Double};
+
+		explicit MatrixStorage(DataType type = Double);
+		MatrixStorage(const MatrixStorage&);
+		MatrixStorage& operator=(const MatrixStorage&);
+		~MatrixStorage();
+		void swap(MatrixStorage&);
+
+		DataType dataType() const { return m_type; }
+		void setDataType(DataType);
+		static int elementSize(DataType);
+		int elementSize() const { return elementSize(m_type); }
+
+		int rowCount() const { return m_rows; }
+		int columnCount() const { return m_columns; }
+		int stride() const { return m_stride; }
+
+		//! Pointer to the first element of the column \c col, the column holds rowCount() values of the type T
+		template<typename T> const T* column(int col) const {
+			return static_cast<const T*>(m_data) + (size_t)col*m_stride;
+		}
+		template<typename T> T* column(int col) {
+			return static_cast<T*>(m_data) + (size_t)col*m_stride;
+		}
+		const char* columnBytes(int col) const { return static_cast<const char*>(m_data) + (size_t)col*m_stride*elementSize(); }
+		char* columnBytes(int col) { return static_cast<char*>(m_data) + (size_t)col*m_stride*elementSize(); }
+
+		double value(int row, int col) const;
+		void setValue(int row, int col, double value);
+
+		void readColumn(int col, int first_row, int count, double* values) const;
+		void writeColumn(int col, int first_row, int count, const double* values);
+		void readRow(int row, int first_column, int count, double* values) const;
+		void writeRow(int row, int first_column, int count, const double* values);
+		void fillColumn(int col, double value);
+		void fill(double value);
+
+		void resize(int rows, int columns);
+		void insertRows(int before, int count);
+		void removeRows(int first, int count);
+		void insertColumns(int before, int count);
+		void removeColumns(int first, int count);
+
+		void transpose();
+		void mirrorHorizontally();
+		void mirrorVertically();
+
+	private:
+		void reallocate(int stride, int capacity);
+		void promote(const double* values, int count);
+
+		DataType m_type;
+		int m_rows;
+		int m_columns;
+		int m_stride; //!< number of elements between the starts of two consecutive columns
+		int m_capacity; //!< number of columns the buffer has space for
+		void* m_data;
+};
+
+#endif
@@ -270,27 +270,13 @@ MatrixTransposeCmd::MatrixTransposeCmd( MatrixPrivate * private_obj, QUndoComman
 }
 
 void MatrixTransposeCmd::redo() {
-	int rows = m_private_obj->rowCount;
-	int cols = m_private_obj->columnCount;
-	int temp_size = qMax(rows, cols);
-	m_private_obj->suppressDataChange = true;
-	if (cols < rows)
-		m_private_obj->insertColumns(cols, temp_size - cols);
-	else if (cols > rows)
-		m_private_obj->insertRows(rows, temp_size - rows);
-	for(int i = 1; i<temp_size; i++)
-	{
-		QVector<double> row = m_private_obj->rowCells(i, 0, i-1);
-		QVector<double> col = m_private_obj->columnCells(i, 0, i-1);
-		m_private_obj->setRowCells(i, 0, i-1, col);
-		m_private_obj->setColumnCells(i, 0, i-1, row);
+	const int rows = m_private_obj->rowCount;
+	const int cols = m_private_obj->columnCount;
+	m_private_obj->transpose();
+	if (rows != cols) {
+		emit m_private_obj->q->rowCountChanged(m_private_obj->rowCount);
+		emit m_private_obj->q->columnCountChanged(m_private_obj->columnCount);
 	}
-	if (cols < rows)
-		m_private_obj->removeRows(cols, temp_size - cols);
-	else if (cols > rows)
-		m_private_obj->removeColumns(rows, temp_size - rows);
-	m_private_obj->suppressDataChange = false;
-	m_private_obj->emitDataChanged(0, 0, m_private_obj->rowCount-1, m_private_obj->columnCount-1);
 }
 
 void MatrixTransposeCmd::undo() {
@@ -306,18 +292,7 @@ MatrixMirrorHorizontallyCmd::MatrixMirrorHorizontallyCmd( MatrixPrivate * privat
 }
 
 void MatrixMirrorHorizontallyCmd::redo() {
-	int rows = m_private_obj->rowCount;
-	int cols = m_private_obj->columnCount;
-	int middle = cols/2;
-	m_private_obj->suppressDataChange = true;
-	for(int i = 0; i<middle; i++)
-	{
-		QVector<double> temp = m_private_obj->columnCells(i, 0, rows-1);
-		m_private_obj->setColumnCells(i, 0, rows-1, m_private_obj->columnCells(cols-i-1, 0, rows-1));
-		m_private_obj->setColumnCells(cols-i-1, 0, rows-1, temp);
-	}
-	m_private_obj->suppressDataChange = false;
-	m_private_obj->emitDataChanged(0, 0, rows-1, cols-1);
+	m_private_obj->mirrorHorizontally();
 }
 
 void MatrixMirrorHorizontallyCmd::undo() {
@@ -333,18 +308,7 @@ MatrixMirrorVerticallyCmd::MatrixMirrorVerticallyCmd( MatrixPrivate * private_ob
 }
 
 void MatrixMirrorVerticallyCmd::redo() {
-	int rows = m_private_obj->rowCount;
-	int cols = m_private_obj->columnCount;
-	int middle = rows/2;
-	m_private_obj->suppressDataChange = true;
-	for(int i = 0; i<middle; i++)
-	{
-		QVector<double> temp = m_private_obj->rowCells(i, 0, cols-1);
-		m_private_obj->setRowCells(i, 0, cols-1, m_private_obj->rowCells(rows-i-1, 0, cols-1));
-		m_private_obj->setRowCells(rows-i-1, 0, cols-1, temp);
-	}
-	m_private_obj->suppressDataChange = false;
-	m_private_obj->emitDataChanged(0, 0, rows-1, cols-1);
+	m_private_obj->mirrorVertically();
 }
 
 void MatrixMirrorVerticallyCmd::undo() {
@@ -354,19 +318,44 @@ void MatrixMirrorVerticallyCmd::undo() {
 
 //replace values
 MatrixReplaceValuesCmd::MatrixReplaceValuesCmd(MatrixPrivate* private_obj, const QVector<QVector<double> >& new_values, QUndoCommand* parent)
- : QUndoCommand(parent), m_private_obj(private_obj), m_new_values(new_values)
+ : QUndoCommand(parent), m_private_obj(private_obj), m_values(private_obj->storage.dataType())
 {
 	setText(i18n("%1: replace values", m_private_obj->name()));
+
+	const int rows = m_private_obj->rowCount;
+	const int cols = qMin(new_values.size(), m_private_obj->columnCount);
+	m_values.resize(rows, m_private_obj->columnCount);
+	for (int col = 0; col < cols; ++col)
+		m_values.writeColumn(col, 0, qMin(new_values.at(col).size(), rows), new_values.at(col).constData());
 }
 
 void MatrixReplaceValuesCmd::redo() {
-	m_old_values = m_private_obj->matrixData;
-	m_private_obj->matrixData = m_new_values;
+	m_private_obj->commitAdapter();
+	m_private_obj->storage.swap(m_values);
 	m_private_obj->emitDataChanged(0, 0, m_private_obj->rowCount -1, m_private_obj->columnCount-1);
 }
 
 void MatrixReplaceValuesCmd::undo() {
-	m_new_values = m_private_obj->matrixData;
-	m_private_obj->matrixData = m_old_values;
+	redo();
+}
+
+
+//set data type
+MatrixSetDataTypeCmd::MatrixSetDataTypeCmd(MatrixPrivate* private_obj, MatrixStorage::DataType type, QUndoCommand* parent)
+ : QUndoCommand(parent), m_private_obj(private_obj), m_type(type), m_backup(type)
+{
+	setText(i18n("%1: change data type", m_private_obj->name()));
+}
+
+void MatrixSetDataTypeCmd::redo() {
+	m_private_obj->commitAdapter();
+	m_backup = m_private_obj->storage;
+	m_private_obj->setDataType(m_type);
+}
+
+void MatrixSetDataTypeCmd::undo() {
+	m_private_obj->storage.swap(m_backup);
 	m_private_obj->emitDataChanged(0, 0, m_private_obj->rowCount -1, m_private_obj->columnCount-1);
+	emit m_private_obj->q->dataTypeChanged(m_private_obj->storage.dataType());
+	m_backup = MatrixStorage(m_type);
 }
@@ -247,8 +247,21 @@ class MatrixReplaceValuesCmd : public QUndoCommand {
 
 	private:
 		MatrixPrivate* m_private_obj;
-		QVector<QVector<double> > m_old_values;
-		QVector<QVector<double> > m_new_values;
+		MatrixStorage m_values; //! The values swapped with the matrix values on redo/undo
+};
+
+
+// Change the element type of the matrix values
+class MatrixSetDataTypeCmd : public QUndoCommand {
+	public:
+		MatrixSetDataTypeCmd(MatrixPrivate* private_obj, MatrixStorage::DataType type, QUndoCommand* parent = 0);
+		virtual void redo();
+		virtual void undo();
+
+	private:
+		MatrixPrivate* m_private_obj;
+		MatrixStorage::DataType m_type; //! The new data type
+		MatrixStorage m_backup; //! Backup of the values before the conversion
 };
 
 
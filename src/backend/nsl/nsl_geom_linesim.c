@@ -35,6 +35,9 @@
 const char* nsl_geom_linesim_type_name[] = {i18n("Douglas-Peucker (number)"), i18n("Douglas-Peucker (tolerance)"), i18n("Visvalingam-Whyatt"), i18n("Reumann-Witkam"), i18n("perpendicular distance"), i18n("n-th point"),
 	i18n("radial distance"), i18n("Interpolation"), i18n("Opheim"), i18n("Lang")};
 
+/* minimal number of points of a Douglas-Peucker span to search its key in parallel */
+#define NSL_GEOM_LINESIM_PARALLEL_SPAN 100000
+
 /*********** error calculation functions *********/
 
 double nsl_geom_linesim_positional_error(const double xdata[], const double ydata[], const size_t n, const size_t index[]) {
@@ -121,31 +124,93 @@ double nsl_geom_linesim_avg_dist_perpoint(const double xdata[], const double yda
 
 /*********** simplification algorithms *********/
 
-void nsl_geom_linesim_douglas_peucker_step(const double xdata[], const double ydata[], const size_t start, const size_t end, size_t *nout, const double tol, size_t index[]) {
-	/*printf("DP: %d - %d\n", start, end);*/
-
-	size_t i, nkey = start;
-	double dist, maxdist = 0;
-	/* search for key (biggest perp. distance) */
-	for (i = start+1; i < end; i++) {
-		dist = nsl_geom_point_line_dist(xdata[start], ydata[start], xdata[end], ydata[end], xdata[i], ydata[i]);
-		if (dist > maxdist) {
-			maxdist=dist;
-			nkey=i;
+/* index of the point in (start, end) with the largest perpendicular distance to the line start -- end.
+	The distances are compared unnormalized and large spans are scanned in parallel if OpenMP is available.
+	The first of several equally distant points is taken. */
+static size_t nsl_geom_linesim_douglas_peucker_key(const double xdata[], const double ydata[], const size_t start, const size_t end, double *maxdist) {
+	const double x1 = xdata[start], y1 = ydata[start];
+	const double dx = xdata[end] - x1, dy = ydata[end] - y1;
+	size_t nkey = start;
+	double max = 0;
+#ifdef _OPENMP
+	if (end - start > NSL_GEOM_LINESIM_PARALLEL_SPAN) {
+#pragma omp parallel
+		{
+			size_t i, key = start;
+			double dist, localmax = 0;
+#pragma omp for schedule(static) nowait
+			for (i = start+1; i < end; i++) {
+				dist = fabs( (xdata[i]-x1)*dy - dx*(ydata[i]-y1) );
+				if (dist > localmax) {
+					localmax = dist;
+					key = i;
+				}
+			}
+#pragma omp critical
+			{
+				if (localmax > max || (localmax == max && localmax > 0 && key < nkey)) {
+					max = localmax;
+					nkey = key;
+				}
+			}
+		}
+	} else
+#endif
+	{
+		size_t i;
+		double dist;
+		for (i = start+1; i < end; i++) {
+			dist = fabs( (xdata[i]-x1)*dy - dx*(ydata[i]-y1) );
+			if (dist > max) {
+				max = dist;
+				nkey = i;
+			}
 		}
 	}
-	/*printf("maxdist = %g @ i = %zu\n", maxdist, nkey);*/
-
-	if (maxdist > tol) {
-		/*printf("take %d\n", nkey);*/
-		index[(*nout)++]=nkey;
-		if (nkey-start > 1)
-			nsl_geom_linesim_douglas_peucker_step(xdata, ydata, start, nkey, nout, tol, index);
-		if (end-nkey > 1)
-			nsl_geom_linesim_douglas_peucker_step(xdata, ydata, nkey, end, nout, tol, index);
+
+	/* all distances are zero for identical end points */
+	*maxdist = (max > 0) ? max/sqrt(dx*dx + dy*dy) : 0;
+	return nkey;
+}
+
+void nsl_geom_linesim_douglas_peucker_step(const double xdata[], const double ydata[], const size_t start, const size_t end, size_t *nout, const double tol, size_t index[]) {
+	/* spans still to be processed, an explicit stack avoids deep recursion on pathological data */
+	size_t size = 64, top = 0;
+	size_t *stack = (size_t *)malloc(2*size*sizeof(size_t));
+	stack[top++] = start;
+	stack[top++] = end;
+
+	while (top > 0) {
+		const size_t spanend = stack[--top];
+		const size_t spanstart = stack[--top];
+		/*printf("DP: %zu - %zu\n", spanstart, spanend);*/
+
+		double maxdist;
+		const size_t nkey = nsl_geom_linesim_douglas_peucker_key(xdata, ydata, spanstart, spanend, &maxdist);
+		/*printf("maxdist = %g @ i = %zu\n", maxdist, nkey);*/
+		if (maxdist <= tol)
+			continue;
+
+		/*printf("take %zu\n", nkey);*/
+		index[(*nout)++] = nkey;
+
+		if (top + 4 > 2*size) {
+			size *= 2;
+			stack = (size_t *)realloc(stack, 2*size*sizeof(size_t));
+		}
+		/* the first half is processed first, as in the recursive version */
+		if (spanend-nkey > 1) {
+			stack[top++] = nkey;
+			stack[top++] = spanend;
+		}
+		if (nkey-spanstart > 1) {
+			stack[top++] = spanstart;
+			stack[top++] = nkey;
+		}
 	}
 
-	/*printf("nout=%d\n", *nout);*/
+	free(stack);
+	/*printf("nout=%zu\n", *nout);*/
 }
 
 size_t nsl_geom_linesim_douglas_peucker(const double xdata[], const double ydata[], const size_t n, const double tol, size_t index[]) {
@@ -410,77 +475,95 @@ size_t nsl_geom_linesim_interp_auto(const double xdata[], const double ydata[],
 	return nsl_geom_linesim_interp(xdata, ydata, n, tol, index);
 }
 
+/* indexed binary min-heap of the points ordered by their area (and index for equal areas) */
+static int nsl_geom_linesim_vw_less(const double area[], const size_t a, const size_t b) {
+	return area[a] < area[b] || (area[a] == area[b] && a < b);
+}
+
+static void nsl_geom_linesim_vw_sift_down(size_t heap[], size_t pos[], const double area[], const size_t size, size_t i) {
+	const size_t point = heap[i];
+	for (;;) {
+		size_t child = 2*i+1;
+		if (child >= size)
+			break;
+		if (child+1 < size && nsl_geom_linesim_vw_less(area, heap[child+1], heap[child]))
+			child++;
+		if (!nsl_geom_linesim_vw_less(area, heap[child], point))
+			break;
+		heap[i] = heap[child];
+		pos[heap[i]] = i;
+		i = child;
+	}
+	heap[i] = point;
+	pos[point] = i;
+}
+
 size_t nsl_geom_linesim_visvalingam_whyatt(const double xdata[], const double ydata[], const size_t n, const double tol, size_t index[]) {
 	if (n < 3)	/* we need at least three points */
 		return 0;
 
-	size_t i, nout = n;
-	double *area = (double *) malloc((n-2)*sizeof(double));	/* area associated with every point */
-	for (i = 0; i < n; i++)
-		index[i] = i;
-	for (i = 1; i < n-1; i++)
-		area[i-1] = nsl_geom_three_point_area(xdata[i-1], ydata[i-1], xdata[i], ydata[i], xdata[i+1], ydata[i+1]);
-
-	double minarea;
-	size_t minindex;
-	while ( (minarea = nsl_stats_minimum(area, n-2, &minindex)) < tol && nout > 2) {
-		/*for (i=0; i < n-2; i++)
-			if (area[i]<DBL_MAX)
-				printf("area[%zu] = %g\n", i, area[i]);
-		*/
-		/* remove point minindex */
-		/*printf("removing point %zu (minindex = %zu, minarea = %g) nout=%zu\n", minindex+1, minindex, minarea, nout-1);*/
-		index[minindex+1] = 0;
-		area[minindex] = DBL_MAX;
+	/* area associated with every point, removed points are unlinked from the list of neighbors prev[]/next[]
+		and the point with the smallest area is taken from the heap in O(log n) */
+	size_t i, nout = n, size = n-2;
+	double *area = (double *) malloc(n*sizeof(double));
+	size_t *prev = (size_t *) malloc(n*sizeof(size_t));
+	size_t *next = (size_t *) malloc(n*sizeof(size_t));
+	size_t *heap = (size_t *) malloc((n-2)*sizeof(size_t));
+	size_t *pos = (size_t *) malloc(n*sizeof(size_t));
+	for (i = 0; i < n; i++) {
+		prev[i] = i-1;
+		next[i] = i+1;
+	}
+	for (i = 1; i < n-1; i++) {
+		area[i] = nsl_geom_three_point_area(xdata[i-1], ydata[i-1], xdata[i], ydata[i], xdata[i+1], ydata[i+1]);
+		heap[i-1] = i;
+		pos[i] = i-1;
+	}
+	for (i = size/2; i > 0; i--)
+		nsl_geom_linesim_vw_sift_down(heap, pos, area, size, i-1);
+
+	while (size > 0 && area[heap[0]] < tol && nout > 2) {
+		/* remove point with minimum area */
+		const size_t point = heap[0];
+		/*printf("removing point %zu (minarea = %g) nout=%zu\n", point, area[point], nout-1);*/
+		heap[0] = heap[--size];
+		pos[heap[0]] = 0;
+		nsl_geom_linesim_vw_sift_down(heap, pos, area, size, 0);
+
+		const size_t before = prev[point], after = next[point];
+		next[before] = after;
+		prev[after] = before;
+
+		/* update area of neighbor points, the area can only grow so the points move down in the heap */
 		double tmparea;
-		/* update area of neigbor points */
-		size_t before = minindex, after = minindex+2;	/* find index before and after */
-		while (index[before] == 0 && before > 0)
-			before--;
-		while (index[after] == 0 && after < n-1)
-			after++;
-		if (minindex > 0) {	/*before */
-			if (before > 0) {
-				size_t beforebefore=before-1;
-				while (index[beforebefore] == 0 && beforebefore > 0)
-					beforebefore--;
-				/*printf("recalculate area[%zu] from %zu %zu %zu\n", before-1, beforebefore, before, after);*/
-				tmparea = nsl_geom_three_point_area(xdata[beforebefore], ydata[beforebefore], xdata[before], ydata[before], xdata[after], ydata[after]);
-				if (tmparea > area[before-1])	/* take largest value of new and old area */
-					area[before-1] = tmparea;
+		if (before > 0) {
+			tmparea = nsl_geom_three_point_area(xdata[prev[before]], ydata[prev[before]], xdata[before], ydata[before], xdata[after], ydata[after]);
+			if (tmparea > area[before]) {	/* take largest value of new and old area */
+				area[before] = tmparea;
+				nsl_geom_linesim_vw_sift_down(heap, pos, area, size, pos[before]);
 			}
 		}
-		if (minindex < n-3) {	/* after */
-			if (after < n-1) {
-				size_t afterafter = after+1;
-				while (index[afterafter] == 0 && afterafter < n-1)
-					afterafter++;
-				/*printf("recalculate area[%zu] from %zu %zu %zu\n",after-1, before, after, afterafter);*/
-				tmparea = nsl_geom_three_point_area(xdata[before], ydata[before], xdata[after], ydata[after], xdata[afterafter], ydata[afterafter]);
-				if (tmparea > area[after-1])	/* take largest value of new and old area */
-					area[after-1] = tmparea;
+		if (after < n-1) {
+			tmparea = nsl_geom_three_point_area(xdata[before], ydata[before], xdata[after], ydata[after], xdata[next[after]], ydata[next[after]]);
+			if (tmparea > area[after]) {
+				area[after] = tmparea;
+				nsl_geom_linesim_vw_sift_down(heap, pos, area, size, pos[after]);
 			}
 		}
 		nout--;
-	};
-
-	/*for(i=0;i<n;i++)
-		printf("INDEX = %d\n", index[i]);
-	*/
-
-	/* condens index */
-	i = 1;
-	size_t newi = 1;
-	while (newi < n-1) {
-		while (index[newi] == 0)
-			newi++;
-		index[i++] = index[newi++];
-	};
+	}
 
-	/*for(i=0;i<nout;i++)
-		printf("INDEX2 = %d\n", index[i]);
-	*/
+	/* collect remaining points */
+	size_t point = 0;
+	for (i = 0; i < nout; i++) {
+		index[i] = point;
+		point = next[point];
+	}
 
+	free(pos);
+	free(heap);
+	free(next);
+	free(prev);
 	free(area);
 	return nout;
 }
@@ -0,0 +1,77 @@
+/***************************************************************************
+    File                 : nsl_geom_linesim_perf_test.c
+    Project              : LabPlot
+    Description          : NSL line simplification performance test
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+#include "nsl_geom_linesim.h"
+
+/* the data of nsl_geom_linesim_test.c repeated along a sine to N points */
+#define N 10000000
+
+static unsigned long long elapsed(struct timeval *time1) {
+	struct timeval time2;
+	gettimeofday(&time2, NULL);
+	return 1000 * (time2.tv_sec - time1->tv_sec) + (time2.tv_usec - time1->tv_usec) / 1000;
+}
+
+int main() {
+	const double xtest[]={1,2,2.5,3,4,7,9,11,13,14};
+	const double ytest[]={1,1,1,3,4,7,8,12,13,13};
+	const size_t ntest=10;
+	size_t i, nout;
+
+	double *xdata = (double *)malloc(N*sizeof(double));
+	double *ydata = (double *)malloc(N*sizeof(double));
+	size_t *index = (size_t *)malloc(N*sizeof(size_t));
+	for (i = 0; i < N; i++) {
+		xdata[i] = xtest[i%ntest] + 14.*(i/ntest);
+		ydata[i] = ytest[i%ntest] + 1000.*sin(2.*M_PI*(i/ntest)/10000.);
+	}
+
+	struct timeval time1;
+
+	printf("* simplification (Douglas Peucker) n = %d\n", N);
+	gettimeofday(&time1, NULL);
+	nout = nsl_geom_linesim_douglas_peucker(xdata, ydata, N, 0.6, index);
+	printf("run time : %llu ms\n", elapsed(&time1));
+	printf("nout = %zu (pos. error = %g, area error = %g)\n", nout, nsl_geom_linesim_positional_squared_error(xdata, ydata, N, index), nsl_geom_linesim_area_error(xdata, ydata, N, index));
+
+	printf("* minimum area (Visvalingam-Whyatt) n = %d\n", N);
+	gettimeofday(&time1, NULL);
+	nout = nsl_geom_linesim_visvalingam_whyatt(xdata, ydata, N, 1.6, index);
+	printf("run time : %llu ms\n", elapsed(&time1));
+	printf("nout = %zu (pos. error = %g, area error = %g)\n", nout, nsl_geom_linesim_positional_squared_error(xdata, ydata, N, index), nsl_geom_linesim_area_error(xdata, ydata, N, index));
+
+	free(index);
+	free(ydata);
+	free(xdata);
+
+	return 0;
+}
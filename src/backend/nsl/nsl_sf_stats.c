@@ -28,6 +28,8 @@
 
 #include "nsl_sf_stats.h"
 #include "nsl_common.h"
+#include <gsl/gsl_randist.h>
+#include <gsl/gsl_math.h>
 
 const char* nsl_sf_stats_distribution_name[] = {i18n("Gaussian (Normal)"), i18n("Gaussian Tail"), i18n("Exponential"), i18n("Laplace"),
 	i18n("Exponential Power"), i18n("Cauchy-Lorentz (Breit-Wigner)"), i18n("Rayleigh"), i18n("Rayleigh Tail"), i18n("Landau"), i18n("Levy alpha-stable"),
@@ -54,3 +56,130 @@ const char* nsl_sf_stats_distribution_equation[] = {
 	"Logarithmic", "a*sqrt(2/pi) * x^2/s^3 * exp(-(x/s)^2/2)", "a/2/s * sech(pi/2*(x-mu)/s)",
 	"a * sqrt(g/(2*pi))/pow(x-mu, 1.5) * exp(-g/2./(x-mu))", "a * g/s*((x-mu)/s)^(-g-1) * exp(-((x-mu)/s)^(-g))"};
 
+/*********** counter-based random number generator *********/
+
+typedef struct {
+	uint64_t key;
+	uint64_t counter;
+} nsl_sf_stats_rng_state;
+
+/* SplitMix64 finalizer */
+static uint64_t nsl_sf_stats_rng_mix(uint64_t z) {
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static uint64_t nsl_sf_stats_rng_next(void* vstate) {
+	nsl_sf_stats_rng_state* state = (nsl_sf_stats_rng_state*)vstate;
+	state->counter++;
+	return nsl_sf_stats_rng_mix(state->key + state->counter * 0x9e3779b97f4a7c15ULL);
+}
+
+static void nsl_sf_stats_rng_set(void* vstate, unsigned long int seed) {
+	nsl_sf_stats_rng_state* state = (nsl_sf_stats_rng_state*)vstate;
+	state->key = nsl_sf_stats_rng_mix((uint64_t)seed);
+	state->counter = 0;
+}
+
+static unsigned long int nsl_sf_stats_rng_get(void* vstate) {
+	return (unsigned long int)(nsl_sf_stats_rng_next(vstate) >> 32);
+}
+
+static double nsl_sf_stats_rng_get_double(void* vstate) {
+	/* 53 random bits in [0,1) */
+	return (double)(nsl_sf_stats_rng_next(vstate) >> 11) * (1.0/9007199254740992.0);
+}
+
+static const gsl_rng_type nsl_sf_stats_rng_counter_type = {"nsl_counter", 0xffffffffUL, 0, sizeof(nsl_sf_stats_rng_state),
+	&nsl_sf_stats_rng_set, &nsl_sf_stats_rng_get, &nsl_sf_stats_rng_get_double};
+
+const gsl_rng_type* nsl_sf_stats_rng_counter = &nsl_sf_stats_rng_counter_type;
+
+void nsl_sf_stats_rng_set_stream(gsl_rng* r, uint64_t seed, uint64_t stream, uint64_t substream) {
+	nsl_sf_stats_rng_state* state = (nsl_sf_stats_rng_state*)r->state;
+	uint64_t key = nsl_sf_stats_rng_mix(seed);
+	key = nsl_sf_stats_rng_mix(key ^ (stream + 0x9e3779b97f4a7c15ULL));
+	key = nsl_sf_stats_rng_mix(key ^ (substream + 0x632be59bd9b4e019ULL));
+
+	state->key = key;
+	state->counter = 0;
+}
+
+double nsl_sf_stats_distribution_random(const gsl_rng* r, nsl_sf_stats_distribution d, double p1, double p2, double p3) {
+	switch (d) {
+	case nsl_sf_stats_gaussian:		/* sigma, mu */
+		return gsl_ran_gaussian(r, p1) + p2;
+	case nsl_sf_stats_gaussian_tail:	/* mu, sigma, a */
+		return gsl_ran_gaussian_tail(r, p3, p2) + p1;
+	case nsl_sf_stats_exponential:		/* lambda, GSL uses the inverse */
+		return gsl_ran_exponential(r, 1./p1);
+	case nsl_sf_stats_laplace:		/* sigma, mu */
+		return gsl_ran_laplace(r, p1) + p2;
+	case nsl_sf_stats_exponential_power:	/* mu, a, b */
+		return gsl_ran_exppow(r, p2, p3) + p1;
+	case nsl_sf_stats_cauchy_lorentz:	/* gamma, mu */
+		return gsl_ran_cauchy(r, p1) + p2;
+	case nsl_sf_stats_rayleigh:		/* sigma */
+		return gsl_ran_rayleigh(r, p1);
+	case nsl_sf_stats_rayleigh_tail:	/* sigma, a */
+		return gsl_ran_rayleigh_tail(r, p2, p1);
+	case nsl_sf_stats_landau:
+		return gsl_ran_landau(r);
+	case nsl_sf_stats_levy_alpha_stable:	/* c, alpha */
+		return gsl_ran_levy(r, p1, p2);
+	case nsl_sf_stats_levy_skew_alpha_stable:	/* c, alpha, beta */
+		return gsl_ran_levy_skew(r, p1, p2, p3);
+	case nsl_sf_stats_gamma:		/* theta, k */
+		return gsl_ran_gamma(r, p2, p1);
+	case nsl_sf_stats_flat:			/* a, b */
+		return gsl_ran_flat(r, p1, p2);
+	case nsl_sf_stats_lognormal:		/* sigma, mu */
+		return gsl_ran_lognormal(r, p2, p1);
+	case nsl_sf_stats_chi_squared:		/* n */
+		return gsl_ran_chisq(r, p1);
+	case nsl_sf_stats_fdist:		/* nu1, nu2 */
+		return gsl_ran_fdist(r, p1, p2);
+	case nsl_sf_stats_tdist:		/* nu */
+		return gsl_ran_tdist(r, p1);
+	case nsl_sf_stats_beta:			/* a, b */
+		return gsl_ran_beta(r, p1, p2);
+	case nsl_sf_stats_logistic:		/* sigma, mu */
+		return gsl_ran_logistic(r, p1) + p2;
+	case nsl_sf_stats_pareto:		/* a, b */
+		return gsl_ran_pareto(r, p1, p2);
+	case nsl_sf_stats_weibull:		/* k, lambda, mu */
+		return gsl_ran_weibull(r, p2, p1) + p3;
+	case nsl_sf_stats_gumbel1:		/* sigma, beta, mu */
+		return gsl_ran_gumbel1(r, 1./p1, p2) + p3;
+	case nsl_sf_stats_gumbel2:		/* a, b */
+		return gsl_ran_gumbel2(r, p1, p2);
+	case nsl_sf_stats_poisson:		/* lambda */
+		return gsl_ran_poisson(r, p1);
+	case nsl_sf_stats_bernoulli:		/* p */
+		return gsl_ran_bernoulli(r, p1);
+	case nsl_sf_stats_binomial:		/* p, n */
+		return gsl_ran_binomial(r, p1, (unsigned int)p2);
+	case nsl_sf_stats_negative_bionomial:	/* p, n */
+		return gsl_ran_negative_binomial(r, p1, p2);
+	case nsl_sf_stats_pascal:		/* p, n */
+		return gsl_ran_pascal(r, p1, (unsigned int)p2);
+	case nsl_sf_stats_geometric:		/* p */
+		return gsl_ran_geometric(r, p1);
+	case nsl_sf_stats_hypergeometric:	/* n1, n2, t */
+		return gsl_ran_hypergeometric(r, (unsigned int)p1, (unsigned int)p2, (unsigned int)p3);
+	case nsl_sf_stats_logarithmic:		/* p */
+		return gsl_ran_logarithmic(r, p1);
+	/* additional non-GSL distributions */
+	case nsl_sf_stats_maxwell_boltzmann:	/* s: norm of three normal distributed components */
+		return p1 * sqrt(gsl_ran_chisq(r, 3.));
+	case nsl_sf_stats_sech:			/* sigma, mu: inverse of the cumulative distribution */
+		return p2 + p1 * M_2_PI * log(tan(M_PI_2 * gsl_rng_uniform_pos(r)));
+	case nsl_sf_stats_levy:			/* g, mu: inverse squared normal distribution */
+		return p2 + p1 / gsl_pow_2(gsl_ran_ugaussian(r));
+	case nsl_sf_stats_frechet:		/* g, s, mu: inverse of the cumulative distribution */
+		return p3 + p2 * pow(-log(gsl_rng_uniform_pos(r)), -1./p1);
+	}
+
+	return NAN;
+}
@@ -29,6 +29,9 @@
 #ifndef NSL_SF_STATS_H
 #define NSL_SF_STATS_H
 
+#include <stdint.h>
+#include <gsl/gsl_rng.h>
+
 #define NSL_SF_STATS_DISTRIBUTION_COUNT 35
 #define NSL_SF_STATS_DISTRIBUTION_RNG_COUNT 31	/* GSL RNG distributions */
 /* ordered as defined in GSL random number distributions */
@@ -45,4 +48,22 @@ extern const char* nsl_sf_stats_distribution_name[];
 extern const char* nsl_sf_stats_distribution_pic_name[];
 extern const char* nsl_sf_stats_distribution_equation[];
 
+/* counter-based random number generator (SplitMix64 output function)
+	Every generator produces an independent stream selected by nsl_sf_stats_rng_set_stream().
+	Use with gsl_rng_alloc(nsl_sf_stats_rng_counter).
+*/
+extern const gsl_rng_type* nsl_sf_stats_rng_counter;
+
+/* select the stream of a generator of type nsl_sf_stats_rng_counter
+	seed: user given seed
+	stream, substream: e.g. column and block of rows
+	the same (seed, stream, substream) always gives the same sequence
+*/
+void nsl_sf_stats_rng_set_stream(gsl_rng* r, uint64_t seed, uint64_t stream, uint64_t substream);
+
+/* random number of distribution d
+	p1, p2, p3: parameters of the distribution in the order shown in the random values dialog
+*/
+double nsl_sf_stats_distribution_random(const gsl_rng* r, nsl_sf_stats_distribution d, double p1, double p2, double p3);
+
 #endif /* NSL_SF_STATS_H */
@@ -28,6 +28,9 @@
 
 #include "nsl_sort.h"
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
 
 int nsl_sort_compare_size_t(const void* a, const void* b) {
 	size_t _a = * ( (size_t*) a );
@@ -41,3 +44,89 @@ void nsl_sort_size_t(size_t array[], const size_t n) {
 	qsort(array, n, sizeof(size_t), nsl_sort_compare_size_t);
 }
 
+
+/* maps a double to an unsigned integer with the same order, NaN is mapped to the largest value */
+static uint64_t nsl_sort_double_key(double value, int ascending) {
+	uint64_t bits;
+	if (isnan(value))
+		return UINT64_MAX;
+
+	if (value == 0.)	/* -0 and +0 are equal */
+		value = 0.;
+
+	memcpy(&bits, &value, sizeof(bits));
+	if (bits & 0x8000000000000000ULL)	/* negative: reverse order of all bits */
+		bits = ~bits;
+	else					/* positive: put in front of the negative values */
+		bits |= 0x8000000000000000ULL;
+
+	if (!ascending) {
+		bits = ~bits;
+		if (bits == UINT64_MAX)	/* keep UINT64_MAX for NaN */
+			bits--;
+	}
+
+	return bits;
+}
+
+#define NSL_SORT_RADIX_BITS 11
+#define NSL_SORT_RADIX_SIZE (1 << NSL_SORT_RADIX_BITS)
+#define NSL_SORT_RADIX_MASK (NSL_SORT_RADIX_SIZE - 1)
+
+int nsl_sort_radix_index(const double data[], size_t index[], const size_t n, int ascending) {
+	size_t i;
+	unsigned int shift;
+	uint64_t *keys, *keys_tmp;
+	size_t *index_tmp, *count;
+
+	if (n < 2)
+		return 0;
+
+	keys = (uint64_t *)malloc(2 * n * sizeof(uint64_t));
+	index_tmp = (size_t *)malloc(n * sizeof(size_t));
+	count = (size_t *)malloc(NSL_SORT_RADIX_SIZE * sizeof(size_t));
+	if (keys == NULL || index_tmp == NULL || count == NULL) {
+		free(keys);
+		free(index_tmp);
+		free(count);
+		return -1;
+	}
+	keys_tmp = keys + n;
+
+	/* structure of arrays: the keys are stored contiguously next to the index */
+	for (i = 0; i < n; i++)
+		keys[i] = nsl_sort_double_key(data[index[i]], ascending);
+
+	/* LSD radix sort, stable in every pass */
+	for (shift = 0; shift < 64; shift += NSL_SORT_RADIX_BITS) {
+		size_t sum = 0;
+		memset(count, 0, NSL_SORT_RADIX_SIZE * sizeof(size_t));
+		for (i = 0; i < n; i++)
+			count[(keys[i] >> shift) & NSL_SORT_RADIX_MASK]++;
+
+		/* skip the pass if all keys have the same digit */
+		if (count[(keys[0] >> shift) & NSL_SORT_RADIX_MASK] == n)
+			continue;
+
+		for (i = 0; i < NSL_SORT_RADIX_SIZE; i++) {
+			size_t c = count[i];
+			count[i] = sum;
+			sum += c;
+		}
+
+		for (i = 0; i < n; i++) {
+			size_t pos = count[(keys[i] >> shift) & NSL_SORT_RADIX_MASK]++;
+			keys_tmp[pos] = keys[i];
+			index_tmp[pos] = index[i];
+		}
+
+		memcpy(keys, keys_tmp, n * sizeof(uint64_t));
+		memcpy(index, index_tmp, n * sizeof(size_t));
+	}
+
+	free(keys);
+	free(index_tmp);
+	free(count);
+
+	return 0;
+}
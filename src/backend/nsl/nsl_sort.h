@@ -37,4 +37,12 @@ int nsl_sort_compare_size_t(const void* a, const void* b);
 /* sort size_t array of size n */
 void nsl_sort_size_t(size_t array[], const size_t n);
 
+/* stable radix sort of the index array index[] of size n by the keys data[index[i]]
+	data: key values (only accessed through index[])
+	ascending: sort ascending (1) or descending (0)
+	NaN values are always put at the end, rows with equal keys keep their order
+	returns 0 on success, -1 if no memory could be allocated
+*/
+int nsl_sort_radix_index(const double data[], size_t index[], const size_t n, int ascending);
+
 #endif /* NSL_SORT_H */
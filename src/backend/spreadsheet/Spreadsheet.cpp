@@ -30,17 +30,27 @@
 #include "Spreadsheet.h"
 #include "backend/core/AspectPrivate.h"
 #include "backend/core/AbstractAspect.h"
+#include "backend/core/column/DateTimeData.h"
+#include "backend/core/column/TextData.h"
 #include "commonfrontend/spreadsheet/SpreadsheetView.h"
 #include "kdefrontend/spreadsheet/ExportSpreadsheetDialog.h"
 
 #include <QPrinter>
 #include <QPrintDialog>
 #include <QPrintPreviewDialog>
+#include <QRunnable>
+#include <QThreadPool>
 
 #include <KIcon>
 #include <KConfigGroup>
 #include <KLocale>
 
+#include <algorithm>
+
+extern "C" {
+#include "backend/nsl/nsl_sort.h"
+}
+
 /*!
   \class Spreadsheet
   \brief Aspect providing a spreadsheet table with column logic.
@@ -430,233 +440,174 @@ int Spreadsheet::colY(int col)
 	return -1;
 }
 
+//! orders row indices by double keys, NaN values are put at the end
+class DoubleIndexLess {
+public:
+	DoubleIndexLess(const double* keys, bool ascending) : m_keys(keys), m_ascending(ascending) {}
+	bool operator()(size_t a, size_t b) const {
+		const double x = m_keys[a];
+		const double y = m_keys[b];
+		if (std::isnan(y))
+			return !std::isnan(x);
+		if (std::isnan(x))
+			return false;
+		return m_ascending ? (x < y) : (x > y);
+	}
+
+private:
+	const double* m_keys;
+	bool m_ascending;
+};
+
+//! orders row indices by string keys
+class StringIndexLess {
+public:
+	StringIndexLess(const QStringList& keys, bool ascending) : m_keys(keys), m_ascending(ascending) {}
+	bool operator()(size_t a, size_t b) const {
+		return m_ascending ? (m_keys.at(a) < m_keys.at(b)) : (m_keys.at(b) < m_keys.at(a));
+	}
+
+private:
+	const QStringList& m_keys;
+	bool m_ascending;
+};
+
+//! sorts a chunk of the index array, radix sort for double keys and stable merge sort for strings
+class SortChunkTask : public QRunnable {
+public:
+	SortChunkTask(size_t* index, size_t count, const double* doubleKeys, const QStringList* stringKeys, bool ascending)
+		: m_index(index), m_count(count), m_doubleKeys(doubleKeys), m_stringKeys(stringKeys), m_ascending(ascending) {}
+
+	void run() {
+		if (m_doubleKeys) {
+			if (nsl_sort_radix_index(m_doubleKeys, m_index, m_count, m_ascending) == 0)
+				return;
+			//not enough memory for the radix sort
+			std::stable_sort(m_index, m_index + m_count, DoubleIndexLess(m_doubleKeys, m_ascending));
+		} else
+			std::stable_sort(m_index, m_index + m_count, StringIndexLess(*m_stringKeys, m_ascending));
+	}
+
+private:
+	size_t* m_index;
+	size_t m_count;
+	const double* m_doubleKeys;
+	const QStringList* m_stringKeys;
+	bool m_ascending;
+};
+
+/*!
+	determines the permutation sorting the rows of \c col. Rows with equal values keep their order.
+	The rows are sorted in chunks in parallel, the sorted chunks are merged afterwards.
+*/
+static QVector<int> sortPermutation(const Column* col, bool ascending) {
+	const int rows = col->rowCount();
+
+	//the sort keys as a contiguous array, date-times are sorted by their milliseconds since epoch
+	//and dictionary encoded texts by the rank of their string in the sorted dictionary
+	QVector<double> doubleKeys;
+	QStringList stringKeys;
+	bool sortStrings = false;
+	switch (col->columnMode()) {
+		case AbstractColumn::Numeric:
+			doubleKeys = *static_cast<QVector<double>*>(col->data());
+			break;
+		case AbstractColumn::Text: {
+			const TextData* data = static_cast<TextData*>(col->data());
+			if (!data->isEncoded()) {
+				stringKeys = data->strings();
+				sortStrings = true;
+				break;
+			}
+
+			const QStringList& dictionary = data->dictionary();
+			QVector<size_t> order(dictionary.size());
+			for (int i = 0; i < dictionary.size(); ++i)
+				order[i] = i;
+			std::sort(order.begin(), order.end(), StringIndexLess(dictionary, true));
+
+			QVector<double> rank(dictionary.size());
+			for (int i = 0; i < order.size(); ++i)
+				rank[order.at(i)] = i;
+
+			doubleKeys.resize(rows);
+			const QVector<quint32>& codes = data->codes();
+			for (int i = 0; i < rows; ++i)
+				doubleKeys[i] = rank.at(codes.at(i));
+			break;
+		}
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day: {
+			doubleKeys.resize(rows);
+			const QVector<qint64>& msecs = static_cast<DateTimeData*>(col->data())->msecs();
+			for (int i = 0; i < rows; ++i)
+				doubleKeys[i] = (msecs.at(i) != DateTimeData::invalidMSecs) ? (double)msecs.at(i) : NAN;
+			break;
+		}
+	}
+
+	const double* keys = sortStrings ? 0 : doubleKeys.constData();
+	QVector<size_t> index(rows);
+	for (int i = 0; i < rows; ++i)
+		index[i] = i;
+
+	QThreadPool pool;
+	const int chunks = (rows > 100000) ? pool.maxThreadCount() : 1;
+	const int chunkSize = rows/chunks + 1;
+	QVector<int> bounds;
+	for (int first = 0; first < rows; first += chunkSize) {
+		bounds << first;
+		pool.start(new SortChunkTask(index.data() + first, qMin(chunkSize, rows - first), keys, &stringKeys, ascending));
+	}
+	bounds << rows;
+	pool.waitForDone();
+
+	//merge neighbouring sorted chunks until only one is left
+	while (bounds.size() > 2) {
+		QVector<int> merged;
+		for (int i = 0; i + 2 < bounds.size(); i += 2) {
+			size_t* data = index.data();
+			if (keys)
+				std::inplace_merge(data + bounds.at(i), data + bounds.at(i+1), data + bounds.at(i+2), DoubleIndexLess(keys, ascending));
+			else
+				std::inplace_merge(data + bounds.at(i), data + bounds.at(i+1), data + bounds.at(i+2), StringIndexLess(stringKeys, ascending));
+			merged << bounds.at(i);
+		}
+		if (bounds.size() % 2 == 0)
+			merged << bounds.at(bounds.size() - 2);
+		merged << rows;
+		bounds = merged;
+	}
+
+	QVector<int> permutation(rows);
+	for (int i = 0; i < rows; ++i)
+		permutation[i] = index.at(i);
+
+	return permutation;
+}
+
 /*! Sorts the given list of column.
   If 'leading' is a null pointer, each column is sorted separately.
+  Otherwise the rows of all columns are reordered according to the sorted order of 'leading'.
+  Only the permutation of the rows is stored in the undo stack.
 */
 void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascending)
 {
 	if(cols.isEmpty()) return;
 
-	// the normal QPair comparison does not work properly with descending sorting
-	// thefore we use our own compare functions
-	class CompareFunctions {
-		public:
-			static bool doubleLess(const QPair<double, int>& a, const QPair<double, int>& b)
-			{
-				return a.first < b.first;
-			}
-			static bool doubleGreater(const QPair<double, int>& a, const QPair<double, int>& b)
-			{
-				return a.first > b.first;
-			}
-			static bool QStringLess(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a < b;
-			}
-			static bool QStringGreater(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a > b;
-			}
-			static bool QDateTimeLess(const QPair<QDateTime, int>& a, const QPair<QDateTime, int>& b)
-			{
-				return a < b;
-			}
-			static bool QDateTimeGreater(const QPair<QDateTime, int>& a, const QPair<QDateTime, int>& b)
-			{
-				return a > b;
-			}
-	};
-
 	WAIT_CURSOR;
 	beginMacro(i18n("%1: sort columns", name()));
 
 	if(leading == 0) { // sort separately
-		foreach(Column *col, cols) {
-			switch (col->columnMode()) {
-				case AbstractColumn::Numeric:
-					{
-						int rows = col->rowCount();
-						QList< QPair<double, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<double, int>(col->valueAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::doubleGreater);
-
-						QListIterator< QPair<double, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
-					}
-				case AbstractColumn::Text:
-					{
-						int rows = col->rowCount();
-						QList< QPair<QString, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<QString, int>(col->textAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-
-						QListIterator< QPair<QString, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
-					}
-				case AbstractColumn::DateTime:
-				case AbstractColumn::Month:
-				case AbstractColumn::Day:
-					{
-						int rows = col->rowCount();
-						QList< QPair<QDateTime, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<QDateTime, int>(col->dateTimeAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeGreater);
-
-						QListIterator< QPair<QDateTime, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
-					}
-			}
-		}
+		foreach(Column *col, cols)
+			col->permuteRows(sortPermutation(col, ascending));
 	} else { // sort with leading column
-		switch (leading->columnMode()) {
-			case AbstractColumn::Numeric:
-				{
-					QList< QPair<double, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<double, int>(leading->valueAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::doubleGreater);
-					QListIterator< QPair<double, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-					}
-					break;
-				}
-			case AbstractColumn::Text:
-				{
-					QList< QPair<QString, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<QString, int>(leading->textAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-					QListIterator< QPair<QString, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-					}
-					break;
-				}
-			case AbstractColumn::DateTime:
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
-				{
-					QList< QPair<QDateTime, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<QDateTime, int>(leading->dateTimeAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeGreater);
-					QListIterator< QPair<QDateTime, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-					}
-					break;
-				}
-		}
+		const QVector<int> permutation = sortPermutation(leading, ascending);
+		foreach (Column *col, cols)
+			col->permuteRows(permutation);
 	}
+
 	endMacro();
 	RESET_CURSOR;
 } // end of sortColumns()
@@ -31,10 +31,14 @@
 #include "backend/core/column/Column.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/spreadsheet/SpreadsheetModel.h"
+#include "backend/core/datatypes/Double2StringFilter.h"
+#include "backend/lib/Interval.h"
 
 #include <QBrush>
 #include <QIcon>
 #include <QFontMetrics>
+#include <QLocale>
+#include <QRunnable>
 
 #include <KLocale>
 
@@ -50,10 +54,73 @@
 	is obtained by calling Spreadsheet::column() and the manipulation is done using the
 	public API of column.
 
+	The formatted cell strings together with the validity and masking flags are cached
+	per column in blocks of rows (LRU, see QCache). The cache of a column is dropped
+	when the data, the format, the masking or the number of rows of the column change.
+	The blocks around the visible rows can be created in advance on a background thread
+	via prefetch().
+
 	\ingroup backend
 */
+
+//number of rows in one cached block
+static const int CacheBlockSize = 256;
+//maximal number of cached blocks per column
+static const int CacheMaxBlocks = 64;
+
+/*!
+	creates the cached cells for the blocks of a numeric column in a background thread.
+	The task only works on a snapshot of the column values taken in the main thread,
+	modifications of the column in the main thread detach from this snapshot.
+*/
+class SpreadsheetPrefetchTask : public QRunnable {
+public:
+	SpreadsheetPrefetchTask(SpreadsheetModel* model, const Column* column, quint64 generation, const QList<int>& blocks)
+		: m_model(model), m_column(column), m_generation(generation), m_blocks(blocks),
+		m_values(column->values()),
+		m_maskedIntervals(column->maskedIntervals()) {
+
+		const Double2StringFilter* filter = static_cast<Double2StringFilter*>(column->outputFilter());
+		m_format = filter->numericFormat();
+		m_digits = filter->numDigits();
+	}
+
+	void run() {
+		QList<SpreadsheetModel::PrefetchResult> results;
+		foreach (int block, m_blocks) {
+			const int first = block*CacheBlockSize;
+			const int count = qMin(CacheBlockSize, m_values.size() - first);
+			if (count <= 0)
+				continue;
+
+			SpreadsheetModel::PrefetchResult result;
+			result.column = m_column;
+			result.generation = m_generation;
+			result.block = block;
+			SpreadsheetModel::fillNumericBlock(result.cells, m_values, first, count, m_format, m_digits, m_maskedIntervals);
+			results << result;
+		}
+
+		m_model->m_prefetchMutex.lock();
+		m_model->m_prefetchResults << results;
+		m_model->m_prefetchMutex.unlock();
+		QMetaObject::invokeMethod(m_model, "handlePrefetchFinished", Qt::QueuedConnection);
+	}
+
+private:
+	SpreadsheetModel* m_model;
+	const AbstractColumn* m_column; //only used as the key, not accessed in run()
+	quint64 m_generation;
+	QList<int> m_blocks;
+	const ColumnValues m_values;
+	const QList< Interval<int> > m_maskedIntervals;
+	char m_format;
+	int m_digits;
+};
+
 SpreadsheetModel::SpreadsheetModel(Spreadsheet* spreadsheet)
-	: QAbstractItemModel(0), m_spreadsheet(spreadsheet), m_formula_mode(false) {
+	: QAbstractItemModel(0), m_spreadsheet(spreadsheet), m_formula_mode(false), m_cacheGeneration(0) {
+	m_prefetchPool.setMaxThreadCount(1);
 	updateVerticalHeader();
 	updateHorizontalHeader();
 
@@ -74,6 +141,11 @@ SpreadsheetModel::SpreadsheetModel(Spreadsheet* spreadsheet)
 	}
 }
 
+SpreadsheetModel::~SpreadsheetModel() {
+	m_prefetchPool.waitForDone();
+	qDeleteAll(m_cellCache);
+}
+
 Qt::ItemFlags SpreadsheetModel::flags(const QModelIndex& index) const {
 	if (index.isValid())
 		return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
@@ -94,21 +166,23 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 
 	switch(role) {
 		case Qt::ToolTipRole: {
-			if(col_ptr->isValid(row)) {
-				if(col_ptr->isMasked(row))
-					return QVariant(i18n("%1, masked (ignored in all operations)").arg(col_ptr->asStringColumn()->textAt(row)));
+			const CachedCell& cell = cachedCell(col_ptr, row);
+			if(cell.valid) {
+				if(cell.masked)
+					return QVariant(i18n("%1, masked (ignored in all operations)").arg(cell.text));
 				else
-					return QVariant(col_ptr->asStringColumn()->textAt(row));
+					return QVariant(cell.text);
 			} else {
-				if(col_ptr->isMasked(row))
+				if(cell.masked)
 					return QVariant(i18n("invalid cell, masked (ignored in all operations)"));
 				else
 					return QVariant(i18n("invalid cell (ignored in all operations)"));
 			}
 		}
 		case Qt::EditRole: {
-			if(col_ptr->isValid(row))
-				return QVariant(col_ptr->asStringColumn()->textAt(row));
+			const CachedCell& cell = cachedCell(col_ptr, row);
+			if(cell.valid)
+				return QVariant(cell.text);
 
 			//m_formula_mode is not used at the moment
 			//if(m_formula_mode)
@@ -117,21 +191,23 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 			return QVariant();
 		}
 		case Qt::DisplayRole: {
-			if(!col_ptr->isValid(row))
+			const CachedCell& cell = cachedCell(col_ptr, row);
+			if(!cell.valid)
 				return QVariant("-");
 
 			//m_formula_mode is not used at the moment
 			//if(m_formula_mode)
 			//	return QVariant(col_ptr->formula(row));
 
-			return QVariant(col_ptr->asStringColumn()->textAt(row));
+			return QVariant(cell.text);
 		}
 		case Qt::ForegroundRole: {
-			if(!col_ptr->isValid(index.row()))
+			if(!cachedCell(col_ptr, row).valid)
 				return QVariant(QBrush(Qt::red));
+			return QVariant();
 		}
 		case MaskingRole:
-			return QVariant(col_ptr->isMasked(row));
+			return QVariant(cachedCell(col_ptr, row).masked);
 		case FormulaRole:
 			return QVariant(col_ptr->formula(row));
 // 		case Qt::DecorationRole:
@@ -253,7 +329,9 @@ void SpreadsheetModel::handleAspectAdded(const AbstractAspect * aspect) {
 	connect(col, SIGNAL(modeChanged(const AbstractColumn*)), this,
 	        SLOT(handleDataChange(const AbstractColumn*)));
 	connect(col, SIGNAL(dataChanged(const AbstractColumn*)), this,
-	        SLOT(handleDataChange(const AbstractColumn*)));
+	        SLOT(handleValuesChange(const AbstractColumn*)));
+	connect(col, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this,
+	        SLOT(handleRowsChange(const AbstractColumn*,int,int)));
 	connect(col, SIGNAL(modeChanged(const AbstractColumn*)), this,
 	        SLOT(handleModeChange(const AbstractColumn*)));
 	connect(col, SIGNAL(rowsInserted(const AbstractColumn*,int,int)), this,
@@ -280,6 +358,8 @@ void SpreadsheetModel::handleAspectAboutToBeRemoved(const AbstractAspect* aspect
 	int index = m_spreadsheet->indexOfChild<Column>(col);
 	beginRemoveColumns(QModelIndex(), index, index);
 	disconnect(col, 0, this, 0);
+	invalidateCache(col);
+	delete m_cellCache.take(col);
 }
 
 void SpreadsheetModel::handleAspectRemoved(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* child) {
@@ -323,12 +403,31 @@ void SpreadsheetModel::handlePlotDesignationChange(const AbstractColumn* col) {
 }
 
 void SpreadsheetModel::handleDataChange(const AbstractColumn* col) {
+	invalidateCache(col);
 	int i = m_spreadsheet->indexOfChild<Column>(col);
 	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
 }
 
+/*!
+	drops the cached cells of the column on every change of its values, the views are updated
+	once per event loop turn for the merged range of the changed rows in handleRowsChange().
+*/
+void SpreadsheetModel::handleValuesChange(const AbstractColumn* col) {
+	invalidateCache(col);
+}
+
+void SpreadsheetModel::handleRowsChange(const AbstractColumn* col, int first, int last) {
+	int i = m_spreadsheet->indexOfChild<Column>(col);
+	last = qMin(last, col->rowCount() - 1);
+	if (i < 0 || first > last)
+		return;
+
+	emit dataChanged(index(first, i), index(last, i));
+}
+
 void SpreadsheetModel::handleRowsInserted(const AbstractColumn* col, int before, int count) {
 	Q_UNUSED(before) Q_UNUSED(count)
+	invalidateCache(col);
 	updateVerticalHeader();
 	int i = m_spreadsheet->indexOfChild<Column>(col);
 	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
@@ -337,6 +436,7 @@ void SpreadsheetModel::handleRowsInserted(const AbstractColumn* col, int before,
 
 void SpreadsheetModel::handleRowsRemoved(const AbstractColumn* col, int first, int count) {
 	Q_UNUSED(first) Q_UNUSED(count)
+	invalidateCache(col);
 	updateVerticalHeader();
 	int i = m_spreadsheet->indexOfChild<Column>(col);
 	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
@@ -417,3 +517,168 @@ void SpreadsheetModel::activateFormulaMode(bool on) {
 bool SpreadsheetModel::formulaModeActive() const {
 	return m_formula_mode;
 }
+
+/*!
+	creates in a background thread the cached cells of the numeric columns
+	for the rows \c firstRow to \c lastRow and for one page of rows above and below.
+	Called by the view when the visible rows change.
+*/
+void SpreadsheetModel::prefetch(int firstRow, int lastRow) {
+	if (firstRow < 0 || lastRow < firstRow)
+		return;
+
+	const int page = lastRow - firstRow + 1;
+	const int firstBlock = qMax(0, firstRow - page)/CacheBlockSize;
+	const int lastBlock = (lastRow + page)/CacheBlockSize;
+
+	foreach (const Column* col, m_spreadsheet->children<Column>()) {
+		if (col->columnMode() != AbstractColumn::Numeric)
+			continue;
+
+		ColumnCache* cache = m_cellCache.value(col);
+		if (!cache) {
+			cache = new ColumnCache(CacheMaxBlocks);
+			cache->generation = ++m_cacheGeneration;
+			m_cellCache.insert(col, cache);
+		}
+
+		const int blockCount = (col->rowCount() + CacheBlockSize - 1)/CacheBlockSize;
+		QList<int> blocks;
+		for (int block = firstBlock; block <= lastBlock && block < blockCount; ++block) {
+			if (!cache->blocks.contains(block) && !cache->pendingBlocks.contains(block)) {
+				blocks << block;
+				cache->pendingBlocks.insert(block);
+			}
+		}
+
+		if (!blocks.isEmpty())
+			m_prefetchPool.start(new SpreadsheetPrefetchTask(this, col, cache->generation, blocks));
+	}
+}
+
+/*!
+	moves the cells created in the background thread into the cache.
+	Blocks of columns that were changed or removed in the meantime are discarded.
+*/
+void SpreadsheetModel::handlePrefetchFinished() {
+	m_prefetchMutex.lock();
+	QList<PrefetchResult> results = m_prefetchResults;
+	m_prefetchResults.clear();
+	m_prefetchMutex.unlock();
+
+	foreach (const PrefetchResult& result, results) {
+		ColumnCache* cache = m_cellCache.value(result.column);
+		if (!cache || cache->generation != result.generation)
+			continue;
+
+		cache->pendingBlocks.remove(result.block);
+		if (!cache->blocks.contains(result.block))
+			cache->blocks.insert(result.block, new CellBlock(result.cells));
+	}
+}
+
+/*!
+	returns the cached cell for the row \c row of the column \c col.
+	The block containing the row is created if not available yet.
+*/
+SpreadsheetModel::CachedCell SpreadsheetModel::cachedCell(const Column* col, int row) const {
+	ColumnCache* cache = m_cellCache.value(col);
+	if (!cache) {
+		cache = new ColumnCache(CacheMaxBlocks);
+		cache->generation = ++m_cacheGeneration;
+		m_cellCache.insert(col, cache);
+	}
+
+	const int block = row/CacheBlockSize;
+	const int offset = row - block*CacheBlockSize;
+	CellBlock* cells = cache->blocks.object(block);
+	if (!cells || offset >= cells->size()) {
+		cells = new CellBlock(createBlock(col, block));
+		cache->blocks.insert(block, cells);
+		if (offset >= cells->size()) {
+			CachedCell cell;
+			cell.valid = false;
+			cell.masked = false;
+			return cell;
+		}
+	}
+
+	return cells->at(offset);
+}
+
+/*!
+	creates the cached cells for the block \c block of the column \c col.
+*/
+SpreadsheetModel::CellBlock SpreadsheetModel::createBlock(const Column* col, int block) const {
+	const int first = block*CacheBlockSize;
+	const int count = qMin(CacheBlockSize, col->rowCount() - first);
+	CellBlock cells;
+	if (count <= 0)
+		return cells;
+
+	if (col->columnMode() == AbstractColumn::Numeric) {
+		const Double2StringFilter* filter = static_cast<Double2StringFilter*>(col->outputFilter());
+		fillNumericBlock(cells, col->values(), first, count,
+		                 filter->numericFormat(), filter->numDigits(), col->maskedIntervals());
+		return cells;
+	}
+
+	cells.resize(count);
+	const ColumnStringIO* stringIO = col->asStringColumn();
+	for (int i = 0; i < count; ++i) {
+		CachedCell& cell = cells[i];
+		cell.valid = col->isValid(first + i);
+		cell.masked = col->isMasked(first + i);
+		if (cell.valid)
+			cell.text = stringIO->textAt(first + i);
+	}
+
+	return cells;
+}
+
+/*!
+	formats \c count values starting at \c first like Double2StringFilter does,
+	with one QLocale for the whole block. Safe to be called from a background thread.
+*/
+void SpreadsheetModel::fillNumericBlock(CellBlock& cells, const ColumnValues& values, int first, int count,
+                                        char format, int digits, const QList< Interval<int> >& maskedIntervals) {
+	const QLocale locale;
+	const Interval<int> range(first, first + count - 1);
+	QList< Interval<int> > masked;
+	foreach (const Interval<int>& interval, maskedIntervals) {
+		if (interval.intersects(range) || range.contains(interval))
+			masked << interval;
+	}
+
+	cells.resize(count);
+	for (int i = 0; i < count; ++i) {
+		const int row = first + i;
+		const double value = values.at(row);
+		CachedCell& cell = cells[i];
+		cell.valid = !std::isnan(value);
+		if (cell.valid)
+			cell.text = locale.toString(value, format, digits);
+
+		cell.masked = false;
+		foreach (const Interval<int>& interval, masked) {
+			if (interval.contains(row)) {
+				cell.masked = true;
+				break;
+			}
+		}
+	}
+}
+
+/*!
+	drops all cached cells of the column \c col. Blocks of this column that are still
+	being created in the background are discarded when they arrive.
+*/
+void SpreadsheetModel::invalidateCache(const AbstractColumn* col) {
+	ColumnCache* cache = m_cellCache.value(col);
+	if (!cache)
+		return;
+
+	cache->blocks.clear();
+	cache->pendingBlocks.clear();
+	cache->generation = ++m_cacheGeneration;
+}
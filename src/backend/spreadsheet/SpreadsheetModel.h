@@ -32,18 +32,27 @@
 #define SPREADSHEETMODEL_H
 
 #include <QAbstractItemModel>
+#include <QCache>
+#include <QMutex>
+#include <QSet>
 #include <QStringList>
+#include <QThreadPool>
+#include <QVector>
 
 class Column;
+class ColumnValues;
 class Spreadsheet;
 class AbstractAspect;
 class AbstractColumn;
+class SpreadsheetPrefetchTask;
+template<class T> class Interval;
 
 class SpreadsheetModel : public QAbstractItemModel {
 	Q_OBJECT
 
 public:
 	explicit SpreadsheetModel(Spreadsheet*);
+	~SpreadsheetModel();
 
 	enum CustomDataRole {
 		MaskingRole = Qt::UserRole, //!< bool determining whether the cell is masked
@@ -66,6 +75,8 @@ public:
 	void activateFormulaMode(bool on);
 	bool formulaModeActive() const;
 
+	void prefetch(int firstRow, int lastRow);
+
 private slots:
 	void handleAspectAboutToBeAdded(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* child);
 	void handleAspectAdded(const AbstractAspect*);
@@ -76,19 +87,57 @@ private slots:
 	void handleModeChange(const AbstractColumn*);
 	void handlePlotDesignationChange(const AbstractColumn*);
 	void handleDataChange(const AbstractColumn*);
+	void handleValuesChange(const AbstractColumn*);
+	void handleRowsChange(const AbstractColumn*, int first, int last);
 	void handleRowsInserted(const AbstractColumn* col, int before, int count);
 	void handleRowsRemoved(const AbstractColumn* col, int first, int count);
+	void handlePrefetchFinished();
 
 protected:
 	void updateVerticalHeader();
 	void updateHorizontalHeader();
 
 private:
+	struct CachedCell {
+		QString text;
+		bool valid;
+		bool masked;
+	};
+	typedef QVector<CachedCell> CellBlock;
+
+	struct ColumnCache {
+		ColumnCache(int maxBlocks) : blocks(maxBlocks), generation(0) {}
+		QCache<int, CellBlock> blocks;
+		QSet<int> pendingBlocks;
+		quint64 generation;
+	};
+
+	struct PrefetchResult {
+		const AbstractColumn* column;
+		quint64 generation;
+		int block;
+		CellBlock cells;
+	};
+
+	CachedCell cachedCell(const Column*, int row) const;
+	CellBlock createBlock(const Column*, int block) const;
+	static void fillNumericBlock(CellBlock&, const ColumnValues& values, int first, int count,
+	                             char format, int digits, const QList< Interval<int> >& maskedIntervals);
+	void invalidateCache(const AbstractColumn*);
+
 	Spreadsheet* m_spreadsheet;
 	bool m_formula_mode;
 	QList<int> m_vertical_header_data;
 	QStringList m_horizontal_header_data;
 	int m_defaultHeaderHeight;
+
+	mutable QHash<const AbstractColumn*, ColumnCache*> m_cellCache;
+	mutable quint64 m_cacheGeneration;
+	QThreadPool m_prefetchPool;
+	QMutex m_prefetchMutex;
+	QList<PrefetchResult> m_prefetchResults;
+
+	friend class SpreadsheetPrefetchTask;
 };
 
 #endif
@@ -34,7 +34,6 @@
 
 #include <QApplication>
 #include <QBuffer>
-#include <QtConcurrentRun>
 #include <QDesktopWidget>
 #include <QPainter>
 #include <QGraphicsScene>
@@ -44,6 +43,7 @@
 #include <KIcon>
 #include <KConfig>
 #include <KConfigGroup>
+#include <KGlobal>
 #include <KLocale>
 
 /**
@@ -423,7 +423,8 @@ void TextLabelPrivate::updateText() {
 		format.fontSize = teXFont.pointSize();
 		format.fontFamily = teXFont.family();
 		format.dpi = teXImageResolution;
-		QFuture<QImage> future = QtConcurrent::run(TeXRenderer::renderImageLaTeX, textWrapper.text, &teXRenderSuccessful, format);
+		//images rendered with the same settings before are taken from the cache of the renderer
+		QFuture<QImage> future = TeXRenderer::render(textWrapper.text, &teXRenderSuccessful, format);
 		teXImageFutureWatcher.setFuture(future);
 
 		//don't need to call retransorm() here since it is done in updateTeXImage
@@ -659,7 +660,9 @@ void TextLabel::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute( "teXFontColor_b", QString::number(d->teXFontColor.blue()) );
 	writer->writeEndElement();
 
-	if (d->textWrapper.teXUsed) {
+	//the rendered image is embedded so that the project can be shown without rendering it again
+	const KConfigGroup group = KGlobal::config()->group(QLatin1String("Settings_Worksheet"));
+	if (d->textWrapper.teXUsed && group.readEntry(QLatin1String("EmbedTeXImages"), true)) {
 		writer->writeStartElement("teXImage");
 		QByteArray ba;
 		QBuffer buffer(&ba);
@@ -607,7 +607,7 @@ void Axis::setMajorTicksColumn(const AbstractColumn* column) {
 		exec(new AxisSetMajorTicksColumnCmd(d, column, i18n("%1: assign major ticks' values")));
 
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(retransformTicks()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(retransformTicks()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(majorTicksColumnAboutToBeRemoved(const AbstractAspect*)));
 			//TODO: add disconnect in the undo-function
@@ -672,7 +672,7 @@ void Axis::setMinorTicksColumn(const AbstractColumn* column) {
 		exec(new AxisSetMinorTicksColumnCmd(d, column, i18n("%1: assign minor ticks' values")));
 
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(retransformTicks()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(retransformTicks()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(minorTicksColumnAboutToBeRemoved(const AbstractAspect*)));
 			//TODO: add disconnect in the undo-function
@@ -871,13 +871,21 @@ void Axis::visibilityChanged() {
 //################### Private implementation ##########################
 //#####################################################################
 AxisPrivate::AxisPrivate(Axis *owner) : m_plot(0), m_cSystem(0), m_printing(false), m_hovered(false), m_suppressRecalc(false),
-	majorTicksColumn(0), minorTicksColumn(0), gridItem(new AxisGrid(this)), q(owner) {
+	m_tickLabelMetricsHtml(false), majorTicksColumn(0), minorTicksColumn(0), gridItem(new AxisGrid(this)), q(owner) {
 
 	setFlag(QGraphicsItem::ItemIsSelectable, true);
 	setFlag(QGraphicsItem::ItemIsFocusable, true);
 	setAcceptHoverEvents(true);
 }
 
+AxisPrivate::TickLabelStringsKey::TickLabelStringsKey() : format(Axis::FormatDecimal), precision(-1) {
+}
+
+bool AxisPrivate::TickLabelStringsKey::operator==(const TickLabelStringsKey& other) const {
+	return values == other.values && format == other.format && precision == other.precision
+		&& prefix == other.prefix && suffix == other.suffix;
+}
+
 QString AxisPrivate::name() const{
 	return q->name();
 }
@@ -913,12 +921,40 @@ void AxisPrivate::retransform() {
 	if (!m_cSystem)
 		return;
 
+	//the plot was only moved (its scales are in item coordinates) or retransformed for other children,
+	//the current lines, ticks, labels and grid are still valid
+	const QVector<double> key = layoutKey();
+	if (key == m_layoutKey)
+		return;
+	m_layoutKey = key;
+
 	m_suppressRecalc = true;
 	retransformLine();
 	m_suppressRecalc = false;
 	recalcShapeAndBoundingRect();
 }
 
+/*!
+	returns the properties of the scales of the coordinate system, the plot ranges and the settings
+	the axis line is positioned with. The other settings recalculate the affected parts directly when changed.
+ */
+QVector<double> AxisPrivate::layoutKey() const {
+	QVector<double> key;
+	const QList<CartesianScale*> scales = m_cSystem->xScales() + m_cSystem->yScales();
+	key << m_cSystem->xScales().size();
+	foreach (const CartesianScale* scale, scales) {
+		CartesianScale::ScaleType type;
+		Interval<double> interval;
+		double a, b, c;
+		scale->getProperties(&type, &interval, &a, &b, &c);
+		key << type << interval.start() << interval.end() << a << b << c;
+	}
+
+	key << m_plot->xMin() << m_plot->xMax() << m_plot->yMin() << m_plot->yMax();
+	key << orientation << position << offset << start << end << scalingFactor << zeroOffset << titleOffsetX << titleOffsetY;
+	return key;
+}
+
 void AxisPrivate::retransformLine() {
 	linePath = QPainterPath();
 	lines.clear();
@@ -1353,6 +1389,19 @@ void AxisPrivate::retransformTickLabelStrings() {
 	}
 	DEBUG("labelsPrecision =" << labelsPrecision);
 
+	//the tick values and the label settings didn't change (e.g. the plot was resized), keep the strings
+	TickLabelStringsKey key;
+	key.values = tickLabelValues;
+	key.format = labelsFormat;
+	key.precision = labelsPrecision;
+	key.prefix = labelsPrefix;
+	key.suffix = labelsSuffix;
+	if (key == m_tickLabelStringsKey && tickLabelStrings.size() == tickLabelValues.size()) {
+		retransformTickLabelPositions();
+		return;
+	}
+	m_tickLabelStringsKey = key;
+
 	tickLabelStrings.clear();
 	QString str;
 	if (labelsFormat == Axis::FormatDecimal) {
@@ -1408,22 +1457,10 @@ int AxisPrivate::upperLabelsPrecision(int precision) {
 	DEBUG("AxisPrivate::upperLabelsPrecision() precision =" << precision);
 	//round float to the current precision and look for duplicates.
 	//if there are duplicates, increase the precision.
-	QList<float> tempValues;
-	for (int i = 0; i < tickLabelValues.size(); ++i) {
-		tempValues.append( round(tickLabelValues[i], precision) );
-	}
-
-	for (int i = 0; i < tempValues.size(); ++i) {
-		for (int j = 0; j < tempValues.size(); ++j) {
-			if (i == j) continue;
-			if ( AbstractCoordinateSystem::essentiallyEqual(tempValues.at(i), tempValues.at(j), pow(10, -precision)) ) {
-				//duplicate for the current precision found, increase the precision and check again
-				return upperLabelsPrecision(precision + 1);
-			}
-		}
-	}
+	static const int maxPrecision = 15;
+	while (precision < maxPrecision && hasDuplicateLabels(precision, pow(10, -precision)))
+		++precision;
 
-	//no duplicates for the current precision found: return the current value
 	return precision;
 }
 
@@ -1433,29 +1470,36 @@ int AxisPrivate::upperLabelsPrecision(int precision) {
 */
 int AxisPrivate::lowerLabelsPrecision(int precision) {
 	DEBUG("AxisPrivate::lowerLabelsPrecision() precision =" << precision);
-	//round float to the current precision and look for duplicates.
-	//if there are duplicates, decrease the precision.
-	QList<float> tempValues;
-	for (int i = 0; i < tickLabelValues.size(); ++i) {
-		tempValues.append( round(tickLabelValues[i], precision-1) );
+	//round float to the reduced precision and look for duplicates.
+	//if there are no duplicates, reduce further and check again.
+	while (!hasDuplicateLabels(precision - 1, pow(10, -precision))) {
+		if (precision == 0)
+			return 0;
+		--precision;
 	}
 
-	for (int i = 0; i < tempValues.size(); ++i) {
-		for (int j = 0; j < tempValues.size(); ++j) {
-			if (i == j) continue;
-			if ( AbstractCoordinateSystem::essentiallyEqual(tempValues.at(i), tempValues.at(j), pow(10, -precision)) ) {
-				//duplicate found for the reduced precision
-				//-> current precision cannot be reduced, return the current value + 1
-				return precision + 1;
-			}
-		}
+	//duplicate found for the reduced precision
+	//-> current precision cannot be reduced, return the current value + 1
+	return precision + 1;
+}
+
+/*!
+	returns \c true if two tick label values are essentially equal (relative tolerance \c epsilon)
+	after rounding to \c precision digits. Every value is rounded once and only compared to its neighbours
+	in the sorted list, instead of comparing all pairs.
+*/
+bool AxisPrivate::hasDuplicateLabels(int precision, float epsilon) {
+	QVector<float> values(tickLabelValues.size());
+	for (int i = 0; i < tickLabelValues.size(); ++i)
+		values[i] = round(tickLabelValues.at(i), precision);
+	qSort(values);
+
+	for (int i = 1; i < values.size(); ++i) {
+		if (AbstractCoordinateSystem::essentiallyEqual(values.at(i-1), values.at(i), epsilon))
+			return true;
 	}
 
-	//no duplicates found, reduce further, and check again
-	if (precision == 0)
-		return 0;
-	else
-		return lowerLabelsPrecision(precision - 1);
+	return false;
 }
 
 double AxisPrivate::round(double value, int precision) {
@@ -1476,10 +1520,8 @@ void AxisPrivate::retransformTickLabelPositions() {
 		return;
 	}
 
-	QFontMetrics fm(labelsFont);
 	float width = 0;
-	float height = fm.ascent();
-	QString label;
+	float height = 0;
 	QPointF pos;
 	float middleX = m_plot->xMin() + (m_plot->xMax() - m_plot->xMin())/2;
 	float middleY = m_plot->yMin() + (m_plot->yMax() - m_plot->yMin())/2;
@@ -1488,17 +1530,10 @@ void AxisPrivate::retransformTickLabelPositions() {
 
 	QPointF startPoint, endPoint, anchorPoint;
 
-	QTextDocument td;
-	td.setDefaultFont(labelsFont);
-
 	for ( int i=0; i<majorTickPoints.size(); i++ ) {
-		if (labelsFormat == Axis::FormatDecimal || labelsFormat == Axis::FormatScientificE) {
-			width = fm.width(tickLabelStrings.at(i));
-		} else {
-			td.setHtml(tickLabelStrings.at(i));
-			width = td.size().width();
-			height = td.size().height();
-		}
+		const TickLabelMetrics& metrics = tickLabelMetrics(tickLabelStrings.at(i));
+		width = metrics.width;
+		height = metrics.height;
 		anchorPoint = majorTickPoints.at(i);
 
 		//center align all labels with respect to the end point of the tick line
@@ -1540,6 +1575,41 @@ void AxisPrivate::retransformTickLabelPositions() {
 	recalcShapeAndBoundingRect();
 }
 
+/*!
+	returns the size of the tick label \c text in the current labels font.
+	The measured labels are cached, zooming and shifting mostly produces labels measured before.
+ */
+const AxisPrivate::TickLabelMetrics& AxisPrivate::tickLabelMetrics(const QString& text) {
+	const bool html = (labelsFormat != Axis::FormatDecimal && labelsFormat != Axis::FormatScientificE);
+	static const int maxCachedLabels = 1000;
+	if (m_tickLabelMetricsFont != labelsFont || m_tickLabelMetricsHtml != html || m_tickLabelMetrics.size() > maxCachedLabels) {
+		m_tickLabelMetrics.clear();
+		m_tickLabelMetricsFont = labelsFont;
+		m_tickLabelMetricsHtml = html;
+	}
+
+	QHash<QString, TickLabelMetrics>::iterator it = m_tickLabelMetrics.find(text);
+	if (it != m_tickLabelMetrics.end())
+		return it.value();
+
+	TickLabelMetrics metrics;
+	if (!html) {
+		QFontMetrics fm(labelsFont);
+		metrics.width = fm.width(text);
+		metrics.height = fm.ascent();
+		metrics.rect = fm.boundingRect(text);
+	} else {
+		QTextDocument td;
+		td.setDefaultFont(labelsFont);
+		td.setHtml(text);
+		metrics.width = td.size().width();
+		metrics.height = td.size().height();
+		metrics.rect = QRectF(0, -metrics.height, metrics.width, metrics.height);
+	}
+
+	return m_tickLabelMetrics.insert(text, metrics).value();
+}
+
 void AxisPrivate::retransformMajorGrid() {
 	majorGridPath = QPainterPath();
 	if (majorGridPen.style() == Qt::NoPen || majorTickPoints.size() == 0) {
@@ -1681,17 +1751,9 @@ void AxisPrivate::recalcShapeAndBoundingRect() {
 	if (labelsPosition != Axis::NoLabels) {
 		QTransform trafo;
 		QPainterPath tempPath;
-		QFontMetrics fm(labelsFont);
-		QTextDocument td;
-		td.setDefaultFont(labelsFont);
 	  	for (int i=0; i<tickLabelPoints.size(); i++) {
 			tempPath = QPainterPath();
-			if (labelsFormat == Axis::FormatDecimal || labelsFormat == Axis::FormatScientificE) {
-				tempPath.addRect( fm.boundingRect(tickLabelStrings.at(i)) );
-			} else {
-				td.setHtml(tickLabelStrings.at(i));
-				tempPath.addRect( QRectF(0, -td.size().height(), td.size().width(), td.size().height()) );
-			}
+			tempPath.addRect( tickLabelMetrics(tickLabelStrings.at(i)).rect );
 
 			trafo.reset();
 			trafo.translate( tickLabelPoints.at(i).x(), tickLabelPoints.at(i).y() );
@@ -30,7 +30,9 @@
 #define AXISPRIVATE_H
 
 #include <QGraphicsItem>
+#include <QHash>
 #include <QPen>
+#include <QVector>
 #include "Axis.h"
 
 class QGraphicsSceneHoverEvent;
@@ -51,6 +53,31 @@ class AxisPrivate: public QGraphicsItem {
 		bool m_hovered;
 		bool m_suppressRecalc;
 
+		//! size of a tick label, the bounding rectangle is relative to the left lower edge of the label
+		struct TickLabelMetrics {
+			qreal width;
+			qreal height;
+			QRectF rect;
+		};
+
+		//! settings the current tick label strings were created for
+		struct TickLabelStringsKey {
+			TickLabelStringsKey();
+			bool operator==(const TickLabelStringsKey&) const;
+
+			QList<float> values;
+			Axis::LabelsFormat format;
+			int precision;
+			QString prefix;
+			QString suffix;
+		};
+
+		QVector<double> m_layoutKey; //!< scales and settings the current lines, ticks, labels and grid were calculated for
+		TickLabelStringsKey m_tickLabelStringsKey;
+		QHash<QString, TickLabelMetrics> m_tickLabelMetrics; //!< measured tick labels for the current font and format
+		QFont m_tickLabelMetricsFont;
+		bool m_tickLabelMetricsHtml;
+
 		//general
 		bool autoScale;
 		Axis::AxisOrientation orientation; //!< horizontal or vertical
@@ -146,6 +173,9 @@ class AxisPrivate: public QGraphicsItem {
 		void retransformMajorGrid();
 		int upperLabelsPrecision(int precision);
 		int lowerLabelsPrecision(int precision);
+		bool hasDuplicateLabels(int precision, float epsilon);
+		const TickLabelMetrics& tickLabelMetrics(const QString&);
+		QVector<double> layoutKey() const;
 		double round(double value, int precision);
 		virtual void recalcShapeAndBoundingRect();
 		bool swapVisible(bool on);
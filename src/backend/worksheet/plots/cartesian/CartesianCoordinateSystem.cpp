@@ -132,8 +132,11 @@ public:
 	CartesianCoordinateSystemPrivate(CartesianCoordinateSystem *owner);
 	~CartesianCoordinateSystemPrivate();
 
+	QRectF plotRect() const;
+
 	CartesianCoordinateSystem* const q;
 	CartesianPlot* plot;
+	QRectF pageRect;	//plot rect of detached copies
 	QList<CartesianScale*> xScales;
 	QList<CartesianScale*> yScales;
 };
@@ -200,7 +203,7 @@ CartesianScale *CartesianScale::createLogScale(const Interval<double> &interval,
 //######################### logical to scene mappers ###########################
 //##############################################################################
 QList<QPointF> CartesianCoordinateSystem::mapLogicalToScene(const QList<QPointF> &points, const MappingFlags &flags) const {
-	const QRectF pageRect = d->plot->plotRect();
+	const QRectF pageRect = d->plotRect();
 	QList<QPointF> result;
 	bool noPageClipping = pageRect.isNull() || (flags & SuppressPageClipping);
 
@@ -247,7 +250,7 @@ void CartesianCoordinateSystem::mapLogicalToScene(const QList<QPointF>& logicalP
 												  QList<QPointF>& scenePoints,
 												  std::vector<bool>& visiblePoints,
 												  const MappingFlags& flags) const{
-	const QRectF pageRect = d->plot->plotRect();
+	const QRectF pageRect = d->plotRect();
 	QList<QPointF> result;
 	bool noPageClipping = pageRect.isNull() || (flags & SuppressPageClipping);
 
@@ -284,8 +287,41 @@ void CartesianCoordinateSystem::mapLogicalToScene(const QList<QPointF>& logicalP
 	}
 }
 
+/*!
+	Maps the \c count points with the logical coordinates \c x and \c y and appends the visible ones to \c scenePoints.
+	Used for large numbers of points, no lists of the logical points have to be created.
+ */
+void CartesianCoordinateSystem::mapLogicalToScene(const double* x, const double* y, int count,
+												  QVector<QPointF>& scenePoints, const MappingFlags& flags) const{
+	const QRectF pageRect = d->plotRect();
+	bool noPageClipping = pageRect.isNull() || (flags & SuppressPageClipping);
+
+	foreach (const CartesianScale* xScale, d->xScales) {
+		if (!xScale) continue;
+
+		foreach (const CartesianScale* yScale, d->yScales) {
+			if (!yScale) continue;
+
+			for (int i=0; i<count; ++i) {
+				double xScene = x[i];
+				double yScene = y[i];
+
+				if (!xScale->contains(xScene) || !yScale->contains(yScene))
+					continue;
+
+				if (!xScale->map(&xScene) || !yScale->map(&yScene))
+					continue;
+
+				const QPointF mappedPoint(xScene, yScene);
+				if (noPageClipping || rectContainsPoint(pageRect, mappedPoint))
+					scenePoints.append(mappedPoint);
+			}
+		}
+	}
+}
+
 QPointF CartesianCoordinateSystem::mapLogicalToScene(const QPointF& logicalPoint, const MappingFlags& flags) const{
-	const QRectF pageRect = d->plot->plotRect();
+	const QRectF pageRect = d->plotRect();
 	QList<QPointF> result;
 	bool noPageClipping = pageRect.isNull() || (flags & SuppressPageClipping);
 
@@ -320,7 +356,7 @@ QPointF CartesianCoordinateSystem::mapLogicalToScene(const QPointF& logicalPoint
 }
 
 QList<QLineF> CartesianCoordinateSystem::mapLogicalToScene(const QList<QLineF> &lines, const MappingFlags &flags) const{
-	QRectF pageRect = d->plot->plotRect();
+	QRectF pageRect = d->plotRect();
 	QList<QLineF> result;
 	bool doPageClipping = !pageRect.isNull() && !(flags & SuppressPageClipping);
 
@@ -483,7 +519,7 @@ QList<QLineF> CartesianCoordinateSystem::mapLogicalToScene(const QList<QLineF> &
 //######################### scene to logical mappers ###########################
 //##############################################################################
 QList<QPointF> CartesianCoordinateSystem::mapSceneToLogical(const QList<QPointF> &points, const MappingFlags &flags) const{
-	QRectF pageRect = d->plot->plotRect();
+	QRectF pageRect = d->plotRect();
 	QList<QPointF> result;
 	bool noPageClipping = pageRect.isNull() || (flags & SuppressPageClipping);
 
@@ -533,7 +569,7 @@ QList<QPointF> CartesianCoordinateSystem::mapSceneToLogical(const QList<QPointF>
 }
 
 QPointF CartesianCoordinateSystem::mapSceneToLogical(const QPointF& logicalPoint, const MappingFlags& flags) const {
-	QRectF pageRect = d->plot->plotRect();
+	QRectF pageRect = d->plotRect();
 	QPointF result;
 	bool noPageClipping = pageRect.isNull() || (flags & SuppressPageClipping);
 
@@ -620,6 +656,36 @@ QList<CartesianScale*> CartesianCoordinateSystem::yScales() const {
 	return d->yScales; // TODO: should rather return a copy of the scales here
 }
 
+/*!
+ * Creates a copy of the coordinate system with copies of the current scales and the current plot rect.
+ * The copy doesn't access the plot and can be used for the mapping in another thread
+ * while the ranges of the plot are changed. The caller takes the ownership.
+ */
+CartesianCoordinateSystem* CartesianCoordinateSystem::detachedCopy() const {
+	CartesianCoordinateSystem* copy = new CartesianCoordinateSystem(0);
+	copy->d->pageRect = d->plotRect();
+
+	CartesianScale::ScaleType type;
+	Interval<double> interval;
+	double a, b, c;
+	foreach (const CartesianScale* scale, d->xScales) {
+		if (scale) {
+			scale->getProperties(&type, &interval, &a, &b, &c);
+			copy->d->xScales << CartesianScale::createScale(type, interval, a, b, c);
+		} else
+			copy->d->xScales << 0;
+	}
+	foreach (const CartesianScale* scale, d->yScales) {
+		if (scale) {
+			scale->getProperties(&type, &interval, &a, &b, &c);
+			copy->d->yScales << CartesianScale::createScale(type, interval, a, b, c);
+		} else
+			copy->d->yScales << 0;
+	}
+
+	return copy;
+}
+
 /*!
  * Adjusted the function QRectF::contains(QPointF) from Qt 4.8.4 to handle the
  * comparison of float numbers correctly.
@@ -671,3 +737,7 @@ CartesianCoordinateSystemPrivate::~CartesianCoordinateSystemPrivate() {
 	while (!yScales.isEmpty())
 		delete yScales.takeFirst();
 }
+
+QRectF CartesianCoordinateSystemPrivate::plotRect() const {
+	return plot ? plot->plotRect() : pageRect;
+}
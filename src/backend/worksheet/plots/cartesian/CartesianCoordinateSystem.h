@@ -32,6 +32,7 @@
 #include "backend/worksheet/plots/AbstractCoordinateSystem.h"
 #include "backend/lib/Interval.h"
 
+#include <QVector>
 #include <vector>
 
 class CartesianPlot;
@@ -81,6 +82,7 @@ class CartesianCoordinateSystem: public AbstractCoordinateSystem {
 
 		virtual QList<QPointF> mapLogicalToScene(const QList<QPointF>&, const MappingFlags &flags = DefaultMapping) const;
 		void mapLogicalToScene(const QList<QPointF>& logicalPoints, QList<QPointF>& scenePoints, std::vector<bool>& visiblePoints, const MappingFlags& flags = DefaultMapping) const;
+		void mapLogicalToScene(const double* x, const double* y, int count, QVector<QPointF>& scenePoints, const MappingFlags& flags = DefaultMapping) const;
 		virtual QPointF mapLogicalToScene(const QPointF&,const MappingFlags& flags = DefaultMapping) const;
 		virtual QList<QLineF> mapLogicalToScene(const QList<QLineF>&, const MappingFlags &flags = DefaultMapping) const;
 
@@ -93,6 +95,7 @@ class CartesianCoordinateSystem: public AbstractCoordinateSystem {
 		QList<CartesianScale*> xScales() const;
 		bool setYScales(const QList<CartesianScale*>&);
 		QList<CartesianScale*> yScales() const;
+		CartesianCoordinateSystem* detachedCopy() const;
 
 	private:
 		void init();
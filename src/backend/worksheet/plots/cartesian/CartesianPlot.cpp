@@ -129,6 +129,10 @@ void CartesianPlot::init() {
 	connect(this, SIGNAL(aspectRemoved(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)),
 			this, SLOT(childRemoved(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)));
 
+	//the complete retransform after interactive zooming is deferred until the interaction settles
+	d->retransformTimer.setSingleShot(true);
+	connect(&d->retransformTimer, SIGNAL(timeout()), this, SLOT(finishInteractiveRetransform()));
+
 	graphicsItem()->setFlag(QGraphicsItem::ItemIsMovable, true);
 	graphicsItem()->setFlag(QGraphicsItem::ItemClipsChildrenToShape, true);
 	graphicsItem()->setFlag(QGraphicsItem::ItemIsSelectable, true);
@@ -543,6 +547,15 @@ CartesianPlot::MouseMode CartesianPlot::mouseMode() const {
 	return d->mouseMode;
 }
 
+void CartesianPlot::setPrinting(bool on) {
+	Q_D(CartesianPlot);
+	//apply the ranges of a pending interactive zoom before the plot is printed or exported
+	if (on && d->retransformTimer.isActive())
+		d->retransformScales();
+
+	AbstractPlot::setPrinting(on);
+}
+
 //##############################################################################
 //######################  setter methods and undo commands  ####################
 //##############################################################################
@@ -931,6 +944,14 @@ void CartesianPlot::curveVisibilityChanged() {
 		this->scaleAutoY();
 }
 
+/*!
+  called when no further zoom steps followed within the retransform delay, or periodically during a long interaction.
+*/
+void CartesianPlot::finishInteractiveRetransform() {
+	Q_D(CartesianPlot);
+	d->retransformScales();
+}
+
 void CartesianPlot::setMouseMode(const MouseMode mouseMode) {
 	Q_D(CartesianPlot);
 
@@ -1299,7 +1320,7 @@ void CartesianPlot::visibilityChanged() {
 CartesianPlotPrivate::CartesianPlotPrivate(CartesianPlot *owner)
 	: AbstractPlotPrivate(owner), q(owner), curvesXMinMaxIsDirty(false), curvesYMinMaxIsDirty(false),
 	  curvesXMin(INFINITY), curvesXMax(-INFINITY), curvesYMin(INFINITY), curvesYMax(-INFINITY),
-	  suppressRetransform(false), m_printing(false), m_selectionBandIsShown(false), cSystem(0),
+	  suppressRetransform(false), interactiveRetransform(false), m_printing(false), m_selectionBandIsShown(false), cSystem(0),
 	  mouseMode(CartesianPlot::SelectionMode) {
 	setData(0, WorksheetElement::NameCartesianPlot);
 }
@@ -1336,8 +1357,114 @@ void CartesianPlotPrivate::retransform() {
 
 void CartesianPlotPrivate::retransformScales() {
 	DEBUG("CartesianPlotPrivate::retransformScales()");
+	if (interactiveRetransform) {
+		scheduleRetransformScales();
+		return;
+	}
 
+	retransformTimer.stop();
 	CartesianPlot* plot = dynamic_cast<CartesianPlot*>(q);
+	updateScales();
+
+	//calculate the changes in x and y and save the current values for xMin, xMax, yMin, yMax
+	float deltaXMin = 0;
+	float deltaXMax = 0;
+	float deltaYMin = 0;
+	float deltaYMax = 0;
+
+	if (xMin!=xMinPrev) {
+		deltaXMin = xMin - xMinPrev;
+		emit plot->xMinChanged(xMin);
+	}
+
+	if (xMax!=xMaxPrev) {
+		deltaXMax = xMax - xMaxPrev;
+		emit plot->xMaxChanged(xMax);
+	}
+
+	if (yMin!=yMinPrev) {
+		deltaYMin = yMin - yMinPrev;
+		emit plot->yMinChanged(yMin);
+	}
+
+	if (yMax!=yMaxPrev) {
+		deltaYMax = yMax - yMaxPrev;
+		emit plot->yMaxChanged(yMax);
+	}
+
+	xMinPrev = xMin;
+	xMaxPrev = xMax;
+	yMinPrev = yMin;
+	yMaxPrev = yMax;
+
+	//adjust auto-scale axes
+	QList<Axis*> childElements = q->children<Axis>();
+	foreach (Axis* axis, childElements) {
+		if (!axis->autoScale())
+			continue;
+
+		if (axis->orientation() == Axis::AxisHorizontal) {
+			if (deltaXMax != 0) {
+				axis->setUndoAware(false);
+				axis->setEnd(xMax);
+				axis->setUndoAware(true);
+			}
+			if (deltaXMin != 0) {
+				axis->setUndoAware(false);
+				axis->setStart(xMin);
+				axis->setUndoAware(true);
+			}
+			//TODO;
+// 			if (axis->position() == Axis::AxisCustom && deltaYMin != 0) {
+// 				axis->setOffset(axis->offset() + deltaYMin, false);
+// 			}
+		} else {
+			if (deltaYMax != 0) {
+				axis->setUndoAware(false);
+				axis->setEnd(yMax);
+				axis->setUndoAware(true);
+			}
+			if (deltaYMin != 0) {
+				axis->setUndoAware(false);
+				axis->setStart(yMin);
+				axis->setUndoAware(true);
+			}
+
+			//TODO;
+// 			if (axis->position() == Axis::AxisCustom && deltaXMin != 0) {
+
+// 				axis->setOffset(axis->offset() + deltaXMin, false);
+// 			}
+		}
+	}
+	// call retransform() on the parent to trigger the update of all axes and curves
+	q->retransform();
+}
+
+/*!
+	updates the coordinate system for a zoom step during an interaction (mouse wheel)
+	and shows the curves transformed to the new ranges right away.
+	The axes, the curves and the other children are retransformed once when no further steps follow
+	within the retransform delay, and at least every maxRetransformInterval ms during a long interaction.
+ */
+void CartesianPlotPrivate::scheduleRetransformScales() {
+	static const int retransformDelay = 150;
+	static const int maxRetransformInterval = 500;
+
+	if (!retransformTimer.isActive())
+		interactionTime.start();
+
+	updateScales();
+	foreach (XYCurve* curve, q->children<XYCurve>())
+		curve->retransformPreview();
+
+	retransformTimer.start(interactionTime.elapsed() < maxRetransformInterval ? retransformDelay : 0);
+}
+
+/*!
+	creates the x- and y-scales of the coordinate system for the current plot rect and ranges.
+ */
+void CartesianPlotPrivate::updateScales() {
 	QList<CartesianScale*> scales;
 
 	//perform the mapping from the scene coordinates to the plot's coordinates here.
@@ -1454,80 +1581,6 @@ void CartesianPlotPrivate::retransformScales() {
 	}
 
 	cSystem->setYScales(scales);
-
-	//calculate the changes in x and y and save the current values for xMin, xMax, yMin, yMax
-	float deltaXMin = 0;
-	float deltaXMax = 0;
-	float deltaYMin = 0;
-	float deltaYMax = 0;
-
-	if (xMin!=xMinPrev) {
-		deltaXMin = xMin - xMinPrev;
-		emit plot->xMinChanged(xMin);
-	}
-
-	if (xMax!=xMaxPrev) {
-		deltaXMax = xMax - xMaxPrev;
-		emit plot->xMaxChanged(xMax);
-	}
-
-	if (yMin!=yMinPrev) {
-		deltaYMin = yMin - yMinPrev;
-		emit plot->yMinChanged(yMin);
-	}
-
-	if (yMax!=yMaxPrev) {
-		deltaYMax = yMax - yMaxPrev;
-		emit plot->yMaxChanged(yMax);
-	}
-
-	xMinPrev = xMin;
-	xMaxPrev = xMax;
-	yMinPrev = yMin;
-	yMaxPrev = yMax;
-
-	//adjust auto-scale axes
-	QList<Axis*> childElements = q->children<Axis>();
-	foreach (Axis* axis, childElements) {
-		if (!axis->autoScale())
-			continue;
-
-		if (axis->orientation() == Axis::AxisHorizontal) {
-			if (deltaXMax != 0) {
-				axis->setUndoAware(false);
-				axis->setEnd(xMax);
-				axis->setUndoAware(true);
-			}
-			if (deltaXMin != 0) {
-				axis->setUndoAware(false);
-				axis->setStart(xMin);
-				axis->setUndoAware(true);
-			}
-			//TODO;
-// 			if (axis->position() == Axis::AxisCustom && deltaYMin != 0) {
-// 				axis->setOffset(axis->offset() + deltaYMin, false);
-// 			}
-		} else {
-			if (deltaYMax != 0) {
-				axis->setUndoAware(false);
-				axis->setEnd(yMax);
-				axis->setUndoAware(true);
-			}
-			if (deltaYMin != 0) {
-				axis->setUndoAware(false);
-				axis->setStart(yMin);
-				axis->setUndoAware(true);
-			}
-
-			//TODO;
-// 			if (axis->position() == Axis::AxisCustom && deltaXMin != 0) {
-
-// 				axis->setOffset(axis->offset() + deltaXMin, false);
-// 			}
-		}
-	}
-	// call retransform() on the parent to trigger the update of all axes and curves
-	q->retransform();
 }
 
 /*!
@@ -1723,6 +1776,8 @@ void CartesianPlotPrivate::wheelEvent(QGraphicsSceneWheelEvent* event) {
 			zoomY = true;
 	}
 
+	//the wheel sends many small steps, show the new ranges immediately and retransform once the steps settle
+	interactiveRetransform = true;
 	if (event->delta() > 0) {
 		if (!zoomX && !zoomY) {
 			//no special axis selected -> zoom in everything
@@ -1740,6 +1795,7 @@ void CartesianPlotPrivate::wheelEvent(QGraphicsSceneWheelEvent* event) {
 			if (zoomY) q->zoomOutY();
 		}
 	}
+	interactiveRetransform = false;
 }
 
 void CartesianPlotPrivate::hoverMoveEvent(QGraphicsSceneHoverEvent* event) {
@@ -105,6 +105,8 @@ class CartesianPlot:public AbstractPlot{
 		CLASS_D_ACCESSOR_DECL(RangeBreaks, xRangeBreaks, XRangeBreaks);
 		CLASS_D_ACCESSOR_DECL(RangeBreaks, yRangeBreaks, YRangeBreaks);
 
+		virtual void setPrinting(bool);
+
 		typedef CartesianPlot BaseClass;
 		typedef CartesianPlotPrivate Private;
 
@@ -197,6 +199,7 @@ class CartesianPlot:public AbstractPlot{
 		void xDataChanged();
 		void yDataChanged();
 		void curveVisibilityChanged();
+		void finishInteractiveRetransform();
 
 		//SLOTs for changes triggered via QActions in the context menu
 		void visibilityChanged();
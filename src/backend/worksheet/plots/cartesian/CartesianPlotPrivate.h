@@ -34,6 +34,8 @@
 #include "backend/worksheet/plots/AbstractPlotPrivate.h"
 
 #include <QGraphicsSceneMouseEvent>
+#include <QTime>
+#include <QTimer>
 
 class CartesianPlotPrivate : public AbstractPlotPrivate {
     public:
@@ -50,6 +52,8 @@ class CartesianPlotPrivate : public AbstractPlotPrivate {
 
 		virtual void retransform();
 		void retransformScales();
+		void updateScales();
+		void scheduleRetransformScales();
 		void checkXRange();
 		void checkYRange();
 		CartesianScale* createScale(CartesianPlot::Scale type,
@@ -71,6 +75,9 @@ class CartesianPlotPrivate : public AbstractPlotPrivate {
 		double curvesXMin, curvesXMax, curvesYMin, curvesYMax;
 
 		bool suppressRetransform;
+		bool interactiveRetransform;	//zoom steps only preview the new ranges, the retransform is deferred
+		QTimer retransformTimer;
+		QTime interactionTime;
 		bool m_printing;
 		bool m_selectionBandIsShown;
 		QPointF m_selectionStart;
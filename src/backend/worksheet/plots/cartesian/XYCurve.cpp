@@ -49,6 +49,9 @@
 #include <QPainter>
 #include <QGraphicsSceneContextMenuEvent>
 #include <QMenu>
+#include <QtConcurrentRun>
+#include <QRunnable>
+#include <QThreadPool>
 // #include <QElapsedTimer>
 
 #include <KIcon>
@@ -56,6 +59,7 @@
 #include <KGlobal>
 #include <KLocale>
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 extern "C" {
@@ -108,6 +112,8 @@ void XYCurve::init() {
 	d->symbolsPen.setStyle( (Qt::PenStyle)group.readEntry("SymbolBorderStyle", (int)Qt::SolidLine) );
 	d->symbolsPen.setColor( group.readEntry("SymbolBorderColor", QColor(Qt::black)) );
 	d->symbolsPen.setWidthF( group.readEntry("SymbolBorderWidth", Worksheet::convertToSceneUnits(0.0, Worksheet::Point)) );
+	d->densityType = (XYCurve::DensityType) group.readEntry("DensityType", (int)XYCurve::NoDensity);
+	d->densityColorMap = (ColorMapRenderer::ColorMap) group.readEntry("DensityColorMap", (int)ColorMapRenderer::Viridis);
 
 	d->valuesType = (XYCurve::ValuesType) group.readEntry("ValuesType", (int)XYCurve::NoValues);
 	d->valuesColumn = NULL;
@@ -144,6 +150,11 @@ void XYCurve::init() {
 	d->errorBarsPen.setWidthF( group.readEntry("ErrorBarsWidth", Worksheet::convertToSceneUnits(1.0, Worksheet::Point)) );
 	d->errorBarsOpacity = group.readEntry("ErrorBarsOpacity", 1.0);
 
+	//the density of the points has to be calculated again on changes of the data
+	connect(this, SIGNAL(xDataChanged()), this, SLOT(invalidateDensity()));
+	connect(this, SIGNAL(yDataChanged()), this, SLOT(invalidateDensity()));
+	connect(this, SIGNAL(dataChanged()), this, SLOT(invalidateDensity()));
+
 	this->initActions();
 }
 
@@ -203,6 +214,8 @@ bool XYCurve::isVisible() const {
 
 void XYCurve::setPrinting(bool on) {
 	Q_D(XYCurve);
+	if (on)
+		d->finishGeometry();
 	d->m_printing = on;
 }
 
@@ -237,6 +250,8 @@ BASIC_SHARED_D_READER_IMPL(XYCurve, qreal, symbolsRotationAngle, symbolsRotation
 BASIC_SHARED_D_READER_IMPL(XYCurve, qreal, symbolsSize, symbolsSize)
 CLASS_SHARED_D_READER_IMPL(XYCurve, QBrush, symbolsBrush, symbolsBrush)
 CLASS_SHARED_D_READER_IMPL(XYCurve, QPen, symbolsPen, symbolsPen)
+BASIC_SHARED_D_READER_IMPL(XYCurve, XYCurve::DensityType, densityType, densityType)
+BASIC_SHARED_D_READER_IMPL(XYCurve, ColorMapRenderer::ColorMap, densityColorMap, densityColorMap)
 
 //values
 BASIC_SHARED_D_READER_IMPL(XYCurve, XYCurve::ValuesType, valuesType, valuesType)
@@ -302,10 +317,10 @@ void XYCurve::setXColumn(const AbstractColumn* column) {
 		//emit xDataChanged() in order to notify the plot about the changes
 		emit xDataChanged();
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SIGNAL(xDataChanged()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SIGNAL(xDataChanged()));
 
-			//update the curve itself on changes
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(retransform()));
+			//update the curve itself on changes, once per event loop turn for all changes of the column
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(retransform()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(xColumnAboutToBeRemoved(const AbstractAspect*)));
 			//TODO: add disconnect in the undo-function
@@ -322,10 +337,10 @@ void XYCurve::setYColumn(const AbstractColumn* column) {
 		//emit yDataChanged() in order to notify the plot about the changes
 		emit yDataChanged();
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SIGNAL(yDataChanged()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SIGNAL(yDataChanged()));
 
-			//update the curve itself on changes
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(retransform()));
+			//update the curve itself on changes, once per event loop turn for all changes of the column
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(retransform()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(yColumnAboutToBeRemoved(const AbstractAspect*)));
 			//TODO: add disconnect in the undo-function
@@ -434,6 +449,20 @@ void XYCurve::setSymbolsOpacity(qreal opacity) {
 		exec(new XYCurveSetSymbolsOpacityCmd(d, opacity, i18n("%1: set symbols opacity")));
 }
 
+STD_SETTER_CMD_IMPL_F_S(XYCurve, SetDensityType, XYCurve::DensityType, densityType, updateDensity)
+void XYCurve::setDensityType(XYCurve::DensityType type) {
+	Q_D(XYCurve);
+	if (type != d->densityType)
+		exec(new XYCurveSetDensityTypeCmd(d, type, i18n("%1: set density type")));
+}
+
+STD_SETTER_CMD_IMPL_F_S(XYCurve, SetDensityColorMap, ColorMapRenderer::ColorMap, densityColorMap, updateDensity)
+void XYCurve::setDensityColorMap(ColorMapRenderer::ColorMap map) {
+	Q_D(XYCurve);
+	if (map != d->densityColorMap)
+		exec(new XYCurveSetDensityColorMapCmd(d, map, i18n("%1: set density color map")));
+}
+
 //Values-Tab
 STD_SETTER_CMD_IMPL_F_S(XYCurve, SetValuesType, XYCurve::ValuesType, valuesType, updateValues)
 void XYCurve::setValuesType(XYCurve::ValuesType type) {
@@ -448,7 +477,7 @@ void XYCurve::setValuesColumn(const AbstractColumn* column) {
 	if (column != d->valuesColumn) {
 		exec(new XYCurveSetValuesColumnCmd(d, column, i18n("%1: set values column")));
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(updateValues()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(updateValues()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(valuesColumnAboutToBeRemoved(const AbstractAspect*)));
 		}
@@ -591,7 +620,7 @@ void XYCurve::setXErrorPlusColumn(const AbstractColumn* column) {
 	if (column != d->xErrorPlusColumn) {
 		exec(new XYCurveSetXErrorPlusColumnCmd(d, column, i18n("%1: set x-error column")));
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(updateErrorBars()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(updateErrorBars()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(xErrorPlusColumnAboutToBeRemoved(const AbstractAspect*)));
 		}
@@ -604,7 +633,7 @@ void XYCurve::setXErrorMinusColumn(const AbstractColumn* column) {
 	if (column != d->xErrorMinusColumn) {
 		exec(new XYCurveSetXErrorMinusColumnCmd(d, column, i18n("%1: set x-error column")));
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(updateErrorBars()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(updateErrorBars()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(xErrorMinusColumnAboutToBeRemoved(const AbstractAspect*)));
 		}
@@ -624,7 +653,7 @@ void XYCurve::setYErrorPlusColumn(const AbstractColumn* column) {
 	if (column != d->yErrorPlusColumn) {
 		exec(new XYCurveSetYErrorPlusColumnCmd(d, column, i18n("%1: set y-error column")));
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(updateErrorBars()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(updateErrorBars()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(yErrorPlusColumnAboutToBeRemoved(const AbstractAspect*)));
 		}
@@ -637,7 +666,7 @@ void XYCurve::setYErrorMinusColumn(const AbstractColumn* column) {
 	if (column != d->yErrorMinusColumn) {
 		exec(new XYCurveSetYErrorMinusColumnCmd(d, column, i18n("%1: set y-error column")));
 		if (column) {
-			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(updateErrorBars()));
+			connect(column, SIGNAL(rowsChanged(const AbstractColumn*,int,int)), this, SLOT(updateErrorBars()));
 			connect(column->parentAspect(), SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 					this, SLOT(yErrorMinusColumnAboutToBeRemoved(const AbstractAspect*)));
 		}
@@ -677,6 +706,31 @@ void XYCurve::suppressRetransform(bool b) {
 	d->m_suppressRetransform = b;
 }
 
+/*!
+  shows the curve transformed to the current ranges of the plot until the next retransform().
+*/
+void XYCurve::retransformPreview() {
+	Q_D(XYCurve);
+	d->retransformPreview();
+}
+
+//value of the setting "DoubleBuffering", read on first use and updated via setDoubleBuffering()
+static int doubleBufferingSetting = -1;
+
+static bool doubleBuffering() {
+	if (doubleBufferingSetting == -1)
+		doubleBufferingSetting = KGlobal::config()->group("Settings_Worksheet").readEntry(QLatin1String("DoubleBuffering"), true);
+
+	return doubleBufferingSetting;
+}
+
+/*!
+  updates the cached value of the setting "DoubleBuffering", called when the settings were changed.
+*/
+void XYCurve::setDoubleBuffering(bool on) {
+	doubleBufferingSetting = on;
+}
+
 //##############################################################################
 //#################################  SLOTS  ####################################
 //##############################################################################
@@ -700,6 +754,26 @@ void XYCurve::updateErrorBars() {
 	d->updateErrorBars();
 }
 
+void XYCurve::geometryFinished() {
+	Q_D(XYCurve);
+	d->geometryFinished();
+}
+
+void XYCurve::densityFinished() {
+	Q_D(XYCurve);
+	d->densityFinished();
+}
+
+void XYCurve::invalidateDensity() {
+	Q_D(XYCurve);
+	d->m_densityDataChanged = true;
+}
+
+void XYCurve::haloMaskFinished() {
+	Q_D(XYCurve);
+	d->haloMaskFinished();
+}
+
 //TODO
 void XYCurve::handlePageResize(double horizontalRatio, double verticalRatio) {
 	Q_D(const XYCurve);
@@ -793,10 +867,131 @@ void XYCurve::navigateTo() {
 //##############################################################################
 //######################### Private implementation #############################
 //##############################################################################
+//curves with at least this number of points calculate their geometry in the background
+static const int backgroundGeometryMinPoints = 10000;
+
 XYCurvePrivate::XYCurvePrivate(XYCurve *owner) : m_printing(false), m_hovered(false), m_suppressRecalc(false),
-	m_suppressRetransform(false), m_hoverEffectImageIsDirty(false), m_selectionEffectImageIsDirty(false), q(owner) {
+	m_suppressRetransform(false), m_hoverEffectImageIsDirty(false), m_selectionEffectImageIsDirty(false),
+	m_haloMaskPixmapKey(0), m_haloMaskRequestKey(0), m_geometryPending(false), m_geometryGeneration(new QAtomicInt(0)),
+	m_densityPending(false), m_densityDataChanged(true), m_densityGeneration(new QAtomicInt(0)),
+	m_densityXColumn(0), m_densityYColumn(0), q(owner) {
 	setFlag(QGraphicsItem::ItemIsSelectable, true);
 	setAcceptHoverEvents(true);
+
+	QObject::connect(&m_geometryWatcher, SIGNAL(finished()), q, SLOT(geometryFinished()));
+	QObject::connect(&m_densityWatcher, SIGNAL(finished()), q, SLOT(densityFinished()));
+	QObject::connect(&m_haloMaskWatcher, SIGNAL(finished()), q, SLOT(haloMaskFinished()));
+}
+
+XYCurvePrivate::~XYCurvePrivate() {
+	//cancel a calculation running in the background, it only works on copies of the data
+	m_geometryGeneration->fetchAndAddOrdered(1);
+	m_densityGeneration->fetchAndAddOrdered(1);
+}
+
+XYCurvePrivate::Geometry::Geometry() : generation(0), cSystem(0), firstNewPoint(0), firstNewScenePoint(0),
+	lineType(XYCurve::NoLine), lineSkipGaps(false), lineInterpolationPointsCount(1),
+	dropLineType(XYCurve::NoDropLine), xMin(0), yMin(0), yColumnMin(0), yColumnMax(0),
+	symbolsStyle(Symbol::NoSymbols), symbolsSize(0), symbolsRotationAngle(0) {
+}
+
+/*!
+  returns \c true if the geometry is calculated in the background and the data or the plot ranges
+  were changed after the calculation was started.
+*/
+bool XYCurvePrivate::Geometry::isStale() const {
+	return latestGeneration && (int)*latestGeneration != generation;
+}
+
+XYCurvePrivate::Density::Density() : generation(0), maxCount(0) {
+}
+
+/*!
+  returns \c true if the density is calculated in the background and the data or the plot ranges
+  were changed after the calculation was started.
+*/
+bool XYCurvePrivate::Density::isStale() const {
+	return latestGeneration && (int)*latestGeneration != generation;
+}
+
+int XYCurvePrivate::Density::rowCount() const {
+	return qMin(xData.isEmpty() ? xValues.size() : xData.size(), yData.isEmpty() ? yValues.size() : yData.size());
+}
+
+XYCurvePrivate::PixmapExtension::PixmapExtension() : lineElements(0), dropLineElements(0), errorBarsElements(0), symbols(-1) {
+}
+
+/*!
+  returns \c true if the lines of the line type \c type between two points don't depend on the other points.
+*/
+static bool isLocalLineType(XYCurve::LineType type) {
+	return type != XYCurve::Segments2 && type != XYCurve::Segments3 && type < XYCurve::SplineCubicNatural;
+}
+
+/*!
+  returns \c true if the drop lines of the type \c type don't depend on the values of the other points.
+*/
+static bool isLocalDropLineType(XYCurve::DropLineType type) {
+	return type != XYCurve::DropLineXMinBaseline && type != XYCurve::DropLineXMaxBaseline;
+}
+
+/*!
+  returns the transformation from logical to scene coordinates for the first x- and y-scale of \c cSystem.
+  For logarithmic scales the logical coordinates are the logarithms of the values.
+  The scene coordinates of the same points in two transformations are related by an affine transformation.
+*/
+static QTransform sceneTransform(const CartesianCoordinateSystem* cSystem) {
+	const QList<CartesianScale*> xScales = cSystem->xScales();
+	const QList<CartesianScale*> yScales = cSystem->yScales();
+	if (xScales.isEmpty() || !xScales.first() || yScales.isEmpty() || !yScales.first())
+		return QTransform();
+
+	double ax, bx, ay, by;
+	xScales.first()->getProperties(NULL, NULL, &ax, &bx);
+	yScales.first()->getProperties(NULL, NULL, &ay, &by);
+	return QTransform(bx, 0, 0, by, ax, ay);
+}
+
+/*!
+  returns the properties of the scales of \c cSystem, mapping the ranges of \c plot to its data rectangle.
+  The data points are mapped to the same scene coordinates as long as they don't change.
+*/
+static QVector<double> mappingKey(const CartesianPlot* plot, const CartesianCoordinateSystem* cSystem) {
+	QVector<double> key;
+	const QList<CartesianScale*> scales = cSystem->xScales() + cSystem->yScales();
+	key << cSystem->xScales().size();
+	foreach (const CartesianScale* scale, scales) {
+		if (!scale) continue;
+
+		CartesianScale::ScaleType type;
+		Interval<double> interval;
+		double a, b, c;
+		scale->getProperties(&type, &interval, &a, &b, &c);
+		key << type << interval.start() << interval.end() << a << b << c;
+	}
+
+	key << plot->xMin() << plot->xMax() << plot->yMin() << plot->yMax();
+	return key;
+}
+
+/*!
+  returns the part of \c path starting with the element \c first, the path consists of lines only.
+*/
+static QPainterPath pathTail(const QPainterPath& path, int first) {
+	QPainterPath tail;
+	if (first > 0 && first < path.elementCount() && !path.elementAt(first).isMoveTo()) {
+		const QPainterPath::Element& element = path.elementAt(first - 1);
+		tail.moveTo(element.x, element.y);
+	}
+
+	for (int i = first; i < path.elementCount(); ++i) {
+		const QPainterPath::Element& element = path.elementAt(i);
+		if (element.isMoveTo())
+			tail.moveTo(element.x, element.y);
+		else
+			tail.lineTo(element.x, element.y);
+	}
+	return tail;
 }
 
 QString XYCurvePrivate::name() const {
@@ -804,7 +999,7 @@ QString XYCurvePrivate::name() const {
 }
 
 QRectF XYCurvePrivate::boundingRect() const {
-	return boundingRectangle;
+	return m_placeholderTransform.mapRect(boundingRectangle);
 }
 
 /*!
@@ -828,26 +1023,37 @@ bool XYCurvePrivate::swapVisible(bool on) {
 /*!
   recalculates the position of the points to be drawn. Called when the data was changed.
   Triggers the update of lines, drop lines, symbols etc.
+
+  The geometry of curves with many points is calculated in the background, the current pixmap
+  is shown transformed to the new plot ranges until the calculation is finished.
+  If points were only appended and the plot ranges didn't change, only the new points are mapped and drawn.
 */
 void XYCurvePrivate::retransform() {
 	DEBUG("XYCurvePrivate::retransform()");
 	if (m_suppressRetransform)
 		return;
 
-	symbolPointsLogical.clear();
-	symbolPointsScene.clear();
-	connectedPointsLogical.clear();
-
 	if ( (NULL == xColumn) || (NULL == yColumn) ) {
-		linePath = QPainterPath();
-		dropLinePath = QPainterPath();
-		symbolsPath = QPainterPath();
-		valuesPath = QPainterPath();
-		errorBarsPath = QPainterPath();
-		recalcShapeAndBoundingRect();
+		clearDensity();
+		clearGeometry();
+		return;
+	}
+
+	//the points are binned instead of calculating the lines, symbols etc. for every point
+	if (densityType != XYCurve::NoDensity) {
+		retransformDensity();
 		return;
 	}
 
+	Geometry geometry = geometryInput();
+	if (!geometry.cSystem)
+		return;
+
+	//a calculation still running in the background is stale now
+	geometry.generation = m_geometryGeneration->fetchAndAddOrdered(1) + 1;
+	geometry.pointsLogical.clear();
+	geometry.connectedPoints.clear();
+
 	int startRow = 0;
 	int endRow = xColumn->rowCount() - 1;
 	QPointF tempPoint;
@@ -855,6 +1061,13 @@ void XYCurvePrivate::retransform() {
 	AbstractColumn::ColumnMode xColMode = xColumn->columnMode();
 	AbstractColumn::ColumnMode yColMode = yColumn->columnMode();
 
+	//date-times are plotted as the milliseconds since epoch stored in the column,
+	//numeric values are read from snapshots without paging in swapped out columns
+	const Column* xDataColumn = dynamic_cast<const Column*>(xColumn);
+	const Column* yDataColumn = dynamic_cast<const Column*>(yColumn);
+	const ColumnValues xValues = (xDataColumn && xColMode == AbstractColumn::Numeric) ? xDataColumn->values() : ColumnValues();
+	const ColumnValues yValues = (yDataColumn && yColMode == AbstractColumn::Numeric) ? yDataColumn->values() : ColumnValues();
+
 	//take over only valid and non masked points.
 	for (int row = startRow; row <= endRow; row++) {
 		if ( xColumn->isValid(row) && yColumn->isValid(row)
@@ -862,54 +1075,628 @@ void XYCurvePrivate::retransform() {
 
 			switch (xColMode) {
 			case AbstractColumn::Numeric:
-				tempPoint.setX(xColumn->valueAt(row));
+				tempPoint.setX(xDataColumn ? xValues.value(row) : xColumn->valueAt(row));
 				break;
 			case AbstractColumn::Text:
-			//TODO
+				//TODO
+				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				//TODO
+				if (xDataColumn)
+					tempPoint.setX((double)xDataColumn->msecsAt(row));
 				break;
 			}
 
 			switch (yColMode) {
 			case AbstractColumn::Numeric:
-				tempPoint.setY(yColumn->valueAt(row));
+				tempPoint.setY(yDataColumn ? yValues.value(row) : yColumn->valueAt(row));
 				break;
 			case AbstractColumn::Text:
-			//TODO
+				//TODO
+				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				//TODO
+				if (yDataColumn)
+					tempPoint.setY((double)yDataColumn->msecsAt(row));
 				break;
 			}
-			symbolPointsLogical.append(tempPoint);
-			connectedPointsLogical.push_back(true);
+			geometry.pointsLogical.append(tempPoint);
+			geometry.connectedPoints.push_back(true);
 		} else {
-			if (!connectedPointsLogical.empty())
-				connectedPointsLogical[connectedPointsLogical.size()-1] = false;
+			if (!geometry.connectedPoints.empty())
+				geometry.connectedPoints[geometry.connectedPoints.size()-1] = false;
 		}
 	}
 
-	//calculate the scene coordinates
-	const AbstractPlot* plot = dynamic_cast<const AbstractPlot*>(q->parentAspect());
-	if (!plot)
+	//nothing to do if the data and the plot ranges are unchanged. If points were appended only,
+	//keep the paths calculated for the current points and add the new ones to them.
+	const int unchanged = unchangedPoints(geometry);
+	if (unchanged == geometry.pointsLogical.size())
 		return;
 
-	const CartesianCoordinateSystem *cSystem = dynamic_cast<const CartesianCoordinateSystem*>(plot->coordinateSystem());
-	Q_ASSERT(cSystem);
-	visiblePoints = std::vector<bool>(symbolPointsLogical.count(), false);
-	cSystem->mapLogicalToScene(symbolPointsLogical, symbolPointsScene, visiblePoints);
+	if (unchanged > 0 && geometry.pointsLogical.size() - unchanged < backgroundGeometryMinPoints) {
+		geometry.firstNewPoint = unchanged;
+		geometry.lines = lines;
+		geometry.linePath = linePath;
+		geometry.dropLinePath = dropLinePath;
+		geometry.symbolsPath = symbolsPath;
+		applyGeometry(calculateGeometry(geometry, QSharedPointer<CartesianCoordinateSystem>()));
+		return;
+	}
+
+	//calculate the geometry of large curves in the background and show the current pixmap
+	//transformed to the new plot ranges in the meantime. When printing, the result is needed right away.
+	if (!m_printing && geometry.pointsLogical.size() >= backgroundGeometryMinPoints) {
+		bool invertible = false;
+		const QTransform inverted = m_geometryTransform.inverted(&invertible);
+
+		prepareGeometryChange();
+		m_placeholderTransform = (invertible && !m_pixmap.isNull()) ? inverted*geometry.sceneTransform : QTransform();
+		m_geometryPending = true;
+		update();
+
+		geometry.latestGeneration = m_geometryGeneration;
+		QSharedPointer<CartesianCoordinateSystem> cSystem(geometry.cSystem->detachedCopy());
+		m_geometryWatcher.setFuture(QtConcurrent::run(&XYCurvePrivate::calculateGeometry, geometry, cSystem));
+		return;
+	}
+
+	applyGeometry(calculateGeometry(geometry, QSharedPointer<CartesianCoordinateSystem>()));
+}
+
+/*!
+  removes the points, the lines, symbols etc. and drops a calculation still running in the background.
+*/
+void XYCurvePrivate::clearGeometry() {
+	//drop a calculation still running in the background
+	m_geometryGeneration->fetchAndAddOrdered(1);
+	if (m_geometryPending || !m_placeholderTransform.isIdentity()) {
+		prepareGeometryChange();
+		m_geometryPending = false;
+		m_placeholderTransform = QTransform();
+	}
+	m_geometryMappingKey.clear();
+
+	symbolPointsLogical.clear();
+	symbolPointsScene.clear();
+	connectedPointsLogical.clear();
+	visiblePoints.clear();
+	lines.clear();
+	linePath = QPainterPath();
+	dropLinePath = QPainterPath();
+	symbolsPath = QPainterPath();
+	valuesPath = QPainterPath();
+	errorBarsPath = QPainterPath();
+	recalcShapeAndBoundingRect();
+}
+
+/*!
+  shows the current pixmap transformed to the current plot ranges without recalculating the curve.
+  Used while the plot is zoomed interactively, the next call of retransform() replaces the placeholder.
+*/
+void XYCurvePrivate::retransformPreview() {
+	const CartesianPlot* plot = dynamic_cast<const CartesianPlot*>(q->parentAspect());
+	if (!plot || m_pixmap.isNull())
+		return;
+
+	const CartesianCoordinateSystem* cSystem = dynamic_cast<const CartesianCoordinateSystem*>(plot->coordinateSystem());
+	bool invertible = false;
+	const QTransform inverted = m_geometryTransform.inverted(&invertible);
+	if (!cSystem || !invertible)
+		return;
+
+	prepareGeometryChange();
+	m_placeholderTransform = inverted*sceneTransform(cSystem);
+	update();
+}
+
+/*!
+  returns the data points in logical and scene coordinates, the settings and the plot ranges
+  the lines, drop lines and symbols are calculated for.
+*/
+XYCurvePrivate::Geometry XYCurvePrivate::geometryInput() const {
+	Geometry geometry;
+
+	const CartesianPlot* plot = dynamic_cast<const CartesianPlot*>(q->parentAspect());
+	if (plot) {
+		geometry.cSystem = dynamic_cast<const CartesianCoordinateSystem*>(plot->coordinateSystem());
+		geometry.xMin = plot->xMin();
+		geometry.yMin = plot->yMin();
+	}
+	if (geometry.cSystem) {
+		geometry.sceneTransform = sceneTransform(geometry.cSystem);
+		geometry.mappingKey = mappingKey(plot, geometry.cSystem);
+	}
+
+	geometry.pointsLogical = symbolPointsLogical;
+	geometry.connectedPoints = connectedPointsLogical;
+	geometry.pointsScene = symbolPointsScene;
+	geometry.visiblePoints = visiblePoints;
+
+	geometry.lineType = lineType;
+	geometry.lineSkipGaps = lineSkipGaps;
+	geometry.lineInterpolationPointsCount = lineInterpolationPointsCount;
+	geometry.dropLineType = dropLineType;
+	if (yColumn && (dropLineType == XYCurve::DropLineXMinBaseline || dropLineType == XYCurve::DropLineXMaxBaseline)) {
+		geometry.yColumnMin = dynamic_cast<const Column*>(yColumn)->minimum();
+		geometry.yColumnMax = dynamic_cast<const Column*>(yColumn)->maximum();
+	}
+	geometry.symbolsStyle = symbolsStyle;
+	geometry.symbolsSize = symbolsSize;
+	geometry.symbolsRotationAngle = symbolsRotationAngle;
+
+	return geometry;
+}
+
+/*!
+  returns the number of points at the beginning of \c geometry whose lines, drop lines and symbols in the
+  current paths are still valid: the plot ranges are unchanged and the current points are the first points
+  of \c geometry. Returns -1 if the geometry has to be recalculated completely.
+*/
+int XYCurvePrivate::unchangedPoints(const Geometry& geometry) const {
+	if (m_geometryPending || !m_placeholderTransform.isIdentity() || m_geometryMappingKey.isEmpty()
+		|| geometry.mappingKey != m_geometryMappingKey)
+		return -1;
+
+	const int count = symbolPointsLogical.size();
+	if (geometry.pointsLogical.size() < count)
+		return -1;
+
+	for (int i = 0; i < count; ++i) {
+		const QPointF& point = geometry.pointsLogical.at(i);
+		const QPointF& currentPoint = symbolPointsLogical.at(i);
+		if (point.x() != currentPoint.x() || point.y() != currentPoint.y())
+			return -1;
+	}
+
+	//the connection of the last point is calculated again together with the new points
+	for (int i = 0; i < count - 1; ++i) {
+		if (geometry.connectedPoints[i] != connectedPointsLogical[i])
+			return -1;
+	}
+
+	return count;
+}
+
+/*!
+  maps the data points in \c geometry to scene coordinates and calculates the lines, drop lines and symbols.
+  Is called in a worker thread with the detached copy \c cSystem of the coordinate system of the plot
+  or in the main thread with the coordinate system set in \c geometry.
+*/
+XYCurvePrivate::Geometry XYCurvePrivate::calculateGeometry(Geometry geometry, QSharedPointer<CartesianCoordinateSystem> cSystem) {
+	if (cSystem)
+		geometry.cSystem = cSystem.data();
+
+	if (geometry.firstNewPoint == 0) {
+		geometry.pointsScene.clear();
+		geometry.visiblePoints = std::vector<bool>(geometry.pointsLogical.count(), false);
+		geometry.cSystem->mapLogicalToScene(geometry.pointsLogical, geometry.pointsScene, geometry.visiblePoints);
+	} else {
+		//map the appended points only
+		const QList<QPointF> newPoints = geometry.pointsLogical.mid(geometry.firstNewPoint);
+		std::vector<bool> visible(newPoints.count(), false);
+		geometry.firstNewScenePoint = geometry.pointsScene.size();
+		geometry.cSystem->mapLogicalToScene(newPoints, geometry.pointsScene, visible);
+		geometry.visiblePoints.resize(geometry.firstNewPoint);
+		geometry.visiblePoints.insert(geometry.visiblePoints.end(), visible.begin(), visible.end());
+	}
+
+	if (!geometry.isStale())
+		calculateLines(geometry);
+	if (!geometry.isStale())
+		calculateDropLines(geometry);
+	if (!geometry.isStale())
+		calculateSymbols(geometry);
+
+	geometry.cSystem = 0;
+	return geometry;
+}
+
+/*!
+  takes over the calculated geometry and updates the values, the filling and the error bars.
+  Lines, drop lines and symbols whose settings were changed while the geometry was calculated
+  in the background are recalculated. If points were appended to the current geometry, the pixmap is
+  extended by them unless the paths drawn already were recalculated completely.
+*/
+void XYCurvePrivate::applyGeometry(const Geometry& geometry) {
+	if (m_geometryPending || !m_placeholderTransform.isIdentity()) {
+		prepareGeometryChange();
+		m_geometryPending = false;
+		m_placeholderTransform = QTransform();
+	}
+
+	PixmapExtension extension;
+	if (geometry.firstNewPoint > 0 && isLocalLineType(lineType) && isLocalDropLineType(dropLineType)) {
+		extension.lineElements = linePath.elementCount();
+		extension.dropLineElements = dropLinePath.elementCount();
+		extension.errorBarsElements = errorBarsPath.elementCount();
+		extension.symbols = symbolPointsScene.size();
+	}
+
+	m_geometryTransform = geometry.sceneTransform;
+	m_geometryMappingKey = geometry.mappingKey;
+	symbolPointsLogical = geometry.pointsLogical;
+	connectedPointsLogical = geometry.connectedPoints;
+	symbolPointsScene = geometry.pointsScene;
+	visiblePoints = geometry.visiblePoints;
+	lines = geometry.lines;
+	linePath = geometry.linePath;
+	dropLinePath = geometry.dropLinePath;
+	symbolsPath = geometry.symbolsPath;
 
 	m_suppressRecalc = true;
-	updateLines();
-	updateDropLines();
-	updateSymbols();
+	if (geometry.lineType != lineType || geometry.lineSkipGaps != lineSkipGaps
+		|| geometry.lineInterpolationPointsCount != lineInterpolationPointsCount)
+		updateLines();
+	else
+		updateFilling();
+	if (geometry.dropLineType != dropLineType)
+		updateDropLines();
+	if (geometry.symbolsStyle != symbolsStyle || geometry.symbolsSize != symbolsSize
+		|| geometry.symbolsRotationAngle != symbolsRotationAngle)
+		updateSymbols();
 	updateValues();
+	updateErrorBars(geometry.firstNewPoint);
 	m_suppressRecalc = false;
-	updateErrorBars();
+
+	m_pixmapExtension = extension;
+	recalcShapeAndBoundingRect();
+}
+
+void XYCurvePrivate::geometryFinished() {
+	if (!m_geometryPending || !m_geometryWatcher.isFinished())
+		return;
+
+	//the data or the plot ranges were changed in the meantime, the newer calculation is still running
+	const Geometry geometry = m_geometryWatcher.result();
+	if (geometry.generation != (int)*m_geometryGeneration)
+		return;
+
+	applyGeometry(geometry);
+}
+
+/*!
+  waits for the calculation running in the background and takes over its result.
+  Called before the curve is printed or exported.
+*/
+void XYCurvePrivate::finishGeometry() {
+	if (m_geometryPending) {
+		m_geometryWatcher.waitForFinished();
+		geometryFinished();
+	}
+
+	if (m_densityPending) {
+		m_densityWatcher.waitForFinished();
+		densityFinished();
+	}
+}
+
+/*!
+  returns the values of \c column as plotted, either in the snapshot \c values of a numeric column
+  or copied to \c data with NAN for invalid rows.
+*/
+static void densityValues(const AbstractColumn* column, ColumnValues& values, QVector<double>& data) {
+	const AbstractColumn::ColumnMode mode = column->columnMode();
+	const Column* dataColumn = dynamic_cast<const Column*>(column);
+	if (dataColumn && mode == AbstractColumn::Numeric) {
+		values = dataColumn->values();
+		return;
+	}
+
+	const int rows = column->rowCount();
+	data.resize(rows);
+	for (int row = 0; row < rows; ++row) {
+		data[row] = NAN;
+		if (!column->isValid(row))
+			continue;
+
+		switch (mode) {
+		case AbstractColumn::Numeric:
+			data[row] = column->valueAt(row);
+			break;
+		case AbstractColumn::Text:
+			break;
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			if (dataColumn)
+				data[row] = (double)dataColumn->msecsAt(row);
+			break;
+		}
+	}
+}
+
+/*!
+  bins the data points in the density curve mode. The points are binned again only if the data
+  or the plot ranges were changed, large curves are binned in the background.
+*/
+void XYCurvePrivate::retransformDensity() {
+	CartesianPlot* plot = dynamic_cast<CartesianPlot*>(q->parentAspect());
+	const CartesianCoordinateSystem* cSystem = plot ? dynamic_cast<const CartesianCoordinateSystem*>(plot->coordinateSystem()) : 0;
+	if (!cSystem)
+		return;
+
+	//the lines, symbols etc. are not shown in the density mode
+	if (m_geometryPending || !m_geometryMappingKey.isEmpty())
+		clearGeometry();
+
+	const QVector<double> key = mappingKey(plot, cSystem);
+	if (!m_densityDataChanged && key == m_densityMappingKey && xColumn == m_densityXColumn && yColumn == m_densityYColumn)
+		return;
+
+	m_densityDataChanged = false;
+	m_densityMappingKey = key;
+	m_densityXColumn = xColumn;
+	m_densityYColumn = yColumn;
+
+	//a calculation still running in the background is stale now
+	Density density;
+	density.generation = m_densityGeneration->fetchAndAddOrdered(1) + 1;
+	density.sceneTransform = sceneTransform(cSystem);
+	densityValues(xColumn, density.xValues, density.xData);
+	densityValues(yColumn, density.yValues, density.yData);
+	density.maskedRows = xColumn->maskedIntervals() + yColumn->maskedIntervals();
+	density.rect = plot->plotRect().toAlignedRect();
+
+	QSharedPointer<CartesianCoordinateSystem> cSystemCopy(cSystem->detachedCopy());
+	if (m_printing || density.rowCount() < backgroundGeometryMinPoints) {
+		applyDensity(calculateDensity(density, cSystemCopy));
+		return;
+	}
+
+	//show the current pixmap transformed to the new plot ranges until the points are binned
+	bool invertible = false;
+	const QTransform inverted = m_geometryTransform.inverted(&invertible);
+
+	prepareGeometryChange();
+	m_placeholderTransform = (invertible && !m_pixmap.isNull()) ? inverted*density.sceneTransform : QTransform();
+	m_densityPending = true;
+	update();
+
+	density.latestGeneration = m_densityGeneration;
+	m_densityWatcher.setFuture(QtConcurrent::run(&XYCurvePrivate::calculateDensity, density, cSystemCopy));
+}
+
+/*!
+	bins the rows [start, end) of the data points into its own histogram, chunk by chunk
+*/
+class DensityTask : public QRunnable {
+	public:
+		DensityTask(int start, int end, const XYCurvePrivate::Density& density, const std::vector<bool>& masked,
+					const CartesianCoordinateSystem* cSystem, QVector<quint32>& counts) :
+			m_start(start), m_end(end), m_density(density), m_masked(masked), m_cSystem(cSystem), m_counts(counts) {
+		};
+
+		void run() {
+			const QRect& rect = m_density.rect;
+			quint32* counts = m_counts.data();
+			QVector<double> xMasked;
+			QVector<double> yMasked;
+			QVector<QPointF> points;
+			points.reserve(ColumnValues::chunkSize);
+
+			for (int first = m_start; first < m_end; first += ColumnValues::chunkSize) {
+				if (m_density.isStale())
+					return;
+
+				const int count = qMin(ColumnValues::chunkSize, m_end - first);
+				const double* x = m_density.x() + first;
+				const double* y = m_density.y() + first;
+
+				//masked points are skipped like invalid ones
+				if (!m_masked.empty()) {
+					xMasked.resize(count);
+					yMasked.resize(count);
+					for (int i = 0; i < count; ++i) {
+						const bool masked = m_masked[first + i];
+						xMasked[i] = masked ? NAN : x[i];
+						yMasked[i] = masked ? NAN : y[i];
+					}
+					x = xMasked.constData();
+					y = yMasked.constData();
+				}
+
+				points.resize(0);
+				m_cSystem->mapLogicalToScene(x, y, count, points);
+				foreach (const QPointF& point, points) {
+					const int column = qBound(0, (int)floor(point.x()) - rect.left(), rect.width() - 1);
+					const int row = qBound(0, (int)floor(point.y()) - rect.top(), rect.height() - 1);
+					++counts[row*rect.width() + column];
+				}
+			}
+		}
+
+	private:
+		int m_start;
+		int m_end;
+		const XYCurvePrivate::Density& m_density;
+		const std::vector<bool>& m_masked;
+		const CartesianCoordinateSystem* m_cSystem;
+		QVector<quint32>& m_counts;
+};
+
+//maximal number of bins of the additional histograms filled in parallel (32 MB)
+static const int densityMaxPartialBins = 8*1024*1024;
+
+/*!
+  bins the data points in \c density into bins of one scene unit covering the plot rectangle.
+  The rows are distributed over several threads, every thread fills its own histogram, which are added at the end.
+  The first thread fills the resulting histogram, the number of threads is limited such that
+  the additional histograms don't exceed \c densityMaxPartialBins.
+  Is called in a worker thread or in the main thread with the detached copy \c cSystem of the coordinate system.
+*/
+XYCurvePrivate::Density XYCurvePrivate::calculateDensity(Density density, QSharedPointer<CartesianCoordinateSystem> cSystem) {
+	const int rows = density.rowCount();
+	const int bins = density.rect.width()*density.rect.height();
+	density.counts.fill(0, bins);
+	density.maxCount = 0;
+
+	if (rows > 0 && bins > 0) {
+		std::vector<bool> masked;
+		if (!density.maskedRows.isEmpty()) {
+			masked.resize(rows, false);
+			foreach (const Interval<int>& interval, density.maskedRows) {
+				for (int row = qMax(interval.start(), 0); row <= qMin(interval.end(), rows - 1); ++row)
+					masked[row] = true;
+			}
+		}
+
+		QThreadPool pool;
+		const int threads = qMin(qMin(pool.maxThreadCount(), rows/ColumnValues::chunkSize + 1), 1 + densityMaxPartialBins/bins);
+		QVector< QVector<quint32> > partialCounts(threads - 1, QVector<quint32>(bins, 0));
+		const int range = ceil(double(rows)/threads);
+		for (int i = 0; i < threads; ++i) {
+			const int start = i*range;
+			const int end = qMin((i+1)*range, rows);
+			if (start >= end)
+				break;
+			pool.start(new DensityTask(start, end, density, masked, cSystem.data(), (i == 0) ? density.counts : partialCounts[i-1]));
+		}
+		pool.waitForDone();
+
+		quint32* data = density.counts.data();
+		foreach (const QVector<quint32>& partial, partialCounts) {
+			const quint32* partialData = partial.constData();
+			for (int i = 0; i < bins; ++i)
+				data[i] += partialData[i];
+		}
+		for (int i = 0; i < bins; ++i)
+			density.maxCount = qMax(density.maxCount, data[i]);
+	}
+
+	//the values are not needed anymore
+	density.xValues = ColumnValues();
+	density.yValues = ColumnValues();
+	density.xData.clear();
+	density.yData.clear();
+	density.maskedRows.clear();
+	return density;
+}
+
+void XYCurvePrivate::applyDensity(const Density& density) {
+	if (m_densityPending || !m_placeholderTransform.isIdentity()) {
+		prepareGeometryChange();
+		m_densityPending = false;
+		m_placeholderTransform = QTransform();
+	}
+
+	m_geometryTransform = density.sceneTransform;
+	m_density = density;
+	updateDensityImage();
+}
+
+void XYCurvePrivate::densityFinished() {
+	if (!m_densityPending || !m_densityWatcher.isFinished())
+		return;
+
+	//the data or the plot ranges were changed in the meantime, the newer calculation is still running
+	const Density density = m_densityWatcher.result();
+	if (density.generation != (int)*m_densityGeneration)
+		return;
+
+	applyDensity(density);
+}
+
+/*!
+  called when the density type or the color map were changed. The points are binned again
+  only when the density mode is switched on, otherwise the current bins are colored again.
+*/
+void XYCurvePrivate::updateDensity() {
+	if (densityType == XYCurve::NoDensity) {
+		clearDensity();
+		retransform();
+		return;
+	}
+
+	if (m_densityMappingKey.isEmpty())
+		retransform();
+	else if (!m_densityPending)
+		updateDensityImage();
+}
+
+/*!
+  colors the non-empty bins of the current density with the color map, normalized to the maximal count.
+*/
+void XYCurvePrivate::updateDensityImage() {
+	m_densityImage = QImage();
+	const QRect& rect = m_density.rect;
+	const quint32* counts = m_density.counts.constData();
+	if (m_density.maxCount > 0 && m_density.counts.size() == rect.width()*rect.height()) {
+		//the image covers the non-empty bins only
+		int left = rect.width();
+		int right = -1;
+		int top = rect.height();
+		int bottom = -1;
+		for (int row = 0; row < rect.height(); ++row) {
+			const quint32* line = counts + row*rect.width();
+			for (int column = 0; column < rect.width(); ++column) {
+				if (!line[column])
+					continue;
+
+				left = qMin(left, column);
+				right = qMax(right, column);
+				top = qMin(top, row);
+				bottom = qMax(bottom, row);
+			}
+		}
+
+		const QVector<QRgb> colors = ColorMapRenderer::colorTable(densityColorMap);
+		const int maxColor = colors.size() - 1;
+		const double maxCount = m_density.maxCount;
+		const double logMaxCount = log(1.0 + maxCount);
+
+		QImage image(right - left + 1, bottom - top + 1, QImage::Format_ARGB32);
+		image.fill(0);
+		for (int row = top; row <= bottom; ++row) {
+			const quint32* line = counts + row*rect.width();
+			QRgb* imageLine = reinterpret_cast<QRgb*>(image.scanLine(row - top));
+			for (int column = left; column <= right; ++column) {
+				const quint32 count = line[column];
+				if (!count)
+					continue;
+
+				double value;
+				switch (densityType) {
+				case XYCurve::DensityLinear:
+					value = count/maxCount;
+					break;
+				case XYCurve::DensitySqrt:
+					value = sqrt(count/maxCount);
+					break;
+				case XYCurve::DensityLog:
+				default:
+					value = log(1.0 + count)/logMaxCount;
+					break;
+				}
+				imageLine[column - left] = colors.at(qBound(0, qRound(value*maxColor), maxColor));
+			}
+		}
+
+		m_densityImage = image;
+		m_densityImageOrigin = rect.topLeft() + QPoint(left, top);
+	}
+
+	recalcShapeAndBoundingRect();
+}
+
+/*!
+  removes the bins and drops a calculation still running in the background.
+*/
+void XYCurvePrivate::clearDensity() {
+	m_densityGeneration->fetchAndAddOrdered(1);
+	if (m_densityPending || !m_placeholderTransform.isIdentity()) {
+		prepareGeometryChange();
+		m_densityPending = false;
+		m_placeholderTransform = QTransform();
+	}
+
+	m_densityMappingKey.clear();
+	m_densityXColumn = 0;
+	m_densityYColumn = 0;
+	m_density = Density();
+	m_densityImage = QImage();
 }
 
 /*!
@@ -917,62 +1704,78 @@ void XYCurvePrivate::retransform() {
   Called each time when the type of this connection is changed.
 */
 void XYCurvePrivate::updateLines() {
-	linePath = QPainterPath();
-	lines.clear();
-	if (lineType == XYCurve::NoLine) {
-		updateFilling();
-		recalcShapeAndBoundingRect();
+	Geometry geometry = geometryInput();
+	calculateLines(geometry);
+	lines = geometry.lines;
+	linePath = geometry.linePath;
+
+	updateFilling();
+	recalcShapeAndBoundingRect();
+}
+
+/*!
+  calculates the lines connecting the data points in \c geometry and their painter path in scene coordinates.
+  For line types not depending on the other points, the lines of appended points are added to the ones in \c geometry.
+*/
+void XYCurvePrivate::calculateLines(Geometry& geometry) {
+	//lines of appended points start at the last point calculated already
+	int first = qMax(geometry.firstNewPoint - 1, 0);
+	if (!isLocalLineType(geometry.lineType))
+		first = 0;
+	if (first == 0) {
+		geometry.linePath = QPainterPath();
+		geometry.lines.clear();
+	}
+	if (geometry.lineType == XYCurve::NoLine)
 		return;
-	}
 
-	const int count = symbolPointsLogical.count();
-//	DEBUG("count ="<<count<<", line type ="<<lineType);
+	const int count = geometry.pointsLogical.count();
+//	DEBUG("count ="<<count<<", line type ="<<geometry.lineType);
 //	for(int i=0;i<qMin(10,count);i++)
-//		DEBUG(symbolPointsLogical.at(i));
+//		DEBUG(geometry.pointsLogical.at(i));
 
 	//nothing to do, if no data points available
-	if (count <= 1) {
-		recalcShapeAndBoundingRect();
+	if (count <= 1)
 		return;
-	}
 
 	//calculate the lines connecting the data points
+	QList<QLineF> lines;
 	QPointF tempPoint1, tempPoint2;
 	QPointF curPoint, nextPoint;
-	switch (lineType) {
+	switch (geometry.lineType) {
 	case XYCurve::NoLine:
 		break;
 	case XYCurve::Line:
-		for (int i = 0; i < count - 1; i++) {
-			if (!lineSkipGaps && !connectedPointsLogical[i]) continue;
-			lines.append(QLineF(symbolPointsLogical.at(i), symbolPointsLogical.at(i+1)));
+		for (int i = first; i < count - 1; i++) {
+			if (!geometry.lineSkipGaps && !geometry.connectedPoints[i]) continue;
+			lines.append(QLineF(geometry.pointsLogical.at(i), geometry.pointsLogical.at(i+1)));
 		}
 		break;
 	case XYCurve::StartHorizontal:
-		for (int i = 0; i < count - 1; i++) {
-			if (!lineSkipGaps && !connectedPointsLogical[i]) continue;
-			curPoint = symbolPointsLogical.at(i);
-			nextPoint = symbolPointsLogical.at(i+1);
+		for (int i = first; i < count - 1; i++) {
+			if (!geometry.lineSkipGaps && !geometry.connectedPoints[i]) continue;
+			curPoint = geometry.pointsLogical.at(i);
+			nextPoint = geometry.pointsLogical.at(i+1);
 			tempPoint1 = QPointF(nextPoint.x(), curPoint.y());
 			lines.append(QLineF(curPoint, tempPoint1));
 			lines.append(QLineF(tempPoint1, nextPoint));
 		}
 		break;
 	case XYCurve::StartVertical:
-		for (int i = 0; i < count - 1; i++) {
-			if (!lineSkipGaps && !connectedPointsLogical[i]) continue;
-			curPoint = symbolPointsLogical.at(i);
-			nextPoint = symbolPointsLogical.at(i+1);
+		for (int i = first; i < count - 1; i++) {
+			if (!geometry.lineSkipGaps && !geometry.connectedPoints[i]) continue;
+			curPoint = geometry.pointsLogical.at(i);
+			nextPoint = geometry.pointsLogical.at(i+1);
 			tempPoint1 = QPointF(curPoint.x(), nextPoint.y());
 			lines.append(QLineF(curPoint, tempPoint1));
 			lines.append(QLineF(tempPoint1,nextPoint));
 		}
 		break;
 	case XYCurve::MidpointHorizontal:
-		for (int i = 0; i < count - 1; i++) {
-			if (!lineSkipGaps && !connectedPointsLogical[i]) continue;
-			curPoint = symbolPointsLogical.at(i);
-			nextPoint = symbolPointsLogical.at(i+1);
+		for (int i = first; i < count - 1; i++) {
+			if (!geometry.lineSkipGaps && !geometry.connectedPoints[i]) continue;
+			curPoint = geometry.pointsLogical.at(i);
+			nextPoint = geometry.pointsLogical.at(i+1);
 			tempPoint1 = QPointF(curPoint.x() + (nextPoint.x()-curPoint.x())/2, curPoint.y());
 			tempPoint2 = QPointF(curPoint.x() + (nextPoint.x()-curPoint.x())/2, nextPoint.y());
 			lines.append(QLineF(curPoint, tempPoint1));
@@ -981,10 +1784,10 @@ void XYCurvePrivate::updateLines() {
 		}
 		break;
 	case XYCurve::MidpointVertical:
-		for (int i = 0; i < count - 1; i++) {
-			if (!lineSkipGaps && !connectedPointsLogical[i]) continue;
-			curPoint = symbolPointsLogical.at(i);
-			nextPoint = symbolPointsLogical.at(i+1);
+		for (int i = first; i < count - 1; i++) {
+			if (!geometry.lineSkipGaps && !geometry.connectedPoints[i]) continue;
+			curPoint = geometry.pointsLogical.at(i);
+			nextPoint = geometry.pointsLogical.at(i+1);
 			tempPoint1 = QPointF(curPoint.x(), curPoint.y() + (nextPoint.y()-curPoint.y())/2);
 			tempPoint2 = QPointF(nextPoint.x(), curPoint.y() + (nextPoint.y()-curPoint.y())/2);
 			lines.append(QLineF(curPoint, tempPoint1));
@@ -996,11 +1799,11 @@ void XYCurvePrivate::updateLines() {
 		int skip=0;
 		for (int i = 0; i < count - 1; i++) {
 			if (skip != 1) {
-				if (!lineSkipGaps && !connectedPointsLogical[i]) {
+				if (!geometry.lineSkipGaps && !geometry.connectedPoints[i]) {
 					skip = 0;
 					continue;
 				}
-				lines.append(QLineF(symbolPointsLogical.at(i), symbolPointsLogical.at(i+1)));
+				lines.append(QLineF(geometry.pointsLogical.at(i), geometry.pointsLogical.at(i+1)));
 				skip++;
 			} else {
 				skip = 0;
@@ -1012,11 +1815,11 @@ void XYCurvePrivate::updateLines() {
 		int skip = 0;
 		for (int i = 0; i < count - 1; i++) {
 			if (skip != 2) {
-				if (!lineSkipGaps && !connectedPointsLogical[i]) {
+				if (!geometry.lineSkipGaps && !geometry.connectedPoints[i]) {
 					skip = 0;
 					continue;
 				}
-				lines.append(QLineF(symbolPointsLogical.at(i), symbolPointsLogical.at(i+1)));
+				lines.append(QLineF(geometry.pointsLogical.at(i), geometry.pointsLogical.at(i+1)));
 				skip++;
 			} else {
 				skip = 0;
@@ -1035,30 +1838,29 @@ void XYCurvePrivate::updateLines() {
 
 		double x[count],  y[count];
 		for (int i = 0; i < count; i++) {
-			x[i] = symbolPointsLogical.at(i).x();
-			y[i] = symbolPointsLogical.at(i).y();
+			x[i] = geometry.pointsLogical.at(i).x();
+			y[i] = geometry.pointsLogical.at(i).y();
 		}
 
 		gsl_set_error_handler_off();
-		if (lineType == XYCurve::SplineCubicNatural) {
+		if (geometry.lineType == XYCurve::SplineCubicNatural) {
 			spline = gsl_spline_alloc(gsl_interp_cspline, count);
-		} else if (lineType == XYCurve::SplineCubicPeriodic) {
+		} else if (geometry.lineType == XYCurve::SplineCubicPeriodic) {
 			spline = gsl_spline_alloc(gsl_interp_cspline_periodic, count);
-		} else if (lineType == XYCurve::SplineAkimaNatural) {
+		} else if (geometry.lineType == XYCurve::SplineAkimaNatural) {
 			spline = gsl_spline_alloc(gsl_interp_akima, count);
-		} else if (lineType == XYCurve::SplineAkimaPeriodic) {
+		} else if (geometry.lineType == XYCurve::SplineAkimaPeriodic) {
 			spline = gsl_spline_alloc(gsl_interp_akima_periodic, count);
 		}
 
 		if (!spline) {
 			QString msg;
-			if ( (lineType == XYCurve::SplineAkimaNatural || lineType == XYCurve::SplineAkimaPeriodic) && count < 5)
+			if ( (geometry.lineType == XYCurve::SplineAkimaNatural || geometry.lineType == XYCurve::SplineAkimaPeriodic) && count < 5)
 				msg = i18n("Error: Akima spline interpolation requires a minimum of 5 points.");
 			else
 				msg = i18n("Couldn't initialize spline function");
 			QDEBUG(msg);
 
-			recalcShapeAndBoundingRect();
 			return;
 		}
 
@@ -1072,7 +1874,6 @@ void XYCurvePrivate::updateLines() {
 				gslError = gsl_strerror (status);
 			QDEBUG("Error in spline calculation. " << gslError);
 
-			recalcShapeAndBoundingRect();
 			return;
 		}
 
@@ -1083,7 +1884,7 @@ void XYCurvePrivate::updateLines() {
 		for (int i = 0; i < count - 1; i++) {
 			x1 = x[i];
 			x2 = x[i+1];
-			step=fabs(x2 - x1)/(lineInterpolationPointsCount + 1);
+			step=fabs(x2 - x1)/(geometry.lineInterpolationPointsCount + 1);
 
 			for (xi = x1; xi < x2; xi += step) {
 				yi = gsl_spline_eval(spline, xi, acc);
@@ -1104,18 +1905,14 @@ void XYCurvePrivate::updateLines() {
 	}
 
 	//map the lines to scene coordinates
-	const CartesianPlot* plot = dynamic_cast<const CartesianPlot*>(q->parentAspect());
-	const AbstractCoordinateSystem* cSystem = plot->coordinateSystem();
-	lines = cSystem->mapLogicalToScene(lines);
+	lines = geometry.cSystem->mapLogicalToScene(lines);
+	geometry.lines << lines;
 
-	//new line path
+	//add the lines to the line path
 	foreach (const QLineF& line, lines) {
-		linePath.moveTo(line.p1());
-		linePath.lineTo(line.p2());
+		geometry.linePath.moveTo(line.p1());
+		geometry.linePath.lineTo(line.p2());
 	}
-
-	updateFilling();
-	recalcShapeAndBoundingRect();
 }
 
 /*!
@@ -1123,104 +1920,125 @@ void XYCurvePrivate::updateLines() {
   Called each time when the type of the drop lines is changed.
 */
 void XYCurvePrivate::updateDropLines() {
-	dropLinePath = QPainterPath();
-	if (dropLineType == XYCurve::NoDropLine) {
-		recalcShapeAndBoundingRect();
+	Geometry geometry = geometryInput();
+	calculateDropLines(geometry);
+	dropLinePath = geometry.dropLinePath;
+
+	recalcShapeAndBoundingRect();
+}
+
+/*!
+  calculates the painter path for the drop lines of the visible points in \c geometry.
+  The drop lines of appended points are added to the path unless they depend on the minimum or maximum of the data.
+*/
+void XYCurvePrivate::calculateDropLines(Geometry& geometry) {
+	const int first = isLocalDropLineType(geometry.dropLineType) ? geometry.firstNewPoint : 0;
+	if (first == 0)
+		geometry.dropLinePath = QPainterPath();
+	if (geometry.dropLineType == XYCurve::NoDropLine)
 		return;
-	}
 
 	//calculate drop lines
-	const CartesianPlot* plot = dynamic_cast<const CartesianPlot*>(q->parentAspect());
 	QList<QLineF> lines;
-	float xMin = 0;
-	float yMin = 0;
-
-	xMin = plot->xMin();
-	yMin = plot->yMin();
-	switch (dropLineType) {
+	const double xMin = geometry.xMin;
+	const double yMin = geometry.yMin;
+	switch (geometry.dropLineType) {
 	case XYCurve::NoDropLine:
 		break;
 	case XYCurve::DropLineX:
-		for(int i=0; i<symbolPointsLogical.size(); ++i) {
-			if (!visiblePoints[i]) continue;
-			const QPointF& point = symbolPointsLogical.at(i);
+		for(int i=first; i<geometry.pointsLogical.size(); ++i) {
+			if (!geometry.visiblePoints[i]) continue;
+			const QPointF& point = geometry.pointsLogical.at(i);
 			lines.append(QLineF(point, QPointF(point.x(), yMin)));
 		}
 		break;
 	case XYCurve::DropLineY:
-		for(int i=0; i<symbolPointsLogical.size(); ++i) {
-			if (!visiblePoints[i]) continue;
-			const QPointF& point = symbolPointsLogical.at(i);
+		for(int i=first; i<geometry.pointsLogical.size(); ++i) {
+			if (!geometry.visiblePoints[i]) continue;
+			const QPointF& point = geometry.pointsLogical.at(i);
 			lines.append(QLineF(point, QPointF(xMin, point.y())));
 		}
 		break;
 	case XYCurve::DropLineXY:
-		for(int i=0; i<symbolPointsLogical.size(); ++i) {
-			if (!visiblePoints[i]) continue;
-			const QPointF& point = symbolPointsLogical.at(i);
+		for(int i=first; i<geometry.pointsLogical.size(); ++i) {
+			if (!geometry.visiblePoints[i]) continue;
+			const QPointF& point = geometry.pointsLogical.at(i);
 			lines.append(QLineF(point, QPointF(point.x(), yMin)));
 			lines.append(QLineF(point, QPointF(xMin, point.y())));
 		}
 		break;
 	case XYCurve::DropLineXZeroBaseline:
-		for(int i=0; i<symbolPointsLogical.size(); ++i) {
-			if (!visiblePoints[i]) continue;
-			const QPointF& point = symbolPointsLogical.at(i);
+		for(int i=first; i<geometry.pointsLogical.size(); ++i) {
+			if (!geometry.visiblePoints[i]) continue;
+			const QPointF& point = geometry.pointsLogical.at(i);
 			lines.append(QLineF(point, QPointF(point.x(), 0)));
 		}
 		break;
 	case XYCurve::DropLineXMinBaseline:
-		for(int i=0; i<symbolPointsLogical.size(); ++i) {
-			if (!visiblePoints[i]) continue;
-			const QPointF& point = symbolPointsLogical.at(i);
-			lines.append( QLineF(point, QPointF(point.x(), dynamic_cast<const Column*>(yColumn)->minimum())) );
+		for(int i=first; i<geometry.pointsLogical.size(); ++i) {
+			if (!geometry.visiblePoints[i]) continue;
+			const QPointF& point = geometry.pointsLogical.at(i);
+			lines.append( QLineF(point, QPointF(point.x(), geometry.yColumnMin)) );
 		}
 		break;
 	case XYCurve::DropLineXMaxBaseline:
-		for(int i=0; i<symbolPointsLogical.size(); ++i) {
-			if (!visiblePoints[i]) continue;
-			const QPointF& point = symbolPointsLogical.at(i);
-			lines.append( QLineF(point, QPointF(point.x(), dynamic_cast<const Column*>(yColumn)->maximum())) );
+		for(int i=first; i<geometry.pointsLogical.size(); ++i) {
+			if (!geometry.visiblePoints[i]) continue;
+			const QPointF& point = geometry.pointsLogical.at(i);
+			lines.append( QLineF(point, QPointF(point.x(), geometry.yColumnMax)) );
 		}
 		break;
 	}
 
 	//map the drop lines to scene coordinates
-	const AbstractCoordinateSystem* cSystem = plot->coordinateSystem();
-	lines = cSystem->mapLogicalToScene(lines);
+	lines = geometry.cSystem->mapLogicalToScene(lines);
 
-	//new painter path for the drop lines
+	//add the drop lines to the painter path
 	foreach (const QLineF& line, lines) {
-		dropLinePath.moveTo(line.p1());
-		dropLinePath.lineTo(line.p2());
+		geometry.dropLinePath.moveTo(line.p1());
+		geometry.dropLinePath.lineTo(line.p2());
 	}
+}
+
+void XYCurvePrivate::updateSymbols() {
+	Geometry geometry = geometryInput();
+	calculateSymbols(geometry);
+	symbolsPath = geometry.symbolsPath;
 
 	recalcShapeAndBoundingRect();
 }
 
-void XYCurvePrivate::updateSymbols() {
-	symbolsPath = QPainterPath();
-	if (symbolsStyle != Symbol::NoSymbols) {
-		QPainterPath path = Symbol::pathFromStyle(symbolsStyle);
+/*!
+  calculates the painter path for the symbols at the visible points in \c geometry,
+  the symbols of appended points are added to the path.
+*/
+void XYCurvePrivate::calculateSymbols(Geometry& geometry) {
+	if (geometry.firstNewScenePoint == 0)
+		geometry.symbolsPath = QPainterPath();
+	if (geometry.symbolsStyle != Symbol::NoSymbols) {
+		QPainterPath path = Symbol::pathFromStyle(geometry.symbolsStyle);
 
 		QTransform trafo;
-		trafo.scale(symbolsSize, symbolsSize);
+		trafo.scale(geometry.symbolsSize, geometry.symbolsSize);
 		path = trafo.map(path);
 		trafo.reset();
 
-		if (symbolsRotationAngle != 0) {
-			trafo.rotate(symbolsRotationAngle);
+		if (geometry.symbolsRotationAngle != 0) {
+			trafo.rotate(geometry.symbolsRotationAngle);
 			path = trafo.map(path);
 		}
 
-		foreach (const QPointF& point, symbolPointsScene) {
+		for (int i = geometry.firstNewScenePoint; i < geometry.pointsScene.size(); ++i) {
+			//adding the paths is the most expensive part of the calculation, stop early if the result isn't needed anymore
+			if (i%4096 == 0 && geometry.isStale())
+				return;
+
+			const QPointF& point = geometry.pointsScene.at(i);
 			trafo.reset();
 			trafo.translate(point.x(), point.y());
-			symbolsPath.addPath(trafo.map(path));
+			geometry.symbolsPath.addPath(trafo.map(path));
 		}
 	}
-
-	recalcShapeAndBoundingRect();
 }
 
 /*!
@@ -1584,8 +2402,13 @@ void XYCurvePrivate::updateFilling() {
 	recalcShapeAndBoundingRect();
 }
 
-void XYCurvePrivate::updateErrorBars() {
-	errorBarsPath = QPainterPath();
+/*!
+  recalculates the painter path for the error bars. If \c first is not 0, points were appended
+  and only the error bars of the points from \c first on are added to the path.
+*/
+void XYCurvePrivate::updateErrorBars(int first) {
+	if (first == 0)
+		errorBarsPath = QPainterPath();
 	if (xErrorType==XYCurve::NoError && yErrorType==XYCurve::NoError) {
 		recalcShapeAndBoundingRect();
 		return;
@@ -1628,7 +2451,7 @@ void XYCurvePrivate::updateErrorBars() {
 		capSizeY = (pointLogical.x() - symbolPointsLogical.at(i).x())/2;
 	}
 
-	for (int i=0; i < symbolPointsLogical.size(); ++i) {
+	for (int i=first; i < symbolPointsLogical.size(); ++i) {
 		if (!visiblePoints[i])
 			continue;
 
@@ -1712,7 +2535,7 @@ void XYCurvePrivate::updateErrorBars() {
 	//map the error bars to scene coordinates
 	lines = cSystem->mapLogicalToScene(lines);
 
-	//new painter path for the drop lines
+	//add the error bars to the painter path
 	foreach (const QLineF& line, lines) {
 		errorBarsPath.moveTo(line.p1());
 		errorBarsPath.lineTo(line.p2());
@@ -1751,6 +2574,10 @@ void XYCurvePrivate::recalcShapeAndBoundingRect() {
 		curveShape.addPath(WorksheetElement::shapeFromPath(errorBarsPath, errorBarsPen));
 	}
 
+	if (!m_densityImage.isNull()) {
+		curveShape.addRect(QRectF(m_densityImageOrigin, m_densityImage.size()));
+	}
+
 	boundingRectangle = curveShape.boundingRect();
 
 	foreach (const QPolygonF& pol, fillPolygons)
@@ -1798,6 +2625,12 @@ void XYCurvePrivate::draw(QPainter *painter) {
 		painter->drawPath(errorBarsPath);
 	}
 
+	//draw the density of the points
+	if (!m_densityImage.isNull()) {
+		painter->setOpacity(symbolsOpacity);
+		painter->drawImage(m_densityImageOrigin, m_densityImage);
+	}
+
 	//draw symbols
 	if (symbolsStyle != Symbol::NoSymbols) {
 		painter->setOpacity(symbolsOpacity);
@@ -1818,6 +2651,62 @@ void XYCurvePrivate::draw(QPainter *painter) {
 	DEBUG("XYCurvePrivate::draw() DONE");
 }
 
+/*!
+  draws the parts of the paths not contained in \c extension and the symbols of the appended points
+  on top of the current pixmap, the pixmap is enlarged if the curve grew.
+  Returns \c false if the pixmap has to be redrawn completely.
+*/
+bool XYCurvePrivate::extendPixmap(const PixmapExtension& extension) {
+	if (!extension.isValid() || m_pixmap.isNull() || !m_placeholderTransform.isIdentity()
+		|| fillingPosition != XYCurve::NoFilling || valuesType != XYCurve::NoValues)
+		return false;
+
+	const QRect currentRect(m_pixmapOrigin, m_pixmap.size());
+	const QRect rect = currentRect.united(boundingRectangle.toAlignedRect());
+	QPixmap pixmap = m_pixmap;
+	if (rect != currentRect) {
+		pixmap = QPixmap(rect.size());
+		pixmap.fill(Qt::transparent);
+	}
+
+	QPainter painter(&pixmap);
+	if (rect != currentRect)
+		painter.drawPixmap(currentRect.topLeft() - rect.topLeft(), m_pixmap);
+	painter.setRenderHint(QPainter::Antialiasing, true);
+	painter.translate(-rect.topLeft());
+	painter.setBrush(Qt::NoBrush);
+
+	if (lineType != XYCurve::NoLine) {
+		painter.setOpacity(lineOpacity);
+		painter.setPen(linePen);
+		painter.drawPath(pathTail(linePath, extension.lineElements));
+	}
+
+	if (dropLineType != XYCurve::NoDropLine) {
+		painter.setOpacity(dropLineOpacity);
+		painter.setPen(dropLinePen);
+		painter.drawPath(pathTail(dropLinePath, extension.dropLineElements));
+	}
+
+	if (xErrorType != XYCurve::NoError || yErrorType != XYCurve::NoError) {
+		painter.setOpacity(errorBarsOpacity);
+		painter.setPen(errorBarsPen);
+		painter.drawPath(pathTail(errorBarsPath, extension.errorBarsElements));
+	}
+
+	if (symbolsStyle != Symbol::NoSymbols) {
+		painter.setOpacity(symbolsOpacity);
+		painter.setPen(symbolsPen);
+		painter.setBrush(symbolsBrush);
+		drawSymbols(&painter, extension.symbols);
+	}
+	painter.end();
+
+	m_pixmap = pixmap;
+	m_pixmapOrigin = rect.topLeft();
+	return true;
+}
+
 void XYCurvePrivate::updatePixmap() {
 	DEBUG("XYCurvePrivate::updatePixmap()");
 	WAIT_CURSOR;
@@ -1826,20 +2715,28 @@ void XYCurvePrivate::updatePixmap() {
 // 	timer.start();
 	m_hoverEffectImageIsDirty = true;
 	m_selectionEffectImageIsDirty = true;
+	const PixmapExtension extension = m_pixmapExtension;
+	m_pixmapExtension = PixmapExtension();
 	if (boundingRectangle.width() == 0 || boundingRectangle.width() == 0) {
 		m_pixmap = QPixmap();
 		RESET_CURSOR;
 		return;
 	}
-	QPixmap pixmap(ceil(boundingRectangle.width()), ceil(boundingRectangle.height()));
-	pixmap.fill(Qt::transparent);
-	QPainter painter(&pixmap);
-	painter.setRenderHint(QPainter::Antialiasing, true);
-	painter.translate(-boundingRectangle.topLeft());
 
-	draw(&painter);
-	painter.end();
-	m_pixmap = pixmap;
+	if (!extendPixmap(extension)) {
+		//the pixmap is aligned to whole pixels, so it can be extended without resampling
+		const QRect rect = boundingRectangle.toAlignedRect();
+		QPixmap pixmap(rect.size());
+		pixmap.fill(Qt::transparent);
+		QPainter painter(&pixmap);
+		painter.setRenderHint(QPainter::Antialiasing, true);
+		painter.translate(-rect.topLeft());
+
+		draw(&painter);
+		painter.end();
+		m_pixmap = pixmap;
+		m_pixmapOrigin = rect.topLeft();
+	}
 
 	//QApplication::processEvents(QEventLoop::AllEvents, 0);
 
@@ -1849,72 +2746,129 @@ void XYCurvePrivate::updatePixmap() {
 	DEBUG("XYCurvePrivate::updatePixmap() DONE");
 }
 
-//TODO: move this to a central place
-QImage blurred(const QImage& image, const QRect& rect, int radius, bool alphaOnly = false) {
-	int tab[] = { 14, 10, 8, 6, 5, 5, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2 };
-	int alpha = (radius < 1)  ? 16 : (radius > 17) ? 1 : tab[radius-1];
+//the halo mask has half the resolution of the pixmap
+static const int haloMaskScale = 2;
 
-	QImage result = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-	int r1 = rect.top();
-	int r2 = rect.bottom();
-	int c1 = rect.left();
-	int c2 = rect.right();
+/*!
+  box blur with radius 1 along the columns of the \c width x \c height values in \c in, the result is written to \c out.
+  The inner loop runs along a row, independent for each column, and is vectorized by the compiler.
+*/
+static void blurColumns(const uchar* in, uchar* out, int width, int height) {
+	for (int y = 0; y < height; ++y) {
+		const uchar* above = in + qMax(y - 1, 0)*width;
+		const uchar* row = in + y*width;
+		const uchar* below = in + qMin(y + 1, height - 1)*width;
+		uchar* result = out + y*width;
+		for (int x = 0; x < width; ++x)
+			result[x] = (above[x] + row[x] + below[x] + 1)/3;
+	}
+}
 
-	int bpl = result.bytesPerLine();
-	int rgba[4];
-	unsigned char* p;
+static void transpose(const uchar* in, uchar* out, int width, int height) {
+	for (int y = 0; y < height; ++y) {
+		const uchar* row = in + y*width;
+		for (int x = 0; x < width; ++x)
+			out[x*height + y] = row[x];
+	}
+}
 
-	int i1 = 0;
-	int i2 = 3;
+/*!
+  calculates the halo of the curve drawn in \c image: the alpha channel is downscaled by haloMaskScale
+  and blurred with three box blur passes in each direction, approximating a gaussian blur.
+  Returns a black image with the blurred alpha channel. Is called in a worker thread.
+*/
+QImage XYCurvePrivate::calculateHaloMask(const QImage& pixmapImage) {
+	const QImage image = pixmapImage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+	const int width = (image.width() + haloMaskScale - 1)/haloMaskScale;
+	const int height = (image.height() + haloMaskScale - 1)/haloMaskScale;
+	if (width == 0 || height == 0)
+		return QImage();
+
+	//average the alpha values of the pixels covered by one pixel of the mask
+	std::vector<uchar> alpha(width*height);
+	std::vector<uchar> temp(width*height);
+	std::vector<int> sums(width);
+	for (int y = 0; y < height; ++y) {
+		std::fill(sums.begin(), sums.end(), 0);
+
+		int count = 0;
+		for (int row = y*haloMaskScale; row < qMin((y + 1)*haloMaskScale, image.height()); ++row, ++count) {
+			const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(row));
+			for (int col = 0; col < image.width(); ++col)
+				sums[col/haloMaskScale] += qAlpha(line[col]);
+		}
 
-	if (alphaOnly)
-		i1 = i2 = (QSysInfo::ByteOrder == QSysInfo::LittleEndian)*3;
+		for (int x = 0; x < width; ++x) {
+			const int pixels = count*qMin(haloMaskScale, image.width() - x*haloMaskScale);
+			alpha[y*width + x] = sums[x]/pixels;
+		}
+	}
 
-	for (int col = c1; col <= c2; col++) {
-		p = result.scanLine(r1) + col * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
+	//blur the columns, transpose, blur the former rows and transpose back
+	for (int i = 0; i < 3; ++i) {
+		blurColumns(&alpha[0], &temp[0], width, height);
+		alpha.swap(temp);
+	}
+	transpose(&alpha[0], &temp[0], width, height);
+	alpha.swap(temp);
+	for (int i = 0; i < 3; ++i) {
+		blurColumns(&alpha[0], &temp[0], height, width);
+		alpha.swap(temp);
+	}
+	transpose(&alpha[0], &temp[0], height, width);
 
-		p += bpl;
-		for (int j = r1; j < r2; j++, p += bpl)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
+	QImage mask(width, height, QImage::Format_ARGB32_Premultiplied);
+	for (int y = 0; y < height; ++y) {
+		QRgb* line = reinterpret_cast<QRgb*>(mask.scanLine(y));
+		const uchar* values = &temp[y*width];
+		for (int x = 0; x < width; ++x)
+			line[x] = (QRgb)values[x] << 24;
 	}
 
-	for (int row = r1; row <= r2; row++) {
-		p = result.scanLine(row) + c1 * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
+	return mask;
+}
 
-		p += 4;
-		for (int j = c1; j < c2; j++, p += 4)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
-	}
+/*!
+  returns \c true if the halo mask for the current pixmap is available.
+  Otherwise, the calculation is started in the background and the curve is updated when it's finished.
+*/
+bool XYCurvePrivate::haloMaskReady() {
+	if (m_pixmap.isNull())
+		return false;
 
-	for (int col = c1; col <= c2; col++) {
-		p = result.scanLine(r2) + col * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
+	const qint64 key = m_pixmap.cacheKey();
+	if (m_haloMaskPixmapKey == key)
+		return true;
 
-		p -= bpl;
-		for (int j = r1; j < r2; j++, p -= bpl)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
+	if (m_haloMaskRequestKey != key) {
+		m_haloMaskRequestKey = key;
+		m_haloMaskWatcher.setFuture(QtConcurrent::run(&XYCurvePrivate::calculateHaloMask, m_pixmap.toImage()));
 	}
 
-	for (int row = r1; row <= r2; row++) {
-		p = result.scanLine(row) + c2 * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
+	return false;
+}
 
-		p -= 4;
-		for (int j = c1; j < c2; j++, p -= 4)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
-	}
+void XYCurvePrivate::haloMaskFinished() {
+	m_haloMask = m_haloMaskWatcher.result();
+	m_haloMaskPixmapKey = m_haloMaskRequestKey;
+	m_hoverEffectImageIsDirty = true;
+	m_selectionEffectImageIsDirty = true;
+	update();
+}
 
-	return result;
+/*!
+  returns the halo mask filled with \c color.
+*/
+QImage XYCurvePrivate::haloImage(const QColor& color) const {
+	if (m_haloMask.isNull())
+		return QImage();
+
+	QImage image = m_haloMask;
+	QPainter painter(&image);
+	painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+	painter.fillRect(image.rect(), color);
+	painter.end();
+	return image;
 }
 
 /*!
@@ -1936,41 +2890,54 @@ void XYCurvePrivate::paint(QPainter* painter, const QStyleOptionGraphicsItem* op
 	painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
 
  	DEBUG("XYCurvePrivate::paint() calling drawPixmap() or draw() 		XXXXXXXXXXXXXXXXXXXX");
-	if ( KGlobal::config()->group("Settings_Worksheet").readEntry(QLatin1String("DoubleBuffering"), true) )
-		painter->drawPixmap(boundingRectangle.topLeft(), m_pixmap); //draw the cached pixmap (fast)
-	else
-		draw(painter); //draw directly again (slow)
+	//while the geometry is calculated in the background or the plot is zoomed interactively,
+	//the current pixmap is shown transformed to the new plot ranges
+	QRectF pixmapRect(m_pixmapOrigin, QSizeF(m_pixmap.size()));
+	if (!m_placeholderTransform.isIdentity())
+		pixmapRect = m_placeholderTransform.mapRect(pixmapRect);
+
+	if (doubleBuffering()) {
+		painter->drawPixmap(pixmapRect, m_pixmap, m_pixmap.rect()); //draw the cached pixmap (fast)
+	} else {
+		//draw directly again (slow)
+		painter->save();
+		if (!m_placeholderTransform.isIdentity())
+			painter->setTransform(m_placeholderTransform, true);
+		draw(painter);
+		painter->restore();
+	}
 
 // 	qDebug() << "Paint the pixmap: " << timer.elapsed() << "ms";
 
+	//the halo has the downscaled size, the source rectangle covers the part corresponding to the pixmap
+	const QRectF haloRect(0, 0, (qreal)m_pixmap.width()/haloMaskScale, (qreal)m_pixmap.height()/haloMaskScale);
+
 	if (m_hovered && !isSelected() && !m_printing) {
 // 		timer.start();
-		if (m_hoverEffectImageIsDirty) {
-			QPixmap pix = m_pixmap;
-			pix.fill(q->hoveredPen.color());
-			pix.setAlphaChannel(m_pixmap.alphaChannel());
-			m_hoverEffectImage = blurred(pix.toImage(), m_pixmap.rect(), 5);
+		if (m_hoverEffectImageIsDirty && haloMaskReady()) {
+			m_hoverEffectImage = haloImage(q->hoveredPen.color());
 			m_hoverEffectImageIsDirty = false;
 		}
 
-		painter->setOpacity(q->hoveredOpacity*2);
-		painter->drawImage(boundingRectangle.topLeft(), m_hoverEffectImage, m_pixmap.rect());
+		if (!m_hoverEffectImageIsDirty) {
+			painter->setOpacity(q->hoveredOpacity*2);
+			painter->drawImage(pixmapRect, m_hoverEffectImage, haloRect);
+		}
 // 		qDebug() << "Paint hovering effect: " << timer.elapsed() << "ms";
 		return;
 	}
 
 	if (isSelected() && !m_printing) {
 // 		timer.start();
-		if (m_selectionEffectImageIsDirty) {
-			QPixmap pix = m_pixmap;
-			pix.fill(q->selectedPen.color());
-			pix.setAlphaChannel(m_pixmap.alphaChannel());
-			m_selectionEffectImage = blurred(pix.toImage(), m_pixmap.rect(), 5);
+		if (m_selectionEffectImageIsDirty && haloMaskReady()) {
+			m_selectionEffectImage = haloImage(q->selectedPen.color());
 			m_selectionEffectImageIsDirty = false;
 		}
 
-		painter->setOpacity(q->selectedOpacity*2);
-		painter->drawImage(boundingRectangle.topLeft(), m_selectionEffectImage, m_pixmap.rect());
+		if (!m_selectionEffectImageIsDirty) {
+			painter->setOpacity(q->selectedOpacity*2);
+			painter->drawImage(pixmapRect, m_selectionEffectImage, haloRect);
+		}
 // 		qDebug() << "Paint selection effect: " << timer.elapsed() << "ms";
 		return;
 	}
@@ -1979,7 +2946,10 @@ void XYCurvePrivate::paint(QPainter* painter, const QStyleOptionGraphicsItem* op
 /*!
 	Drawing of symbolsPath is very slow, so we draw every symbol in the loop which is much faster (factor 10)
 */
-void XYCurvePrivate::drawSymbols(QPainter* painter) {
+/*!
+  draws the symbols at the visible points starting with the point \c first.
+*/
+void XYCurvePrivate::drawSymbols(QPainter* painter, int first) {
 	QPainterPath path = Symbol::pathFromStyle(symbolsStyle);
 
 	QTransform trafo;
@@ -1990,7 +2960,8 @@ void XYCurvePrivate::drawSymbols(QPainter* painter) {
 		trafo.rotate(symbolsRotationAngle);
 		path = trafo.map(path);
 	}
-	foreach (const QPointF& point, symbolPointsScene) {
+	for (int i = first; i < symbolPointsScene.size(); ++i) {
+		const QPointF& point = symbolPointsScene.at(i);
 		trafo.reset();
 		trafo.translate(point.x(), point.y());
 		painter->drawPath(trafo.map(path));
@@ -2161,6 +3132,8 @@ void XYCurve::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute( "opacity", QString::number(d->symbolsOpacity) );
 	writer->writeAttribute( "rotation", QString::number(d->symbolsRotationAngle) );
 	writer->writeAttribute( "size", QString::number(d->symbolsSize) );
+	writer->writeAttribute( "densityType", QString::number(d->densityType) );
+	writer->writeAttribute( "densityColorMap", QString::number(d->densityColorMap) );
 	WRITE_QBRUSH(d->symbolsBrush);
 	WRITE_QPEN(d->symbolsPen);
 	writer->writeEndElement();
@@ -2274,6 +3247,13 @@ bool XYCurve::load(XmlStreamReader* reader) {
 			READ_DOUBLE_VALUE("rotation", symbolsRotationAngle);
 			READ_DOUBLE_VALUE("size", symbolsSize);
 
+			//the density attributes are not available in projects created with older versions
+			str = attribs.value("densityType").toString();
+			d->densityType = str.isEmpty() ? XYCurve::NoDensity : (XYCurve::DensityType)str.toInt();
+			str = attribs.value("densityColorMap").toString();
+			if (!str.isEmpty())
+				d->densityColorMap = (ColorMapRenderer::ColorMap)str.toInt();
+
 			READ_QBRUSH(d->symbolsBrush);
 			READ_QPEN(d->symbolsPen);
 		} else if (reader->name() == "values") {
@@ -35,6 +35,7 @@
 #include "backend/worksheet/plots/PlotArea.h"
 #include "backend/lib/macros.h"
 #include "backend/core/AbstractColumn.h"
+#include "tools/ColorMapRenderer.h"
 
 #include <QFont>
 #include <QPen>
@@ -52,6 +53,7 @@ class XYCurve: public WorksheetElement {
 		enum ErrorType {NoError, SymmetricError, AsymmetricError};
 		enum FillingPosition {NoFilling, FillingAbove, FillingBelow, FillingZeroBaseline, FillingLeft, FillingRight};
 		enum ErrorBarsType {ErrorBarsSimple, ErrorBarsWithEnds};
+		enum DensityType {NoDensity, DensityLinear, DensitySqrt, DensityLog};
 
 		explicit XYCurve(const QString &name);
 		virtual ~XYCurve();
@@ -85,6 +87,8 @@ class XYCurve: public WorksheetElement {
 		BASIC_D_ACCESSOR_DECL(qreal, symbolsSize, SymbolsSize)
 		CLASS_D_ACCESSOR_DECL(QBrush, symbolsBrush, SymbolsBrush)
 		CLASS_D_ACCESSOR_DECL(QPen, symbolsPen, SymbolsPen)
+		BASIC_D_ACCESSOR_DECL(DensityType, densityType, DensityType)
+		BASIC_D_ACCESSOR_DECL(ColorMapRenderer::ColorMap, densityColorMap, DensityColorMap)
 
 		BASIC_D_ACCESSOR_DECL(ValuesType, valuesType, ValuesType)
 		POINTER_D_ACCESSOR_DECL(const AbstractColumn, valuesColumn, ValuesColumn)
@@ -127,6 +131,8 @@ class XYCurve: public WorksheetElement {
 		virtual bool isVisible() const;
 		virtual void setPrinting(bool on);
 		void suppressRetransform(bool);
+		void retransformPreview();
+		static void setDoubleBuffering(bool);
 
 		typedef WorksheetElement BaseClass;
 		typedef XYCurvePrivate Private;
@@ -138,6 +144,10 @@ class XYCurve: public WorksheetElement {
 	private slots:
 		void updateValues();
 		void updateErrorBars();
+		void geometryFinished();
+		void densityFinished();
+		void invalidateDensity();
+		void haloMaskFinished();
 		void xColumnAboutToBeRemoved(const AbstractAspect*);
 		void yColumnAboutToBeRemoved(const AbstractAspect*);
 		void valuesColumnAboutToBeRemoved(const AbstractAspect*);
@@ -199,12 +209,16 @@ class XYCurve: public WorksheetElement {
 		friend class XYCurveSetSymbolsOpacityCmd;
 		friend class XYCurveSetSymbolsBrushCmd;
 		friend class XYCurveSetSymbolsPenCmd;
+		friend class XYCurveSetDensityTypeCmd;
+		friend class XYCurveSetDensityColorMapCmd;
 		void symbolsStyleChanged(Symbol::Style);
 		void symbolsSizeChanged(qreal);
 		void symbolsRotationAngleChanged(qreal);
 		void symbolsOpacityChanged(qreal);
 		void symbolsBrushChanged(QBrush);
 		void symbolsPenChanged(const QPen&);
+		void densityTypeChanged(XYCurve::DensityType);
+		void densityColorMapChanged(ColorMapRenderer::ColorMap);
 
 		//Values-Tab
 		friend class XYCurveSetValuesColumnCmd;
@@ -29,14 +29,21 @@
 #ifndef XYCURVEPRIVATE_H
 #define XYCURVEPRIVATE_H
 
+#include "backend/core/column/ColumnValues.h"
+#include "backend/lib/Interval.h"
+
 #include <QGraphicsItem>
+#include <QFutureWatcher>
+#include <QSharedPointer>
 #include <vector>
 
 class CartesianPlot;
+class CartesianCoordinateSystem;
 
 class XYCurvePrivate: public QGraphicsItem {
 	public:
 		explicit XYCurvePrivate(XYCurve *owner);
+		virtual ~XYCurvePrivate();
 
 		QString name() const;
 		virtual QRectF boundingRect() const;
@@ -47,21 +54,140 @@ class XYCurvePrivate: public QGraphicsItem {
 		bool m_suppressRecalc;
 		bool m_suppressRetransform;
 		QPixmap m_pixmap;
+		QPoint m_pixmapOrigin;	//position of the top left corner of m_pixmap in item coordinates
 		QImage m_hoverEffectImage;
 		QImage m_selectionEffectImage;
 		bool m_hoverEffectImageIsDirty;
 		bool m_selectionEffectImageIsDirty;
 
+		//blurred alpha channel of m_pixmap, downscaled, used for the hover and selection effects
+		QImage m_haloMask;
+		qint64 m_haloMaskPixmapKey;	//cache key of the pixmap m_haloMask was calculated for
+		qint64 m_haloMaskRequestKey;	//cache key of the pixmap the running calculation is done for
+		QFutureWatcher<QImage> m_haloMaskWatcher;
+		static QImage calculateHaloMask(const QImage&);
+		bool haloMaskReady();
+		void haloMaskFinished();
+		QImage haloImage(const QColor&) const;
+
+		//! input and result of the calculation of the lines, drop lines and symbols in scene coordinates
+		struct Geometry {
+			Geometry();
+			bool isStale() const;
+
+			int generation;
+			QSharedPointer<QAtomicInt> latestGeneration;	//set for calculations in the background, stale calculations are canceled
+			const CartesianCoordinateSystem* cSystem;
+			QTransform sceneTransform;	//maps logical to scene coordinates for the first scales of cSystem
+			QVector<double> mappingKey;	//scales and plot rectangle, the points are mapped the same way as long as it doesn't change
+			int firstNewPoint;	//lines, drop lines and symbols of the points before this index are calculated already and kept
+			int firstNewScenePoint;
+
+			QList<QPointF> pointsLogical;
+			std::vector<bool> connectedPoints;
+			XYCurve::LineType lineType;
+			bool lineSkipGaps;
+			int lineInterpolationPointsCount;
+			XYCurve::DropLineType dropLineType;
+			double xMin;
+			double yMin;
+			double yColumnMin;
+			double yColumnMax;
+			Symbol::Style symbolsStyle;
+			qreal symbolsSize;
+			qreal symbolsRotationAngle;
+
+			QList<QPointF> pointsScene;
+			std::vector<bool> visiblePoints;
+			QList<QLineF> lines;
+			QPainterPath linePath;
+			QPainterPath dropLinePath;
+			QPainterPath symbolsPath;
+		};
+
+		static Geometry calculateGeometry(Geometry, QSharedPointer<CartesianCoordinateSystem>);
+		static void calculateLines(Geometry&);
+		static void calculateDropLines(Geometry&);
+		static void calculateSymbols(Geometry&);
+		Geometry geometryInput() const;
+		int unchangedPoints(const Geometry&) const;
+		void applyGeometry(const Geometry&);
+		void geometryFinished();
+		void finishGeometry();
+
+		bool m_geometryPending;
+		QSharedPointer<QAtomicInt> m_geometryGeneration;
+		QFutureWatcher<Geometry> m_geometryWatcher;
+		QTransform m_geometryTransform;	//scene transformation the current paths and the pixmap were calculated with
+		QTransform m_placeholderTransform;	//maps the current pixmap to its position in the new scene transformation, identity if up to date
+		QVector<double> m_geometryMappingKey;	//mapping key of the current paths, empty if they have to be recalculated
+
+		//! parts of the current paths drawn on the pixmap already, the rest is drawn on top of it after points were appended
+		struct PixmapExtension {
+			PixmapExtension();
+			bool isValid() const { return symbols >= 0; }
+
+			int lineElements;
+			int dropLineElements;
+			int errorBarsElements;
+			int symbols;
+		};
+		PixmapExtension m_pixmapExtension;
+		bool extendPixmap(const PixmapExtension&);
+
+		//! input and result of the binning of the data points into a two-dimensional histogram in scene coordinates
+		struct Density {
+			Density();
+			bool isStale() const;
+			int rowCount() const;
+			const double* x() const { return xData.isEmpty() ? xValues.constData() : xData.constData(); }
+			const double* y() const { return yData.isEmpty() ? yValues.constData() : yData.constData(); }
+
+			int generation;
+			QSharedPointer<QAtomicInt> latestGeneration;	//set for calculations in the background, stale calculations are canceled
+			QTransform sceneTransform;
+			QVector<double> mappingKey;
+			ColumnValues xValues;	//values of numeric columns
+			ColumnValues yValues;
+			QVector<double> xData;	//values of the other columns, NAN for invalid rows
+			QVector<double> yData;
+			QList< Interval<int> > maskedRows;
+
+			QRect rect;	//bins of one scene unit covering this rectangle
+			QVector<quint32> counts;
+			quint32 maxCount;
+		};
+
+		static Density calculateDensity(Density, QSharedPointer<CartesianCoordinateSystem>);
+		void retransformDensity();
+		void applyDensity(const Density&);
+		void densityFinished();
+		void updateDensity();
+		void updateDensityImage();
+		void clearDensity();
+		void clearGeometry();
+
+		bool m_densityPending;
+		bool m_densityDataChanged;	//the data was changed since the points were binned
+		QSharedPointer<QAtomicInt> m_densityGeneration;
+		QFutureWatcher<Density> m_densityWatcher;
+		const AbstractColumn* m_densityXColumn;	//columns the current density was calculated for
+		const AbstractColumn* m_densityYColumn;
+		Density m_density;
+		QImage m_densityImage;
+		QPoint m_densityImageOrigin;
+
 		void retransform();
+		void retransformPreview();
 		void updateLines();
 		void updateDropLines();
 		void updateSymbols();
 		void updateValues();
 		void updateFilling();
-		void updateErrorBars();
+		void updateErrorBars(int first = 0);
 		bool swapVisible(bool on);
 		void recalcShapeAndBoundingRect();
-		void drawSymbols(QPainter*);
+		void drawSymbols(QPainter*, int first = 0);
 		void drawValues(QPainter*);
 		void drawFilling(QPainter*);
 		void draw(QPainter*);
@@ -94,6 +220,8 @@ class XYCurvePrivate: public QGraphicsItem {
 		qreal symbolsOpacity;
 		qreal symbolsRotationAngle;
 		qreal symbolsSize;
+		XYCurve::DensityType densityType;
+		ColorMapRenderer::ColorMap densityColorMap;
 
 		//values
 		XYCurve::ValuesType valuesType;
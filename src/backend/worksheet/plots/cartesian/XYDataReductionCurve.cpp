@@ -215,15 +215,18 @@ void XYDataReductionCurvePrivate::recalculate() {
 	QVector<double> ydataVector;
 	const double xmin = dataReductionData.xRange.first();
 	const double xmax = dataReductionData.xRange.last();
-	for (int row=0; row<xDataColumn->rowCount(); ++row) {
+	const int rowCount = xDataColumn->rowCount();
+	xdataVector.reserve(rowCount);
+	ydataVector.reserve(rowCount);
+	for (int row = 0; row < rowCount; ++row) {
 		//only copy those data where _all_ values (for x and y, if given) are valid
-		if (!std::isnan(xDataColumn->valueAt(row)) && !std::isnan(yDataColumn->valueAt(row))
-			&& !xDataColumn->isMasked(row) && !yDataColumn->isMasked(row)) {
-
+		const double x = xDataColumn->valueAt(row);
+		const double y = yDataColumn->valueAt(row);
+		if (!std::isnan(x) && !std::isnan(y) && !xDataColumn->isMasked(row) && !yDataColumn->isMasked(row)) {
 			// only when inside given range
-			if (xDataColumn->valueAt(row) >= xmin && xDataColumn->valueAt(row) <= xmax) {
-				xdataVector.append(xDataColumn->valueAt(row));
-				ydataVector.append(yDataColumn->valueAt(row));
+			if (x >= xmin && x <= xmax) {
+				xdataVector.append(x);
+				ydataVector.append(y);
 			}
 		}
 	}
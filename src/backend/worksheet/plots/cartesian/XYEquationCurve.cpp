@@ -30,6 +30,10 @@
   \class XYEquationCurve
   \brief A xy-curve defined by a mathematical equation
 
+  Cartesian equations can be sampled adaptively (EquationData::adaptive): on every change of the plot ranges
+  the equation is evaluated in the background in the visible x-range only, intervals are subdivided
+  until the curve deviates from the chord by less than half a pixel.
+
   \ingroup worksheet
 */
 
@@ -39,9 +43,22 @@
 #include "backend/core/column/Column.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/gsl/ExpressionParser.h"
+#include "backend/worksheet/Worksheet.h"
+#include "backend/worksheet/plots/cartesian/CartesianPlot.h"
+#include "backend/worksheet/plots/cartesian/CartesianCoordinateSystem.h"
+
+#include <gsl/gsl_math.h>
 
 #include <KIcon>
 #include <KLocale>
+#include <QtConcurrentRun>
+
+//intervals of the initial grid, maximal subdivision depth and number of points of the adaptive sampling
+static const int samplingIntervals = 256;
+static const int samplingMaxDepth = 20;
+static const int samplingMaxPoints = 100000;
+//number of samplings kept for recently shown ranges
+static const int samplingCacheSize = 8;
 
 XYEquationCurve::XYEquationCurve(const QString& name)
 		: XYCurve(name, new XYEquationCurvePrivate(this)) {
@@ -83,6 +100,20 @@ void XYEquationCurve::recalculate() {
 	d->recalculate();
 }
 
+/*!
+	reimplemented from XYCurve, updates the adaptive sampling for the current plot ranges first.
+*/
+void XYEquationCurve::retransform() {
+	Q_D(XYEquationCurve);
+	d->updateAdaptiveSampling();
+	XYCurve::retransform();
+}
+
+void XYEquationCurve::adaptiveSamplingFinished() {
+	Q_D(XYEquationCurve);
+	d->adaptiveSamplingFinished();
+}
+
 /*!
 	Returns an icon to be used in the project explorer.
 */
@@ -105,7 +136,8 @@ void XYEquationCurve::setEquationData(const XYEquationCurve::EquationData& equat
 		|| (equationData.expression2 != d->equationData.expression2)
 		|| (equationData.min != d->equationData.min)
 		|| (equationData.max != d->equationData.max)
-		|| (equationData.count != d->equationData.count) )
+		|| (equationData.count != d->equationData.count)
+		|| (equationData.adaptive != d->equationData.adaptive) )
 		exec(new XYEquationCurveSetEquationDataCmd(d, equationData, i18n("%1: set equation")));
 }
 
@@ -117,13 +149,18 @@ XYEquationCurvePrivate::XYEquationCurvePrivate(XYEquationCurve* owner) : XYCurve
 	yColumn(new Column("y", AbstractColumn::Numeric)),
 	xVector(static_cast<QVector<double>* >(xColumn->data())),
 	yVector(static_cast<QVector<double>* >(yColumn->data())),
+	adaptiveMin(0),
+	adaptiveMax(0),
+	samplingGeneration(0),
 	q(owner)  {
 
+	QObject::connect(&samplingFutureWatcher, SIGNAL(finished()), q, SLOT(adaptiveSamplingFinished()));
 }
 
 XYEquationCurvePrivate::~XYEquationCurvePrivate() {
 	//no need to delete xColumn and yColumn, they are deleted
 	//when the parent aspect is removed
+	samplingFutureWatcher.waitForFinished();
 }
 
 void XYEquationCurvePrivate::recalculate() {
@@ -162,9 +199,240 @@ void XYEquationCurvePrivate::recalculate() {
 		xVector->clear();
 		yVector->clear();
 	}
+
+	//the samplings of the old equation are invalid now. The adaptive sampling is started
+	//in retransform(), called by the plot after the points calculated above were added.
+	++samplingGeneration;
+	samplingCache.clear();
+	requestedView = SamplingView();
+	adaptiveGraph = ExpressionGraph();
+	if (rc && equationData.adaptive && equationData.type == XYEquationCurve::Cartesian) {
+		ExpressionGraph minGraph;
+		ExpressionGraph maxGraph;
+		if (minGraph.compile(equationData.min, QStringList()) && maxGraph.compile(equationData.max, QStringList())
+			&& adaptiveGraph.compile(equationData.expression1, QStringList() << "x")) {
+			adaptiveMin = minGraph.evaluate(0);
+			adaptiveMax = maxGraph.evaluate(0);
+		} else {
+			//not supported by the expression graph, the points calculated above are used
+			adaptiveGraph = ExpressionGraph();
+		}
+	}
+
 	emit (q->dataChanged());
 }
 
+//##############################################################################
+//############################  adaptive sampling  #############################
+//##############################################################################
+bool XYEquationCurvePrivate::SamplingView::matches(const SamplingView& other) const {
+	//the scales may change by 10% before the sampling is recalculated
+	return xMin == other.xMin && xMax == other.xMax && min == other.min && max == other.max
+		&& xLog == other.xLog && yLog == other.yLog
+		&& fabs(xFactor - other.xFactor) <= 0.1*other.xFactor
+		&& fabs(yFactor - other.yFactor) <= 0.1*other.yFactor;
+}
+
+//all non-linear scales of CartesianPlot are logarithmic
+static double toScale(bool log, double value) {
+	return log ? ::log(value) : value;
+}
+
+static double fromScale(bool log, double value) {
+	return log ? exp(value) : value;
+}
+
+//! a point of the curve, \c sx and \c sy are its scene coordinates relative to the origin
+struct SamplePoint {
+	SamplePoint() : u(0), x(0), y(0), sx(0), sy(0), valid(false) {}
+	SamplePoint(const ExpressionGraph& graph, const XYEquationCurvePrivate::SamplingView& view, double value) : u(value) {
+		x = fromScale(view.xLog, u);
+		y = graph.evaluate(&x);
+		sx = u*view.xFactor;
+		sy = toScale(view.yLog, y)*view.yFactor;
+		valid = gsl_finite(sx) && gsl_finite(sy);
+	}
+
+	double u;	//x in the scale of the x-axis
+	double x, y;
+	double sx, sy;
+	bool valid;
+};
+
+//! an interval of the adaptive sampling that still has to be checked
+struct SampleInterval {
+	SampleInterval() : depth(0) {}
+	SampleInterval(const SamplePoint& p0, const SamplePoint& p1, int depth) : p0(p0), p1(p1), depth(depth) {}
+
+	SamplePoint p0, p1;
+	int depth;
+};
+
+/*!
+	returns \c true if the interval [p0,p1] has to be subdivided at its center pm, i.e. if pm deviates
+	from the chord p0-p1 by more than the tolerance or if the curve starts or ends in the interval.
+*/
+static bool needsSubdivision(const SamplePoint& p0, const SamplePoint& pm, const SamplePoint& p1, double tolerance) {
+	if (p0.valid != pm.valid || pm.valid != p1.valid)
+		return true;
+	if (!pm.valid)
+		return false;
+
+	const double dx = p1.sx - p0.sx;
+	const double dy = p1.sy - p0.sy;
+	const double length = sqrt(dx*dx + dy*dy);
+	double deviation;
+	if (length > 0)
+		deviation = fabs(dx*(pm.sy - p0.sy) - dy*(pm.sx - p0.sx))/length;
+	else
+		deviation = sqrt(gsl_pow_2(pm.sx - p0.sx) + gsl_pow_2(pm.sy - p0.sy));
+
+	return deviation > tolerance;
+}
+
+/*!
+	samples y=f(x) in [view.xMin, view.xMax]. Runs in a worker thread, the graph is evaluated concurrently.
+	The x-range of the equation is added at both ends so that the autoscaling of the plot doesn't shrink to the visible range.
+*/
+static XYEquationCurvePrivate::Sampling adaptiveSampling(const ExpressionGraph& graph, const XYEquationCurvePrivate::SamplingView& view, int generation) {
+	XYEquationCurvePrivate::Sampling sampling;
+	sampling.view = view;
+	sampling.generation = generation;
+	QVector<double>& xVector = sampling.x;
+	QVector<double>& yVector = sampling.y;
+
+	//half a pixel at 96 dpi and 100% zoom
+	const double tolerance = Worksheet::convertToSceneUnits(0.5/96., Worksheet::Inch);
+
+	if (view.min < view.xMin) {
+		xVector << view.min;
+		yVector << graph.evaluate(&view.min);
+	}
+
+	const double u0 = toScale(view.xLog, view.xMin);
+	const double u1 = toScale(view.xLog, view.xMax);
+	SamplePoint p0(graph, view, u0);
+	xVector << p0.x;
+	yVector << p0.y;
+
+	//the intervals of the grid are subdivided depth-first, left before right, to get the points in ascending order
+	QVector<SampleInterval> stack;
+	for (int i = 1; i <= samplingIntervals; ++i) {
+		const SamplePoint p1(graph, view, (i == samplingIntervals) ? u1 : u0 + i*(u1 - u0)/samplingIntervals);
+		stack.append(SampleInterval(p0, p1, 0));
+		while (!stack.isEmpty()) {
+			const SampleInterval interval = stack.last();
+			stack.removeLast();
+
+			const SamplePoint pm(graph, view, 0.5*(interval.p0.u + interval.p1.u));
+			if (interval.depth < samplingMaxDepth && xVector.size() + stack.size() < samplingMaxPoints
+				&& needsSubdivision(interval.p0, pm, interval.p1, tolerance)) {
+				stack.append(SampleInterval(pm, interval.p1, interval.depth + 1));
+				stack.append(SampleInterval(interval.p0, pm, interval.depth + 1));
+			} else {
+				xVector << pm.x << interval.p1.x;
+				yVector << pm.y << interval.p1.y;
+			}
+		}
+		p0 = p1;
+	}
+
+	if (view.max > view.xMax) {
+		xVector << view.max;
+		yVector << graph.evaluate(&view.max);
+	}
+
+	return sampling;
+}
+
+/*!
+	determines the visible part of the plot and starts the adaptive sampling for it
+	if it's neither cached nor the one shown at the moment.
+*/
+void XYEquationCurvePrivate::updateAdaptiveSampling() {
+	if (!adaptiveGraph.isValid())
+		return;
+
+	const CartesianPlot* plot = dynamic_cast<const CartesianPlot*>(q->parentAspect());
+	if (!plot)
+		return;
+	const CartesianCoordinateSystem* cSystem = dynamic_cast<const CartesianCoordinateSystem*>(plot->coordinateSystem());
+	if (!cSystem)
+		return;
+
+	SamplingView view;
+	view.min = adaptiveMin;
+	view.max = adaptiveMax;
+	view.xLog = (plot->xScale() != CartesianPlot::ScaleLinear);
+	view.yLog = (plot->yScale() != CartesianPlot::ScaleLinear);
+
+	//scene units per unit of the scales, range breaks are not taken into account
+	const double u0 = toScale(view.xLog, plot->xMin());
+	const double u1 = toScale(view.xLog, plot->xMax());
+	const double v0 = toScale(view.yLog, plot->yMin());
+	const double v1 = toScale(view.yLog, plot->yMax());
+	if (!gsl_finite(u0) || !gsl_finite(u1) || !gsl_finite(v0) || !gsl_finite(v1) || u0 == u1 || v0 == v1)
+		return;
+
+	const QPointF s0 = cSystem->mapLogicalToScene(QPointF(plot->xMin(), plot->yMin()), AbstractCoordinateSystem::SuppressPageClipping);
+	const QPointF s1 = cSystem->mapLogicalToScene(QPointF(plot->xMax(), plot->yMax()), AbstractCoordinateSystem::SuppressPageClipping);
+	view.xFactor = fabs((s1.x() - s0.x())/(u1 - u0));
+	view.yFactor = fabs((s1.y() - s0.y())/(v1 - v0));
+	if (view.xFactor == 0 || view.yFactor == 0)
+		return;
+
+	//the visible range plus a margin of 10% on both sides, restricted to the range of the equation
+	const double margin = 0.1*(u1 - u0);
+	view.xMin = qMax(fromScale(view.xLog, qMin(u0, u1) - fabs(margin)), adaptiveMin);
+	view.xMax = qMin(fromScale(view.xLog, qMax(u0, u1) + fabs(margin)), adaptiveMax);
+	if (!(view.xMin < view.xMax))
+		return;
+
+	if (view.matches(requestedView))
+		return;
+	requestedView = view;
+
+	for (int i = 0; i < samplingCache.size(); ++i) {
+		if (samplingCache.at(i).view.matches(view)) {
+			samplingCache.move(i, 0);
+			*xVector = samplingCache.first().x;
+			*yVector = samplingCache.first().y;
+			emit (q->dataChanged());
+			return;
+		}
+	}
+
+	//if a sampling is running, the requested view is sampled in adaptiveSamplingFinished()
+	if (!samplingFutureWatcher.isRunning())
+		samplingFutureWatcher.setFuture(QtConcurrent::run(adaptiveSampling, adaptiveGraph, view, samplingGeneration));
+}
+
+void XYEquationCurvePrivate::adaptiveSamplingFinished() {
+	const Sampling sampling = samplingFutureWatcher.result();
+	if (sampling.generation == samplingGeneration) {
+		samplingCache.prepend(sampling);
+		while (samplingCache.size() > samplingCacheSize)
+			samplingCache.removeLast();
+
+		if (sampling.view.matches(requestedView)) {
+			*xVector = sampling.x;
+			*yVector = sampling.y;
+			emit (q->dataChanged());
+			return;
+		}
+	}
+
+	//the equation or the plot ranges were changed in the meantime, sample the current view if it wasn't taken from the cache
+	if (!adaptiveGraph.isValid() || !(requestedView.xMin < requestedView.xMax))
+		return;
+	foreach (const Sampling& cached, samplingCache) {
+		if (cached.view.matches(requestedView))
+			return;
+	}
+
+	samplingFutureWatcher.setFuture(QtConcurrent::run(adaptiveSampling, adaptiveGraph, requestedView, samplingGeneration));
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -185,6 +453,7 @@ void XYEquationCurve::save(QXmlStreamWriter* writer) const{
 	writer->writeAttribute( "min", d->equationData.min);
 	writer->writeAttribute( "max", d->equationData.max );
 	writer->writeAttribute( "count", QString::number(d->equationData.count) );
+	writer->writeAttribute( "adaptive", QString::number(d->equationData.adaptive) );
 	writer->writeEndElement();
 
 	writer->writeEndElement();
@@ -223,6 +492,11 @@ bool XYEquationCurve::load(XmlStreamReader* reader) {
 			READ_STRING_VALUE("min", equationData.min);
 			READ_STRING_VALUE("max", equationData.max);
 			READ_INT_VALUE("count", equationData.count, int);
+
+			//not available in projects created with older versions, keep the uniform sampling then
+			str = attribs.value("adaptive").toString();
+			if (!str.isEmpty())
+				d->equationData.adaptive = str.toInt();
 		}
 	}
 
@@ -39,7 +39,7 @@ class XYEquationCurve: public XYCurve {
 		enum EquationType {Cartesian, Polar, Parametric, Implicit, Neutral};
 
 		struct EquationData {
-			EquationData() : type(Cartesian), min("0"), max("1"), count(1000) {};
+			EquationData() : type(Cartesian), min("0"), max("1"), count(1000), adaptive(false) {};
 
 			EquationType type;
 			QString expression1;
@@ -47,6 +47,7 @@ class XYEquationCurve: public XYCurve {
 			QString min;
 			QString max;
 			int count;
+			bool adaptive; //!< sample y=f(x) adaptively in the visible x-range instead of at count points
 		};
 
 		explicit XYEquationCurve(const QString& name);
@@ -62,6 +63,9 @@ class XYEquationCurve: public XYCurve {
 		typedef WorksheetElement BaseClass;
 		typedef XYEquationCurvePrivate Private;
 
+	public slots:
+		virtual void retransform();
+
 	protected:
 		XYEquationCurve(const QString& name, XYEquationCurvePrivate* dd);
 
@@ -69,6 +73,9 @@ class XYEquationCurve: public XYCurve {
 		Q_DECLARE_PRIVATE(XYEquationCurve)
 		void init();
 
+	private slots:
+		void adaptiveSamplingFinished();
+
 	signals:
 		friend class XYEquationCurveSetEquationDataCmd;
 		void equationDataChanged(const XYEquationCurve::EquationData&);
@@ -31,6 +31,9 @@
 
 #include "backend/worksheet/plots/cartesian/XYCurvePrivate.h"
 #include "backend/worksheet/plots/cartesian/XYEquationCurve.h"
+#include "backend/gsl/ExpressionGraph.h"
+
+#include <QFutureWatcher>
 
 class XYEquationCurve;
 class Column;
@@ -41,6 +44,27 @@ class XYEquationCurvePrivate: public XYCurvePrivate {
 		~XYEquationCurvePrivate();
 
 		void recalculate();
+		void updateAdaptiveSampling();
+		void adaptiveSamplingFinished();
+
+		//! the part of the plot an adaptive sampling is calculated for
+		struct SamplingView {
+			SamplingView() : xMin(0), xMax(0), min(0), max(0), xLog(false), yLog(false), xFactor(0), yFactor(0) {}
+			bool matches(const SamplingView&) const;
+
+			double xMin, xMax;	//evaluated x-range, the visible range plus a margin
+			double min, max;	//x-range of the equation
+			bool xLog, yLog;	//logarithmic scales
+			double xFactor, yFactor;	//scene units per (logarithmic) logical unit
+		};
+
+		struct Sampling {
+			Sampling() : generation(0) {}
+			SamplingView view;
+			int generation;	//samplings of previous equations are discarded
+			QVector<double> x;
+			QVector<double> y;
+		};
 
 		XYEquationCurve::EquationData equationData;
 		Column* xColumn;
@@ -48,6 +72,14 @@ class XYEquationCurvePrivate: public XYCurvePrivate {
 		QVector<double>* xVector;
 		QVector<double>* yVector;
 
+		ExpressionGraph adaptiveGraph;
+		double adaptiveMin;
+		double adaptiveMax;
+		SamplingView requestedView;
+		QList<Sampling> samplingCache;
+		int samplingGeneration;
+		QFutureWatcher<Sampling> samplingFutureWatcher;
+
 		XYEquationCurve* const q;
 };
 
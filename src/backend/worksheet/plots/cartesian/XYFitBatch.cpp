@@ -0,0 +1,258 @@
+/***************************************************************************
+    File                 : XYFitBatch.cpp
+    Project              : LabPlot
+    Description          : Concurrent fits of one model to several data sets
+                           and from several start values
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \class XYFitBatch
+  \brief Fits the model of a XYFitCurve to several data sets, optionally from several start vectors per data set.
+
+  The data of all data sets is copied on construction of the jobs, the fits run concurrently
+  in the global thread pool, each with its own solver workspace. The model is evaluated from its compiled
+  expression graph, models that can't be compiled are rejected in start().
+  For every data set the fit with the smallest sum of squared errors is kept.
+
+  \ingroup worksheet
+*/
+
+#include "XYFitBatch.h"
+#include "backend/core/column/Column.h"
+#include "backend/gsl/ExpressionGraph.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <gsl/gsl_math.h>
+#include <gsl/gsl_rng.h>
+#include <cfloat>
+
+#include <KLocale>
+#include <QtConcurrentMap>
+
+/* runs one job, called concurrently by QtConcurrent::mapped() */
+class FitJob {
+public:
+	typedef XYFitCurve::FitResult result_type;
+
+	explicit FitJob(const XYFitCurve::FitData& fitData) : m_fitData(fitData) {}
+
+	XYFitCurve::FitResult operator()(const XYFitBatch::Job& job) const {
+		return XYFitCurve::fit(m_fitData, job.startValues, job.x, job.y, job.sigma);
+	}
+
+private:
+	XYFitCurve::FitData m_fitData;
+};
+
+XYFitBatch::XYFitBatch(const XYFitCurve::FitData& fitData, QObject* parent) : QObject(parent),
+	m_fitData(fitData), m_startCount(1) {
+
+	connect(&m_watcher, SIGNAL(progressRangeChanged(int,int)), this, SIGNAL(progressRangeChanged(int,int)));
+	connect(&m_watcher, SIGNAL(progressValueChanged(int)), this, SIGNAL(progressValueChanged(int)));
+	connect(&m_watcher, SIGNAL(finished()), this, SLOT(jobsFinished()));
+}
+
+XYFitBatch::~XYFitBatch() {
+	m_watcher.cancel();
+	m_watcher.waitForFinished();
+}
+
+/*!
+  copies the valid data points of the columns \c x, \c y and \c weights to a new data set.
+  Has to be called from the main thread.
+ */
+void XYFitBatch::addDataSet(const QString& name, const AbstractColumn* x, const AbstractColumn* y, const AbstractColumn* weights) {
+	DataSet dataSet;
+	dataSet.name = name;
+	XYFitCurve::copyFitData(m_fitData, x, y, weights, dataSet.x, dataSet.y, dataSet.sigma);
+	m_dataSets.append(dataSet);
+}
+
+int XYFitBatch::dataSetCount() const {
+	return m_dataSets.size();
+}
+
+/*!
+  sets the number of fits per data set. The first fit starts from the start values of the fit data,
+  the other ones from random values within the parameter limits or, for parameters
+  without limits, around the start values.
+ */
+void XYFitBatch::setStartCount(int count) {
+	m_startCount = qMax(count, 1);
+}
+
+int XYFitBatch::startCount() const {
+	return m_startCount;
+}
+
+/*!
+  starts the fits in the background, finished() is emitted when all fits are done or the batch was canceled.
+  Returns \c false if the model can't be evaluated concurrently or if there is nothing to fit.
+ */
+bool XYFitBatch::start() {
+	if (m_watcher.isRunning() || m_dataSets.isEmpty())
+		return false;
+
+	const int np = m_fitData.paramNames.size();
+	if (np == 0 || m_fitData.paramStartValues.size() != np)
+		return false;
+
+	ExpressionGraph graph;
+	if (!graph.compile(m_fitData.model, QStringList() << "x" << m_fitData.paramNames))
+		return false;
+
+	//the random start values are created up front with a fixed seed to get reproducible results
+	gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+	m_jobs.clear();
+	m_results = QVector<XYFitCurve::FitResult>(m_dataSets.size());
+	for (int i = 0; i < m_dataSets.size(); ++i) {
+		const DataSet& dataSet = m_dataSets.at(i);
+		if (dataSet.x.size() < np) {
+			m_results[i].available = true;
+			m_results[i].status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", dataSet.x.size(), np);
+			continue;
+		}
+
+		Job job;
+		job.dataSet = i;
+		job.x = dataSet.x;
+		job.y = dataSet.y;
+		job.sigma = dataSet.sigma;
+		job.startValues = m_fitData.paramStartValues;
+		m_jobs.append(job);
+
+		for (int s = 1; s < m_startCount; ++s) {
+			for (int j = 0; j < np; ++j) {
+				//parameters without limits have the limits -DBL_MAX and DBL_MAX
+				const double min = m_fitData.paramLowerLimits.at(j);
+				const double max = m_fitData.paramUpperLimits.at(j);
+				const double startValue = m_fitData.paramStartValues.at(j);
+				double& value = job.startValues[j];
+				if (m_fitData.paramFixed.at(j))
+					value = startValue;
+				else if (min > -DBL_MAX && max < DBL_MAX)
+					value = min + (max - min)*gsl_rng_uniform(rng);
+				else {
+					//additive spread around the start value, such that start values of zero are varied too
+					value = startValue + (2.*gsl_rng_uniform(rng) - 1.)*qMax(fabs(startValue), 1.);
+					if (value < min)
+						value = min;
+					if (value > max)
+						value = max;
+				}
+			}
+			m_jobs.append(job);
+		}
+	}
+	gsl_rng_free(rng);
+
+	m_watcher.setFuture(QtConcurrent::mapped(m_jobs, FitJob(m_fitData)));
+	return true;
+}
+
+void XYFitBatch::cancel() {
+	m_watcher.cancel();
+}
+
+bool XYFitBatch::isRunning() const {
+	return m_watcher.isRunning();
+}
+
+void XYFitBatch::jobsFinished() {
+	const QFuture<XYFitCurve::FitResult> future = m_watcher.future();
+	for (int i = 0; i < m_jobs.size(); ++i) {
+		if (!future.isResultReadyAt(i))
+			continue;
+
+		const XYFitCurve::FitResult& fitResult = future.resultAt(i);
+		XYFitCurve::FitResult& best = m_results[m_jobs.at(i).dataSet];
+		if (!best.valid || fitResult.sse < best.sse)
+			best = fitResult;
+	}
+	m_jobs.clear();
+
+	emit finished();
+}
+
+/*!
+  returns the best fit result for the data set with the index \c dataSet.
+ */
+const XYFitCurve::FitResult& XYFitBatch::result(int dataSet) const {
+	return m_results.at(dataSet);
+}
+
+/*!
+  writes the name, the parameter values and errors and chi^2 of the best fit of every data set
+  to a row of the spreadsheet \c spreadsheet.
+ */
+void XYFitBatch::writeResults(Spreadsheet* spreadsheet) const {
+	const int np = m_fitData.paramNames.size();
+	const int rows = m_dataSets.size();
+	spreadsheet->setColumnCount(2*np + 2);
+	spreadsheet->setRowCount(rows);
+
+	QStringList names;
+	QVector<double> chi2(rows, NAN);
+	QVector< QVector<double> > values(np, QVector<double>(rows, NAN));
+	QVector< QVector<double> > errors(np, QVector<double>(rows, NAN));
+	for (int i = 0; i < rows; ++i) {
+		names << m_dataSets.at(i).name;
+		const XYFitCurve::FitResult& fitResult = m_results.at(i);
+		if (!fitResult.valid)
+			continue;
+
+		chi2[i] = fitResult.sse;
+		for (int j = 0; j < np; ++j) {
+			values[j][i] = fitResult.paramValues.at(j);
+			errors[j][i] = fitResult.errorValues.at(j);
+		}
+	}
+
+	Column* column = spreadsheet->column(0);
+	column->setName(i18n("data set"));
+	column->setColumnMode(AbstractColumn::Text);
+	column->setPlotDesignation(AbstractColumn::X);
+	column->replaceTexts(0, names);
+
+	for (int j = 0; j < np; ++j) {
+		column = spreadsheet->column(2*j + 1);
+		column->setName(m_fitData.paramNamesUtf8.value(j, m_fitData.paramNames.at(j)));
+		column->setColumnMode(AbstractColumn::Numeric);
+		column->setPlotDesignation(AbstractColumn::Y);
+		column->replaceValues(0, values.at(j));
+
+		column = spreadsheet->column(2*j + 2);
+		column->setName(i18n("%1 error", m_fitData.paramNamesUtf8.value(j, m_fitData.paramNames.at(j))));
+		column->setColumnMode(AbstractColumn::Numeric);
+		column->setPlotDesignation(AbstractColumn::YError);
+		column->replaceValues(0, errors.at(j));
+	}
+
+	column = spreadsheet->column(2*np + 1);
+	column->setName(i18n("chi^2"));
+	column->setColumnMode(AbstractColumn::Numeric);
+	column->setPlotDesignation(AbstractColumn::Y);
+	column->replaceValues(0, chi2);
+}
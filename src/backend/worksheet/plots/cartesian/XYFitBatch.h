@@ -0,0 +1,90 @@
+/***************************************************************************
+    File                 : XYFitBatch.h
+    Project              : LabPlot
+    Description          : Concurrent fits of one model to several data sets
+                           and from several start values
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef XYFITBATCH_H
+#define XYFITBATCH_H
+
+#include "backend/worksheet/plots/cartesian/XYFitCurve.h"
+#include <QFutureWatcher>
+
+class Spreadsheet;
+
+class XYFitBatch : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit XYFitBatch(const XYFitCurve::FitData&, QObject* parent = 0);
+		virtual ~XYFitBatch();
+
+		void addDataSet(const QString& name, const AbstractColumn* x, const AbstractColumn* y, const AbstractColumn* weights = 0);
+		int dataSetCount() const;
+		void setStartCount(int);
+		int startCount() const;
+
+		bool start();
+		void cancel();
+		bool isRunning() const;
+
+		const XYFitCurve::FitResult& result(int dataSet) const;
+		void writeResults(Spreadsheet*) const;
+
+		//! one fit of the model to a data set from one vector of start values
+		struct Job {
+			int dataSet;
+			QVector<double> x;
+			QVector<double> y;
+			QVector<double> sigma;
+			QVector<double> startValues;
+		};
+
+	private:
+		struct DataSet {
+			QString name;
+			QVector<double> x;
+			QVector<double> y;
+			QVector<double> sigma;
+		};
+
+		XYFitCurve::FitData m_fitData;
+		QVector<DataSet> m_dataSets;
+		QVector<XYFitCurve::FitResult> m_results;
+		QVector<Job> m_jobs;
+		int m_startCount;
+		QFutureWatcher<XYFitCurve::FitResult> m_watcher;
+
+	private slots:
+		void jobsFinished();
+
+	signals:
+		void progressRangeChanged(int minimum, int maximum);
+		void progressValueChanged(int value);
+		void finished();
+};
+
+#endif
@@ -41,6 +41,7 @@
 #include "backend/core/column/Column.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
+#include "backend/gsl/ExpressionGraph.h"
 #include "backend/gsl/ExpressionParser.h"
 
 extern "C" {
@@ -57,7 +58,9 @@ extern "C" {
 #include <KIcon>
 #include <KLocale>
 #include <QElapsedTimer>
+#include <QSemaphore>
 #include <QThreadPool>
+#include <QVarLengthArray>
 
 XYFitCurve::XYFitCurve(const QString& name)
 		: XYCurve(name, new XYFitCurvePrivate(this)) {
@@ -199,19 +202,119 @@ struct data {
 	nsl_fit_model_category modelCategory;
 	unsigned int modelType;
 	int degree;
-	QString* func;	// string containing the definition of the model/function
-	QStringList* paramNames;
-	double* paramMin;	// lower parameter limits
-	double* paramMax;	// upper parameter limits
-	bool* paramFixed;	// parameter fixed?
+	const QString* func;	// string containing the definition of the model/function
+	const QStringList* paramNames;
+	const double* paramMin;	// lower parameter limits
+	const double* paramMax;	// upper parameter limits
+	const bool* paramFixed;	// parameter fixed?
+	const ExpressionGraph* graph;	// compiled model, 0 if not available
+	bool parallel;	// evaluate the compiled model in several threads
 };
 
+/*!
+ * calculates the weighted residuals and/or the Jacobian of a model for the data points [start, end)
+ * in one evaluation pass over the compiled expression graph of the model.
+ */
+class ModelTask : public QRunnable {
+public:
+	ModelTask(size_t start, size_t end, const gsl_vector* paramValues, const struct data* params, gsl_vector* f, gsl_matrix* J,
+			QSemaphore* finished = 0) :
+		m_start(start), m_end(end), m_paramValues(paramValues), m_params(params), m_f(f), m_J(J), m_finished(finished) {
+	};
+
+	void run() {
+		evaluate();
+		if (m_finished)
+			m_finished->release();
+	}
+
+private:
+	void evaluate() {
+		const double* x = m_params->x;
+		const double* y = m_params->y;
+		const double* sigmaVector = m_params->sigma;
+		const bool* fixed = m_params->paramFixed;
+		const int np = m_params->paramNames->size();
+		// checks for allowed values of x for different models
+		const bool positiveX = (m_params->modelCategory == nsl_fit_model_distribution && m_params->modelType == nsl_sf_stats_lognormal);
+
+		// the first variable of the graph is x, followed by the parameters
+		QVarLengthArray<double, 16> variables(np + 1);
+		QVarLengthArray<double, 16> gradient(np + 1);
+		for (int j = 0; j < np; ++j)
+			variables[j + 1] = nsl_fit_map_bound(gsl_vector_get(m_paramValues, j), m_params->paramMin[j], m_params->paramMax[j]);
+
+		double sigma = 1.0;
+		for (size_t i = m_start; i < m_end; ++i) {
+			//rows without data don't contribute to the fit
+			if (std::isnan(x[i]) || std::isnan(y[i])) {
+				if (m_f)
+					gsl_vector_set(m_f, i, 0.);
+				if (m_J) {
+					for (int j = 0; j < np; ++j)
+						gsl_matrix_set(m_J, i, j, 0.);
+				}
+				continue;
+			}
+
+			variables[0] = (positiveX && x[i] < 0) ? 0. : x[i];
+			if (sigmaVector) sigma = sigmaVector[i];
+			const double Yi = m_params->graph->evaluate(variables.constData(), m_J ? gradient.data() : 0);
+
+			if (m_f)
+				gsl_vector_set(m_f, i, (Yi - y[i])/sigma);
+			if (m_J) {
+				for (int j = 0; j < np; ++j)
+					gsl_matrix_set(m_J, i, j, fixed[j] ? 0. : gradient[j + 1]/sigma);
+			}
+		}
+	}
+
+	size_t m_start;
+	size_t m_end;
+	const gsl_vector* m_paramValues;
+	const struct data* m_params;
+	gsl_vector* m_f;
+	gsl_matrix* m_J;
+	QSemaphore* m_finished;
+};
+
+/*!
+ * evaluates the compiled model, large data sets are distributed over several threads if params->parallel is set.
+ */
+static void evaluateModel(const gsl_vector* paramValues, const struct data* params, gsl_vector* f, gsl_matrix* J) {
+	const size_t n = params->n;
+	const size_t minPointsPerTask = 10000;
+	QThreadPool* pool = QThreadPool::globalInstance();
+	const size_t tasks = params->parallel ? qMin((size_t)pool->maxThreadCount(), n/minPointsPerTask) : 1;
+	if (tasks <= 1) {
+		ModelTask task(0, n, paramValues, params, f, J);
+		task.run();
+		return;
+	}
+
+	//wait for the tasks started here only, the global pool may be busy with other work
+	QSemaphore finished;
+	int started = 0;
+	const size_t range = (n + tasks - 1)/tasks;
+	for (size_t start = 0; start < n; start += range) {
+		pool->start(new ModelTask(start, qMin(start + range, n), paramValues, params, f, J, &finished));
+		++started;
+	}
+	finished.acquire(started);
+}
+
 /*!
  * \param paramValues vector containing current values of the fit parameters
  * \param params
  * \param f vector with the weighted residuals (Yi - y[i])/sigma[i]
  */
 int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
+	if (((struct data*)params)->graph) {
+		evaluateModel(paramValues, (struct data*)params, f, 0);
+		return GSL_SUCCESS;
+	}
+
 	size_t n = ((struct data*)params)->n;
 	double* x = ((struct data*)params)->x;
 	double* y = ((struct data*)params)->y;
@@ -219,9 +322,9 @@ int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
 	unsigned int modelType = ((struct data*)params)->modelType;
 	QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();	// a local byte array is needed!
-	QStringList* paramNames = ((struct data*)params)->paramNames;
-	double *min = ((struct data*)params)->paramMin;
-	double *max = ((struct data*)params)->paramMax;
+	const QStringList* paramNames = ((struct data*)params)->paramNames;
+	const double *min = ((struct data*)params)->paramMin;
+	const double *max = ((struct data*)params)->paramMax;
 
 	// set current values of the parameters
 	for (int i = 0; i < paramNames->size(); i++) {
@@ -274,10 +377,10 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
 	unsigned int modelType = ((struct data*)params)->modelType;
 	int degree = ((struct data*)params)->degree;
-	QStringList* paramNames = ((struct data*)params)->paramNames;
-	double *min = ((struct data*)params)->paramMin;
-	double *max = ((struct data*)params)->paramMax;
-	bool *fixed = ((struct data*)params)->paramFixed;
+	const QStringList* paramNames = ((struct data*)params)->paramNames;
+	const double *min = ((struct data*)params)->paramMin;
+	const double *max = ((struct data*)params)->paramMax;
+	const bool *fixed = ((struct data*)params)->paramFixed;
 
 	// calculate the Jacobian matrix:
 	// Jacobian matrix J(i,j) = df_i / dx_j
@@ -757,6 +860,11 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		}
 		break;
 	case nsl_fit_model_custom:
+		if (((struct data*)params)->graph) {
+			evaluateModel(paramValues, (struct data*)params, 0, J);
+			break;
+		}
+
 		QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();
 		char* func = funcba.data();
 		QByteArray nameba;
@@ -803,91 +911,48 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 }
 
 int func_fdf(const gsl_vector* x, void* params, gsl_vector* f, gsl_matrix* J) {
+	// residuals and Jacobian of a compiled custom model are calculated in one pass,
+	// the other models use their analytic derivatives in func_df()
+	if (((struct data*)params)->graph && ((struct data*)params)->modelCategory == nsl_fit_model_custom) {
+		evaluateModel(x, (struct data*)params, f, J);
+		return GSL_SUCCESS;
+	}
+
 	func_f(x, params, f);
 	func_df(x, params, J);
 
 	return GSL_SUCCESS;
 }
 
-void XYFitCurvePrivate::recalculate() {
-	QElapsedTimer timer;
-	timer.start();
-
-	//create fit result columns if not available yet, clear them otherwise
-	if (!xColumn) {
-		xColumn = new Column("x", AbstractColumn::Numeric);
-		yColumn = new Column("y", AbstractColumn::Numeric);
-		residualsColumn = new Column("residuals", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
-		residualsVector = static_cast<QVector<double>* >(residualsColumn->data());
-
-		xColumn->setHidden(true);
-		q->addChild(xColumn);
-
-		yColumn->setHidden(true);
-		q->addChild(yColumn);
-
-		q->addChild(residualsColumn);
-
-		q->setUndoAware(false);
-		q->setXColumn(xColumn);
-		q->setYColumn(yColumn);
-		q->setUndoAware(true);
-	} else {
-		xVector->clear();
-		yVector->clear();
-		residualsVector->clear();
-	}
-
-	// clear the previous result
-	fitResult = XYFitCurve::FitResult();
+/*!
+ * writes out the current state of the solver \c s
+ */
+static QString solverState(gsl_multifit_fdfsolver* s, const XYFitCurve::FitData& fitData) {
+	QString state;
 
-	if (!xDataColumn || !yDataColumn) {
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+	//current parameter values, semicolon separated
+	const double* min = fitData.paramLowerLimits.constData();
+	const double* max = fitData.paramUpperLimits.constData();
+	for (int i = 0; i < fitData.paramNames.size(); ++i) {
+		double x = gsl_vector_get(s->x, i);
+		// map parameter if bounded
+		state += QString::number(nsl_fit_map_bound(x, min[i], max[i])) + '\t';
 	}
 
-	//fit settings
-	const int maxIters = fitData.maxIterations;	//maximal number of iterations
-	const double delta = fitData.eps;		//fit tolerance
-	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
-	if (np == 0) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Model has no parameters.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
-	}
+	//current value of the chi2-function
+	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(s->f)));
+	state += ';';
 
-	//check column sizes
-	if (xDataColumn->rowCount() != yDataColumn->rowCount()) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Number of x and y data points must be equal.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
-	}
-	if (weightsColumn) {
-		if (weightsColumn->rowCount() < xDataColumn->rowCount()) {
-			fitResult.available = true;
-			fitResult.valid = false;
-			fitResult.status = i18n("Not sufficient weight data points provided.");
-			emit (q->dataChanged());
-			sourceDataChangedSinceLastFit = false;
-			return;
-		}
-	}
+	return state;
+}
 
-	//copy all valid data point for the fit to temporary vectors
-	QVector<double> xdataVector;
-	QVector<double> ydataVector;
-	QVector<double> sigmaVector;
-	double xmin = fitData.xRange.first();
-	double xmax = fitData.xRange.last();
+/*!
+ * copies the valid data points of the columns inside of the x-range of \c fitData to the vectors used in fit().
+ */
+void XYFitCurve::copyFitData(const FitData& fitData, const AbstractColumn* xDataColumn, const AbstractColumn* yDataColumn, const AbstractColumn* weightsColumn,
+		QVector<double>& xdataVector, QVector<double>& ydataVector, QVector<double>& sigmaVector) {
+	const double xmin = fitData.xRange.first();
+	const double xmax = fitData.xRange.last();
 	for (int row=0; row < xDataColumn->rowCount(); ++row) {
 		//only copy those data where _all_ values (for x, y and sigma, if given) are valid
 		if (!std::isnan(xDataColumn->valueAt(row)) && !std::isnan(yDataColumn->valueAt(row))
@@ -903,10 +968,10 @@ void XYFitCurvePrivate::recalculate() {
 						xdataVector.append(xDataColumn->valueAt(row));
 						ydataVector.append(yDataColumn->valueAt(row));
 
-						if (fitData.weightsType == XYFitCurve::WeightsFromColumn) {
+						if (fitData.weightsType == WeightsFromColumn) {
 							//weights from a given column -> calculate the square root of the inverse (sigma = sqrt(1/weight))
 							sigmaVector.append( sqrt(1./weightsColumn->valueAt(row)) );
-						} else if (fitData.weightsType == XYFitCurve::WeightsFromErrorColumn) {
+						} else if (fitData.weightsType == WeightsFromErrorColumn) {
 							//weights from a given column with error bars (sigma = error)
 							sigmaVector.append( weightsColumn->valueAt(row) );
 						}
@@ -915,26 +980,24 @@ void XYFitCurvePrivate::recalculate() {
 			}
 		}
 	}
+}
 
-	//number of data points to fit
-	const size_t n = xdataVector.size();
-	if (n == 0) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("No data points available.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
-	}
+/*!
+ * fits the model of \c fitData to the data points with the Levenberg-Marquardt solver, starting from the parameter values \c startValues.
+ * Every call uses its own solver workspace. Models that can be compiled into an ExpressionGraph are evaluated
+ * without the global expression parser, so fits of such models can run concurrently in several threads.
+ * If \c parallel is \c true, the data points are distributed over the global thread pool,
+ * this must not be used from a thread of this pool.
+ * The weighted residuals (Y_i - y_i)/sigma_i are written to \c residuals if given.
+ */
+XYFitCurve::FitResult XYFitCurve::fit(const FitData& fitData, const QVector<double>& startValues, QVector<double> xdataVector,
+		QVector<double> ydataVector, QVector<double> sigmaVector, QVector<double>* residuals, bool parallel) {
+	FitResult fitResult;
 
-	if (n < np) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
-	}
+	const size_t n = xdataVector.size();
+	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
+	const int maxIters = fitData.maxIterations;	//maximal number of iterations
+	const double delta = fitData.eps;		//fit tolerance
 
 	double* xdata = xdataVector.data();
 	double* ydata = ydataVector.data();
@@ -945,12 +1008,17 @@ void XYFitCurvePrivate::recalculate() {
 	/////////////////////// GSL >= 2 has a complete new interface! But the old one is still supported. ///////////////////////////
 	// GSL >= 2 : "the 'fdf' field of gsl_multifit_function_fdf is now deprecated and does not need to be specified for nonlinear least squares problems"
 	for (unsigned int i = 0; i < np; i++)
-		DEBUG("fixed parameter"<<i<<fitData.paramFixed.data()[i]);
+		DEBUG("fixed parameter"<<i<<fitData.paramFixed.at(i));
+
+	//the model is compiled once and evaluated from the expression graph, for custom models this also provides the analytic Jacobian.
+	//if the model can't be compiled, the expression is parsed for every data point.
+	ExpressionGraph graph;
+	graph.compile(fitData.model, QStringList() << "x" << fitData.paramNames);
 
 	//function to fit
 	gsl_multifit_function_fdf f;
 	struct data params = {n, xdata, ydata, sigma, fitData.modelCategory, fitData.modelType, fitData.degree, &fitData.model, &fitData.paramNames, 
-				fitData.paramLowerLimits.data(), fitData.paramUpperLimits.data(), fitData.paramFixed.data()};
+				fitData.paramLowerLimits.constData(), fitData.paramUpperLimits.constData(), fitData.paramFixed.constData(), graph.isValid() ? &graph : 0, parallel};
 	f.f = &func_f;
 	f.df = &func_df;
 	f.fdf = &func_fdf;
@@ -963,9 +1031,10 @@ void XYFitCurvePrivate::recalculate() {
 	gsl_multifit_fdfsolver* s = gsl_multifit_fdfsolver_alloc(T, n, np);
 
 	// set start values
-	double* x_init = fitData.paramStartValues.data();
-	double* x_min = fitData.paramLowerLimits.data();
-	double* x_max = fitData.paramUpperLimits.data();
+	QVector<double> x_initVector = startValues;
+	double* x_init = x_initVector.data();
+	const double* x_min = fitData.paramLowerLimits.constData();
+	const double* x_max = fitData.paramUpperLimits.constData();
 	// scale start values if limits are set
 	for (unsigned int i = 0; i < np; i++)
 		x_init[i] = nsl_fit_map_unbound(x_init[i], x_min[i], x_max[i]);
@@ -976,20 +1045,15 @@ void XYFitCurvePrivate::recalculate() {
 	//iterate
 	int status;
 	int iter = 0;
-	fitResult.solverOutput.clear();
-	writeSolverState(s);
+	fitResult.solverOutput = solverState(s, fitData);
 	do {
 		iter++;
 		status = gsl_multifit_fdfsolver_iterate(s);
-		writeSolverState(s);
+		fitResult.solverOutput += solverState(s, fitData);
 		if (status) break;
 		status = gsl_multifit_test_delta(s->dx, s->x, delta, delta);
 	} while (status == GSL_CONTINUE && iter < maxIters);
 
-	// unscale start values again
-	for (unsigned int i = 0; i < np; i++)
-		x_init[i] = nsl_fit_map_bound(x_init[i], x_min[i], x_max[i]);
-
 	//get the covariance matrix
 	//TODO: scale the Jacobian when limits are used before constructing the covar matrix?
 	gsl_matrix* covar = gsl_matrix_alloc(np, np);
@@ -998,6 +1062,7 @@ void XYFitCurvePrivate::recalculate() {
 	gsl_matrix *J = gsl_matrix_alloc(s->fdf->n, s->fdf->p);
 	gsl_multifit_fdfsolver_jac(s, J);
 	gsl_multifit_covar(J, 0.0, covar);
+	gsl_matrix_free(J);
 #else
 	gsl_multifit_covar(s->J, 0.0, covar);
 #endif
@@ -1051,14 +1116,128 @@ void XYFitCurvePrivate::recalculate() {
 	for (unsigned int i = 0; i < np; i++) {
 		// scale resulting values if they are bounded
 		fitResult.paramValues[i] = nsl_fit_map_bound(gsl_vector_get(s->x, i), x_min[i], x_max[i]);
-		// use results as start values if desired
-		if (fitData.useResults) {
-			fitData.paramStartValues.data()[i] = fitResult.paramValues[i];
-			DEBUG("saving parameter"<<i<<fitResult.paramValues[i]<<fitData.paramStartValues.data()[i]);
-		}
 		fitResult.errorValues[i] = c*sqrt(gsl_matrix_get(covar, i, i));
 	}
 
+	//weighted residuals (Yi - y[i])/sigma[i]
+	if (residuals) {
+		residuals->resize(n);
+		for (size_t i = 0; i < n; i++)
+			(*residuals)[i] = gsl_vector_get(s->f, i);
+	}
+
+	//free resources
+	gsl_multifit_fdfsolver_free(s);
+	gsl_matrix_free(covar);
+
+	return fitResult;
+}
+
+void XYFitCurvePrivate::recalculate() {
+	QElapsedTimer timer;
+	timer.start();
+
+	//create fit result columns if not available yet, clear them otherwise
+	if (!xColumn) {
+		xColumn = new Column("x", AbstractColumn::Numeric);
+		yColumn = new Column("y", AbstractColumn::Numeric);
+		residualsColumn = new Column("residuals", AbstractColumn::Numeric);
+		xVector = static_cast<QVector<double>* >(xColumn->data());
+		yVector = static_cast<QVector<double>* >(yColumn->data());
+		residualsVector = static_cast<QVector<double>* >(residualsColumn->data());
+
+		xColumn->setHidden(true);
+		q->addChild(xColumn);
+
+		yColumn->setHidden(true);
+		q->addChild(yColumn);
+
+		q->addChild(residualsColumn);
+
+		q->setUndoAware(false);
+		q->setXColumn(xColumn);
+		q->setYColumn(yColumn);
+		q->setUndoAware(true);
+	} else {
+		xVector->clear();
+		yVector->clear();
+		residualsVector->clear();
+	}
+
+	// clear the previous result
+	fitResult = XYFitCurve::FitResult();
+
+	if (!xDataColumn || !yDataColumn) {
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+
+	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
+	if (np == 0) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("Model has no parameters.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+
+	//check column sizes
+	if (xDataColumn->rowCount() != yDataColumn->rowCount()) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("Number of x and y data points must be equal.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+	if (weightsColumn) {
+		if (weightsColumn->rowCount() < xDataColumn->rowCount()) {
+			fitResult.available = true;
+			fitResult.valid = false;
+			fitResult.status = i18n("Not sufficient weight data points provided.");
+			emit (q->dataChanged());
+			sourceDataChangedSinceLastFit = false;
+			return;
+		}
+	}
+
+	//copy all valid data point for the fit to temporary vectors
+	QVector<double> xdataVector;
+	QVector<double> ydataVector;
+	QVector<double> sigmaVector;
+	XYFitCurve::copyFitData(fitData, xDataColumn, yDataColumn, weightsColumn, xdataVector, ydataVector, sigmaVector);
+	double xmin = fitData.xRange.first();
+	double xmax = fitData.xRange.last();
+
+	//number of data points to fit
+	const size_t n = xdataVector.size();
+	if (n == 0) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("No data points available.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+
+	if (n < np) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+
+	QVector<double> residuals;
+	fitResult = XYFitCurve::fit(fitData, fitData.paramStartValues, xdataVector, ydataVector, sigmaVector, &residuals, true);
+
+	// use results as start values if desired
+	if (fitData.useResults && fitResult.paramValues.size() == fitData.paramStartValues.size())
+		fitData.paramStartValues = fitResult.paramValues;
+
 	// fill residuals vector. To get residuals on the correct x values, fill the rest with zeros.
 	residualsVector->resize(xDataColumn->rowCount());
 	if (fitData.evaluateFullRange) {	// evaluate full range of residuals
@@ -1076,17 +1255,13 @@ void XYFitCurvePrivate::recalculate() {
 		size_t j = 0;
 		for (int i = 0; i < xDataColumn->rowCount(); i++) {
 			if (xDataColumn->valueAt(i) >= xmin && xDataColumn->valueAt(i) <= xmax)
-				residualsVector->data()[i] = - gsl_vector_get(s->f, j++);
+				residualsVector->data()[i] = - residuals.at(j++);
 			else	// outside range
 				residualsVector->data()[i] = 0;
 		}
 	}
 	residualsColumn->setChanged();
 
-	//free resources
-	gsl_multifit_fdfsolver_free(s);
-	gsl_matrix_free(covar);
-
 	//calculate the fit function (vectors)
 	ExpressionParser* parser = ExpressionParser::getInstance();
 	if (fitData.evaluateFullRange) { // evaluate fit on full data range if selected
@@ -1109,29 +1284,6 @@ void XYFitCurvePrivate::recalculate() {
 	sourceDataChangedSinceLastFit = false;
 }
 
-/*!
- * writes out the current state of the solver \c s
- */
-void XYFitCurvePrivate::writeSolverState(gsl_multifit_fdfsolver* s) {
-	QString state;
-
-	//current parameter values, semicolon separated
-	double* min = fitData.paramLowerLimits.data();
-	double* max = fitData.paramUpperLimits.data();
-	for (int i = 0; i < fitData.paramNames.size(); ++i) {
-		double x = gsl_vector_get(s->x, i);
-		// map parameter if bounded
-		state += QString::number(nsl_fit_map_bound(x, min[i], max[i])) + '\t';
-	}
-
-	//current value of the chi2-function
-	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(s->f)));
-	state += ';';
-
-	fitResult.solverOutput += state;
-}
-
-
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -117,6 +117,11 @@ class XYFitCurve : public XYCurve {
 		const FitResult& fitResult() const;
 		bool isSourceDataChangedSinceLastFit() const;
 
+		static void copyFitData(const FitData&, const AbstractColumn* x, const AbstractColumn* y, const AbstractColumn* weights,
+					QVector<double>& xdata, QVector<double>& ydata, QVector<double>& sigma);
+		static FitResult fit(const FitData&, const QVector<double>& startValues, QVector<double> xdata, QVector<double> ydata,
+					QVector<double> sigma, QVector<double>* residuals = 0, bool parallel = false);
+
 		typedef WorksheetElement BaseClass;
 		typedef XYFitCurvePrivate Private;
 
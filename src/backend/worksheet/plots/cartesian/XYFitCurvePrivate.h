@@ -69,7 +69,6 @@ class XYFitCurvePrivate: public XYCurvePrivate {
 		XYFitCurve* const q;
 
 	private:
-		void writeSolverState(gsl_multifit_fdfsolver* s);
 };
 
 #endif
@@ -736,7 +736,7 @@ void DatapickerImageView::exportToFile(const QString& path, const WorksheetView:
 		exportPaint(&painter, targetRect, sourceRect);
 		painter.end();
 	} else {
-		//PNG
+		//PNG, TIFF
 		//TODO add all formats supported by Qt in QImage
 		int w = Worksheet::convertFromSceneUnits(sourceRect.width(), Worksheet::Millimeter);
 		int h = Worksheet::convertFromSceneUnits(sourceRect.height(), Worksheet::Millimeter);
@@ -752,7 +752,7 @@ void DatapickerImageView::exportToFile(const QString& path, const WorksheetView:
 		exportPaint(&painter, targetRect, sourceRect);
 		painter.end();
 
-		image.save(path, "png");
+		image.save(path, (format==WorksheetView::Tiff) ? "tiff" : "png");
 	}
 }
 
@@ -52,7 +52,6 @@
 #include <QMimeData>
 #include <QTextStream>
 #include <QThreadPool>
-#include <QMutex>
 #include <QProcess>
 // #include <QElapsedTimer>
 
@@ -582,11 +581,7 @@ void MatrixView::fillWithConstValues() {
 	                                       i18n("Value"), 0, -2147483647, 2147483647, 6, &ok);
 	if (ok) {
 		WAIT_CURSOR;
-		QVector<QVector<double> > newData = m_matrix->data();
-		for (int col=0; col<m_matrix->columnCount(); ++col) {
-			for (int row=0; row<m_matrix->rowCount(); ++row)
-				newData[col][row] = value;
-		}
+		QVector<QVector<double> > newData(m_matrix->columnCount(), QVector<double>(m_matrix->rowCount(), value));
 		m_matrix->setData(newData);
 		RESET_CURSOR;
 	}
@@ -722,71 +717,165 @@ void MatrixView::clearSelectedCells() {
 }
 
 
-class UpdateImageTask : public QRunnable {
+//maximal width and height of the image shown for the matrix, larger matrices are downsampled
+static const int MaxImageSize = 4096;
+//size of the square tiles the image is filled with
+static const int ImageTileSize = 64;
+
+/*!
+	determines the minimal and the maximal value in the columns [start, end)
+*/
+template<typename T> class MinMaxTask : public QRunnable {
 public:
-	UpdateImageTask(int start, int end, QImage& image, const QVector<QVector<double> >& matrixData, double scaleFactor, double min) : m_image(image), m_matrixData(matrixData) {
-		m_start = start;
-		m_end = end;
-		m_scaleFactor = scaleFactor;
-		m_min = min;
-	};
+	MinMaxTask(int start, int end, const MatrixStorage& storage, double& min, double& max) : m_start(start), m_end(end),
+		m_storage(storage), m_min(min), m_max(max) {}
 
 	void run() {
-		for (int row=m_start; row<m_end; ++row) {
-			mutex.lock();
-			QRgb* line = (QRgb*)m_image.scanLine(row);
-			mutex.unlock();
-			for (int col=0; col<m_image.width(); ++col) {
-				const int gray = (m_matrixData[col][row]-m_min)*m_scaleFactor;
-				line[col] = qRgb(gray, gray, gray);
+		const int rows = m_storage.rowCount();
+		double min = DBL_MAX;
+		double max = -DBL_MAX;
+		for (int col = m_start; col < m_end; ++col) {
+			const T* data = m_storage.column<T>(col);
+			for (int row = 0; row < rows; ++row) {
+				const double value = data[row];
+				min = value < min ? value : min;
+				max = value > max ? value : max;
 			}
 		}
+		m_min = min;
+		m_max = max;
 	}
 
 private:
-	QMutex mutex;
 	int m_start;
 	int m_end;
-	QImage& m_image;
-	const QVector<QVector<double> >& m_matrixData;
-	double m_scaleFactor;
-	double m_min;
+	const MatrixStorage& m_storage;
+	double& m_min;
+	double& m_max;
 };
 
-void MatrixView::updateImage() {
-	WAIT_CURSOR;
-	m_image = QImage(m_matrix->columnCount(), m_matrix->rowCount(), QImage::Format_ARGB32);
-
-	//find min/max value
-// 	QTime timer;
-// 	timer.start();
-	double dmax= -DBL_MAX, dmin= DBL_MAX;
-	const QVector<QVector<double> >& matrixData = m_matrix->data();
-	const int width = m_matrix->columnCount();
-	const int height = m_matrix->rowCount();
-	for (int col=0; col<width; ++col) {
-		for (int row=0; row<height; ++row) {
-			const double value = matrixData[col][row];
-			if (dmax<value) dmax=value;
-			if (dmin>value) dmin=value;
+/*!
+	fills the rows [start, end) of the image. Every \c step-th value of the matrix in both directions
+	is mapped onto one of the 256 colors in the color table. The matrix is traversed tile by tile,
+	such that the columns are read and the scan lines are written within the cache.
+*/
+template<typename T> class UpdateImageTask : public QRunnable {
+public:
+	UpdateImageTask(int start, int end, uchar* bits, int bytesPerLine, int width, int step, const MatrixStorage& storage,
+		const QRgb* colors, double min, double scaleFactor) : m_start(start), m_end(end), m_bits(bits),
+		m_bytesPerLine(bytesPerLine), m_width(width), m_step(step), m_storage(storage), m_colors(colors),
+		m_min(min), m_scaleFactor(scaleFactor) {}
+
+	void run() {
+		for (int rowTile = m_start; rowTile < m_end; rowTile += ImageTileSize) {
+			const int rowEnd = qMin(rowTile + ImageTileSize, m_end);
+			for (int colTile = 0; colTile < m_width; colTile += ImageTileSize) {
+				const int colEnd = qMin(colTile + ImageTileSize, m_width);
+				for (int col = colTile; col < colEnd; ++col) {
+					const T* data = m_storage.column<T>(col*m_step);
+					for (int row = rowTile; row < rowEnd; ++row) {
+						QRgb* line = reinterpret_cast<QRgb*>(m_bits + (size_t)row*m_bytesPerLine);
+						line[col] = color(data[(size_t)row*m_step]);
+					}
+				}
+			}
 		}
 	}
-// 	qDebug()<<"min/max determined in " << (float)timer.elapsed()/1000 << "s";
 
-	//update the image
-// 	timer.start();
-	const double scaleFactor = 255.0/(dmax-dmin);
+private:
+	inline QRgb color(double value) const {
+		if (value != value)
+			return qRgba(0, 0, 0, 0);
+		const int index = (value - m_min)*m_scaleFactor;
+		return m_colors[index < 0 ? 0 : (index > 255 ? 255 : index)];
+	}
+
+	int m_start;
+	int m_end;
+	uchar* m_bits;
+	int m_bytesPerLine;
+	int m_width;
+	int m_step;
+	const MatrixStorage& m_storage;
+	const QRgb* m_colors;
+	double m_min;
+	double m_scaleFactor;
+};
+
+template<typename T> static void updateImageValues(QImage& image, int step, const MatrixStorage& storage, const QVector<QRgb>& colors) {
 	QThreadPool* pool = QThreadPool::globalInstance();
-	int range = ceil(double(m_image.height())/pool->maxThreadCount());
-	for (int i=0; i<pool->maxThreadCount(); ++i) {
+	const int threads = pool->maxThreadCount();
+
+	//find min/max value, every thread checks a range of columns
+	const int cols = storage.columnCount();
+	QVector<double> mins(threads, DBL_MAX);
+	QVector<double> maxs(threads, -DBL_MAX);
+	int range = ceil(double(cols)/threads);
+	for (int i = 0; i < threads; ++i) {
 		const int start = i*range;
-		int end = (i+1)*range;
-		if (end>m_image.height()) end = m_image.height();
-		UpdateImageTask* task = new UpdateImageTask(start, end, m_image, matrixData, scaleFactor, dmin);
-		pool->start(task);
+		const int end = qMin((i+1)*range, cols);
+		if (start >= end)
+			break;
+		pool->start(new MinMaxTask<T>(start, end, storage, mins[i], maxs[i]));
 	}
 	pool->waitForDone();
-// 	qDebug()<<"image updated in " << (float)timer.elapsed()/1000 << "s";
+
+	double dmin = DBL_MAX;
+	double dmax = -DBL_MAX;
+	for (int i = 0; i < threads; ++i) {
+		dmin = qMin(dmin, mins.at(i));
+		dmax = qMax(dmax, maxs.at(i));
+	}
+
+	//update the image, every thread fills a range of scan lines
+	const double scaleFactor = (dmax > dmin) ? 256.0/(dmax-dmin) : 0.0;
+	uchar* bits = image.bits(); //detach here and not in the threads
+	range = ceil(double(image.height())/threads);
+	for (int i = 0; i < threads; ++i) {
+		const int start = i*range;
+		const int end = qMin((i+1)*range, image.height());
+		if (start >= end)
+			break;
+		pool->start(new UpdateImageTask<T>(start, end, bits, image.bytesPerLine(), image.width(), step,
+			storage, colors.constData(), dmin, scaleFactor));
+	}
+	pool->waitForDone();
+}
+
+void MatrixView::updateImage() {
+	WAIT_CURSOR;
+	const MatrixStorage& storage = m_matrix->storage();
+	const int cols = m_matrix->columnCount();
+	const int rows = m_matrix->rowCount();
+
+	//show large matrices downsampled
+	const int step = qMax(1, (qMax(cols, rows) + MaxImageSize - 1)/MaxImageSize);
+	const int width = (cols + step - 1)/step;
+	const int height = (rows + step - 1)/step;
+	m_image = QImage(width, height, QImage::Format_ARGB32);
+
+	//gray scale color table
+	QVector<QRgb> colors(256);
+	for (int i = 0; i < 256; ++i)
+		colors[i] = qRgb(i, i, i);
+
+	switch (storage.dataType()) {
+	case MatrixStorage::UInt8:
+		updateImageValues<quint8>(m_image, step, storage, colors);
+		break;
+	case MatrixStorage::Int16:
+		updateImageValues<qint16>(m_image, step, storage, colors);
+		break;
+	case MatrixStorage::Int32:
+		updateImageValues<qint32>(m_image, step, storage, colors);
+		break;
+	case MatrixStorage::Float:
+		updateImageValues<float>(m_image, step, storage, colors);
+		break;
+	case MatrixStorage::Double:
+		updateImageValues<double>(m_image, step, storage, colors);
+		break;
+	}
 
 	m_imageLabel->resize(width, height);
 	m_imageLabel->setPixmap(QPixmap::fromImage(m_image));
@@ -947,8 +1036,6 @@ void MatrixView::print(QPrinter* printer) const {
 
 	QHeaderView *hHeader = m_tableView->horizontalHeader();
 	QHeaderView *vHeader = m_tableView->verticalHeader();
-	const QVector<QVector<double> >& matrixData = m_matrix->data();
-
 	const int rows = m_matrix->rowCount();
 	const int cols = m_matrix->columnCount();
 	int height = margin;
@@ -960,18 +1047,17 @@ void MatrixView::print(QPrinter* printer) const {
 	int firstRowStringWidth = vertHeaderWidth;
 	bool tablesNeeded = false;
 	QVector<int> firstRowCeilSizes;
-	firstRowCeilSizes.reserve(matrixData[0].size());
-	firstRowCeilSizes.resize(matrixData[0].size());
+	firstRowCeilSizes.resize(cols);
 	QRect br;
 
-	for (int i = 0; i < matrixData.size(); ++i) {
-		br = painter.boundingRect(br, Qt::AlignCenter,QString::number(matrixData[i][0]) + '\t');
+	for (int i = 0; i < cols; ++i) {
+		br = painter.boundingRect(br, Qt::AlignCenter,QString::number(m_matrix->cell(0, i)) + '\t');
 		firstRowCeilSizes[i] = br.width() > m_tableView->columnWidth(i) ?
 		                       br.width() : m_tableView->columnWidth(i);
 	}
 	for (int col = 0; col < cols; ++col) {
 		headerStringWidth += m_tableView->columnWidth(col);
-		br = painter.boundingRect(br, Qt::AlignCenter,QString::number(matrixData[col][0]) + '\t');
+		br = painter.boundingRect(br, Qt::AlignCenter,QString::number(m_matrix->cell(0, col)) + '\t');
 		firstRowStringWidth += br.width();
 		if ((headerStringWidth >= printer->pageRect().width() -2*margin) ||
 		        (firstRowStringWidth >= printer->pageRect().width() - 2*margin)) {
@@ -1049,7 +1135,7 @@ void MatrixView::print(QPrinter* printer) const {
 			}
 			for (; j< toJ; j++) {
 				int w = /*m_tableView->columnWidth(j)*/ firstRowCeilSizes[j];
-				cellText = QString::number(matrixData[j][i]) + '\t';
+				cellText = QString::number(m_matrix->cell(i, j)) + '\t';
 				tr = painter.boundingRect(tr,Qt::AlignCenter,cellText);
 				br.setTopLeft(QPoint(right,height));
 				br.setWidth(w);
@@ -1085,10 +1171,10 @@ void MatrixView::exportToFile(const QString& path, const QString& separator) con
 	//export values
 	const int cols = m_matrix->columnCount();
 	const int rows = m_matrix->rowCount();
-	const QVector<QVector<double> >& matrixData = m_matrix->data();
+	const MatrixStorage& storage = m_matrix->storage();
 	for (int row=0; row<rows; ++row) {
 		for (int col=0; col<cols; ++col) {
-			out << matrixData[col][row];
+			out << storage.value(row, col);
 			if (col!=cols-1)
 				out<<sep;
 		}
@@ -1444,7 +1530,7 @@ void MatrixView::showColumnStatistics() {
 		for (int col = 0; col < m_matrix->columnCount(); ++col) {
 			if (isColumnSelected(col, false)) {
 				QString headerString = m_tableView->model()->headerData(col, Qt::Horizontal).toString();
-				list << new Column(headerString, m_matrix->data().at(col));
+				list << new Column(headerString, m_matrix->columnCells(col, 0, m_matrix->rowCount()-1));
 			}
 		}
 		dlg->setColumns(list);
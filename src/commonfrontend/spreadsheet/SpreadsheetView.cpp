@@ -50,6 +50,7 @@
 #include <QMenu>
 #include <QPainter>
 #include <QPrinter>
+#include <QScrollBar>
 #include <QToolBar>
 #include <QTextStream>
 #include <QProcess>
@@ -170,6 +171,9 @@ void SpreadsheetView::init() {
 
 	connect(m_spreadsheet, SIGNAL(columnSelected(int)), this, SLOT(selectColumn(int)) );
 	connect(m_spreadsheet, SIGNAL(columnDeselected(int)), this, SLOT(deselectColumn(int)) );
+
+	//prepare the cells around the visible rows in the model while scrolling
+	connect(m_tableView->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(prefetchVisibleRows()));
 }
 
 void SpreadsheetView::initActions() {
@@ -1618,6 +1622,21 @@ void SpreadsheetView::addRows() {
 	m_spreadsheet->appendRows(selectedRowCount(false));
 }
 
+/*!
+	lets the model prepare the cells of the currently visible rows and of the rows around them.
+*/
+void SpreadsheetView::prefetchVisibleRows() {
+	const int first = m_tableView->rowAt(0);
+	if (first == -1)
+		return;
+
+	int last = m_tableView->rowAt(m_tableView->viewport()->height());
+	if (last == -1)
+		last = m_model->rowCount() - 1;
+
+	m_model->prefetch(first, last);
+}
+
 /*!
   Cause a repaint of the header.
 */
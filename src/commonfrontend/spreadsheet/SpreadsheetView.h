@@ -230,6 +230,7 @@ class SpreadsheetView : public QWidget {
 		void handleAspectAdded(const AbstractAspect* aspect);
 		void handleAspectAboutToBeRemoved(const AbstractAspect* aspect);
 		void updateHeaderGeometry(Qt::Orientation o, int first, int last);
+		void prefetchVisibleRows();
 
 		void selectColumn(int);
 		void deselectColumn(int);
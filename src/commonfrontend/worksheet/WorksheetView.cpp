@@ -34,6 +34,7 @@
 #include "kdefrontend/worksheet/GridDialog.h"
 #include "kdefrontend/worksheet/PresenterWidget.h"
 #include "kdefrontend/worksheet/DynamicPresenterWidget.h"
+#include "tools/BandImageWriter.h"
 #include <QApplication>
 #include <QMenu>
 #include <QToolBar>
@@ -47,6 +48,7 @@
 #include <QGraphicsOpacityEffect>
 #include <QTimeLine>
 #include <QClipboard>
+#include <QProgressDialog>
 
 #include <KAction>
 #include <KLocale>
@@ -1456,24 +1458,64 @@ void WorksheetView::exportToFile(const QString& path, const ExportFormat format,
 		exportPaint(&painter, targetRect, sourceRect, background);
 		painter.end();
 	} else {
-		//PNG
-		//TODO add all formats supported by Qt in QImage
-		int w = Worksheet::convertFromSceneUnits(sourceRect.width(), Worksheet::Millimeter);
-		int h = Worksheet::convertFromSceneUnits(sourceRect.height(), Worksheet::Millimeter);
-		w = w*resolution/25.4;
-		h = h*resolution/25.4;
-		QImage image(QSize(w, h), QImage::Format_ARGB32_Premultiplied);
-		image.fill(Qt::transparent);
-		QRectF targetRect(0, 0, w, h);
+		//PNG, TIFF
+		if (!exportToImage(path, format, sourceRect, background, resolution))
+			KMessageBox::sorry(this, i18n("Failed to export the worksheet to '%1'.", path));
+	}
+}
+
+/*!
+	renders the worksheet to a PNG or TIFF file in horizontal bands of at most 32 MiB. The bands are compressed
+	on worker threads while the next ones are rendered, so that only a few of them are kept in memory
+	also for high resolutions. The scene is painted in the GUI thread, its items are not thread-safe.
+	Returns \c false if the export failed, the incomplete file is removed also if the export was canceled.
+ */
+bool WorksheetView::exportToImage(const QString& path, const ExportFormat format, const QRectF& sourceRect, const bool background, const int resolution) {
+	int w = Worksheet::convertFromSceneUnits(sourceRect.width(), Worksheet::Millimeter);
+	int h = Worksheet::convertFromSceneUnits(sourceRect.height(), Worksheet::Millimeter);
+	w = w*resolution/25.4;
+	h = h*resolution/25.4;
+	if (w < 1 || h < 1)
+		return false;
+
+	const int rows = qMax(1, 32*1024*1024/(4*w));
+	BandImageWriter writer;
+	if (!writer.open(path, (format == WorksheetView::Tiff) ? BandImageWriter::Tiff : BandImageWriter::Png, w, h, rows, resolution))
+		return false;
+
+	const int bandCount = (h + rows - 1)/rows;
+	QProgressDialog progress(i18n("Exporting the worksheet..."), i18n("Cancel"), 0, bandCount, this);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setMinimumDuration(500);
+
+	//every band is rendered with the transformation of the whole image, shifted to the top of the band
+	const QRectF targetRect(0, 0, w, h);
+	for (int i = 0; i < bandCount; ++i) {
+		progress.setValue(i);
+		if (progress.wasCanceled()) {
+			writer.abort();
+			return true;
+		}
+
+		const int y = i*rows;
+		QImage band(w, qMin(rows, h - y), QImage::Format_ARGB32_Premultiplied);
+		band.fill(Qt::transparent);
 
 		QPainter painter;
-		painter.begin(&image);
+		painter.begin(&band);
 		painter.setRenderHint(QPainter::Antialiasing);
+		painter.translate(0, -y);
 		exportPaint(&painter, targetRect, sourceRect, background);
 		painter.end();
 
-		image.save(path, "PNG");
+		if (!writer.writeBand(band)) {
+			writer.abort();
+			return false;
+		}
 	}
+
+	progress.setValue(bandCount);
+	return writer.close();
 }
 
 void WorksheetView::exportToClipboard() {
@@ -1518,7 +1560,7 @@ void WorksheetView::exportPaint(QPainter* painter, const QRectF& targetRect, con
 
 	//draw the scene items
 	m_worksheet->setPrinting(true);
-	scene()->render(painter, QRectF(), sourceRect);
+	scene()->render(painter, targetRect, sourceRect);
 	m_worksheet->setPrinting(false);
 }
 
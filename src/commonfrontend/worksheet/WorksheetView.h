@@ -48,7 +48,7 @@ class WorksheetView : public QGraphicsView {
 public:
 	explicit WorksheetView(Worksheet* worksheet);
 
-	enum ExportFormat {Pdf, Eps, Svg, Png};
+	enum ExportFormat {Pdf, Eps, Svg, Png, Tiff};
 	enum GridStyle {NoGrid, LineGrid, DotGrid};
 	enum ExportArea {ExportBoundingBox, ExportSelection, ExportWorksheet};
 
@@ -76,6 +76,7 @@ private:
 	void drawBackground(QPainter*, const QRectF&);
 	void drawBackgroundItems(QPainter*, const QRectF&);
 	void exportPaint(QPainter* painter, const QRectF& targetRect, const QRectF& sourceRect, const bool);
+	bool exportToImage(const QString&, const ExportFormat, const QRectF& sourceRect, const bool, const int);
 	void cartesianPlotAdd(CartesianPlot*, QAction*);
 
 	//events
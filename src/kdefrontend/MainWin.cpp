@@ -36,6 +36,7 @@
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/matrix/Matrix.h"
 #include "backend/worksheet/Worksheet.h"
+#include "backend/worksheet/plots/cartesian/XYCurve.h"
 #include "backend/datasources/FileDataSource.h"
 #include "backend/datapicker/Datapicker.h"
 #include "backend/note/Note.h"
@@ -1486,6 +1487,10 @@ void MainWin::handleSettingsChanges() {
 	interval *= 60*1000;
 	if (interval != m_autoSaveTimer.interval())
 		m_autoSaveTimer.setInterval(interval);
+
+	//double buffering of the curves, the setting is cached by XYCurve
+	const KConfigGroup worksheetGroup = KGlobal::config()->group(QLatin1String("Settings_Worksheet"));
+	XYCurve::setDoubleBuffering(worksheetGroup.readEntry(QLatin1String("DoubleBuffering"), true));
 }
 
 /***************************************************************************************/
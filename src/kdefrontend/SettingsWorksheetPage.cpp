@@ -59,6 +59,8 @@ SettingsWorksheetPage::SettingsWorksheetPage(QWidget* parent) : SettingsPage(par
 	connect(ui.chkDoubleBuffering, SIGNAL(stateChanged(int)), this, SLOT(changed()) );
 	connect(ui.cbTexEngine, SIGNAL(currentIndexChanged(int)), this, SLOT(changed()) );
 	connect(ui.cbTexEngine, SIGNAL(currentIndexChanged(int)), this, SLOT(checkTeX(int)) );
+	connect(ui.sbTexCacheSize, SIGNAL(valueChanged(int)), this, SLOT(changed()) );
+	connect(ui.chkTexEmbedImages, SIGNAL(stateChanged(int)), this, SLOT(changed()) );
 
 	loadSettings();
 }
@@ -68,6 +70,8 @@ void SettingsWorksheetPage::applySettings() {
 	group.writeEntry(QLatin1String("PresenterModeInteractive"), ui.chkPresenterModeInteractive->isChecked());
 	group.writeEntry(QLatin1String("DoubleBuffering"), ui.chkDoubleBuffering->isChecked());
 	group.writeEntry(QLatin1String("LaTeXEngine"), ui.cbTexEngine->itemData(ui.cbTexEngine->currentIndex()));
+	group.writeEntry(QLatin1String("TeXCacheSize"), ui.sbTexCacheSize->value());
+	group.writeEntry(QLatin1String("EmbedTeXImages"), ui.chkTexEmbedImages->isChecked());
 }
 
 void SettingsWorksheetPage::restoreDefaults() {
@@ -87,6 +91,9 @@ void SettingsWorksheetPage::loadSettings() {
 		index = ui.cbTexEngine->findData(engine);
 
 	ui.cbTexEngine->setCurrentIndex(index);
+
+	ui.sbTexCacheSize->setValue(group.readEntry(QLatin1String("TeXCacheSize"), 64));
+	ui.chkTexEmbedImages->setChecked(group.readEntry(QLatin1String("EmbedTeXImages"), true));
 }
 
 void SettingsWorksheetPage::changed() {
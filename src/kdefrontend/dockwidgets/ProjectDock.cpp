@@ -45,6 +45,7 @@ ProjectDock::ProjectDock(QWidget *parent): QWidget(parent),	m_project(0), m_init
 	connect(ui.leName, SIGNAL(textChanged(QString)), this, SLOT(titleChanged(QString)) );
 	connect(ui.leAuthor, SIGNAL(textChanged(QString)), this, SLOT(authorChanged(QString)) );
 	connect(ui.tbComment, SIGNAL(textChanged()), this, SLOT(commentChanged()) );
+	connect(ui.sbMemoryBudget, SIGNAL(valueChanged(int)), this, SLOT(memoryBudgetChanged(int)) );
 
 	TemplateHandler* templateHandler = new TemplateHandler(this, TemplateHandler::Worksheet);
 	ui.verticalLayout->addWidget(templateHandler, 0, 0);
@@ -100,6 +101,14 @@ void ProjectDock::commentChanged(){
 	m_project->setComment(ui.tbComment->toPlainText());
 }
 
+void ProjectDock::memoryBudgetChanged(int budget){
+	if (m_initializing)
+		return;
+
+	m_project->setColumnMemoryBudget(budget);
+	m_project->setChanged(true);
+}
+
 //*************************************************************
 //******** SLOTs for changes triggered in Project   ***********
 //*************************************************************
@@ -125,6 +134,7 @@ void ProjectDock::loadConfig(KConfig& config){
 	ui.leName->setText( group.readEntry("Name", m_project->name()) );
 	ui.leAuthor->setText( group.readEntry("Author", m_project->author()) );
 	ui.tbComment->setText( group.readEntry("Comment", m_project->comment()) );
+	ui.sbMemoryBudget->setValue( group.readEntry("ColumnMemoryBudget", m_project->columnMemoryBudget()) );
 }
 
 void ProjectDock::saveConfig(KConfig& config){
@@ -133,4 +143,5 @@ void ProjectDock::saveConfig(KConfig& config){
 	group.writeEntry("Name", ui.leName->text());
 	group.writeEntry("Author", ui.leAuthor->text());
 	group.writeEntry("Comment", ui.tbComment->toPlainText());
+	group.writeEntry("ColumnMemoryBudget", ui.sbMemoryBudget->value());
 }
@@ -51,6 +51,7 @@ private slots:
 	void titleChanged(const QString&);
 	void authorChanged(const QString&);
 	void commentChanged();
+	void memoryBudgetChanged(int);
 
 	//SLOTs for changes triggered in Project
 	void projectDescriptionChanged(const AbstractAspect*);
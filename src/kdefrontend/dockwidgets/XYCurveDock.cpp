@@ -128,6 +128,8 @@ XYCurveDock::XYCurveDock(QWidget *parent): QWidget(parent),
 	connect( ui.kcbSymbolFillingColor, SIGNAL(changed(QColor)), this, SLOT(symbolsFillingColorChanged(QColor)) );
 
 	connect( ui.cbSymbolBorderStyle, SIGNAL(currentIndexChanged(int)), this, SLOT(symbolsBorderStyleChanged(int)) );
+	connect( ui.cbDensityType, SIGNAL(currentIndexChanged(int)), this, SLOT(densityTypeChanged(int)) );
+	connect( ui.cbDensityColorMap, SIGNAL(currentIndexChanged(int)), this, SLOT(densityColorMapChanged(int)) );
 	connect( ui.kcbSymbolBorderColor, SIGNAL(changed(QColor)), this, SLOT(symbolsBorderColorChanged(QColor)) );
 	connect( ui.sbSymbolBorderWidth, SIGNAL(valueChanged(double)), this, SLOT(symbolsBorderWidthChanged(double)) );
 
@@ -403,6 +405,16 @@ void XYCurveDock::init() {
 	}
 
 	GuiTools::updateBrushStyles(ui.cbSymbolFillingStyle, Qt::black);
+
+	ui.cbDensityType->addItem(i18n("none"));
+	ui.cbDensityType->addItem(i18n("linear"));
+	ui.cbDensityType->addItem(i18n("square root"));
+	ui.cbDensityType->addItem(i18n("logarithmic"));
+
+	const QStringList colorMaps = ColorMapRenderer::names();
+	ui.cbDensityColorMap->setIconSize(QSize(3*iconSize, iconSize));
+	for (int i = 0; i < colorMaps.size(); ++i)
+		ui.cbDensityColorMap->addItem(QIcon(ColorMapRenderer::pixmap((ColorMapRenderer::ColorMap)i, QSize(3*iconSize, iconSize))), colorMaps.at(i));
 	m_initializing = false;
 
 	//Values
@@ -623,6 +635,8 @@ void XYCurveDock::initTabs() {
 	connect(m_curve, SIGNAL(symbolsOpacityChanged(qreal)), this, SLOT(curveSymbolsOpacityChanged(qreal)));
 	connect(m_curve, SIGNAL(symbolsBrushChanged(QBrush)), this, SLOT(curveSymbolsBrushChanged(QBrush)));
 	connect(m_curve, SIGNAL(symbolsPenChanged(QPen)), this, SLOT(curveSymbolsPenChanged(QPen)));
+	connect(m_curve, SIGNAL(densityTypeChanged(XYCurve::DensityType)), this, SLOT(curveDensityTypeChanged(XYCurve::DensityType)));
+	connect(m_curve, SIGNAL(densityColorMapChanged(ColorMapRenderer::ColorMap)), this, SLOT(curveDensityColorMapChanged(ColorMapRenderer::ColorMap)));
 
 	//Values-Tab
 	connect(m_curve, SIGNAL(valuesTypeChanged(XYCurve::ValuesType)), this, SLOT(curveValuesTypeChanged(XYCurve::ValuesType)));
@@ -1092,6 +1106,30 @@ void XYCurveDock::symbolsOpacityChanged(int value) {
 		curve->setSymbolsOpacity(opacity);
 }
 
+void XYCurveDock::densityTypeChanged(int index) {
+	XYCurve::DensityType type = XYCurve::DensityType(index);
+
+	//the symbols are not drawn in the density mode, the opacity is used for the density
+	const bool density = (type != XYCurve::NoDensity);
+	ui.cbDensityColorMap->setEnabled(density);
+	ui.cbSymbolStyle->setEnabled(!density);
+	ui.sbSymbolOpacity->setEnabled(density || Symbol::Style(ui.cbSymbolStyle->currentIndex()) != Symbol::NoSymbols);
+
+	if (m_initializing)
+		return;
+
+	foreach(XYCurve* curve, m_curvesList)
+		curve->setDensityType(type);
+}
+
+void XYCurveDock::densityColorMapChanged(int index) {
+	if (m_initializing)
+		return;
+
+	foreach(XYCurve* curve, m_curvesList)
+		curve->setDensityColorMap(ColorMapRenderer::ColorMap(index));
+}
+
 void XYCurveDock::symbolsFillingStyleChanged(int index) {
 	Qt::BrushStyle brushStyle = Qt::BrushStyle(index);
 	ui.kcbSymbolFillingColor->setEnabled(!(brushStyle == Qt::NoBrush));
@@ -1821,6 +1859,16 @@ void XYCurveDock::curveSymbolsOpacityChanged(qreal opacity) {
 	ui.sbSymbolOpacity->setValue( round(opacity*100.0) );
 	m_initializing = false;
 }
+void XYCurveDock::curveDensityTypeChanged(XYCurve::DensityType type) {
+	m_initializing = true;
+	ui.cbDensityType->setCurrentIndex((int)type);
+	m_initializing = false;
+}
+void XYCurveDock::curveDensityColorMapChanged(ColorMapRenderer::ColorMap map) {
+	m_initializing = true;
+	ui.cbDensityColorMap->setCurrentIndex((int)map);
+	m_initializing = false;
+}
 void XYCurveDock::curveSymbolsBrushChanged(QBrush brush) {
 	m_initializing = true;
 	ui.cbSymbolFillingStyle->setCurrentIndex((int) brush.style());
@@ -2027,6 +2075,8 @@ void XYCurveDock::load() {
 	ui.cbSymbolBorderStyle->setCurrentIndex( (int) m_curve->symbolsPen().style() );
 	ui.kcbSymbolBorderColor->setColor( m_curve->symbolsPen().color() );
 	ui.sbSymbolBorderWidth->setValue( Worksheet::convertFromSceneUnits(m_curve->symbolsPen().widthF(), Worksheet::Point) );
+	ui.cbDensityType->setCurrentIndex( (int)m_curve->densityType() );
+	ui.cbDensityColorMap->setCurrentIndex( (int)m_curve->densityColorMap() );
 
 	//Values
 	ui.cbValuesType->setCurrentIndex( (int) m_curve->valuesType() );
@@ -2126,6 +2176,8 @@ void XYCurveDock::loadConfig(KConfig& config) {
 	ui.cbSymbolBorderStyle->setCurrentIndex( group.readEntry("SymbolBorderStyle", (int) m_curve->symbolsPen().style()) );
 	ui.kcbSymbolBorderColor->setColor( group.readEntry("SymbolBorderColor", m_curve->symbolsPen().color()) );
 	ui.sbSymbolBorderWidth->setValue( Worksheet::convertFromSceneUnits(group.readEntry("SymbolBorderWidth",m_curve->symbolsPen().widthF()), Worksheet::Point) );
+	ui.cbDensityType->setCurrentIndex( group.readEntry("DensityType", (int)m_curve->densityType()) );
+	ui.cbDensityColorMap->setCurrentIndex( group.readEntry("DensityColorMap", (int)m_curve->densityColorMap()) );
 
 	//Values
 	ui.cbValuesType->setCurrentIndex( group.readEntry("ValuesType", (int) m_curve->valuesType()) );
@@ -2202,6 +2254,8 @@ void XYCurveDock::saveConfigAsTemplate(KConfig& config) {
 	group.writeEntry("SymbolBorderStyle", ui.cbSymbolBorderStyle->currentIndex());
 	group.writeEntry("SymbolBorderColor", ui.kcbSymbolBorderColor->color());
 	group.writeEntry("SymbolBorderWidth", Worksheet::convertToSceneUnits(ui.sbSymbolBorderWidth->value(),Worksheet::Point));
+	group.writeEntry("DensityType", ui.cbDensityType->currentIndex());
+	group.writeEntry("DensityColorMap", ui.cbDensityColorMap->currentIndex());
 
 	//Values
 	group.writeEntry("ValuesType", ui.cbValuesType->currentIndex());
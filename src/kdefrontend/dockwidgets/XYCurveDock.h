@@ -121,6 +121,8 @@ private slots:
 	void symbolsBorderStyleChanged(int);
 	void symbolsBorderColorChanged(const QColor&);
 	void symbolsBorderWidthChanged(double);
+	void densityTypeChanged(int);
+	void densityColorMapChanged(int);
 
 	//Values-Tab
 	void valuesTypeChanged(int);
@@ -184,6 +186,8 @@ private slots:
 	void curveSymbolsOpacityChanged(qreal);
 	void curveSymbolsBrushChanged(QBrush);
 	void curveSymbolsPenChanged(const QPen&);
+	void curveDensityTypeChanged(XYCurve::DensityType);
+	void curveDensityColorMapChanged(ColorMapRenderer::ColorMap);
 
 	//Values-Tab
 	void curveValuesTypeChanged(XYCurve::ValuesType);
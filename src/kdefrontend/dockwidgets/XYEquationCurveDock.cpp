@@ -110,6 +110,7 @@ void XYEquationCurveDock::setupGeneral() {
 	connect( uiGeneralTab.teMin, SIGNAL(expressionChanged()), this, SLOT(enableRecalculate()) );
 	connect( uiGeneralTab.teMax, SIGNAL(expressionChanged()), this, SLOT(enableRecalculate()) );
 	connect( uiGeneralTab.sbCount, SIGNAL(valueChanged(int)), this, SLOT(enableRecalculate()) );
+	connect( uiGeneralTab.chkAdaptive, SIGNAL(clicked(bool)), this, SLOT(enableRecalculate()) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
 }
 
@@ -161,6 +162,7 @@ void XYEquationCurveDock::initGeneralTab() {
 	uiGeneralTab.teMin->setText(data.min);
 	uiGeneralTab.teMax->setText(data.max);
 	uiGeneralTab.sbCount->setValue(data.count);
+	uiGeneralTab.chkAdaptive->setChecked(data.adaptive);
 
 	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
 
@@ -239,6 +241,9 @@ void XYEquationCurveDock::typeChanged(int index) {
 		uiGeneralTab.teMax->hide();
 	}
 
+	//the adaptive sampling is only available for y=f(x)
+	uiGeneralTab.chkAdaptive->setVisible(type==XYEquationCurve::Cartesian);
+
 	uiGeneralTab.teEquation1->setExpressionType(type);
 	this->enableRecalculate();
 }
@@ -251,6 +256,7 @@ void XYEquationCurveDock::recalculateClicked() {
 	data.min = uiGeneralTab.teMin->document()->toPlainText();
 	data.max = uiGeneralTab.teMax->document()->toPlainText();
 	data.count = uiGeneralTab.sbCount->value();
+	data.adaptive = uiGeneralTab.chkAdaptive->isChecked();
 
 	foreach(XYCurve* curve, m_curvesList)
 		dynamic_cast<XYEquationCurve*>(curve)->setEquationData(data);
@@ -370,5 +376,6 @@ void XYEquationCurveDock::curveEquationDataChanged(const XYEquationCurve::Equati
 	uiGeneralTab.teMin->setText(data.min);
 	uiGeneralTab.teMax->setText(data.max);
 	uiGeneralTab.sbCount->setValue(data.count);
+	uiGeneralTab.chkAdaptive->setChecked(data.adaptive);
 	m_initializing = false;
 }
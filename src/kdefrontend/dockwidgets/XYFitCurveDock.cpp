@@ -30,12 +30,16 @@
 #include "XYFitCurveDock.h"
 #include "backend/core/AspectTreeModel.h"
 #include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+#include "backend/worksheet/plots/cartesian/XYFitBatch.h"
 #include "commonfrontend/widgets/TreeViewComboBox.h"
 #include "kdefrontend/widgets/ConstantsWidget.h"
 #include "kdefrontend/widgets/FunctionsWidget.h"
 #include "kdefrontend/widgets/FitOptionsWidget.h"
 #include "kdefrontend/widgets/FitParametersWidget.h"
 
+#include <KMessageBox>
 #include <KStandardDirs>
 #include <QMenu>
 #include <QWidgetAction>
@@ -62,7 +66,7 @@ extern "C" {
 */
 
 XYFitCurveDock::XYFitCurveDock(QWidget *parent)
-	 : XYCurveDock(parent), cbXDataColumn(0), cbYDataColumn(0), cbWeightsColumn(0), m_fitCurve(0) {
+	 : XYCurveDock(parent), cbXDataColumn(0), cbYDataColumn(0), cbWeightsColumn(0), m_fitCurve(0), m_fitBatch(0) {
 
 	//remove the tab "Error bars"
 	ui.tabWidget->removeTab(5);
@@ -107,6 +111,10 @@ void XYFitCurveDock::setupGeneral() {
 	uiGeneralTab.tbConstants->setIcon( KIcon("labplot-format-text-symbol") );
 	uiGeneralTab.tbFunctions->setIcon( KIcon("preferences-desktop-font") );
 	uiGeneralTab.pbRecalculate->setIcon(KIcon("run-build"));
+	uiGeneralTab.pbBatchFit->setIcon(KIcon("run-build"));
+	uiGeneralTab.pbBatchCancel->setIcon(KIcon("process-stop"));
+	uiGeneralTab.pbBatchProgress->setVisible(false);
+	uiGeneralTab.pbBatchCancel->setVisible(false);
 
 	QHBoxLayout* layout = new QHBoxLayout(ui.tabGeneral);
 	layout->setMargin(0);
@@ -129,6 +137,8 @@ void XYFitCurveDock::setupGeneral() {
 	connect( uiGeneralTab.pbParameters, SIGNAL(clicked()), this, SLOT(showParameters()) );
 	connect( uiGeneralTab.pbOptions, SIGNAL(clicked()), this, SLOT(showOptions()) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
+	connect( uiGeneralTab.pbBatchFit, SIGNAL(clicked()), this, SLOT(batchFitClicked()) );
+	connect( uiGeneralTab.pbBatchCancel, SIGNAL(clicked()), this, SLOT(batchFitCancelClicked()) );
 }
 
 void XYFitCurveDock::initGeneralTab() {
@@ -973,6 +983,79 @@ void XYFitCurveDock::recalculateClicked() {
 	QApplication::restoreOverrideCursor();
 }
 
+/*!
+ * fits the current model to all numeric columns of the spreadsheet containing the y-data column,
+ * with the x-data column as the independent variable. The fits run in the background,
+ * the results are written to a new spreadsheet next to the source spreadsheet in batchFitFinished().
+ */
+void XYFitCurveDock::batchFitClicked() {
+	if (m_fitBatch)
+		return;
+
+	const AbstractColumn* xColumn = m_fitCurve->xDataColumn();
+	const AbstractColumn* yColumn = m_fitCurve->yDataColumn();
+	if (!xColumn || !yColumn)
+		return;
+
+	Spreadsheet* spreadsheet = dynamic_cast<Spreadsheet*>(yColumn->parentAspect());
+	if (!spreadsheet || !spreadsheet->parentAspect())
+		return;
+
+	XYFitCurve::FitData fitData = m_fitData;
+	fitData.degree = uiGeneralTab.sbDegree->value();
+	if (fitData.modelCategory == nsl_fit_model_custom)
+		fitData.model = uiGeneralTab.teEquation->toPlainText();
+
+	m_fitBatch = new XYFitBatch(fitData, this);
+	m_fitBatch->setStartCount(uiGeneralTab.sbStarts->value());
+	foreach (const Column* column, spreadsheet->children<Column>()) {
+		if (column == xColumn || column->columnMode() != AbstractColumn::Numeric)
+			continue;
+
+		//the weights belong to the y-data of the curve only
+		m_fitBatch->addDataSet(column->name(), xColumn, column, column == yColumn ? m_fitCurve->weightsColumn() : 0);
+	}
+
+	connect(m_fitBatch, SIGNAL(progressRangeChanged(int,int)), uiGeneralTab.pbBatchProgress, SLOT(setRange(int,int)));
+	connect(m_fitBatch, SIGNAL(progressValueChanged(int)), uiGeneralTab.pbBatchProgress, SLOT(setValue(int)));
+	connect(m_fitBatch, SIGNAL(finished()), this, SLOT(batchFitFinished()));
+	if (!m_fitBatch->start()) {
+		delete m_fitBatch;
+		m_fitBatch = 0;
+		KMessageBox::sorry(this, i18n("The batch fit is only possible for models that can be evaluated without the expression parser and for spreadsheets with numeric columns."),
+					i18n("Batch fit not possible"));
+		return;
+	}
+
+	uiGeneralTab.pbBatchFit->setEnabled(false);
+	uiGeneralTab.pbBatchProgress->setValue(0);
+	uiGeneralTab.pbBatchProgress->setVisible(true);
+	uiGeneralTab.pbBatchCancel->setVisible(true);
+}
+
+void XYFitCurveDock::batchFitCancelClicked() {
+	if (m_fitBatch)
+		m_fitBatch->cancel();
+}
+
+void XYFitCurveDock::batchFitFinished() {
+	Spreadsheet* spreadsheet = 0;
+	if (m_fitCurve->yDataColumn())
+		spreadsheet = dynamic_cast<Spreadsheet*>(m_fitCurve->yDataColumn()->parentAspect());
+
+	if (spreadsheet && spreadsheet->parentAspect()) {
+		Spreadsheet* results = new Spreadsheet(0, i18n("%1 - batch fit", m_fitCurve->name()));
+		m_fitBatch->writeResults(results);
+		spreadsheet->parentAspect()->addChild(results);
+	}
+
+	m_fitBatch->deleteLater();
+	m_fitBatch = 0;
+	uiGeneralTab.pbBatchFit->setEnabled(true);
+	uiGeneralTab.pbBatchProgress->setVisible(false);
+	uiGeneralTab.pbBatchCancel->setVisible(false);
+}
+
 void XYFitCurveDock::enableRecalculate() const {
 	if (m_initializing)
 		return;
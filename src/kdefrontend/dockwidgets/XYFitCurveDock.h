@@ -34,6 +34,7 @@
 #include "ui_xyfitcurvedockgeneraltab.h"
 
 class TreeViewComboBox;
+class XYFitBatch;
 
 class XYFitCurveDock: public XYCurveDock {
 	Q_OBJECT
@@ -54,6 +55,7 @@ private:
 
 	XYFitCurve* m_fitCurve;
 	XYFitCurve::FitData m_fitData;
+	XYFitBatch* m_fitBatch;
 	QList<double> parameters;
 	QList<double> parameterValues;
 
@@ -84,6 +86,9 @@ private slots:
 	void recalculateClicked();
 	void updateModelEquation();
 	void enableRecalculate() const;
+	void batchFitClicked();
+	void batchFitCancelClicked();
+	void batchFitFinished();
 
 	//SLOTs for changes triggered in XYCurve
 	//General-Tab
@@ -27,6 +27,7 @@
  ***************************************************************************/
 #include "DropValuesDialog.h"
 #include "backend/core/column/Column.h"
+#include "backend/core/column/TextData.h"
 #include "backend/lib/macros.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 
@@ -81,6 +82,15 @@ DropValuesDialog::DropValuesDialog(Spreadsheet* s, bool mask, QWidget* parent, Q
 
 void DropValuesDialog::setColumns(QList<Column*> list) {
 	m_columns = list;
+
+	//text columns are compared with the entered text, numeric columns ignore values that are no numbers
+	foreach (const Column* col, m_columns) {
+		if (col->columnMode() == AbstractColumn::Text) {
+			ui.leValue1->setValidator(0);
+			ui.leValue2->setValidator(0);
+			break;
+		}
+	}
 }
 
 void DropValuesDialog::operatorChanged(int index) const {
@@ -98,17 +108,63 @@ void DropValuesDialog::okClicked() const {
 		dropValues();
 }
 
+/*!
+  returns the rows of the text column \c col equal to \c text.
+  For dictionary encoded columns only the codes of the rows are compared.
+ */
+static QVector<int> equalTextRows(const Column* col, const QString& text) {
+	QVector<int> rows;
+	const TextData* data = static_cast<const TextData*>(col->data());
+	if (data->isEncoded()) {
+		const int code = data->code(text);
+		if (code == -1)
+			return rows;
+
+		const QVector<quint32>& codes = data->codes();
+		for (int i=0; i<codes.size(); ++i) {
+			if (codes.at(i) == (quint32)code)
+				rows << i;
+		}
+	} else {
+		const QStringList& strings = data->strings();
+		for (int i=0; i<strings.size(); ++i) {
+			if (strings.at(i) == text)
+				rows << i;
+		}
+	}
+
+	return rows;
+}
+
 //TODO: m_column->setMasked() is slow, we need direct access to the masked-container -> redesign
 class MaskValuesTask : public QRunnable {
 	public:
-		MaskValuesTask(Column* col, int op, double value1, double value2){
+		MaskValuesTask(Column* col, int op, double value1, double value2, const QString& text){
 			m_column = col;
 			m_operator = op;
 			m_value1 = value1;
 			m_value2 = value2;
+			m_text = text;
 		};
 
 		void run() {
+			//texts can only be compared for equality
+			if (m_column->columnMode() == AbstractColumn::Text) {
+				if (m_operator != 0)
+					return;
+
+				m_column->setSuppressDataChangedSignal(true);
+				const QVector<int> rows = equalTextRows(m_column, m_text);
+				foreach (int row, rows)
+					m_column->setMasked(row, true);
+				m_column->setSuppressDataChangedSignal(false);
+				if (!rows.isEmpty())
+					m_column->setChanged();
+				return;
+			}
+			if (m_column->columnMode() != AbstractColumn::Numeric)
+				return;
+
 			m_column->setSuppressDataChangedSignal(true);
 			bool changed = false;
 			QVector<double>* data = static_cast<QVector<double>* >(m_column->data());
@@ -193,18 +249,38 @@ class MaskValuesTask : public QRunnable {
 		int m_operator;
 		double m_value1;
 		double m_value2;
+		QString m_text;
 };
 
 class DropValuesTask : public QRunnable {
 	public:
-		DropValuesTask(Column* col, int op, double value1, double value2){
+		DropValuesTask(Column* col, int op, double value1, double value2, const QString& text){
 			m_column = col;
 			m_operator = op;
 			m_value1 = value1;
 			m_value2 = value2;
+			m_text = text;
 		};
 
 		void run() {
+			//texts can only be compared for equality, dropped texts are cleared
+			if (m_column->columnMode() == AbstractColumn::Text) {
+				if (m_operator != 0)
+					return;
+
+				const QVector<int> rows = equalTextRows(m_column, m_text);
+				if (rows.isEmpty())
+					return;
+
+				QStringList new_data = static_cast<TextData*>(m_column->data())->toStringList();
+				foreach (int row, rows)
+					new_data[row] = QString();
+				m_column->replaceTexts(0, new_data);
+				return;
+			}
+			if (m_column->columnMode() != AbstractColumn::Numeric)
+				return;
+
 			bool changed = false;
 			QVector<double>* data = static_cast<QVector<double>* >(m_column->data());
 			QVector<double> new_data(*data);
@@ -288,6 +364,7 @@ class DropValuesTask : public QRunnable {
 		int m_operator;
 		double m_value1;
 		double m_value2;
+		QString m_text;
 };
 
 void DropValuesDialog::maskValues() const {
@@ -297,11 +374,17 @@ void DropValuesDialog::maskValues() const {
 	m_spreadsheet->beginMacro(i18n("%1: mask values", m_spreadsheet->name()));
 
 	const int op = ui.cbOperator->currentIndex();
-	const double value1 = ui.leValue1->text().toDouble();
-	const double value2 = ui.leValue2->text().toDouble();
+	bool ok;
+	double value1 = ui.leValue1->text().toDouble(&ok);
+	if (!ok)
+		value1 = NAN;
+	double value2 = ui.leValue2->text().toDouble(&ok);
+	if (!ok)
+		value2 = NAN;
+	const QString text = ui.leValue1->text();
 
 	foreach(Column* col, m_columns) {
-		MaskValuesTask* task = new MaskValuesTask(col, op, value1, value2);
+		MaskValuesTask* task = new MaskValuesTask(col, op, value1, value2, text);
 		task->run();
 		//TODO: writing to the undo-stack in Column::setMasked() is not tread-safe -> redesign
 // 		QThreadPool::globalInstance()->start(task);
@@ -321,11 +404,17 @@ void DropValuesDialog::dropValues() const {
 	m_spreadsheet->beginMacro(i18n("%1: drop values", m_spreadsheet->name()));
 
 	const int op = ui.cbOperator->currentIndex();
-	const double value1 = ui.leValue1->text().toDouble();
-	const double value2 = ui.leValue2->text().toDouble();
+	bool ok;
+	double value1 = ui.leValue1->text().toDouble(&ok);
+	if (!ok)
+		value1 = NAN;
+	double value2 = ui.leValue2->text().toDouble(&ok);
+	if (!ok)
+		value2 = NAN;
+	const QString text = ui.leValue1->text();
 
 	foreach(Column* col, m_columns) {
-		DropValuesTask* task = new DropValuesTask(col, op, value1, value2);
+		DropValuesTask* task = new DropValuesTask(col, op, value1, value2, text);
 		QThreadPool::globalInstance()->start(task);
 	}
 
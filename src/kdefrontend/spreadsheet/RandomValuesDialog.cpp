@@ -30,13 +30,16 @@
 #include "backend/core/column/Column.h"
 #include "backend/lib/macros.h"
 #include "backend/spreadsheet/Spreadsheet.h"
+#include <KIcon>
 #include <KStandardDirs>
+#include <QDateTime>
 #include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
 
 extern "C" {
 #include "backend/nsl/nsl_sf_stats.h"
 #include <gsl/gsl_rng.h>
-#include <gsl/gsl_randist.h>
 }
 
 /*!
@@ -57,8 +60,8 @@ RandomValuesDialog::RandomValuesDialog(Spreadsheet* s, QWidget* parent, Qt::WFla
 	setButtonText(KDialog::Ok, i18n("&Generate"));
 	setButtonToolTip(KDialog::Ok, i18n("Generate random values according to the selected distribution"));
 
-	for (int i = 0; i < NSL_SF_STATS_DISTRIBUTION_RNG_COUNT; i++)
-                ui.cbDistribution->addItem(i18n(nsl_sf_stats_distribution_name[i]), i);
+	for (int i = 0; i < NSL_SF_STATS_DISTRIBUTION_COUNT; i++)
+		ui.cbDistribution->addItem(i18n(nsl_sf_stats_distribution_name[i]), i);
 
 	//use white background in the preview label
 	QPalette p;
@@ -73,11 +76,15 @@ RandomValuesDialog::RandomValuesDialog(Spreadsheet* s, QWidget* parent, Qt::WFla
 	ui.kleParameter1->setValidator( new QDoubleValidator(ui.kleParameter1) );
 	ui.kleParameter2->setValidator( new QDoubleValidator(ui.kleParameter2) );
 	ui.kleParameter3->setValidator( new QDoubleValidator(ui.kleParameter3) );
+	ui.kleSeed->setValidator( new QRegExpValidator(QRegExp("\\d{1,19}"), ui.kleSeed) );
+	ui.bNewSeed->setIcon(KIcon("view-refresh"));
 
 	connect( ui.cbDistribution, SIGNAL(currentIndexChanged(int)), SLOT(distributionChanged(int)) );
 	connect( ui.kleParameter1, SIGNAL(textChanged(QString)), this, SLOT(checkValues()) );
 	connect( ui.kleParameter2, SIGNAL(textChanged(QString)), this, SLOT(checkValues()) );
 	connect( ui.kleParameter3, SIGNAL(textChanged(QString)), this, SLOT(checkValues()) );
+	connect( ui.kleSeed, SIGNAL(textChanged(QString)), this, SLOT(checkValues()) );
+	connect( ui.bNewSeed, SIGNAL(clicked()), this, SLOT(newSeed()) );
 	connect(this, SIGNAL(okClicked()), this, SLOT(generate()));
 
 	//restore saved settings if available
@@ -88,6 +95,7 @@ RandomValuesDialog::RandomValuesDialog(Spreadsheet* s, QWidget* parent, Qt::WFla
 		ui.kleParameter1->setText(conf.readEntry("Parameter1"));
 		ui.kleParameter2->setText(conf.readEntry("Parameter2"));
 		ui.kleParameter3->setText(conf.readEntry("Parameter3"));
+		ui.kleSeed->setText(conf.readEntry("Seed"));
 		restoreDialogSize(conf);
 	} else {
 		//Gaussian distribution as default
@@ -95,6 +103,9 @@ RandomValuesDialog::RandomValuesDialog(Spreadsheet* s, QWidget* parent, Qt::WFla
 
 		resize( QSize(400,0).expandedTo(minimumSize()) );
 	}
+
+	if (ui.kleSeed->text().isEmpty())
+		newSeed();
 }
 
 RandomValuesDialog::~RandomValuesDialog() {
@@ -104,6 +115,7 @@ RandomValuesDialog::~RandomValuesDialog() {
 	conf.writeEntry("Parameter1", ui.kleParameter1->text());
 	conf.writeEntry("Parameter2", ui.kleParameter2->text());
 	conf.writeEntry("Parameter3", ui.kleParameter3->text());
+	conf.writeEntry("Seed", ui.kleSeed->text());
 	saveDialogSize(conf);
 }
 
@@ -296,7 +308,7 @@ void RandomValuesDialog::distributionChanged(int index) {
 	case nsl_sf_stats_pascal:
 		ui.lFunc->setText("p(k) =");
 		ui.lParameter1->setText("p =");
-		ui.lParameter1->setText("n =");
+		ui.lParameter2->setText("n =");
 		ui.kleParameter1->setText("0.5");
 		ui.kleParameter2->setText("100");
 		break;
@@ -312,9 +324,32 @@ void RandomValuesDialog::distributionChanged(int index) {
 		ui.kleParameter3->setText("3.0");
 		break;
 	case nsl_sf_stats_maxwell_boltzmann:	// additional non-GSL distros
+		ui.lParameter2->hide();
+		ui.kleParameter2->hide();
+		ui.lParameter1->setText(QString::fromUtf8("\u03c3 ="));
+		ui.kleParameter1->setText("1.0");
+		break;
 	case nsl_sf_stats_sech:
+		ui.lParameter1->setText(QString::fromUtf8("\u03c3 ="));
+		ui.lParameter2->setText(QString::fromUtf8("\u03bc ="));
+		ui.kleParameter1->setText("1.0");
+		ui.kleParameter2->setText("0.0");
+		break;
 	case nsl_sf_stats_levy:
+		ui.lParameter1->setText(QString::fromUtf8("\u03b3 ="));
+		ui.lParameter2->setText(QString::fromUtf8("\u03bc ="));
+		ui.kleParameter1->setText("1.0");
+		ui.kleParameter2->setText("0.0");
+		break;
 	case nsl_sf_stats_frechet:
+		ui.lParameter3->show();
+		ui.kleParameter3->show();
+		ui.lParameter1->setText(QString::fromUtf8("\u03b3 ="));
+		ui.lParameter2->setText(QString::fromUtf8("\u03c3 ="));
+		ui.lParameter3->setText(QString::fromUtf8("\u03bc ="));
+		ui.kleParameter1->setText("1.0");
+		ui.kleParameter2->setText("1.0");
+		ui.kleParameter3->setText("0.0");
 		break;
 	}
 
@@ -338,17 +373,55 @@ void RandomValuesDialog::checkValues() {
 		return;
 	}
 
+	if (ui.kleSeed->text().isEmpty()) {
+		enableButton(KDialog::Ok, false);
+		return;
+	}
+
 	enableButton(KDialog::Ok, true);
 }
 
+void RandomValuesDialog::newSeed() {
+	ui.kleSeed->setText(QString::number(QDateTime::currentMSecsSinceEpoch()));
+}
+
+//number of rows generated with one random number stream, independent of the number of threads
+static const int RandomBlockSize = 16384;
+
+/*!
+	fills one block of rows of one column. Every block has its own stream of random numbers
+	determined by the seed, the column and the block, such that the generated values
+	don't depend on the number of threads and on the order of execution.
+*/
+class RandomValuesTask : public QRunnable {
+public:
+	RandomValuesTask(double* data, int first, int count, quint64 seed, int column, nsl_sf_stats_distribution dist,
+	                 double p1, double p2, double p3) : m_data(data), m_first(first), m_count(count), m_seed(seed),
+		m_column(column), m_dist(dist), m_p1(p1), m_p2(p2), m_p3(p3) {}
+
+	void run() {
+		gsl_rng* r = gsl_rng_alloc(nsl_sf_stats_rng_counter);
+		nsl_sf_stats_rng_set_stream(r, m_seed, m_column, m_first/RandomBlockSize);
+		for (int i = m_first; i < m_first + m_count; ++i)
+			m_data[i] = nsl_sf_stats_distribution_random(r, m_dist, m_p1, m_p2, m_p3);
+		gsl_rng_free(r);
+	}
+
+private:
+	double* m_data;
+	int m_first;
+	int m_count;
+	quint64 m_seed;
+	int m_column;
+	nsl_sf_stats_distribution m_dist;
+	double m_p1;
+	double m_p2;
+	double m_p3;
+};
+
 void RandomValuesDialog::generate() {
 	Q_ASSERT(m_spreadsheet);
 
-	//create a generator chosen by the environment variable GSL_RNG_TYPE
-	gsl_rng_env_setup();
-	const gsl_rng_type* T = gsl_rng_default;
-	gsl_rng* r = gsl_rng_alloc(T);
-
 	WAIT_CURSOR;
 	foreach (Column* col, m_columns)
 		col->setSuppressDataChangedSignal(true);
@@ -359,322 +432,26 @@ void RandomValuesDialog::generate() {
 
 	int index = ui.cbDistribution->currentIndex();
 	nsl_sf_stats_distribution dist = (nsl_sf_stats_distribution)ui.cbDistribution->itemData(index).toInt();
+	const double p1 = ui.kleParameter1->text().toDouble();
+	const double p2 = ui.kleParameter2->text().toDouble();
+	const double p3 = ui.kleParameter3->text().toDouble();
+	const quint64 seed = ui.kleSeed->text().toULongLong();
 
+	//generate the values for all columns in parallel, block by block
 	const int rows = m_spreadsheet->rowCount();
-	QVector<double> new_data(rows);
-
-	switch (dist) {
-	case nsl_sf_stats_gaussian: {
-		double mu = ui.kleParameter1->text().toDouble();
-		double sigma = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gaussian(r, sigma) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gaussian_tail: {
-		double mu = ui.kleParameter1->text().toDouble();
-		double sigma = ui.kleParameter2->text().toDouble();
-		double a = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gaussian_tail(r, a, sigma) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_exponential: {
-		double mu = ui.kleParameter1->text().toDouble();
-		mu = 1./mu; //GSL uses the inverse for exp. distrib.
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_exponential(r, mu);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_laplace: {
-		double s = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_laplace(r, s) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_exponential_power: {
-		double mu = ui.kleParameter1->text().toDouble();
-		double a = ui.kleParameter2->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_exppow(r, a, b) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_cauchy_lorentz: {
-		double gamma = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_cauchy(r, gamma) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_rayleigh: {
-		double s = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_rayleigh(r, s);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_rayleigh_tail: {
-		double sigma = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_rayleigh(r, sigma);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_landau:
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_landau(r);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	case nsl_sf_stats_levy_alpha_stable: {
-		double c = ui.kleParameter1->text().toDouble();
-		double alpha = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_levy(r, c, alpha);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_levy_skew_alpha_stable: {
-		double c = ui.kleParameter1->text().toDouble();
-		double alpha = ui.kleParameter2->text().toDouble();
-		double beta = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_levy_skew(r, c, alpha, beta);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gamma: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gamma(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_flat: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach(Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_flat(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_lognormal: {
-		double s = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach(Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_lognormal(r, mu, s);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_chi_squared: {
-		double n = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_chisq(r, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_fdist: {
-		double nu1 = ui.kleParameter1->text().toDouble();
-		double nu2 = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_fdist(r, nu1, nu2);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_tdist: {
-		double nu = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_tdist(r, nu);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_beta: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_beta(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_logistic: {
-		double s = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_logistic(r, s) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_pareto: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_pareto(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_weibull: {
-		double k = ui.kleParameter1->text().toDouble();
-		double l = ui.kleParameter2->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_weibull(r, l, k) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gumbel1: {
-		double s = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		double mu = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gumbel1(r, 1./s, b) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gumbel2: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gumbel2(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_poisson: {
-		double l = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_poisson(r, l);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_bernoulli: {
-		double p = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_bernoulli(r, p);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_binomial: {
-		double p = ui.kleParameter1->text().toDouble();
-		double n = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_binomial(r, p, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_negative_bionomial: {
-		double p = ui.kleParameter1->text().toDouble();
-		double n = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_negative_binomial(r, p, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_pascal: {
-		double p = ui.kleParameter1->text().toDouble();
-		double n = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_pascal(r, p, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_geometric: {
-		double p = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_geometric(r, p);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_hypergeometric: {
-		double n1 = ui.kleParameter1->text().toDouble();
-		double n2 = ui.kleParameter2->text().toDouble();
-		double t = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_hypergeometric(r, n1, n2, t);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_logarithmic: {
-		double p = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_logarithmic(r, p);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_maxwell_boltzmann:	// additional non-GSL distros
-	case nsl_sf_stats_sech:
-	case nsl_sf_stats_levy:
-	case nsl_sf_stats_frechet:
-		break;
+	QVector< QVector<double> > new_data(m_columns.size());
+	QThreadPool pool;
+	for (int c = 0; c < m_columns.size(); ++c) {
+		new_data[c].resize(rows);
+		double* data = new_data[c].data();
+		const int column = m_spreadsheet->indexOfChild<Column>(m_columns.at(c));
+		for (int first = 0; first < rows; first += RandomBlockSize)
+			pool.start(new RandomValuesTask(data, first, qMin(RandomBlockSize, rows - first), seed, column, dist, p1, p2, p3));
 	}
+	pool.waitForDone();
+
+	for (int c = 0; c < m_columns.size(); ++c)
+		m_columns.at(c)->replaceValues(0, new_data.at(c));
 
 	foreach (Column* col, m_columns) {
 		col->setSuppressDataChangedSignal(false);
@@ -682,6 +459,4 @@ void RandomValuesDialog::generate() {
 	}
 	m_spreadsheet->endMacro();
 	RESET_CURSOR;
-
-	gsl_rng_free(r);
 }
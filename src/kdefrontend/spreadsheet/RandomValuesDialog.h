@@ -53,6 +53,7 @@ class RandomValuesDialog : public KDialog{
 		void generate();
 		void distributionChanged(int index);
 		void checkValues();
+		void newSeed();
 };
 
 #endif
@@ -326,6 +326,7 @@ void DatapickerImageWidget::initConnections() {
 	connect( m_image, SIGNAL(axisPointsChanged(DatapickerImage::ReferencePoints)), this, SLOT(imageAxisPointsChanged(DatapickerImage::ReferencePoints)) );
 	connect( m_image, SIGNAL(settingsChanged(DatapickerImage::EditorSettings)), this, SLOT(imageEditorSettingsChanged(DatapickerImage::EditorSettings)) );
 	connect( m_image, SIGNAL(minSegmentLengthChanged(int)), this, SLOT(imageMinSegmentLengthChanged(int)) );
+	connect( m_image, SIGNAL(histogramsChanged()), this, SLOT(imageHistogramsChanged()) );
 	connect( m_image, SIGNAL(pointStyleChanged(Symbol::Style)), this, SLOT(symbolStyleChanged(Symbol::Style)));
 	connect( m_image, SIGNAL(pointSizeChanged(qreal)), this, SLOT(symbolSizeChanged(qreal)));
 	connect( m_image, SIGNAL(pointRotationAngleChanged(qreal)), this, SLOT(symbolRotationAngleChanged(qreal)));
@@ -768,6 +769,14 @@ void DatapickerImageWidget::imageMinSegmentLengthChanged(const int value) {
 	m_initializing = false;
 }
 
+void DatapickerImageWidget::imageHistogramsChanged() {
+	gvIntensity->invalidateScene(gvIntensity->sceneRect(), QGraphicsScene::BackgroundLayer);
+	gvForeground->invalidateScene(gvForeground->sceneRect(), QGraphicsScene::BackgroundLayer);
+	gvHue->invalidateScene(gvHue->sceneRect(), QGraphicsScene::BackgroundLayer);
+	gvSaturation->invalidateScene(gvSaturation->sceneRect(), QGraphicsScene::BackgroundLayer);
+	gvValue->invalidateScene(gvValue->sceneRect(), QGraphicsScene::BackgroundLayer);
+}
+
 void DatapickerImageWidget::updateSymbolWidgets() {
 	int pointCount = m_image->childCount<DatapickerPoint>(AbstractAspect::IncludeHidden);
 	if (pointCount)
@@ -129,6 +129,7 @@ private slots:
 	void imageAxisPointsChanged(const DatapickerImage::ReferencePoints&);
 	void imageEditorSettingsChanged(const DatapickerImage::EditorSettings&);
 	void imageMinSegmentLengthChanged(const int);
+	void imageHistogramsChanged();
     void updateSymbolWidgets();
 	void handleWidgetActions();
     //symbol
@@ -53,6 +53,7 @@ ExportWorksheetDialog::ExportWorksheetDialog(QWidget* parent) : KDialog(parent),
 	ui.cbFormat->addItem(KIcon("image-svg+xml"), "Scalable Vector Graphics (SVG)");
 	ui.cbFormat->insertSeparator(3);
 	ui.cbFormat->addItem(KIcon("image-x-generic"), "Portable Network Graphics (PNG)");
+	ui.cbFormat->addItem(KIcon("image-x-generic"), "Tagged Image File Format (TIFF)");
 
 	ui.cbExportArea->addItem(i18n("Object's bounding box"));
 	ui.cbExportArea->addItem(i18n("Current selection"));
@@ -217,7 +218,7 @@ void ExportWorksheetDialog::formatChanged(int index) {
 		index --;
 
 	QStringList extensions;
-	extensions<<".pdf"<<".eps"<<".svg"<<".png";
+	extensions<<".pdf"<<".eps"<<".svg"<<".png"<<".tiff";
 	QString path = ui.kleFileName->text();
 	int i = path.indexOf(".");
 	if (i==-1)
@@ -227,9 +228,9 @@ void ExportWorksheetDialog::formatChanged(int index) {
 
 	ui.kleFileName->setText(path);
 
-	// show resolution option for png format
-	ui.lResolution->setVisible(index==3);
-	ui.cbResolution->setVisible(index==3);
+	// show resolution option for the raster formats
+	ui.lResolution->setVisible(index>=3);
+	ui.cbResolution->setVisible(index>=3);
 }
 
 void ExportWorksheetDialog::fileNameChanged(const QString& name) {
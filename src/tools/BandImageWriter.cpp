@@ -0,0 +1,397 @@
+/***************************************************************************
+    File                 : BandImageWriter.cpp
+    Project              : LabPlot
+    Description          : Streaming PNG and TIFF writer for images rendered in bands
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#include "BandImageWriter.h"
+
+#include <QDataStream>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+
+#include <zlib.h>
+
+/*!
+	\class BandImageWriter
+	\brief Writes a large image to a PNG or TIFF file band by band.
+
+	The bands are added from top to bottom with writeBand() and compressed concurrently in a thread pool,
+	the compressed bands are written to the file in order. Only the bands that are compressed at the moment
+	are kept in memory, writeBand() waits for the oldest band to be written if the pool is busy.
+
+	PNG: every band is compressed to a separate raw deflate stream, flushed to a byte boundary, that are written
+	one after the other in the IDAT chunks. The checksums of the bands are combined to the one of the zlib stream.
+	TIFF: every band is a deflate-compressed strip.
+
+	\ingroup tools
+*/
+
+//! a band of the image and its compressed data
+struct BandImageWriter::Band {
+	QImage image;
+	QImage previousImage;	//previous band, its last row is needed for the PNG filters
+	bool last;
+	QByteArray data;
+	unsigned long adler;	//checksum and size of the uncompressed data (PNG)
+	qint64 rawSize;
+	bool valid;
+	QSemaphore done;
+};
+
+//! compresses one band in the thread pool of the writer
+class BandEncodeTask : public QRunnable {
+public:
+	BandEncodeTask(BandImageWriter::Band* band, BandImageWriter::Format format) : m_band(band), m_format(format) {}
+
+	void run() {
+		m_band->valid = (m_format == BandImageWriter::Png) ? encodePng() : encodeTiff();
+		m_band->image = QImage();
+		m_band->previousImage = QImage();
+		m_band->done.release();
+	}
+
+private:
+	//converts the row \c y of \c image to non-premultiplied RGBA
+	static void rgbaRow(const QImage& image, int y, uchar* row) {
+		const QRgb* pixel = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+		for (int x = 0; x < image.width(); ++x) {
+			*row++ = qRed(pixel[x]);
+			*row++ = qGreen(pixel[x]);
+			*row++ = qBlue(pixel[x]);
+			*row++ = qAlpha(pixel[x]);
+		}
+	}
+
+	//compresses \c raw to m_band->data, raw deflate for PNG, zlib for TIFF
+	bool compress(const QByteArray& raw, int windowBits, int flush) {
+		z_stream stream;
+		stream.zalloc = Z_NULL;
+		stream.zfree = Z_NULL;
+		stream.opaque = Z_NULL;
+		if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			return false;
+
+		//the bound doesn't include the few bytes of a sync flush
+		m_band->data.resize(deflateBound(&stream, raw.size()) + 16);
+		stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.constData()));
+		stream.avail_in = raw.size();
+		stream.next_out = reinterpret_cast<Bytef*>(m_band->data.data());
+		stream.avail_out = m_band->data.size();
+		const int rc = deflate(&stream, flush);
+		const bool success = (flush == Z_FINISH) ? (rc == Z_STREAM_END) : (rc == Z_OK && stream.avail_in == 0);
+		m_band->data.resize(stream.total_out);
+		deflateEnd(&stream);
+		return success;
+	}
+
+	bool encodePng() {
+		const QImage image = m_band->image.convertToFormat(QImage::Format_ARGB32);
+		const int stride = 4*image.width();
+		QByteArray raw(image.height()*(stride + 1), 0);
+		QByteArray previous(stride, 0);	//the row above the image is zero
+		QByteArray current(stride, 0);
+		QByteArray sub(stride, 0);
+		QByteArray up(stride, 0);
+		if (!m_band->previousImage.isNull()) {
+			const QImage previousImage = m_band->previousImage.copy(0, m_band->previousImage.height() - 1, m_band->previousImage.width(), 1)
+				.convertToFormat(QImage::Format_ARGB32);
+			rgbaRow(previousImage, 0, reinterpret_cast<uchar*>(previous.data()));
+		}
+
+		//every row is written with the filter (none, sub or up) with the smallest sum of absolute values
+		uchar* out = reinterpret_cast<uchar*>(raw.data());
+		for (int y = 0; y < image.height(); ++y) {
+			const uchar* c = reinterpret_cast<uchar*>(current.data());
+			const uchar* p = reinterpret_cast<const uchar*>(previous.constData());
+			uchar* s = reinterpret_cast<uchar*>(sub.data());
+			uchar* u = reinterpret_cast<uchar*>(up.data());
+			rgbaRow(image, y, reinterpret_cast<uchar*>(current.data()));
+			unsigned long sumNone = 0, sumSub = 0, sumUp = 0;
+			for (int i = 0; i < stride; ++i) {
+				s[i] = c[i] - (i >= 4 ? c[i - 4] : 0);
+				u[i] = c[i] - p[i];
+				sumNone += qAbs((signed char)c[i]);
+				sumSub += qAbs((signed char)s[i]);
+				sumUp += qAbs((signed char)u[i]);
+			}
+
+			if (sumNone <= sumSub && sumNone <= sumUp) {
+				*out++ = 0;
+				memcpy(out, c, stride);
+			} else if (sumSub <= sumUp) {
+				*out++ = 1;
+				memcpy(out, s, stride);
+			} else {
+				*out++ = 2;
+				memcpy(out, u, stride);
+			}
+			out += stride;
+			qSwap(previous, current);
+		}
+
+		m_band->adler = adler32(adler32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(raw.constData()), raw.size());
+		m_band->rawSize = raw.size();
+		return compress(raw, -MAX_WBITS, m_band->last ? Z_FINISH : Z_SYNC_FLUSH);
+	}
+
+	bool encodeTiff() {
+		const QImage image = m_band->image.convertToFormat(QImage::Format_ARGB32);
+		const int stride = 4*image.width();
+		QByteArray raw(image.height()*stride, 0);
+		for (int y = 0; y < image.height(); ++y)
+			rgbaRow(image, y, reinterpret_cast<uchar*>(raw.data()) + y*stride);
+
+		return compress(raw, MAX_WBITS, Z_FINISH);
+	}
+
+	BandImageWriter::Band* m_band;
+	BandImageWriter::Format m_format;
+};
+
+BandImageWriter::BandImageWriter() : m_format(Png), m_width(0), m_height(0), m_rowsPerBand(0), m_dpi(0),
+	m_rowsAdded(0), m_error(false), m_adler(0) {
+
+	m_pool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+BandImageWriter::~BandImageWriter() {
+	if (m_file.isOpen())
+		abort();
+}
+
+/*!
+	creates the file \c fileName for an image of the size \c width x \c height.
+	All bands but the last one have to have \c rowsPerBand rows.
+ */
+bool BandImageWriter::open(const QString& fileName, Format format, int width, int height, int rowsPerBand, int dpi) {
+	if (width < 1 || height < 1 || rowsPerBand < 1)
+		return false;
+
+	m_file.setFileName(fileName);
+	if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	m_format = format;
+	m_width = width;
+	m_height = height;
+	m_rowsPerBand = rowsPerBand;
+	m_dpi = dpi;
+	m_rowsAdded = 0;
+	m_lastBand = QImage();
+	m_error = false;
+	m_stripOffsets.clear();
+	m_stripByteCounts.clear();
+
+	if (m_format == Png) {
+		m_file.write("\x89PNG\r\n\x1a\n", 8);
+
+		QByteArray header;
+		QDataStream out(&header, QIODevice::WriteOnly);
+		out << (quint32)width << (quint32)height;
+		out << (quint8)8 << (quint8)6 << (quint8)0 << (quint8)0 << (quint8)0;	//8 bit RGBA, deflate, no interlace
+		writePngChunk("IHDR", header);
+
+		const quint32 pixelsPerMeter = qRound(dpi/0.0254);
+		QByteArray physical;
+		QDataStream phys(&physical, QIODevice::WriteOnly);
+		phys << pixelsPerMeter << pixelsPerMeter << (quint8)1;
+		writePngChunk("pHYs", physical);
+
+		//zlib header, the deflate streams of the bands follow
+		writePngChunk("IDAT", QByteArray("\x78\x9c", 2));
+		m_adler = adler32(0, Z_NULL, 0);
+	} else {
+		//little endian header, the offset of the directory is written in close()
+		m_file.write("II\x2a\0\0\0\0\0", 8);
+	}
+
+	return !m_error;
+}
+
+/*!
+	adds the next band of the image. Waits until the oldest band was written if all threads are busy.
+ */
+bool BandImageWriter::writeBand(const QImage& image) {
+	if (!m_file.isOpen() || m_error || image.width() != m_width || m_rowsAdded + image.height() > m_height)
+		return false;
+	if (m_rowsAdded + image.height() < m_height && image.height() != m_rowsPerBand)
+		return false;
+
+	Band* band = new Band;
+	band->image = image;
+	band->previousImage = m_lastBand;
+	band->last = (m_rowsAdded + image.height() == m_height);
+	band->adler = 0;
+	band->rawSize = 0;
+	band->valid = false;
+	m_bands << band;
+	m_lastBand = image;
+	m_rowsAdded += image.height();
+	m_pool.start(new BandEncodeTask(band, m_format));
+
+	while (m_bands.size() > m_pool.maxThreadCount()) {
+		if (!writeOldestBand())
+			return false;
+	}
+
+	return true;
+}
+
+/*!
+	waits for the oldest band to be compressed and writes it to the file.
+ */
+bool BandImageWriter::writeOldestBand() {
+	Band* band = m_bands.takeFirst();
+	band->done.acquire();
+	m_error = m_error || !band->valid;
+
+	if (!m_error) {
+		if (m_format == Png) {
+			//the IDAT chunks are limited to 1 MiB
+			const int chunkSize = 1024*1024;
+			for (int i = 0; i < band->data.size(); i += chunkSize)
+				writePngChunk("IDAT", band->data.mid(i, chunkSize));
+
+			m_adler = adler32_combine(m_adler, band->adler, band->rawSize);
+		} else {
+			m_stripOffsets << m_file.pos();
+			m_stripByteCounts << band->data.size();
+			m_error = (m_file.write(band->data) != band->data.size());
+		}
+	}
+
+	delete band;
+	return !m_error;
+}
+
+bool BandImageWriter::writePngChunk(const char* type, const QByteArray& data) {
+	QByteArray chunk;
+	QDataStream out(&chunk, QIODevice::WriteOnly);
+	out << (quint32)data.size();
+	out.writeRawData(type, 4);
+	out.writeRawData(data.constData(), data.size());
+	const uLong crc = crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(chunk.constData() + 4), chunk.size() - 4);
+	out << (quint32)crc;
+
+	m_error = m_error || (m_file.write(chunk) != chunk.size());
+	return !m_error;
+}
+
+/*!
+	writes the remaining bands and the end of the file. Returns \c false if the image is incomplete or couldn't be written.
+ */
+bool BandImageWriter::close() {
+	while (!m_bands.isEmpty())
+		writeOldestBand();
+
+	if (!m_file.isOpen())
+		return false;
+
+	if (m_rowsAdded != m_height)
+		m_error = true;
+
+	if (!m_error) {
+		if (m_format == Png) {
+			QByteArray checksum;
+			QDataStream out(&checksum, QIODevice::WriteOnly);
+			out << (quint32)m_adler;
+			writePngChunk("IDAT", checksum);
+			writePngChunk("IEND", QByteArray());
+		} else {
+			//image file directory with 14 entries, followed by the values that don't fit into the entries
+			if (m_file.pos() % 2)
+				m_file.write("\0", 1);
+			const quint32 ifdOffset = m_file.pos();
+			const int entries = 14;
+			quint32 dataOffset = ifdOffset + 2 + entries*12 + 4;
+			const int strips = m_stripOffsets.size();
+
+			QByteArray ifd;
+			QDataStream out(&ifd, QIODevice::WriteOnly);
+			out.setByteOrder(QDataStream::LittleEndian);
+			QByteArray data;
+			QDataStream outData(&data, QIODevice::WriteOnly);
+			outData.setByteOrder(QDataStream::LittleEndian);
+
+			out << (quint16)entries;
+			//tag, type (3 = short, 4 = long, 5 = rational), count and value or offset of the values
+			out << (quint16)256 << (quint16)4 << (quint32)1 << (quint32)m_width;		//ImageWidth
+			out << (quint16)257 << (quint16)4 << (quint32)1 << (quint32)m_height;		//ImageLength
+			out << (quint16)258 << (quint16)3 << (quint32)4 << dataOffset;			//BitsPerSample
+			outData << (quint16)8 << (quint16)8 << (quint16)8 << (quint16)8;
+			out << (quint16)259 << (quint16)3 << (quint32)1 << (quint16)8 << (quint16)0;	//Compression: deflate
+			out << (quint16)262 << (quint16)3 << (quint32)1 << (quint16)2 << (quint16)0;	//PhotometricInterpretation: RGB
+			out << (quint16)273 << (quint16)4 << (quint32)strips;				//StripOffsets
+			if (strips == 1)
+				out << m_stripOffsets.first();
+			else {
+				out << (quint32)(dataOffset + data.size());
+				foreach (quint32 offset, m_stripOffsets)
+					outData << offset;
+			}
+			out << (quint16)277 << (quint16)3 << (quint32)1 << (quint16)4 << (quint16)0;	//SamplesPerPixel
+			out << (quint16)278 << (quint16)4 << (quint32)1 << (quint32)m_rowsPerBand;	//RowsPerStrip
+			out << (quint16)279 << (quint16)4 << (quint32)strips;				//StripByteCounts
+			if (strips == 1)
+				out << m_stripByteCounts.first();
+			else {
+				out << (quint32)(dataOffset + data.size());
+				foreach (quint32 count, m_stripByteCounts)
+					outData << count;
+			}
+			out << (quint16)282 << (quint16)5 << (quint32)1 << (quint32)(dataOffset + data.size());	//XResolution
+			outData << (quint32)m_dpi << (quint32)1;
+			out << (quint16)283 << (quint16)5 << (quint32)1 << (quint32)(dataOffset + data.size());	//YResolution
+			outData << (quint32)m_dpi << (quint32)1;
+			out << (quint16)284 << (quint16)3 << (quint32)1 << (quint16)1 << (quint16)0;	//PlanarConfiguration: chunky
+			out << (quint16)296 << (quint16)3 << (quint32)1 << (quint16)2 << (quint16)0;	//ResolutionUnit: inch
+			out << (quint16)338 << (quint16)3 << (quint32)1 << (quint16)2 << (quint16)0;	//ExtraSamples: unassociated alpha
+			out << (quint32)0;	//no further directory
+
+			m_error = (m_file.write(ifd) != ifd.size()) || (m_file.write(data) != data.size());
+			if (!m_error) {
+				m_file.seek(4);
+				QDataStream header(&m_file);
+				header.setByteOrder(QDataStream::LittleEndian);
+				header << ifdOffset;
+			}
+		}
+	}
+
+	m_file.close();
+	if (m_error)
+		m_file.remove();
+
+	return !m_error;
+}
+
+/*!
+	stops writing and removes the incomplete file.
+ */
+void BandImageWriter::abort() {
+	m_error = true;
+	close();
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+    File                 : BandImageWriter.h
+    Project              : LabPlot
+    Description          : Streaming PNG and TIFF writer for images rendered in bands
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef BANDIMAGEWRITER_H
+#define BANDIMAGEWRITER_H
+
+#include <QFile>
+#include <QImage>
+#include <QList>
+#include <QThreadPool>
+#include <QVector>
+
+class BandImageWriter {
+
+public:
+	enum Format {Png, Tiff};
+
+	BandImageWriter();
+	~BandImageWriter();
+
+	bool open(const QString& fileName, Format, int width, int height, int rowsPerBand, int dpi);
+	bool writeBand(const QImage&);
+	bool close();
+	void abort();
+
+	struct Band;
+
+private:
+	bool writeOldestBand();
+	bool writePngChunk(const char* type, const QByteArray& data);
+
+	QFile m_file;
+	Format m_format;
+	int m_width;
+	int m_height;
+	int m_rowsPerBand;
+	int m_dpi;
+	int m_rowsAdded;
+	QImage m_lastBand;
+	QList<Band*> m_bands;
+	QThreadPool m_pool;
+	bool m_error;
+
+	//PNG: checksum of the uncompressed data
+	unsigned long m_adler;
+	//TIFF: position and size of the strips
+	QVector<quint32> m_stripOffsets;
+	QVector<quint32> m_stripByteCounts;
+};
+
+#endif
@@ -29,8 +29,10 @@
 #include "ColorMapRenderer.h"
 
 #include <KDebug>
+#include <KLocale>
 #include <QFile>
 #include <QPainter>
+#include <QTextStream>
 
 QPixmap ColorMapRenderer::pixmap(const QString& fileName) {
 	QFile file(fileName);
@@ -65,3 +67,69 @@ QPixmap ColorMapRenderer::pixmap(const QString& fileName) {
 
 	return pixmap;
 }
+
+/*!
+  returns the colors of the built-in color map \c map, interpolated to \c size entries
+  from the lowest to the highest value.
+*/
+QVector<QRgb> ColorMapRenderer::colorTable(ColorMap map, int size) {
+	static const QRgb viridis[] = {0x440154, 0x3b528b, 0x21918c, 0x5ec962, 0xfde725};
+	static const QRgb hot[] = {0x000000, 0xe60000, 0xffd200, 0xffffff};
+	static const QRgb grayscale[] = {0x000000, 0xffffff};
+	static const QRgb rainbow[] = {0x0000ff, 0x00ffff, 0x00ff00, 0xffff00, 0xff0000};
+
+	const QRgb* stops = viridis;
+	int count = 5;
+	switch (map) {
+	case Viridis:
+		break;
+	case Hot:
+		stops = hot;
+		count = 4;
+		break;
+	case Grayscale:
+		stops = grayscale;
+		count = 2;
+		break;
+	case Rainbow:
+		stops = rainbow;
+		count = 5;
+		break;
+	}
+
+	QVector<QRgb> colors(size);
+	for (int i = 0; i < size; ++i) {
+		const double position = (size > 1) ? double(i)*(count - 1)/(size - 1) : 0;
+		const int stop = qMin(int(position), count - 2);
+		const double t = position - stop;
+		const QRgb c1 = stops[stop];
+		const QRgb c2 = stops[stop + 1];
+		colors[i] = qRgb(qRound(qRed(c1) + t*(qRed(c2) - qRed(c1))),
+						qRound(qGreen(c1) + t*(qGreen(c2) - qGreen(c1))),
+						qRound(qBlue(c1) + t*(qBlue(c2) - qBlue(c1))));
+	}
+
+	return colors;
+}
+
+/*!
+  returns a horizontal bar of the size \c size showing the built-in color map \c map.
+*/
+QPixmap ColorMapRenderer::pixmap(ColorMap map, const QSize& size) {
+	const QVector<QRgb> colors = colorTable(map, size.width());
+	QPixmap pixmap(size);
+	QPainter p(&pixmap);
+	for (int i = 0; i < colors.size(); ++i) {
+		p.setPen(QColor(colors.at(i)));
+		p.drawLine(QPoint(i, 0), QPoint(i, size.height()));
+	}
+
+	return pixmap;
+}
+
+/*!
+  returns the names of the built-in color maps in the order of ColorMap.
+*/
+QStringList ColorMapRenderer::names() {
+	return QStringList() << i18n("viridis") << i18n("hot") << i18n("grayscale") << i18n("rainbow");
+}
@@ -30,11 +30,18 @@
 #define COLORMAPRENDERER_H
 
 #include <QPixmap>
+#include <QStringList>
+#include <QVector>
 
 class ColorMapRenderer{
 
 public:
+  enum ColorMap {Viridis, Hot, Grayscale, Rainbow};
+
   static QPixmap pixmap( const QString& );
+  static QPixmap pixmap(ColorMap, const QSize&);
+  static QVector<QRgb> colorTable(ColorMap, int size = 256);
+  static QStringList names();
 
 };
 
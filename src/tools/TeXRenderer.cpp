@@ -36,9 +36,15 @@
 
 #include <QImage>
 #include <QColor>
+#include <QCryptographicHash>
 #include <QDir>
+#include <QFutureInterface>
+#include <QMutex>
+#include <QRunnable>
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
 #include <QProcess>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
@@ -52,10 +58,68 @@
 	\class TeXRenderer
 	\brief Implements rendering of latex code to a PNG image.
 
-	Uses latex engine specified by the user (default xelatex) to render LaTeX text
+	Uses latex engine specified by the user (default xelatex) to render LaTeX text.
+	The rendered images are kept in a size-bounded cache on disk, keyed by a hash of the TeX code,
+	the formatting and the engine. Only images not found in the cache are rendered,
+	at most half as many at the same time as there are cores.
 
 	\ingroup tools
 */
+
+//mutex for the access to the cache directory
+static QMutex cacheMutex;
+
+//! renders one image in the thread pool of the TeX renderer, provides the result via QFuture like QtConcurrent::run()
+class TeXRenderTask : public QFutureInterface<QImage>, public QRunnable {
+public:
+	TeXRenderTask(const QString& teXString, bool* success, const TeXRenderer::Formatting& format)
+		: m_teXString(teXString), m_success(success), m_format(format) {}
+
+	QFuture<QImage> start(QThreadPool* pool) {
+		setThreadPool(pool);
+		reportStarted();
+		QFuture<QImage> future = this->future();
+		pool->start(this);
+		return future;
+	}
+
+	void run() {
+		if (!isCanceled())
+			reportResult(TeXRenderer::renderImageLaTeX(m_teXString, m_success, m_format));
+		reportFinished();
+	}
+
+private:
+	QString m_teXString;
+	bool* m_success;
+	TeXRenderer::Formatting m_format;
+};
+
+/*!
+	returns the image for \c teXString. Cached images are returned in an already finished future,
+	all other ones are rendered in the background. Every rendering starts several external processes,
+	the number of concurrent renderings is limited to not overload the system if many labels are rendered at once.
+ */
+QFuture<QImage> TeXRenderer::render(const QString& teXString, bool* success, const TeXRenderer::Formatting& format) {
+	const QImage image = cachedImage(teXString, format);
+	if (!image.isNull()) {
+		*success = true;
+		QFutureInterface<QImage> futureInterface;
+		futureInterface.reportStarted();
+		futureInterface.reportResult(image);
+		futureInterface.reportFinished();
+		return futureInterface.future();
+	}
+
+	static QThreadPool* pool = 0;
+	if (!pool) {
+		pool = new QThreadPool();
+		pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()/2));
+	}
+
+	return (new TeXRenderTask(teXString, success, format))->start(pool);
+}
+
 QImage TeXRenderer::renderImageLaTeX(const QString& teXString, bool* success, const TeXRenderer::Formatting& format) {
 	const QColor& fontColor =format.fontColor;
 	const int fontSize = format.fontSize;
@@ -88,8 +152,7 @@ QImage TeXRenderer::renderImageLaTeX(const QString& teXString, bool* success, co
 	}
 
 	//determine latex engine to be used
-	KConfigGroup group = KGlobal::config()->group(QLatin1String("Settings_Worksheet"));
-	QString engine = group.readEntry("LaTeXEngine", "pdflatex");
+	const QString engine = TeXRenderer::engine();
 
 	// create latex code
 	QTextStream out(&file);
@@ -133,10 +196,16 @@ QImage TeXRenderer::renderImageLaTeX(const QString& teXString, bool* success, co
 	out << "\\end{preview}";
 	out << "\\end{document}";
 	out.flush();
+	QImage image;
 	if (engine == "latex")
-		return imageFromDVI(file, dpi, success);
+		image = imageFromDVI(file, dpi, success);
 	else
-		return imageFromPDF(file, dpi, engine, success);
+		image = imageFromPDF(file, dpi, engine, success);
+
+	if (*success && !image.isNull())
+		cacheImage(teXString, format, image);
+
+	return image;
 }
 
 // TEX -> PDF -> PNG
@@ -248,9 +317,82 @@ QImage TeXRenderer::imageFromDVI(const QTemporaryFile& file, const int dpi, bool
 	return image;
 }
 
+/*!
+	returns the image rendered for \c teXString and \c format with the current engine before
+	or a null image if it's not in the cache.
+ */
+QImage TeXRenderer::cachedImage(const QString& teXString, const TeXRenderer::Formatting& format) {
+	const QString fileName = cacheFileName(teXString, format);
+	QImage image;
+	if (!fileName.isEmpty())
+		image.load(fileName, "PNG");
+	return image;
+}
+
+/*!
+	stores \c image in the cache and removes the oldest images if the size of the cache exceeds
+	the limit (setting "TeXCacheSize" in MiB, 0 disables the cache). Can be called from several threads.
+ */
+void TeXRenderer::cacheImage(const QString& teXString, const TeXRenderer::Formatting& format, const QImage& image) {
+	const QString fileName = cacheFileName(teXString, format);
+	if (fileName.isEmpty() || image.isNull())
+		return;
+
+	QMutexLocker locker(&cacheMutex);
+
+	//write to a temporary file first so that a concurrent lookup never reads an incomplete image
+	const QString tempFileName = fileName + QLatin1String(".part");
+	if (!image.save(tempFileName, "PNG"))
+		return;
+	QFile::remove(fileName);
+	QFile::rename(tempFileName, fileName);
+
+	const KConfigGroup group = KGlobal::config()->group(QLatin1String("Settings_Worksheet"));
+	const qint64 maxSize = group.readEntry(QLatin1String("TeXCacheSize"), 64)*qint64(1024*1024);
+	const QFileInfoList files = QFileInfo(fileName).dir().entryInfoList(QStringList() << "*.png", QDir::Files, QDir::Time);
+	qint64 size = 0;
+	foreach (const QFileInfo& file, files) {
+		size += file.size();
+		if (size > maxSize)
+			QFile::remove(file.absoluteFilePath());
+	}
+}
+
+QString TeXRenderer::engine() {
+	const KConfigGroup group = KGlobal::config()->group(QLatin1String("Settings_Worksheet"));
+	return group.readEntry("LaTeXEngine", "pdflatex");
+}
+
+/*!
+	returns the name of the file in the cache for \c teXString and \c format
+	or an empty string if the cache is disabled.
+ */
+QString TeXRenderer::cacheFileName(const QString& teXString, const TeXRenderer::Formatting& format) {
+	const KConfigGroup group = KGlobal::config()->group(QLatin1String("Settings_Worksheet"));
+	if (group.readEntry(QLatin1String("TeXCacheSize"), 64) <= 0)
+		return QString();
+
+	static QString cachePath;
+	{
+		QMutexLocker locker(&cacheMutex);
+		if (cachePath.isEmpty()) {
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+			cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/tex/");
+			QDir().mkpath(cachePath);
+#else
+			cachePath = KGlobal::dirs()->locateLocal("cache", QLatin1String("labplot2/tex/"));
+#endif
+		}
+	}
+
+	const QString key = teXString + QLatin1Char('\n') + format.fontFamily + QLatin1Char('\n')
+		+ QString::number(format.fontSize) + QLatin1Char('\n') + QString::number(format.fontColor.rgba(), 16) + QLatin1Char('\n')
+		+ QString::number(format.dpi) + QLatin1Char('\n') + engine();
+	return cachePath + QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex() + QLatin1String(".png");
+}
+
 bool TeXRenderer::enabled() {
-	KConfigGroup group = KGlobal::config()->group(QLatin1String("Settings_Worksheet"));
-	QString engine = group.readEntry("LaTeXEngine", "pdflatex");
+	const QString engine = TeXRenderer::engine();
 	if (engine.isEmpty() || !executableExists(engine)) {
 		WARNING("LaTeX engine does not exist");
 		return false;
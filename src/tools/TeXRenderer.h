@@ -34,6 +34,7 @@ class QTemporaryFile;
 
 #include <QString>
 #include <QColor>
+#include <QFuture>
 
 class TeXRenderer {
 
@@ -45,11 +46,18 @@ public:
 		int dpi;
 	};
 
+	static QFuture<QImage> render(const QString&, bool* success, const TeXRenderer::Formatting&);
 	static QImage renderImageLaTeX(const QString&, bool* success, const TeXRenderer::Formatting&);
+	static QImage cachedImage(const QString&, const TeXRenderer::Formatting&);
+	static void cacheImage(const QString&, const TeXRenderer::Formatting&, const QImage&);
 	static QImage imageFromPDF(const QTemporaryFile&, const int dpi, const QString& engine, bool* success);
 	static QImage imageFromDVI(const QTemporaryFile&, const int dpi, bool* success);
 	static bool enabled();
 	static bool executableExists(const QString&);
+
+private:
+	static QString engine();
+	static QString cacheFileName(const QString&, const TeXRenderer::Formatting&);
 };
 
 #endif